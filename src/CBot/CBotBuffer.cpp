@@ -0,0 +1,117 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "CBot/CBotBuffer.h"
+
+#include "CBot/CBotFileUtils.h"
+
+#include <cstring>
+
+namespace CBot
+{
+
+////////////////////////////////////////////////////////////////////////////////
+CBotBufferWriter::CBotBufferWriter(std::size_t reserve)
+{
+    m_data.reserve(reserve);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotBufferWriter::WriteBytes(const void* data, std::size_t size)
+{
+    if (size == 0) return;
+    std::memcpy(Grow(size), data, size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+char* CBotBufferWriter::Grow(std::size_t size)
+{
+    std::size_t pos = m_data.size();
+    m_data.resize(pos + size);
+    return m_data.data() + pos;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotBufferReader::CBotBufferReader()
+    : m_pos(nullptr), m_end(nullptr), m_istr(nullptr)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotBufferReader::CBotBufferReader(const char* data, std::size_t size)
+    : m_pos(data), m_end(data + size), m_istr(nullptr)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotBufferReader::CBotBufferReader(std::istream &istr)
+    : m_pos(nullptr), m_end(nullptr), m_istr(&istr)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotBufferReader::Load(std::istream &istr, std::size_t size)
+{
+    m_istr = nullptr;
+    m_data.resize(size);
+    m_pos = m_data.data();
+    m_end = m_pos + size;
+    if (size == 0) return true;
+    return static_cast<bool>(istr.read(m_data.data(), size));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotBufferReader::ReadBytes(void* data, std::size_t size)
+{
+    if (m_istr != nullptr && m_pos == m_end)
+        return static_cast<bool>(m_istr->read(static_cast<char*>(data), size));
+
+    const char* src = Skip(size);
+    if (src == nullptr) return false;
+    if (size != 0) std::memcpy(data, src, size);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const char* CBotBufferReader::Skip(std::size_t size)
+{
+    if (GetRemaining() < size) return nullptr;
+    const char* p = m_pos;
+    m_pos += size;
+    return p;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool WriteBuffer(std::ostream &ostr, const CBotBufferWriter &buffer)
+{
+    if (!WriteLong(ostr, static_cast<long>(buffer.GetSize()))) return false;
+    if (buffer.GetSize() == 0) return true;
+    return static_cast<bool>(ostr.write(buffer.GetData(), buffer.GetSize()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ReadBuffer(std::istream &istr, CBotBufferReader &buffer)
+{
+    long size;
+    if (!ReadLong(istr, size)) return false;
+    if (size < 0) return false;
+    return buffer.Load(istr, static_cast<std::size_t>(size));
+}
+
+} // namespace CBot
@@ -0,0 +1,205 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+namespace CBot
+{
+
+/**
+ * \brief Contiguous, growable byte buffer used to serialize program state
+ *
+ * Writing to a std::ostream one value at a time goes through the stream sentry
+ * and virtual buffer machinery for every single byte. The whole state is
+ * instead encoded into this buffer and handed to the stream with a single write.
+ *
+ * \see CBotBufferReader
+ * \see CBotProgram::SaveState()
+ */
+class CBotBufferWriter
+{
+public:
+    /**
+     * \brief Constructor
+     * \param reserve Number of bytes to preallocate
+     */
+    explicit CBotBufferWriter(std::size_t reserve = 0);
+
+    /**
+     * \brief Append a single byte
+     * \param c Byte to append
+     */
+    void WriteByte(char c)
+    {
+        m_data.push_back(c);
+    }
+
+    /**
+     * \brief Append a block of bytes
+     * \param data Pointer to the data
+     * \param size Number of bytes to append
+     */
+    void WriteBytes(const void* data, std::size_t size);
+
+    /**
+     * \brief Grow the buffer by the given number of bytes and return a pointer to the new area
+     *
+     * Used for bulk encoding, so that arrays can be written without going through WriteByte() for every value
+     *
+     * \param size Number of bytes to append
+     * \return Pointer to the first appended byte, valid until the next write
+     */
+    char* Grow(std::size_t size);
+
+    //! Pointer to the encoded data
+    const char* GetData() const
+    {
+        return m_data.data();
+    }
+
+    //! Number of encoded bytes
+    std::size_t GetSize() const
+    {
+        return m_data.size();
+    }
+
+    //! Discard the contents, keeping the allocated memory
+    void Clear()
+    {
+        m_data.clear();
+    }
+
+private:
+    std::vector<char> m_data;
+};
+
+/**
+ * \brief Reader for data written with CBotBufferWriter
+ *
+ * The reader normally works on a contiguous block of memory, loaded from a stream
+ * with a single read (see Load()). For states saved by older versions, which did
+ * not store the size of the data, it can also read directly from a stream.
+ *
+ * \see CBotBufferWriter
+ * \see CBotProgram::RestoreState()
+ */
+class CBotBufferReader
+{
+public:
+    /**
+     * \brief Constructor, creates an empty reader
+     */
+    CBotBufferReader();
+
+    /**
+     * \brief Constructor, reads from the given memory block without copying it
+     * \param data Pointer to the data, must stay valid as long as the reader is used
+     * \param size Size of the data in bytes
+     */
+    CBotBufferReader(const char* data, std::size_t size);
+
+    /**
+     * \brief Constructor, reads directly from a stream
+     *
+     * Only meant for restoring old states which were not saved as one block
+     *
+     * \param istr Input stream
+     */
+    explicit CBotBufferReader(std::istream &istr);
+
+    /**
+     * \brief Load a block of data from the stream with a single read
+     * \param istr Input stream
+     * \param size Number of bytes to read
+     * \return false on read error
+     */
+    bool Load(std::istream &istr, std::size_t size);
+
+    /**
+     * \brief Read a single byte
+     * \param[out] c Byte read
+     * \return false if there is no more data
+     */
+    bool ReadByte(char &c)
+    {
+        if (m_pos < m_end)
+        {
+            c = *m_pos++;
+            return true;
+        }
+        if (m_istr != nullptr) return static_cast<bool>(m_istr->get(c));
+        return false;
+    }
+
+    /**
+     * \brief Read a block of bytes
+     * \param[out] data Destination
+     * \param size Number of bytes to read
+     * \return false if there is not enough data
+     */
+    bool ReadBytes(void* data, std::size_t size);
+
+    /**
+     * \brief Get a pointer to the next bytes and skip over them
+     *
+     * Used for bulk decoding. Not available when reading directly from a stream.
+     *
+     * \param size Number of bytes
+     * \return Pointer to the data, or nullptr if there is not enough data
+     */
+    const char* Skip(std::size_t size);
+
+    //! Number of bytes left in the memory block
+    std::size_t GetRemaining() const
+    {
+        return static_cast<std::size_t>(m_end - m_pos);
+    }
+
+private:
+    //! Memory owned by the reader when filled with Load()
+    std::vector<char> m_data;
+    //! Current read position
+    const char* m_pos;
+    //! End of the memory block
+    const char* m_end;
+    //! Stream used when there is no memory block
+    std::istream* m_istr;
+};
+
+/*!
+ * \brief Write the contents of a buffer as a single block, preceded by its size
+ * \param ostr Output stream
+ * \param buffer Buffer to write
+ * \return true on success
+ */
+bool WriteBuffer(std::ostream &ostr, const CBotBufferWriter &buffer);
+
+/*!
+ * \brief Read a block written with WriteBuffer()
+ * \param istr Input stream
+ * \param[out] buffer Buffer to load the data into
+ * \return true on success
+ */
+bool ReadBuffer(std::istream &istr, CBotBufferReader &buffer);
+
+} // namespace CBot
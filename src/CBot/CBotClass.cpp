@@ -44,6 +44,7 @@ namespace CBot
 
 ////////////////////////////////////////////////////////////////////////////////
 std::set<CBotClass*> CBotClass::m_publicClasses{};
+int CBotClass::m_publicVersion = 0;
 
 ////////////////////////////////////////////////////////////////////////////////
 CBotClass::CBotClass(const std::string& name,
@@ -60,12 +61,14 @@ CBotClass::CBotClass(const std::string& name,
     m_nbVar     = m_parent == nullptr ? 0 : m_parent->m_nbVar;
 
     m_publicClasses.insert(this);
+    ++m_publicVersion;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 CBotClass::~CBotClass()
 {
     m_publicClasses.erase(this);
+    ++m_publicVersion;
 
     delete  m_pVar;
     delete  m_externalMethods;
@@ -89,6 +92,12 @@ void CBotClass::ClearPublic()
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int CBotClass::GetPublicVersion()
+{
+    return m_publicVersion;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void CBotClass::Purge()
 {
@@ -98,6 +107,7 @@ void CBotClass::Purge()
     for (CBotFunction* f : m_pMethod) delete f;
     m_pMethod.clear();
     m_IsDef     = false;
+    ++m_publicVersion;
 
     m_nbVar     = m_parent == nullptr ? 0 : m_parent->m_nbVar;
 }
@@ -299,6 +309,16 @@ bool CBotClass::SetUpdateFunc(void rUpdate(CBotVar* thisVar, void* user))
     return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotClass::SetFieldUpdateFunc(const std::string& name, void rUpdate(CBotVar* field, void* user))
+{
+    CBotVar* pVar = GetItem(name);
+    if (pVar == nullptr) return false;
+
+    m_fieldUpdates[pVar->GetUniqNum()] = rUpdate;
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 CBotTypResult CBotClass::CompileMethode(CBotToken* name,
                                         CBotVar* pThis,
@@ -367,66 +387,88 @@ bool CBotClass::SaveStaticState(std::ostream &ostr)
 {
     if (!WriteLong(ostr, CBOTVERSION*2)) return false;
 
+    // the state is encoded in memory and written as one block
+    CBotBufferWriter buffer;
+
     // saves the state of static variables in classes
     for (CBotClass* p : m_publicClasses)
     {
-        if (!WriteWord(ostr, 1)) return false;
+        if (!WriteWord(buffer, 1)) return false;
         // save the name of the class
-        if (!WriteString(ostr, p->GetName())) return false;
+        if (!WriteString(buffer, p->GetName())) return false;
 
         CBotVar*    pv = p->GetVar();
         while( pv != nullptr )
         {
             if ( pv->IsStatic() )
             {
-                if (!WriteWord(ostr, 1)) return false;
-                if (!WriteString(ostr, pv->GetName())) return false;
+                if (!WriteWord(buffer, 1)) return false;
+                if (!WriteString(buffer, pv->GetName())) return false;
 
-                if (!pv->Save0State(ostr)) return false;             // common header
-                if (!pv->Save1State(ostr)) return false;                // saves as the child class
-                if (!WriteWord(ostr, 0)) return false;
+                if (!pv->Save0State(buffer)) return false;             // common header
+                if (!pv->Save1State(buffer)) return false;                // saves as the child class
+                if (!WriteWord(buffer, 0)) return false;
             }
             pv = pv->GetNext();
         }
 
-        if (!WriteWord(ostr, 0)) return false;
+        if (!WriteWord(buffer, 0)) return false;
     }
 
-    if (!WriteWord(ostr, 0)) return false;
-    return true;
+    if (!WriteWord(buffer, 0)) return false;
+    return WriteBuffer(ostr, buffer);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool CBotClass::RestoreStaticState(std::istream &istr)
+{
+    long version;
+    if (!ReadLong(istr, version)) return false;
+
+    if (version == CBOTVERSION*2)
+    {
+        CBotBufferReader buffer;
+        if (!ReadBuffer(istr, buffer)) return false;
+        return RestoreStaticState(buffer);
+    }
+
+    // older versions were written directly to the stream, without the size of the state
+    if (version >= CBOTVERSION_COMPAT*2 && version < CBOTVERSION*2)
+    {
+        CBotBufferReader buffer(istr);
+        return RestoreStaticState(buffer);
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotClass::RestoreStaticState(CBotBufferReader &buffer)
 {
     std::string      ClassName, VarName;
     CBotClass*      pClass;
     unsigned short  w;
 
-    long version;
-    if (!ReadLong(istr, version)) return false;
-    if (version != CBOTVERSION*2) return false;
-
     while (true)
     {
-        if (!ReadWord(istr, w)) return false;
+        if (!ReadWord(buffer, w)) return false;
         if ( w == 0 ) return true;
 
-        if (!ReadString(istr, ClassName)) return false;
+        if (!ReadString(buffer, ClassName)) return false;
         pClass = Find(ClassName);
 
         while (true)
         {
-            if (!ReadWord(istr, w)) return false;
+            if (!ReadWord(buffer, w)) return false;
             if ( w == 0 ) break;
 
             CBotVar*    pVar = nullptr;
             CBotVar*    pv = nullptr;
 
-            if (!ReadString(istr, VarName)) return false;
+            if (!ReadString(buffer, VarName)) return false;
             if ( pClass != nullptr ) pVar = pClass->GetItem(VarName);
 
-            if (!CBotVar::RestoreState(istr, pv)) return false; // the temp variable
+            if (!CBotVar::RestoreState(buffer, pv)) return false; // the temp variable
 
             if ( pVar != nullptr ) pVar->Copy(pv);
             delete pv;
@@ -814,4 +856,13 @@ void CBotClass::Update(CBotVar* var, void* user)
     m_rUpdate(var, user);
 }
 
+void CBotClass::UpdateField(CBotVar* var, CBotVar* field, void* user)
+{
+    auto it = m_fieldUpdates.find(field->GetUniqNum());
+    if (it != m_fieldUpdates.end())
+        it->second(field, user);
+    else
+        m_rUpdate(var, user);
+}
+
 } // namespace CBot
@@ -25,6 +25,7 @@
 
 #include <string>
 #include <deque>
+#include <map>
 #include <set>
 #include <list>
 
@@ -149,6 +150,17 @@ public:
      * \return
      */
     bool SetUpdateFunc(void rUpdate(CBotVar* thisVar, void* user));
+
+    /*!
+     * \brief SetFieldUpdateFunc Defines routine to be called to update a single
+     * element of the class. When a script reads instance.name, only this routine
+     * is called instead of the one given to SetUpdateFunc(), which still updates
+     * all elements whenever the instance is used as a whole.
+     * \param name Name of an element previously added with AddItem()
+     * \param rUpdate Routine updating the given element
+     * \return false if there is no element with this name
+     */
+    bool SetFieldUpdateFunc(const std::string& name, void rUpdate(CBotVar* field, void* user));
     //
 
     /*!
@@ -336,6 +348,13 @@ public:
      */
     static void ClearPublic();
 
+    /*!
+     * \brief Returns a number which changes every time a class is created, purged or deleted
+     *
+     * Compiled code depends on the definitions of classes, see CBotProgram::CompileShared()
+     */
+    static int GetPublicVersion();
+
     /*!
      * \brief Save all static variables from each public class
      * \param ostr Output stream
@@ -380,9 +399,27 @@ public:
 
     void Update(CBotVar* var, void* user);
 
+    /*!
+     * \brief Update a single element of an instance, see SetFieldUpdateFunc()
+     * Falls back to updating the whole instance if the element has no routine of its own.
+     * \param var Instance of this class
+     * \param field Element of the instance to update
+     * \param user User pointer
+     */
+    void UpdateField(CBotVar* var, CBotVar* field, void* user);
+
 private:
+    /*!
+     * \brief Restore all static variables in each public class from a buffer
+     * \param buffer Input buffer
+     * \return true on success
+     */
+    static bool RestoreStaticState(CBotBufferReader &buffer);
+
     //! List of all public classes
     static std::set<CBotClass*> m_publicClasses;
+    //! See GetPublicVersion()
+    static int m_publicVersion;
 
 
     //! true if this class is fully compiled, false if only precompiled
@@ -402,6 +439,8 @@ private:
     //! List of all class methods
     std::list<CBotFunction*> m_pMethod{};
     void (*m_rUpdate)(CBotVar* thisVar, void* user);
+    //! Routines updating single elements, by unique number of the element
+    std::map<long, void (*)(CBotVar* field, void* user)> m_fieldUpdates;
 
     CBotToken* m_pOpenblk;
 
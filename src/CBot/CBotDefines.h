@@ -25,7 +25,9 @@
 #define    MAXARRAYSIZE    9999
 
 //! Define the current CBot version
-#define    CBOTVERSION    104
+#define    CBOTVERSION    105
+//! Oldest CBot version whose saved states can still be restored
+#define    CBOTVERSION_COMPAT    104
 
 // for SetUserPtr when deleting an object
 // \TODO define own types to distinct between different states of objects
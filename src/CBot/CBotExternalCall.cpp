@@ -32,11 +32,13 @@ namespace CBot
 void CBotExternalCallList::Clear()
 {
     m_list.clear();
+    ++m_version;
 }
 
 bool CBotExternalCallList::AddFunction(const std::string& name, std::unique_ptr<CBotExternalCall> call)
 {
     m_list[name] = std::move(call);
+    ++m_version;
     return true;
 }
 
@@ -211,9 +211,20 @@ public:
      */
     void Clear();
 
+    /**
+     * \brief Returns a number which changes every time the list of functions is modified
+     *
+     * Compiled code depends on the registered functions, see CBotProgram::CompileShared()
+     */
+    int GetVersion() const
+    {
+        return m_version;
+    }
+
 private:
     std::map<std::string, std::unique_ptr<CBotExternalCall>> m_list{};
     void* m_user = nullptr;
+    int m_version = 0;
 };
 
 } // namespace CBot
@@ -22,11 +22,55 @@
 #include "CBot/CBotClass.h"
 #include "CBot/CBotEnums.h"
 
+#include <cstring>
+
 namespace CBot
 {
 
-template<typename T>
-static bool WriteBinary(std::ostream &ostr, T value, unsigned padTo = 0)
+static bool PutChar(std::ostream &ostr, char c)
+{
+    return static_cast<bool>(ostr.put(c));
+}
+
+static bool PutChar(CBotBufferWriter &buffer, char c)
+{
+    buffer.WriteByte(c);
+    return true;
+}
+
+static bool GetChar(std::istream &istr, char &c)
+{
+    return static_cast<bool>(istr.get(c));
+}
+
+static bool GetChar(CBotBufferReader &buffer, char &c)
+{
+    return buffer.ReadByte(c);
+}
+
+static bool PutBytes(std::ostream &ostr, const char* data, std::size_t size)
+{
+    return static_cast<bool>(ostr.write(data, size));
+}
+
+static bool PutBytes(CBotBufferWriter &buffer, const char* data, std::size_t size)
+{
+    buffer.WriteBytes(data, size);
+    return true;
+}
+
+static bool GetBytes(std::istream &istr, char* data, std::size_t size)
+{
+    return static_cast<bool>(istr.read(data, size));
+}
+
+static bool GetBytes(CBotBufferReader &buffer, char* data, std::size_t size)
+{
+    return buffer.ReadBytes(data, size);
+}
+
+template<typename T, typename Out>
+static bool WriteBinary(Out &ostr, T value, unsigned padTo = 0)
 {
     unsigned char chr;
     unsigned count = 1;
@@ -34,32 +78,34 @@ static bool WriteBinary(std::ostream &ostr, T value, unsigned padTo = 0)
     {
         ++count;
         chr = (value & 0x7F) | 0x80;
-        if (!ostr.write(reinterpret_cast<char*>(&chr), 1)) return false;
+        if (!PutChar(ostr, chr)) return false;
         value >>= 7;
     }
     chr = value & 0x7F;
     if (count < padTo) chr |= 0x80;
-    if (!ostr.write(reinterpret_cast<char*>(&chr), 1)) return false;
+    if (!PutChar(ostr, chr)) return false;
 
     if (count < padTo)
     {
         while (++count < padTo)
-            if (!(ostr << '\x80')) return false;
-        if (!(ostr << '\x00')) return false;
+            if (!PutChar(ostr, '\x80')) return false;
+        if (!PutChar(ostr, '\x00')) return false;
     }
     return true;
 }
 
-template<typename T>
-static bool ReadBinary(std::istream &istr, T &value)
+template<typename T, typename In>
+static bool ReadBinary(In &istr, T &value)
 {
     value = 0;
+    char c;
     unsigned char chr;
     unsigned shift = 0;
     while (true)        // unsigned LEB128
     {
-        if (!istr.read(reinterpret_cast<char*>(&chr), 1)) return false;
-        if (shift < sizeof(T) * 8 - 1)
+        if (!GetChar(istr, c)) return false;
+        chr = static_cast<unsigned char>(c);
+        if (shift < sizeof(T) * 8)
             value |= static_cast<T>(chr & 0x7F) << shift;
         shift += 7;
         if ((chr & 0x80) == 0) break;
@@ -67,8 +113,8 @@ static bool ReadBinary(std::istream &istr, T &value)
     return true;
 }
 
-template<typename T>
-static bool WriteSignedBinary(std::ostream &ostr, T value, unsigned padTo = 0)
+template<typename T, typename Out>
+static bool WriteSignedBinary(Out &ostr, T value, unsigned padTo = 0)
 {
     signed char sign = value >> (8 * sizeof(T) - 1);
     unsigned count = 0;
@@ -80,32 +126,34 @@ static bool WriteSignedBinary(std::ostream &ostr, T value, unsigned padTo = 0)
         if (!(value != sign || ((chr ^ sign) & 0x40) != 0))
         {
             if (count < padTo) chr |= 0x80;
-            if (!ostr.write(reinterpret_cast<char*>(&chr), 1)) return false;
+            if (!PutChar(ostr, chr)) return false;
             break;
         }
         chr |= 0x80;
-        if (!ostr.put(chr)) return false;
+        if (!PutChar(ostr, chr)) return false;
     }
 
     if (count < padTo)
     {
         char chr = (sign < 0) ? 0x7F : 0x00;
         while (++count < padTo)
-            if (!ostr.put(chr | 0x80)) return false;
-        if (!ostr.put(chr)) return false;
+            if (!PutChar(ostr, chr | 0x80)) return false;
+        if (!PutChar(ostr, chr)) return false;
     }
     return true;
 }
 
-template<typename T>
-static bool ReadSignedBinary(std::istream &istr, T &value)
+template<typename T, typename In>
+static bool ReadSignedBinary(In &istr, T &value)
 {
     value = 0;
+    char c;
     unsigned char chr;
     unsigned shift = 0;
     while (true)        // signed LEB128
     {
-        if (!istr.read(reinterpret_cast<char*>(&chr), 1)) return false;
+        if (!GetChar(istr, c)) return false;
+        chr = static_cast<unsigned char>(c);
         if (shift < sizeof(T) * 8 - 1)
             value |= (static_cast<T>(chr & 0x7F) << shift);
         shift += 7;
@@ -119,143 +167,67 @@ static bool ReadSignedBinary(std::istream &istr, T &value)
     return true;
 }
 
-bool WriteWord(std::ostream &ostr, unsigned short w)
-{
-    return WriteBinary<unsigned short>(ostr, w);
-}
-
-bool ReadWord(std::istream &istr, unsigned short &w)
-{
-    return ReadBinary<unsigned short>(istr, w);
-}
-
-bool WriteByte(std::ostream &ostr, char c)
-{
-    if (!ostr.put(c)) return false;
-    return true;
-}
-
-bool ReadByte(std::istream &istr, char& c)
-{
-    if (!istr.get(c)) return false;
-    return true;
-}
-
-bool WriteShort(std::ostream &ostr, short s)
-{
-    return WriteSignedBinary<short>(ostr, s);
-}
-
-bool ReadShort(std::istream &istr, short &s)
-{
-    return ReadSignedBinary<short>(istr, s);
-}
-
-bool WriteUInt32(std::ostream &ostr, uint32_t i)
-{
-    return WriteBinary<uint32_t>(ostr, i);
-}
-
-bool ReadUInt32(std::istream &istr, uint32_t &i)
-{
-    return ReadBinary<uint32_t>(istr, i);
-}
-
-bool WriteInt(std::ostream &ostr, int i)
-{
-    return WriteSignedBinary<int>(ostr, i);
-}
-
-bool ReadInt(std::istream &istr, int &i)
-{
-    return ReadSignedBinary<int>(istr, i);
-}
-
-bool WriteLong(std::ostream &ostr, long l, unsigned padTo)
+union FloatConverter
 {
-    return WriteSignedBinary<long>(ostr, l, padTo);
-}
+    float fValue;
+    unsigned int iValue;
+};
 
-bool ReadLong(std::istream &istr, long &l)
+union DoubleConverter
 {
-    return ReadSignedBinary<long>(istr, l);
-}
+    double dValue;
+    unsigned long iValue;
+};
 
-bool WriteFloat(std::ostream &ostr, float f)
+template<typename Out>
+static bool WriteFloatValue(Out &ostr, float f)
 {
-    union TypeConverter
-    {
-        float fValue;
-        unsigned int iValue;
-    };
-
-    TypeConverter u;
-    u.fValue = 0.0f;
+    FloatConverter u;
     u.iValue = 0;
-
     u.fValue = f;
     return WriteBinary<unsigned int>(ostr, u.iValue);
 }
 
-bool ReadFloat(std::istream &istr, float &f)
+template<typename In>
+static bool ReadFloatValue(In &istr, float &f)
 {
-    union TypeConverter
-    {
-        float fValue;
-        unsigned int iValue;
-    };
-
-    TypeConverter u;
-    u.fValue = 0.0f;
+    FloatConverter u;
     u.iValue = 0;
-
     if (!ReadBinary<unsigned int>(istr, u.iValue)) return false;
     f = u.fValue;
     return true;
 }
 
-bool WriteDouble(std::ostream &ostr, double d)
+template<typename Out>
+static bool WriteDoubleValue(Out &ostr, double d)
 {
-    union TypeConverter
-    {
-        double dValue;
-        unsigned long iValue;
-    };
-
-    TypeConverter u;
-    u.dValue = 0.0;
+    DoubleConverter u;
     u.iValue = 0;
-
     u.dValue = d;
     return WriteBinary<unsigned long>(ostr, u.iValue);
 }
 
-bool ReadDouble(std::istream &istr, double &d)
+template<typename In>
+static bool ReadDoubleValue(In &istr, double &d)
 {
-    union TypeConverter
-    {
-        double dValue;
-        unsigned long iValue;
-    };
-
-    TypeConverter u;
-    u.dValue = 0.0;
+    DoubleConverter u;
     u.iValue = 0;
-
     if (!ReadBinary<unsigned long>(istr, u.iValue)) return false;
     d = u.dValue;
     return true;
 }
 
-bool WriteString(std::ostream &ostr, const std::string &s)
+template<typename Out>
+static bool WriteStringValue(Out &ostr, const std::string &s)
 {
     if (!WriteBinary<size_t>(ostr, s.size())) return false;
-    if (!ostr.write(&(s[0]), s.size())) return false;
+    if (!PutBytes(ostr, s.data(), s.size())) return false;
 
     return true;
 }
 
-bool ReadString(std::istream &istr, std::string &s)
+template<typename In>
+static bool ReadStringValue(In &istr, std::string &s)
 {
     size_t length = 0;
     if (!ReadBinary<size_t>(istr, length)) return false;
@@ -263,12 +235,13 @@ bool ReadString(std::istream &istr, std::string &s)
     s.resize(length);
     if (length != 0)
     {
-        if (!istr.read(&(s[0]), length)) return false;
+        if (!GetBytes(istr, &(s[0]), length)) return false;
     }
     return true;
 }
 
-bool WriteType(std::ostream &ostr, const CBotTypResult &type)
+template<typename Out>
+static bool WriteTypeValue(Out &ostr, const CBotTypResult &type)
 {
     int typ = type.GetType();
     if ( typ == CBotTypIntrinsic ) typ = CBotTypClass;
@@ -296,7 +269,8 @@ bool WriteType(std::ostream &ostr, const CBotTypResult &type)
     return true;
 }
 
-bool ReadType(std::istream &istr, CBotTypResult &type)
+template<typename In>
+static bool ReadTypeValue(In &istr, CBotTypResult &type)
 {
     unsigned short  w, ww;
     if (!ReadWord(istr, w)) return false;
@@ -333,6 +307,311 @@ bool ReadType(std::istream &istr, CBotTypResult &type)
     return true;
 }
 
+static bool IsLittleEndian()
+{
+    const uint16_t one = 1;
+    return *reinterpret_cast<const unsigned char*>(&one) == 1;
+}
+
+/**
+ * Arrays are stored as fixed-width little-endian values, so that on most machines
+ * the whole array is copied with a single memcpy instead of being encoded value by value
+ */
+template<typename T, typename Bits>
+static bool WriteArrayValues(CBotBufferWriter &buffer, const std::vector<T> &values)
+{
+    static_assert(sizeof(T) == sizeof(Bits), "Bits must have the same size as T");
+
+    if (!WriteBinary<size_t>(buffer, values.size())) return false;
+    if (values.empty()) return true;
+
+    char* dst = buffer.Grow(values.size() * sizeof(T));
+    if (IsLittleEndian())
+    {
+        std::memcpy(dst, values.data(), values.size() * sizeof(T));
+        return true;
+    }
+
+    for (const T& value : values)
+    {
+        Bits bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+            *dst++ = static_cast<char>((bits >> (8 * i)) & 0xFF);
+    }
+    return true;
+}
+
+template<typename T, typename Bits>
+static bool ReadArrayValues(CBotBufferReader &buffer, std::vector<T> &values)
+{
+    static_assert(sizeof(T) == sizeof(Bits), "Bits must have the same size as T");
+
+    size_t count = 0;
+    if (!ReadBinary<size_t>(buffer, count)) return false;
+    if (count > buffer.GetRemaining() / sizeof(T)) return false;
+
+    values.resize(count);
+    if (count == 0) return true;
+
+    const char* src = buffer.Skip(count * sizeof(T));
+    if (src == nullptr) return false;
+    if (IsLittleEndian())
+    {
+        std::memcpy(values.data(), src, count * sizeof(T));
+        return true;
+    }
+
+    for (T& value : values)
+    {
+        Bits bits = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+            bits |= static_cast<Bits>(static_cast<unsigned char>(*src++)) << (8 * i);
+        std::memcpy(&value, &bits, sizeof(T));
+    }
+    return true;
+}
+
+bool WriteWord(std::ostream &ostr, unsigned short w)
+{
+    return WriteBinary<unsigned short>(ostr, w);
+}
+
+bool WriteWord(CBotBufferWriter &buffer, unsigned short w)
+{
+    return WriteBinary<unsigned short>(buffer, w);
+}
+
+bool ReadWord(std::istream &istr, unsigned short &w)
+{
+    return ReadBinary<unsigned short>(istr, w);
+}
+
+bool ReadWord(CBotBufferReader &buffer, unsigned short &w)
+{
+    return ReadBinary<unsigned short>(buffer, w);
+}
+
+bool WriteByte(std::ostream &ostr, char c)
+{
+    return PutChar(ostr, c);
+}
+
+bool WriteByte(CBotBufferWriter &buffer, char c)
+{
+    return PutChar(buffer, c);
+}
+
+bool ReadByte(std::istream &istr, char& c)
+{
+    return GetChar(istr, c);
+}
+
+bool ReadByte(CBotBufferReader &buffer, char& c)
+{
+    return GetChar(buffer, c);
+}
+
+bool WriteShort(std::ostream &ostr, short s)
+{
+    return WriteSignedBinary<short>(ostr, s);
+}
+
+bool WriteShort(CBotBufferWriter &buffer, short s)
+{
+    return WriteSignedBinary<short>(buffer, s);
+}
+
+bool ReadShort(std::istream &istr, short &s)
+{
+    return ReadSignedBinary<short>(istr, s);
+}
+
+bool ReadShort(CBotBufferReader &buffer, short &s)
+{
+    return ReadSignedBinary<short>(buffer, s);
+}
+
+bool WriteUInt32(std::ostream &ostr, uint32_t i)
+{
+    return WriteBinary<uint32_t>(ostr, i);
+}
+
+bool WriteUInt32(CBotBufferWriter &buffer, uint32_t i)
+{
+    return WriteBinary<uint32_t>(buffer, i);
+}
+
+bool ReadUInt32(std::istream &istr, uint32_t &i)
+{
+    return ReadBinary<uint32_t>(istr, i);
+}
+
+bool ReadUInt32(CBotBufferReader &buffer, uint32_t &i)
+{
+    return ReadBinary<uint32_t>(buffer, i);
+}
+
+bool WriteInt(std::ostream &ostr, int i)
+{
+    return WriteSignedBinary<int>(ostr, i);
+}
+
+bool WriteInt(CBotBufferWriter &buffer, int i)
+{
+    return WriteSignedBinary<int>(buffer, i);
+}
+
+bool ReadInt(std::istream &istr, int &i)
+{
+    return ReadSignedBinary<int>(istr, i);
+}
+
+bool ReadInt(CBotBufferReader &buffer, int &i)
+{
+    return ReadSignedBinary<int>(buffer, i);
+}
+
+bool WriteLong(std::ostream &ostr, long l, unsigned padTo)
+{
+    return WriteSignedBinary<long>(ostr, l, padTo);
+}
+
+bool WriteLong(CBotBufferWriter &buffer, long l, unsigned padTo)
+{
+    return WriteSignedBinary<long>(buffer, l, padTo);
+}
+
+bool ReadLong(std::istream &istr, long &l)
+{
+    return ReadSignedBinary<long>(istr, l);
+}
+
+bool ReadLong(CBotBufferReader &buffer, long &l)
+{
+    return ReadSignedBinary<long>(buffer, l);
+}
+
+bool WriteFloat(std::ostream &ostr, float f)
+{
+    return WriteFloatValue(ostr, f);
+}
+
+bool WriteFloat(CBotBufferWriter &buffer, float f)
+{
+    return WriteFloatValue(buffer, f);
+}
+
+bool ReadFloat(std::istream &istr, float &f)
+{
+    return ReadFloatValue(istr, f);
+}
+
+bool ReadFloat(CBotBufferReader &buffer, float &f)
+{
+    return ReadFloatValue(buffer, f);
+}
+
+bool WriteDouble(std::ostream &ostr, double d)
+{
+    return WriteDoubleValue(ostr, d);
+}
+
+bool WriteDouble(CBotBufferWriter &buffer, double d)
+{
+    return WriteDoubleValue(buffer, d);
+}
+
+bool ReadDouble(std::istream &istr, double &d)
+{
+    return ReadDoubleValue(istr, d);
+}
+
+bool ReadDouble(CBotBufferReader &buffer, double &d)
+{
+    return ReadDoubleValue(buffer, d);
+}
+
+bool WriteString(std::ostream &ostr, const std::string &s)
+{
+    return WriteStringValue(ostr, s);
+}
+
+bool WriteString(CBotBufferWriter &buffer, const std::string &s)
+{
+    return WriteStringValue(buffer, s);
+}
+
+bool ReadString(std::istream &istr, std::string &s)
+{
+    return ReadStringValue(istr, s);
+}
+
+bool ReadString(CBotBufferReader &buffer, std::string &s)
+{
+    return ReadStringValue(buffer, s);
+}
+
+bool WriteIntArray(CBotBufferWriter &buffer, const std::vector<int> &values)
+{
+    return WriteArrayValues<int, uint32_t>(buffer, values);
+}
+
+bool ReadIntArray(CBotBufferReader &buffer, std::vector<int> &values)
+{
+    return ReadArrayValues<int, uint32_t>(buffer, values);
+}
+
+bool WriteLongArray(CBotBufferWriter &buffer, const std::vector<int64_t> &values)
+{
+    return WriteArrayValues<int64_t, uint64_t>(buffer, values);
+}
+
+bool ReadLongArray(CBotBufferReader &buffer, std::vector<int64_t> &values)
+{
+    return ReadArrayValues<int64_t, uint64_t>(buffer, values);
+}
+
+bool WriteFloatArray(CBotBufferWriter &buffer, const std::vector<float> &values)
+{
+    return WriteArrayValues<float, uint32_t>(buffer, values);
+}
+
+bool ReadFloatArray(CBotBufferReader &buffer, std::vector<float> &values)
+{
+    return ReadArrayValues<float, uint32_t>(buffer, values);
+}
+
+bool WriteDoubleArray(CBotBufferWriter &buffer, const std::vector<double> &values)
+{
+    return WriteArrayValues<double, uint64_t>(buffer, values);
+}
+
+bool ReadDoubleArray(CBotBufferReader &buffer, std::vector<double> &values)
+{
+    return ReadArrayValues<double, uint64_t>(buffer, values);
+}
+
+bool WriteType(std::ostream &ostr, const CBotTypResult &type)
+{
+    return WriteTypeValue(ostr, type);
+}
+
+bool WriteType(CBotBufferWriter &buffer, const CBotTypResult &type)
+{
+    return WriteTypeValue(buffer, type);
+}
+
+bool ReadType(std::istream &istr, CBotTypResult &type)
+{
+    return ReadTypeValue(istr, type);
+}
+
+bool ReadType(CBotBufferReader &buffer, CBotTypResult &type)
+{
+    return ReadTypeValue(buffer, type);
+}
+
 bool WriteStream(std::ostream &ostr, std::istream& istr)
 {
     if (!istr.seekg(0, istr.end)) return false;
@@ -353,10 +632,11 @@ bool ReadStream(std::istream& istr, std::ostream &ostr)
     if (!ReadLong(istr, length)) return false;
     if (length == 0) return true;
 
-    while (length-- > 0)
-    {
-        if (!(ostr << istr.get())) return false;
-    }
+    if (length < 0) return false;
+
+    std::vector<char> data(length);
+    if (!istr.read(data.data(), length)) return false;
+    if (!ostr.write(data.data(), length)) return false;
     return true;
 }
 
@@ -19,8 +19,12 @@
 
 #pragma once
 
+#include "CBot/CBotBuffer.h"
+
+#include <cstdint>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace CBot
 {
@@ -30,11 +34,11 @@ class CBotTypResult;
 
 /*!
  * \brief Save a linked list if variables
- * \param ostr Output stream
+ * \param buffer Output buffer
  * \param pVar First variable in the list
  * \return true on success
  */
-bool SaveVars(std::ostream &ostr, CBotVar* pVar);
+bool SaveVars(CBotBufferWriter &buffer, CBotVar* pVar);
 
 /*!
  * \brief WriteWord
@@ -44,6 +48,14 @@ bool SaveVars(std::ostream &ostr, CBotVar* pVar);
  */
 bool WriteWord(std::ostream &ostr, unsigned short w);
 
+/*!
+ * \brief WriteWord
+ * \param buffer Output buffer
+ * \param w
+ * \return true on success
+ */
+bool WriteWord(CBotBufferWriter &buffer, unsigned short w);
+
 /*!
  * \brief ReadWord
  * \param istr Input stream
@@ -52,6 +64,14 @@ bool WriteWord(std::ostream &ostr, unsigned short w);
  */
 bool ReadWord(std::istream &istr, unsigned short &w);
 
+/*!
+ * \brief ReadWord
+ * \param buffer Input buffer
+ * \param[out] w
+ * \return true on success
+ */
+bool ReadWord(CBotBufferReader &buffer, unsigned short &w);
+
 /*!
  * \brief WriteByte
  * \param ostr Output stream
@@ -60,6 +80,14 @@ bool ReadWord(std::istream &istr, unsigned short &w);
  */
 bool WriteByte(std::ostream &ostr, char c);
 
+/*!
+ * \brief WriteByte
+ * \param buffer Output buffer
+ * \param c
+ * \return true on success
+ */
+bool WriteByte(CBotBufferWriter &buffer, char c);
+
 /*!
  * \brief ReadByte
  * \param istr Input stream
@@ -68,6 +96,14 @@ bool WriteByte(std::ostream &ostr, char c);
  */
 bool ReadByte(std::istream &istr, char& c);
 
+/*!
+ * \brief ReadByte
+ * \param buffer Input buffer
+ * \param[out] c
+ * \return true on success
+ */
+bool ReadByte(CBotBufferReader &buffer, char& c);
+
 /*!
  * \brief WriteShort
  * \param ostr Output stream
@@ -76,6 +112,14 @@ bool ReadByte(std::istream &istr, char& c);
  */
 bool WriteShort(std::ostream &ostr, short s);
 
+/*!
+ * \brief WriteShort
+ * \param buffer Output buffer
+ * \param s
+ * \return true on success
+ */
+bool WriteShort(CBotBufferWriter &buffer, short s);
+
 /*!
  * \brief ReadShort
  * \param istr Input stream
@@ -84,6 +128,14 @@ bool WriteShort(std::ostream &ostr, short s);
  */
 bool ReadShort(std::istream &istr, short &s);
 
+/*!
+ * \brief ReadShort
+ * \param buffer Input buffer
+ * \param[out] s
+ * \return true on success
+ */
+bool ReadShort(CBotBufferReader &buffer, short &s);
+
 /*!
  * \brief WriteUInt32
  * \param ostr Output stream
@@ -92,6 +144,14 @@ bool ReadShort(std::istream &istr, short &s);
  */
 bool WriteUInt32(std::ostream &ostr, uint32_t i);
 
+/*!
+ * \brief WriteUInt32
+ * \param buffer Output buffer
+ * \param i
+ * \return true on success
+ */
+bool WriteUInt32(CBotBufferWriter &buffer, uint32_t i);
+
 /*!
  * \brief ReadUInt32
  * \param istr Input stream
@@ -100,6 +160,14 @@ bool WriteUInt32(std::ostream &ostr, uint32_t i);
  */
 bool ReadUInt32(std::istream &istr, uint32_t &i);
 
+/*!
+ * \brief ReadUInt32
+ * \param buffer Input buffer
+ * \param[out] i
+ * \return true on success
+ */
+bool ReadUInt32(CBotBufferReader &buffer, uint32_t &i);
+
 /*!
  * \brief WriteInt
  * \param ostr Output stream
@@ -108,6 +176,14 @@ bool ReadUInt32(std::istream &istr, uint32_t &i);
  */
 bool WriteInt(std::ostream &ostr, int i);
 
+/*!
+ * \brief WriteInt
+ * \param buffer Output buffer
+ * \param i
+ * \return true on success
+ */
+bool WriteInt(CBotBufferWriter &buffer, int i);
+
 /*!
  * \brief ReadInt
  * \param istr Input stream
@@ -116,6 +192,14 @@ bool WriteInt(std::ostream &ostr, int i);
  */
 bool ReadInt(std::istream &istr, int &i);
 
+/*!
+ * \brief ReadInt
+ * \param buffer Input buffer
+ * \param[out] i
+ * \return true on success
+ */
+bool ReadInt(CBotBufferReader &buffer, int &i);
+
 /*!
  * \brief WriteLong
  * \param ostr Output stream
@@ -125,6 +209,15 @@ bool ReadInt(std::istream &istr, int &i);
  */
 bool WriteLong(std::ostream &ostr, long l, unsigned padTo = 0);
 
+/*!
+ * \brief WriteLong
+ * \param buffer Output buffer
+ * \param l
+ * \param padTo minimum number of bytes to write
+ * \return true on success
+ */
+bool WriteLong(CBotBufferWriter &buffer, long l, unsigned padTo = 0);
+
 /*!
  * \brief ReadLong
  * \param istr Input stream
@@ -133,6 +226,14 @@ bool WriteLong(std::ostream &ostr, long l, unsigned padTo = 0);
  */
 bool ReadLong(std::istream &istr, long &l);
 
+/*!
+ * \brief ReadLong
+ * \param buffer Input buffer
+ * \param[out] l
+ * \return true on success
+ */
+bool ReadLong(CBotBufferReader &buffer, long &l);
+
 /*!
  * \brief WriteFloat
  * \param ostr Output stream
@@ -141,6 +242,14 @@ bool ReadLong(std::istream &istr, long &l);
  */
 bool WriteFloat(std::ostream &ostr, float f);
 
+/*!
+ * \brief WriteFloat
+ * \param buffer Output buffer
+ * \param f
+ * \return true on success
+ */
+bool WriteFloat(CBotBufferWriter &buffer, float f);
+
 /*!
  * \brief ReadFloat
  * \param istr Input stream
@@ -149,6 +258,14 @@ bool WriteFloat(std::ostream &ostr, float f);
  */
 bool ReadFloat(std::istream &istr, float &f);
 
+/*!
+ * \brief ReadFloat
+ * \param buffer Input buffer
+ * \param[out] f
+ * \return true on success
+ */
+bool ReadFloat(CBotBufferReader &buffer, float &f);
+
 /*!
  * \brief WriteDouble
  * \param ostr Output stream
@@ -157,6 +274,14 @@ bool ReadFloat(std::istream &istr, float &f);
  */
 bool WriteDouble(std::ostream &ostr, double d);
 
+/*!
+ * \brief WriteDouble
+ * \param buffer Output buffer
+ * \param d
+ * \return true on success
+ */
+bool WriteDouble(CBotBufferWriter &buffer, double d);
+
 /*!
  * \brief ReadDouble
  * \param istr Input stream
@@ -165,6 +290,14 @@ bool WriteDouble(std::ostream &ostr, double d);
  */
 bool ReadDouble(std::istream &istr, double &d);
 
+/*!
+ * \brief ReadDouble
+ * \param buffer Input buffer
+ * \param[out] d
+ * \return true on success
+ */
+bool ReadDouble(CBotBufferReader &buffer, double &d);
+
 /*!
  * \brief WriteString
  * \param ostr Output stream
@@ -173,6 +306,14 @@ bool ReadDouble(std::istream &istr, double &d);
  */
 bool WriteString(std::ostream &ostr, const std::string &s);
 
+/*!
+ * \brief WriteString
+ * \param buffer Output buffer
+ * \param s
+ * \return true on success
+ */
+bool WriteString(CBotBufferWriter &buffer, const std::string &s);
+
 /*!
  * \brief ReadString
  * \param istr Input stream
@@ -181,6 +322,78 @@ bool WriteString(std::ostream &ostr, const std::string &s);
  */
 bool ReadString(std::istream &istr, std::string &s);
 
+/*!
+ * \brief ReadString
+ * \param buffer Input buffer
+ * \param[out] s
+ * \return true on success
+ */
+bool ReadString(CBotBufferReader &buffer, std::string &s);
+
+/*!
+ * \brief Write an array of integers as a single block
+ * \param buffer Output buffer
+ * \param values Values to write
+ * \return true on success
+ */
+bool WriteIntArray(CBotBufferWriter &buffer, const std::vector<int> &values);
+
+/*!
+ * \brief Read an array of integers written with WriteIntArray()
+ * \param buffer Input buffer
+ * \param[out] values Values read
+ * \return true on success
+ */
+bool ReadIntArray(CBotBufferReader &buffer, std::vector<int> &values);
+
+/*!
+ * \brief Write an array of 64-bit integers as a single block
+ * \param buffer Output buffer
+ * \param values Values to write
+ * \return true on success
+ */
+bool WriteLongArray(CBotBufferWriter &buffer, const std::vector<int64_t> &values);
+
+/*!
+ * \brief Read an array of 64-bit integers written with WriteLongArray()
+ * \param buffer Input buffer
+ * \param[out] values Values read
+ * \return true on success
+ */
+bool ReadLongArray(CBotBufferReader &buffer, std::vector<int64_t> &values);
+
+/*!
+ * \brief Write an array of floats as a single block
+ * \param buffer Output buffer
+ * \param values Values to write
+ * \return true on success
+ */
+bool WriteFloatArray(CBotBufferWriter &buffer, const std::vector<float> &values);
+
+/*!
+ * \brief Read an array of floats written with WriteFloatArray()
+ * \param buffer Input buffer
+ * \param[out] values Values read
+ * \return true on success
+ */
+bool ReadFloatArray(CBotBufferReader &buffer, std::vector<float> &values);
+
+/*!
+ * \brief Write an array of doubles as a single block
+ * \param buffer Output buffer
+ * \param values Values to write
+ * \return true on success
+ */
+bool WriteDoubleArray(CBotBufferWriter &buffer, const std::vector<double> &values);
+
+/*!
+ * \brief Read an array of doubles written with WriteDoubleArray()
+ * \param buffer Input buffer
+ * \param[out] values Values read
+ * \return true on success
+ */
+bool ReadDoubleArray(CBotBufferReader &buffer, std::vector<double> &values);
+
 /*!
  * \brief WriteType
  * \param ostr Output stream
@@ -189,6 +402,14 @@ bool ReadString(std::istream &istr, std::string &s);
  */
 bool WriteType(std::ostream &ostr, const CBotTypResult &type);
 
+/*!
+ * \brief WriteType
+ * \param buffer Output buffer
+ * \param type
+ * \return true on success
+ */
+bool WriteType(CBotBufferWriter &buffer, const CBotTypResult &type);
+
 /*!
  * \brief ReadType
  * \param istr Input stream
@@ -197,6 +418,14 @@ bool WriteType(std::ostream &ostr, const CBotTypResult &type);
  */
 bool ReadType(std::istream &istr, CBotTypResult &type);
 
+/*!
+ * \brief ReadType
+ * \param buffer Input buffer
+ * \param[out] type
+ * \return true on success
+ */
+bool ReadType(CBotBufferReader &buffer, CBotTypResult &type);
+
 /*!
  * \brief WriteStream
  * \param ostr Output stream
@@ -286,7 +286,9 @@ bool CBotExprVar::ExecuteVar(CBotVar* &pVar, CBotStack* &pj, CBotToken* prevToke
 
     if (bStep && m_nIdent>0 && pj->IfStep()) return false;
 
-    pVar = pj->FindVar(m_nIdent, true);     // tries with the variable update if necessary
+    // tries with the variable update if necessary, a field access updates only its field
+    bool bUpdate = m_next3 == nullptr || !m_next3->IsFieldAccess();
+    pVar = pj->FindVar(m_nIdent, bUpdate);
     if (pVar == nullptr)
     {
         assert(false);
@@ -104,9 +104,15 @@ bool CBotFieldExpr::ExecuteVar(CBotVar* &pVar, CBotStack* &pile, CBotToken* prev
         CBotClass* pClass = pItem->GetClass();
         pVar = pClass->GetItem(m_token.GetString());
     }
+    else
+    {
+        // request the update of this field only, the instance was not updated as a whole
+        pItem->UpdateField(pVar, pile->GetUserPtr());
+    }
 
     // request the update of the element, if applicable
-    pVar->Update(pile->GetUserPtr());
+    if (m_next3 == nullptr || !m_next3->IsFieldAccess())
+        pVar->Update(pile->GetUserPtr());
 
     if ( m_next3 != nullptr &&
          !m_next3->ExecuteVar(pVar, pile, &m_token, bStep, bExtend) ) return false;
@@ -127,6 +133,12 @@ void CBotFieldExpr::RestoreStateVar(CBotStack* &pj, bool bMain)
          m_next3->RestoreStateVar(pj, bMain);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotFieldExpr::IsFieldAccess()
+{
+    return true;
+}
+
 std::string CBotFieldExpr::GetDebugData()
 {
     std::stringstream ss;
@@ -65,6 +65,8 @@ public:
      */
     void RestoreStateVar(CBotStack* &pj, bool bMain) override;
 
+    bool IsFieldAccess() override;
+
     /*!
      * \brief Check if access to a variable is allowed or not depending on public/private/protected setting
      *
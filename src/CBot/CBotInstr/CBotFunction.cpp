@@ -56,6 +56,7 @@ CBotFunction::CBotFunction()
 
 ////////////////////////////////////////////////////////////////////////////////
 std::set<CBotFunction*> CBotFunction::m_publicFunctions{};
+int CBotFunction::m_publicVersion = 0;
 
 ////////////////////////////////////////////////////////////////////////////////
 CBotFunction::~CBotFunction()
@@ -67,6 +68,7 @@ CBotFunction::~CBotFunction()
     if (m_bPublic)
     {
         m_publicFunctions.erase(this);
+        ++m_publicVersion;
     }
 }
 
@@ -398,7 +400,7 @@ bool CBotFunction::Execute(CBotVar** ppVars, CBotStack* &pj, CBotVar* pInstance)
     CBotStack*  pile = pj->AddStack(this, CBotStack::BlockVisibilityType::FUNCTION);               // one end of stack local to this function
 //  if ( pile == EOX ) return true;
 
-    pile->SetProgram(m_pProg);                              // bases for routines
+    if (m_pProg != nullptr) pile->SetProgram(m_pProg);      // bases for routines
 
     if ( pile->IfStep() ) return false;
 
@@ -463,7 +465,7 @@ void CBotFunction::RestoreState(CBotVar** ppVars, CBotStack* &pj, CBotVar* pInst
     if ( pile == nullptr ) return;
     CBotStack*  pile2 = pile;
 
-    pile->SetProgram(m_pProg);                          // bases for routines
+    if (m_pProg != nullptr) pile->SetProgram(m_pProg);  // bases for routines
 
     if ( pile->GetBlock() != CBotStack::BlockVisibilityType::FUNCTION)
     {
@@ -759,7 +761,7 @@ int CBotFunction::DoCall(CBotProgram* program, const std::list<CBotFunction*>& l
         CBotStack*  pStk1 = pStack->AddStack(pt, CBotStack::BlockVisibilityType::FUNCTION);    // to put "this"
 //      if ( pStk1 == EOX ) return true;
 
-        pStk1->SetProgram(pt->m_pProg);                 // it may have changed module
+        if (pt->m_pProg != nullptr) pStk1->SetProgram(pt->m_pProg); // it may have changed module
 
         if ( pStk1->IfStep() ) return false;
 
@@ -805,7 +807,7 @@ int CBotFunction::DoCall(CBotProgram* program, const std::list<CBotFunction*>& l
             {
                 if (!pt->m_param->Execute(ppVars, pStk3)) // interupt here
                 {
-                    if (!pStk3->IsOk() && pt->m_pProg != program)
+                    if (!pStk3->IsOk() && pt->m_pProg != nullptr && pt->m_pProg != program)
                     {
                         pStk3->SetPosError(pToken);       // indicates the error on the procedure call
                     }
@@ -821,7 +823,7 @@ int CBotFunction::DoCall(CBotProgram* program, const std::list<CBotFunction*>& l
         if ( !pStk3->GetRetVar(                     // puts the result on the stack
             pt->m_block->Execute(pStk3) ))          // GetRetVar said if it is interrupted
         {
-            if ( !pStk3->IsOk() && pt->m_pProg != program )
+            if ( !pStk3->IsOk() && pt->m_pProg != nullptr && pt->m_pProg != program )
             {
                 pStk3->SetPosError(pToken);         // indicates the error on the procedure call
             }
@@ -850,7 +852,7 @@ void CBotFunction::RestoreCall(const std::list<CBotFunction*>& localFunctionList
         pStk1 = pStack->RestoreStack(pt);
         if ( pStk1 == nullptr ) return;
 
-        pStk1->SetProgram(pt->m_pProg);                 // it may have changed module
+        if (pt->m_pProg != nullptr) pStk1->SetProgram(pt->m_pProg); // it may have changed module
 
         if ( pStk1->GetBlock() != CBotStack::BlockVisibilityType::FUNCTION)
         {
@@ -1215,6 +1217,12 @@ const std::string& CBotFunction::GetClassName() const
 void CBotFunction::AddPublic(CBotFunction* func)
 {
     m_publicFunctions.insert(func);
+    ++m_publicVersion;
+}
+
+int CBotFunction::GetPublicVersion()
+{
+    return m_publicVersion;
 }
 
 bool CBotFunction::HasReturn()
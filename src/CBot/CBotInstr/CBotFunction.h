@@ -259,6 +259,13 @@ public:
      */
     static void AddPublic(CBotFunction* pfunc);
 
+    /*!
+     * \brief Returns a number which changes every time a public function is added or removed
+     *
+     * Compiled code depends on the public functions, see CBotProgram::CompileShared()
+     */
+    static int GetPublicVersion();
+
     /*!
      * \brief GetName
      * \return
@@ -350,6 +357,7 @@ private:
     std::string m_MasterClass;
     //! Token of the class we are part of
     CBotToken m_classToken;
+    //! Program this function belongs to, nullptr if shared between programs (see CBotProgram::CompileShared())
     CBotProgram* m_pProg;
     //! For the position of the word "extern".
     CBotToken m_extern;
@@ -360,6 +368,8 @@ private:
 
     //! List of public functions
     static std::set<CBotFunction*> m_publicFunctions;
+    //! See GetPublicVersion()
+    static int m_publicVersion;
 
     friend class CBotProgram;
     friend class CBotClass;
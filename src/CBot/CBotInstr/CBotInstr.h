@@ -276,6 +276,14 @@ public:
      */
     virtual bool HasReturn();
 
+    /**
+     * \brief Check if this instruction reads a field of a class instance.
+     * Field access updates only the field it reads, so the instructions preceding it
+     * don't need to update the whole instance, see CBotClass::SetFieldUpdateFunc().
+     * \return true if this is a field access
+     */
+    virtual bool IsFieldAccess();
+
 protected:
     friend class CBotDebug;
     /**
@@ -30,12 +30,42 @@
 #include "CBot/stdlib/stdlib.h"
 
 #include <algorithm>
+#include <functional>
 
 namespace CBot
 {
 
 std::unique_ptr<CBotExternalCallList> CBotProgram::m_externalCalls;
 
+/**
+ * \brief Compiled code shared between programs, see CBotProgram::CompileShared()
+ */
+struct CBotProgram::SharedCode
+{
+    //! Source code the functions were compiled from
+    std::string source;
+    //! Compile context given to CompileShared()
+    long context = 0;
+    //! Version of the external function table at compile time
+    int externalCallsVersion = 0;
+    //! Versions of the classes and public functions of all programs at compile time
+    int publicClassesVersion = 0;
+    int publicFunctionsVersion = 0;
+    //! The compiled functions, owned by this object
+    std::list<CBotFunction*> functions{};
+    //! Names of the functions declared as extern
+    std::vector<std::string> externFunctions{};
+
+    ~SharedCode()
+    {
+        for (CBotFunction* f : functions) delete f;
+    }
+};
+
+std::unordered_multimap<std::size_t, std::weak_ptr<CBotProgram::SharedCode>> CBotProgram::m_sharedCodeCache;
+int CBotProgram::m_sharedCodeHits = 0;
+int CBotProgram::m_sharedCodeMisses = 0;
+
 CBotProgram::CBotProgram()
 {
 }
@@ -54,7 +84,16 @@ CBotProgram::~CBotProgram()
 
     CBotClass::FreeLock(this);
 
-    for (CBotFunction* f : m_functions) delete f;
+    FreeFunctions();
+}
+
+void CBotProgram::FreeFunctions()
+{
+    if (m_sharedCode == nullptr)
+    {
+        for (CBotFunction* f : m_functions) delete f;
+    }
+    m_sharedCode.reset();
     m_functions.clear();
 }
 
@@ -68,8 +107,7 @@ bool CBotProgram::Compile(const std::string& program, std::vector<std::string>&
                          // but without destroying the object
 
     m_classes.clear();
-    for (CBotFunction* f : m_functions) delete f;
-    m_functions.clear();
+    FreeFunctions();
 
     externFunctions.clear();
     m_error = CBotNoErr;
@@ -79,7 +117,7 @@ bool CBotProgram::Compile(const std::string& program, std::vector<std::string>&
     if (tokens == nullptr) return false;
 
     auto pStack = std::unique_ptr<CBotCStack>(new CBotCStack(nullptr));
-    CBotToken* p = tokens.get()->GetNext();                 // skips the first token (separator)
+    CBotToken* p = tokens->GetFirst()->GetNext();           // skips the first token (separator)
 
     pStack->SetProgram(this);                               // defined used routines
     m_externalCalls->SetUserPtr(pUser);
@@ -117,7 +155,7 @@ bool CBotProgram::Compile(const std::string& program, std::vector<std::string>&
 
     // Step 3. Real compilation
     std::list<CBotFunction*>::iterator next = m_functions.begin();
-    p  = tokens.get()->GetNext();                             // returns to the beginning
+    p  = tokens->GetFirst()->GetNext();                       // returns to the beginning
     while ( pStack->IsOk() && p != nullptr && p->GetType() != 0 )
     {
         if ( IsOfType(p, ID_SEP) ) continue;                // semicolons lurking
@@ -147,6 +185,95 @@ bool CBotProgram::Compile(const std::string& program, std::vector<std::string>&
     return !m_functions.empty();
 }
 
+bool CBotProgram::CompileShared(const std::string& program, std::vector<std::string>& externFunctions, void* pUser, long context)
+{
+    const int externalCallsVersion = m_externalCalls->GetVersion();
+    const std::size_t hash = std::hash<std::string>()(program);
+
+    // keep our own code alive while releasing it, so that recompiling the same program reuses it
+    std::shared_ptr<SharedCode> previousCode = m_sharedCode;
+    Stop();
+    for (CBotClass* c : m_classes)
+        c->Purge();
+    m_classes.clear();
+    FreeFunctions();
+
+    // the code may use classes and public functions of other programs, which must not have changed since
+    const int publicClassesVersion = CBotClass::GetPublicVersion();
+    const int publicFunctionsVersion = CBotFunction::GetPublicVersion();
+
+    std::shared_ptr<SharedCode> code;
+    auto range = m_sharedCodeCache.equal_range(hash);
+    for (auto it = range.first; it != range.second; )
+    {
+        std::shared_ptr<SharedCode> candidate = it->second.lock();
+        if (candidate == nullptr)
+        {
+            it = m_sharedCodeCache.erase(it);
+            continue;
+        }
+        if (candidate->context == context &&
+            candidate->externalCallsVersion == externalCallsVersion &&
+            candidate->publicClassesVersion == publicClassesVersion &&
+            candidate->publicFunctionsVersion == publicFunctionsVersion &&
+            candidate->source == program)
+        {
+            code = candidate;
+            break;
+        }
+        ++it;
+    }
+
+    if (code != nullptr)
+    {
+        m_sharedCodeHits++;
+
+        m_sharedCode = code;
+        m_functions = code->functions;
+        externFunctions = code->externFunctions;
+        m_error = CBotNoErr;
+        return true;
+    }
+
+    m_sharedCodeMisses++;
+
+    if (!Compile(program, externFunctions, pUser)) return false;
+
+    // classes and public functions are registered globally with this program as their module
+    if (!m_classes.empty()) return true;
+    for (CBotFunction* f : m_functions)
+    {
+        if (f->IsPublic()) return true;
+    }
+
+    code = std::make_shared<SharedCode>();
+    code->source = program;
+    code->context = context;
+    code->externalCallsVersion = externalCallsVersion;
+    code->publicClassesVersion = publicClassesVersion;
+    code->publicFunctionsVersion = publicFunctionsVersion;
+    code->functions = m_functions;
+    code->externFunctions = externFunctions;
+    // the functions no longer belong to this program, calls keep the module of the caller
+    for (CBotFunction* f : m_functions) f->m_pProg = nullptr;
+
+    m_sharedCode = code;
+    m_sharedCodeCache.emplace(hash, code);
+    return true;
+}
+
+void CBotProgram::GetCacheStats(int& hits, int& misses)
+{
+    hits = m_sharedCodeHits;
+    misses = m_sharedCodeMisses;
+}
+
+void CBotProgram::ResetCacheStats()
+{
+    m_sharedCodeHits = 0;
+    m_sharedCodeMisses = 0;
+}
+
 bool CBotProgram::Start(const std::string& name)
 {
     Stop();
@@ -328,44 +455,63 @@ bool CBotProgram::SaveState(std::ostream &ostr)
 {
     if (!WriteLong(ostr, CBOTVERSION)) return false;
 
-
+    // the state is encoded in memory and written as one block
+    CBotBufferWriter buffer;
     if (m_stack != nullptr )
     {
-        if (!WriteWord(ostr, 1)) return false;
-        if (!WriteString(ostr, m_entryPoint->GetName())) return false;
-        if (!m_stack->SaveState(ostr)) return false;
+        if (!WriteWord(buffer, 1)) return false;
+        if (!WriteString(buffer, m_entryPoint->GetName())) return false;
+        if (!m_stack->SaveState(buffer)) return false;
     }
     else
     {
-        if (!WriteWord(ostr, 0)) return false;
+        if (!WriteWord(buffer, 0)) return false;
     }
-    return true;
+    return WriteBuffer(ostr, buffer);
 }
 
 bool CBotProgram::RestoreState(std::istream &istr)
 {
-    unsigned short  w;
-    std::string      s;
-
     Stop();
 
     long version;
     if (!ReadLong(istr, version)) return false;
-    if ( version != CBOTVERSION ) return false;
 
-    if (!ReadWord(istr, w)) return false;
+    if (version == CBOTVERSION)
+    {
+        CBotBufferReader buffer;
+        if (!ReadBuffer(istr, buffer)) return false;
+        return RestoreState(buffer);
+    }
+
+    // older versions were written directly to the stream, without the size of the state
+    if (version >= CBOTVERSION_COMPAT && version < CBOTVERSION)
+    {
+        CBotBufferReader buffer(istr);
+        return RestoreState(buffer);
+    }
+
+    return false;
+}
+
+bool CBotProgram::RestoreState(CBotBufferReader &buffer)
+{
+    unsigned short  w;
+    std::string      s;
+
+    if (!ReadWord(buffer, w)) return false;
     if ( w == 0 ) return true;
 
     // don't restore if compile error exists
     if (m_error != CBotNoErr) return false;
 
-    if (!ReadString(istr, s)) return false;
+    if (!ReadString(buffer, s)) return false;
     if (!Start(s)) return false; // point de reprise
     // Start() already created the new stack
     // and called m_stack->SetProgram(this);
 
     // retrieves the stack from the memory
-    if (!m_stack->RestoreState(istr, m_stack))
+    if (!m_stack->RestoreState(buffer, m_stack))
     {
         m_stack->Delete();
         m_stack = nullptr;
@@ -386,6 +532,11 @@ int CBotProgram::GetVersion()
     return  CBOTVERSION;
 }
 
+bool CBotProgram::IsVersionSupported(int version)
+{
+    return version >= CBOTVERSION_COMPAT && version <= CBOTVERSION;
+}
+
 void CBotProgram::Init()
 {
     m_externalCalls.reset(new CBotExternalCallList);
@@ -412,6 +563,7 @@ void CBotProgram::Init()
 
 void CBotProgram::Free()
 {
+    m_sharedCodeCache.clear();
     CBotToken::ClearDefineNum();
     m_externalCalls->Clear();
     CBotClass::ClearPublic();
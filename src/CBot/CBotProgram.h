@@ -24,6 +24,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace CBot
@@ -35,6 +36,7 @@ class CBotStack;
 class CBotTypResult;
 class CBotVar;
 class CBotExternalCallList;
+class CBotBufferReader;
 
 /**
  * \brief Class that manages a CBot program. This is the main entry point into the CBot engine.
@@ -118,6 +120,13 @@ public:
      */
     static int GetVersion();
 
+    /**
+     * \brief Check if states saved by the given version of the CBot library can be restored
+     * \param version Version number, as returned by GetVersion()
+     * \return true if the version is the current one or an older compatible one
+     */
+    static bool IsVersionSupported(int version);
+
     /**
      * \brief Compile compiles the program given as string
      *
@@ -134,6 +143,38 @@ public:
      */
     bool Compile(const std::string& program, std::vector<std::string>& externFunctions, void* pUser = nullptr);
 
+    /**
+     * \brief Compile the program, sharing the compiled code with other programs with identical source
+     *
+     * Works like Compile(), but the instruction trees are looked up in a cache keyed by the source code,
+     * the compile context and the version of the external function table (see CBotExternalCallList::GetVersion()).
+     * Programs compiled from the same source share one immutable copy of the code, only the execution state
+     * (stack, variables) is allocated separately for each program.
+     *
+     * Programs which define classes or public functions are never shared, they are compiled as with Compile().
+     *
+     * \param program Code to compile
+     * \param[out] externFunctions Returns the names of functions declared as extern
+     * \param pUser Optional pointer to be passed to compile function (see AddFunction())
+     * \param context Value describing everything the compile functions decide based on pUser,
+     *                programs are only shared if compiled with the same context
+     * \return true if compilation is successful, false if an compilation error occurs
+     * \see GetCacheStats()
+     */
+    bool CompileShared(const std::string& program, std::vector<std::string>& externFunctions, void* pUser, long context);
+
+    /**
+     * \brief Returns the statistics of the compiled code cache used by CompileShared()
+     * \param[out] hits Number of programs which reused already compiled code
+     * \param[out] misses Number of programs which had to be compiled
+     */
+    static void GetCacheStats(int& hits, int& misses);
+
+    /**
+     * \brief Resets the counters returned by GetCacheStats()
+     */
+    static void ResetCacheStats();
+
     /**
      * \brief Returns the last error
      * \return Error code
@@ -332,10 +373,32 @@ public:
     static const std::unique_ptr<CBotExternalCallList>& GetExternalCalls();
 
 private:
+    struct SharedCode;
+
+    /**
+     * \brief Delete the compiled functions, or release them if they are shared
+     */
+    void FreeFunctions();
+
+    /**
+     * \brief Restore the execution state from a buffer
+     * \param buffer Input buffer
+     * \return true on success, false on read error
+     */
+    bool RestoreState(CBotBufferReader &buffer);
+
     //! All external calls
     static std::unique_ptr<CBotExternalCallList> m_externalCalls;
+    //! Compiled code of all live shared programs, by hash of the source code
+    static std::unordered_multimap<std::size_t, std::weak_ptr<SharedCode>> m_sharedCodeCache;
+    //! Number of CompileShared() calls which reused compiled code
+    static int m_sharedCodeHits;
+    //! Number of CompileShared() calls which had to compile the program
+    static int m_sharedCodeMisses;
     //! All user-defined functions
     std::list<CBotFunction*> m_functions{};
+    //! Owner of m_functions if they are shared with other programs, see CompileShared()
+    std::shared_ptr<SharedCode> m_sharedCode;
     //! The entry point function
     CBotFunction* m_entryPoint = nullptr;
     //! Classes defined in this program
@@ -25,6 +25,7 @@
 
 #include "CBot/CBotVar/CBotVarPointer.h"
 #include "CBot/CBotVar/CBotVarClass.h"
+#include "CBot/CBotVar/CBotVarInt.h"
 
 #include "CBot/CBotUtils.h"
 #include "CBot/CBotExternalCall.h"
@@ -32,6 +33,7 @@
 #include <cassert>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
 
 namespace CBot
@@ -709,104 +711,233 @@ CBotVar* CBotStack::GetStackVars(std::string& functionName, int level)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-bool CBotStack::SaveState(std::ostream &ostr)
+bool CBotStack::SaveState(CBotBufferWriter &buffer)
 {
     if (m_next2 != nullptr)
     {
-        if (!WriteWord(ostr, 2)) return false; // a marker of type (m_next2)
-        if (!m_next2->SaveState(ostr)) return false; // saves the next element
+        if (!WriteWord(buffer, 2)) return false; // a marker of type (m_next2)
+        if (!m_next2->SaveState(buffer)) return false; // saves the next element
     }
     else
     {
-        if (!WriteWord(ostr, 1)) return false; // a marker of type (m_next)
+        if (!WriteWord(buffer, 1)) return false; // a marker of type (m_next)
     }
-    if (!WriteWord(ostr, static_cast<unsigned short>(m_block))) return false;
-    if (!WriteInt(ostr, m_state)) return false;
-    if (!WriteWord(ostr, 0)) return false; // for backwards combatibility (m_bDontDelete)
-    if (!WriteInt(ostr, m_step)) return false;
+    if (!WriteWord(buffer, static_cast<unsigned short>(m_block))) return false;
+    if (!WriteInt(buffer, m_state)) return false;
+    if (!WriteWord(buffer, 0)) return false; // for backwards combatibility (m_bDontDelete)
+    if (!WriteInt(buffer, m_step)) return false;
 
-    if (!SaveVars(ostr, m_var)) return false;          // current result
-    if (!SaveVars(ostr, m_listVar)) return false;      // local variables
+    if (!SaveVars(buffer, m_var)) return false;          // current result
+    if (!SaveVars(buffer, m_listVar)) return false;      // local variables
 
     if (m_next != nullptr)
     {
-        if (!m_next->SaveState(ostr)) return false; // saves the next element
+        if (!m_next->SaveState(buffer)) return false; // saves the next element
     }
     else
     {
-        if (!WriteWord(ostr, 0)) return false; // 0 - CBotStack::SaveState terminator
+        if (!WriteWord(buffer, 0)) return false; // 0 - CBotStack::SaveState terminator
     }
     return true;
 }
 
-bool SaveVars(std::ostream &ostr, CBotVar* pVar)
+bool SaveVars(CBotBufferWriter &buffer, CBotVar* pVar)
 {
     while (pVar != nullptr)
     {
-        if (!pVar->Save0State(ostr)) return false; // common header
-        if (!pVar->Save1State(ostr)) return false; // saves the data
+        if (!pVar->Save0State(buffer)) return false; // common header
+        if (!pVar->Save1State(buffer)) return false; // saves the data
 
         pVar = pVar->GetNext();
     }
-    return WriteWord(ostr, 0); // 0 - CBot::SaveVars terminator
+    return WriteWord(buffer, 0); // 0 - CBot::SaveVars terminator
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-bool CBotStack::RestoreState(std::istream &istr, CBotStack* &pStack)
+bool CBotStack::RestoreState(CBotBufferReader &buffer, CBotStack* &pStack)
 {
     unsigned short w;
 
     if (pStack != this) pStack = nullptr;
-    if (!ReadWord(istr, w)) return false;
+    if (!ReadWord(buffer, w)) return false;
     if ( w == 0 ) return true; // 0 - CBotStack::SaveState terminator
 
     if (pStack == nullptr) pStack = AddStack();
 
     if ( w == 2 ) // 2 - m_next2
     {
-        if (!pStack->RestoreState(istr, pStack->m_next2)) return false;
+        if (!pStack->RestoreState(buffer, pStack->m_next2)) return false;
     }
 
-    if (!ReadWord(istr, w)) return false;
+    if (!ReadWord(buffer, w)) return false;
     pStack->m_block = static_cast<BlockVisibilityType>(w);
 
     int state;
-    if (!ReadInt(istr, state)) return false;
+    if (!ReadInt(buffer, state)) return false;
     pStack->SetState(state);
 
-    if (!ReadWord(istr, w)) return false; // backwards compatibility (m_bDontDelete)
+    if (!ReadWord(buffer, w)) return false; // backwards compatibility (m_bDontDelete)
 
-    if (!ReadInt(istr, state)) return false;
+    if (!ReadInt(buffer, state)) return false;
     pStack->m_step = state;
 
-    if (!CBotVar::RestoreState(istr, pStack->m_var)) return false;     // temp variable
-    if (!CBotVar::RestoreState(istr, pStack->m_listVar)) return false; // local variables
+    if (!CBotVar::RestoreState(buffer, pStack->m_var)) return false;     // temp variable
+    if (!CBotVar::RestoreState(buffer, pStack->m_listVar)) return false; // local variables
 
-    return pStack->RestoreState(istr, pStack->m_next);
+    return pStack->RestoreState(buffer, pStack->m_next);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-bool CBotVar::Save0State(std::ostream &ostr)
+bool CBotVar::Save0State(CBotBufferWriter &buffer)
 {
-    if (!WriteWord(ostr, 100+static_cast<int>(m_mPrivate)))return false; // private variable?
-    if (!WriteWord(ostr, m_bStatic))return false;            // static variable?
-    if (!WriteWord(ostr, m_type.GetType()))return false;     // saves the type (always non-zero)
+    if (!WriteWord(buffer, 100+static_cast<int>(m_mPrivate)))return false; // private variable?
+    if (!WriteWord(buffer, m_bStatic))return false;            // static variable?
+    if (!WriteWord(buffer, m_type.GetType()))return false;     // saves the type (always non-zero)
 
     if (m_type.Eq(CBotTypPointer) && GetPointer() != nullptr)
     {
         if (GetPointer()->m_bConstructor)                    // constructor was called?
         {
-            if (!WriteWord(ostr, (2000 + static_cast<unsigned short>(m_binit)) )) return false;
-            return WriteString(ostr, m_token->GetString());  // and variable name
+            if (!WriteWord(buffer, (2000 + static_cast<unsigned short>(m_binit)) )) return false;
+            return WriteString(buffer, m_token->GetString());  // and variable name
         }
     }
 
-    if (!WriteWord(ostr, static_cast<unsigned short>(m_binit))) return false;        // variable defined?
-    return WriteString(ostr, m_token->GetString());          // and variable name
+    if (!WriteWord(buffer, static_cast<unsigned short>(m_binit))) return false;        // variable defined?
+    return WriteString(buffer, m_token->GetString());          // and variable name
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-bool CBotVar::RestoreState(std::istream &istr, CBotVar* &pVar)
+bool CBotVar::SaveArrayItems(CBotBufferWriter &buffer, CBotVar* pVar)
+{
+    while (pVar != nullptr)
+    {
+        int type = pVar->m_type.GetType();
+
+        // elements which can be restored from their value alone
+        auto isPlain = [type](CBotVar* p)
+        {
+            if (p->m_type.GetType() != type) return false;
+            if (p->m_binit != InitType::DEF || p->m_bStatic) return false;
+            if (p->m_mPrivate != ProtectionLevel::Public) return false;
+            if (!p->m_token->GetString().empty()) return false;
+            if (type == CBotTypInt && !static_cast<CBotVarInt*>(p)->m_defnum.empty()) return false;
+            return true;
+        };
+
+        CBotVar* pEnd = pVar;
+        if (type == CBotTypInt || type == CBotTypLong || type == CBotTypFloat || type == CBotTypDouble)
+        {
+            while (pEnd != nullptr && isPlain(pEnd)) pEnd = pEnd->m_next;
+        }
+
+        if (pEnd == pVar)
+        {
+            if (!pVar->Save0State(buffer)) return false; // common header
+            if (!pVar->Save1State(buffer)) return false; // saves the data
+            pVar = pVar->m_next;
+            continue;
+        }
+
+        if (!WriteWord(buffer, 300)) return false; // 300 - block of plain values
+        if (!WriteWord(buffer, type)) return false;
+
+        bool ok = false;
+        switch (type)
+        {
+        case CBotTypInt:
+            {
+                std::vector<int> values;
+                for (CBotVar* p = pVar; p != pEnd; p = p->m_next) values.push_back(p->GetValInt());
+                ok = WriteIntArray(buffer, values);
+                break;
+            }
+        case CBotTypLong:
+            {
+                std::vector<int64_t> values;
+                for (CBotVar* p = pVar; p != pEnd; p = p->m_next) values.push_back(p->GetValLong());
+                ok = WriteLongArray(buffer, values);
+                break;
+            }
+        case CBotTypFloat:
+            {
+                std::vector<float> values;
+                for (CBotVar* p = pVar; p != pEnd; p = p->m_next) values.push_back(p->GetValFloat());
+                ok = WriteFloatArray(buffer, values);
+                break;
+            }
+        case CBotTypDouble:
+            {
+                std::vector<double> values;
+                for (CBotVar* p = pVar; p != pEnd; p = p->m_next) values.push_back(p->GetValDouble());
+                ok = WriteDoubleArray(buffer, values);
+                break;
+            }
+        }
+        if (!ok) return false;
+
+        pVar = pEnd;
+    }
+    return WriteWord(buffer, 0); // 0 - CBot::SaveVars terminator
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static bool RestoreArrayItems(CBotBufferReader &buffer, unsigned short type, std::vector<CBotVar*> &items)
+{
+    CBotToken token("", std::string());
+
+    switch (type)
+    {
+    case CBotTypInt:
+        {
+            std::vector<int> values;
+            if (!ReadIntArray(buffer, values)) return false;
+            for (int value : values)
+            {
+                items.push_back(CBotVar::Create(token, type));
+                items.back()->SetValInt(value);
+            }
+            return true;
+        }
+    case CBotTypLong:
+        {
+            std::vector<int64_t> values;
+            if (!ReadLongArray(buffer, values)) return false;
+            for (int64_t value : values)
+            {
+                items.push_back(CBotVar::Create(token, type));
+                items.back()->SetValLong(value);
+            }
+            return true;
+        }
+    case CBotTypFloat:
+        {
+            std::vector<float> values;
+            if (!ReadFloatArray(buffer, values)) return false;
+            for (float value : values)
+            {
+                items.push_back(CBotVar::Create(token, type));
+                items.back()->SetValFloat(value);
+            }
+            return true;
+        }
+    case CBotTypDouble:
+        {
+            std::vector<double> values;
+            if (!ReadDoubleArray(buffer, values)) return false;
+            for (double value : values)
+            {
+                items.push_back(CBotVar::Create(token, type));
+                items.back()->SetValDouble(value);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotVar::RestoreState(CBotBufferReader &buffer, CBotVar* &pVar)
 {
     unsigned short        w, wi, prv, st;
 
@@ -818,27 +949,42 @@ bool CBotVar::RestoreState(std::istream &istr, CBotVar* &pVar)
 
     while ( true )            // retrieves a list
     {
-        if (!ReadWord(istr, w)) return false;                      // private or type?
+        if (!ReadWord(buffer, w)) return false;                      // private or type?
         if ( w == 0 ) return true; // 0 - CBot::SaveVars terminator
 
+        if ( w == 300 ) // 300 - block of plain array values
+        {
+            if (!ReadWord(buffer, w)) return false;                  // type
+            std::vector<CBotVar*> items;
+            bool ok = RestoreArrayItems(buffer, w, items);
+            for (CBotVar* pItem : items)
+            {
+                if ( pPrev != nullptr ) pPrev->m_next = pItem;
+                if ( pVar == nullptr  ) pVar = pItem;
+                pPrev = pItem;
+            }
+            if (!ok) return false;
+            continue;
+        }
+
         std::string defnum;
         if ( w == 200 )
         {
-            if (!ReadString(istr, defnum)) return false;          // number with identifier
-            if (!ReadWord(istr, w)) return false;                 // type
+            if (!ReadString(buffer, defnum)) return false;          // number with identifier
+            if (!ReadWord(buffer, w)) return false;                 // type
         }
 
         prv = 100; st = 0;
         if ( w >= 100 )
         {
             prv = w;
-            if (!ReadWord(istr, st)) return false;              // static
-            if (!ReadWord(istr, w)) return false;               // type
+            if (!ReadWord(buffer, st)) return false;              // static
+            if (!ReadWord(buffer, w)) return false;               // type
         }
 
         if ( w == CBotTypClass ) w = CBotTypIntrinsic;            // necessarily intrinsic
 
-        if (!ReadWord(istr, wi)) return false;                  // init ?
+        if (!ReadWord(buffer, wi)) return false;                  // init ?
         bool bConstructor = false;
         if (w == CBotTypPointer && wi >= 2000)
         {
@@ -848,7 +994,7 @@ bool CBotVar::RestoreState(std::istream &istr, CBotVar* &pVar)
 
         CBotVar::InitType initType = static_cast<CBotVar::InitType>(wi);
         std::string varname;
-        if (!ReadString(istr, varname)) return false;           // variable name
+        if (!ReadString(buffer, varname)) return false;           // variable name
         CBotToken token(varname, std::string());
 
         bool isClass = false;
@@ -857,56 +1003,56 @@ bool CBotVar::RestoreState(std::istream &istr, CBotVar* &pVar)
         {
         case CBotTypBoolean:
             char valBool;
-            if (!ReadByte(istr, valBool)) return false;
+            if (!ReadByte(buffer, valBool)) return false;
             pNew = CBotVar::Create(token, w);                        // creates a variable
             pNew->SetValInt(valBool);
             break;
         case CBotTypByte:
             char valByte;
-            if (!ReadByte(istr, valByte)) return false;
+            if (!ReadByte(buffer, valByte)) return false;
             pNew = CBotVar::Create(token, w);                        // creates a variable
             pNew->SetValByte(valByte);
             break;
         case CBotTypShort:
             short valShort;
-            if (!ReadShort(istr, valShort)) return false;
+            if (!ReadShort(buffer, valShort)) return false;
             pNew = CBotVar::Create(token, w);                        // creates a variable
             pNew->SetValShort(valShort);
             break;
         case CBotTypChar:
             uint32_t valChar;
-            if (!ReadUInt32(istr, valChar)) return false;
+            if (!ReadUInt32(buffer, valChar)) return false;
             pNew = CBotVar::Create(token, w);                        // creates a variable
             pNew->SetValChar(valChar);
             break;
         case CBotTypInt:
             int valInt;
-            if (!ReadInt(istr, valInt)) return false;
+            if (!ReadInt(buffer, valInt)) return false;
             pNew = CBotVar::Create(token, w);                        // creates a variable
             pNew->SetValInt(valInt, defnum);
             break;
         case CBotTypLong:
             long valLong;
-            if (!ReadLong(istr, valLong)) return false;
+            if (!ReadLong(buffer, valLong)) return false;
             pNew = CBotVar::Create(token, w);                        // creates a variable
             pNew->SetValInt(valLong);
             break;
         case CBotTypFloat:
             float valFloat;
-            if (!ReadFloat(istr, valFloat)) return false;
+            if (!ReadFloat(buffer, valFloat)) return false;
             pNew = CBotVar::Create(token, w);                        // creates a variable
             pNew->SetValFloat(valFloat);
             break;
         case CBotTypDouble:
             double valDouble;
-            if (!ReadDouble(istr, valDouble)) return false;
+            if (!ReadDouble(buffer, valDouble)) return false;
             pNew = CBotVar::Create(token, w);                        // creates a variable
             pNew->SetValDouble(valDouble);
             break;
         case CBotTypString:
             {
                 std::string valString;
-                if (!ReadString(istr, valString)) return false;
+                if (!ReadString(buffer, valString)) return false;
                 pNew = CBotVar::Create(token, w);                    // creates a variable
                 pNew->SetValString(valString);
                 break;
@@ -918,8 +1064,8 @@ bool CBotVar::RestoreState(std::istream &istr, CBotVar* &pVar)
             {
                 CBotTypResult    r;
                 long            id;
-                if (!ReadType(istr, r)) return false;               // complete type
-                if (!ReadLong(istr, id)) return false;
+                if (!ReadType(buffer, r)) return false;               // complete type
+                if (!ReadLong(buffer, id)) return false;
 
                 {
                     CBotVar* p = nullptr;
@@ -927,7 +1073,7 @@ bool CBotVar::RestoreState(std::istream &istr, CBotVar* &pVar)
 
                     pNew = new CBotVarClass(token, r);                // directly creates an instance
                                                                     // attention cptuse = 0
-                    if (!RestoreState(istr, (static_cast<CBotVarClass*>(pNew))->m_pVar)) return false;
+                    if (!RestoreState(buffer, (static_cast<CBotVarClass*>(pNew))->m_pVar)) return false;
                     pNew->SetIdent(id);
 
                     if (isClass && p == nullptr) // set id for each item in this instance
@@ -960,18 +1106,18 @@ bool CBotVar::RestoreState(std::istream &istr, CBotVar* &pVar)
         case CBotTypNullPointer:
         {
             std::string className;
-            if (!ReadString(istr, className)) return false; // name of the class
+            if (!ReadString(buffer, className)) return false; // name of the class
             {
 //                CBotVarClass* p = nullptr;
                 long id;
-                if (!ReadLong(istr, id)) return false;
+                if (!ReadLong(buffer, id)) return false;
 //                if ( id ) p = CBotVarClass::Find(id);        // found the instance (made by RestoreInstance)
 
                 CBotTypResult ptrType(w, className);
                 pNew = CBotVar::Create(token, ptrType);        // creates a variable
                 // returns a copy of the original instance
                 CBotVar* pInstance = nullptr;
-                if (!CBotVar::RestoreState(istr, pInstance)) return false;
+                if (!CBotVar::RestoreState(buffer, pInstance)) return false;
                 (static_cast<CBotVarPointer*>(pNew))->SetPointer( pInstance );            // and point over
 
                 if (bConstructor) pNew->ConstructorSet(); // constructor was called
@@ -985,13 +1131,13 @@ bool CBotVar::RestoreState(std::istream &istr, CBotVar* &pVar)
         case CBotTypArrayPointer:
             {
                 CBotTypResult    r;
-                if (!ReadType(istr, r)) return false;
+                if (!ReadType(buffer, r)) return false;
 
                 pNew = CBotVar::Create(token, r);                        // creates a variable
 
                 // returns a copy of the original instance
                 CBotVar* pInstance = nullptr;
-                if (!CBotVar::RestoreState(istr, pInstance)) return false;
+                if (!CBotVar::RestoreState(buffer, pInstance)) return false;
                 (static_cast<CBotVarPointer*>(pNew))->SetPointer( pInstance );            // and point over
             }
             break;
@@ -428,8 +428,8 @@ public:
     //! \name Write to file
     //@{
 
-    bool            SaveState(std::ostream &ostr);
-    bool            RestoreState(std::istream &istr, CBotStack* &pStack);
+    bool            SaveState(CBotBufferWriter &buffer);
+    bool            RestoreState(CBotBufferReader &buffer, CBotStack* &pStack);
 
     //@}
 
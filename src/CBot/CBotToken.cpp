@@ -21,6 +21,8 @@
 
 #include <cstdarg>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <boost/bimap.hpp>
 
 namespace CBot
@@ -151,7 +153,7 @@ const std::string& LoadString(TokenId id)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-std::map<std::string, long> CBotToken::m_defineNum;
+std::unordered_map<std::string, long> CBotToken::m_defineNum;
 ////////////////////////////////////////////////////////////////////////////////
 CBotToken::CBotToken()
 {
@@ -258,269 +260,342 @@ void CBotToken::SetPos(int start, int end)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+namespace
+{
 
-// TODO: CharInList could probably be optimized to conditions like (*c >= '0' && *c <= '9') to gain some performance
-static char    sep1[] = " \r\n\t,:()[]{}-+*/=;><!~^|&%.\"\'?";
-static char    sep2[] = " \r\n\t";                           // only separators
-static char    sep3[] = ",:()[]{}-+*/=;<>!~^|&%.?";          // operational separators
-static char    num[]  = "0123456789";                        // point (single) is tested separately
-static char    hexnum[]   = "0123456789ABCDEFabcdef";
-static char    nch[]  = "\r\n\t";                            // forbidden in chains
+//! Character classes used by the tokenizer
+enum CharClass : unsigned char
+{
+    CHAR_SEP    = 1 << 0,   //!< ends an identifier
+    CHAR_SPACE  = 1 << 1,   //!< only separators
+    CHAR_OPER   = 1 << 2,   //!< operational separators
+    CHAR_NUM    = 1 << 3,   //!< decimal digits, point (single) is tested separately
+    CHAR_HEX    = 1 << 4,   //!< hexadecimal digits
+    CHAR_BIN    = 1 << 5,   //!< binary digits
+    CHAR_NCH    = 1 << 6,   //!< forbidden in chains
+};
+
+class CCharClassTable
+{
+public:
+    CCharClassTable()
+    {
+        Set(" \r\n\t,:()[]{}-+*/=;><!~^|&%.\"\'?", CHAR_SEP);
+        Set(" \r\n\t",                           CHAR_SPACE);
+        Set(",:()[]{}-+*/=;<>!~^|&%.?",          CHAR_OPER);
+        Set("0123456789",                        CHAR_NUM);
+        Set("0123456789ABCDEFabcdef",            CHAR_HEX);
+        Set("01",                                CHAR_BIN);
+        Set("\r\n\t",                            CHAR_NCH);
+    }
 
-////////////////////////////////////////////////////////////////////////////////
-CBotToken*  CBotToken::NextToken(const char*& program, bool first)
+    bool Is(char c, unsigned char charClass) const
+    {
+        return (m_classes[static_cast<unsigned char>(c)] & charClass) != 0;
+    }
+
+private:
+    void Set(const char* list, unsigned char charClass)
+    {
+        for (; *list != 0; ++list)
+            m_classes[static_cast<unsigned char>(*list)] |= charClass;
+    }
+
+    unsigned char m_classes[256] = {};
+};
+
+const CCharClassTable CHAR_CLASSES;
+
+/**
+ * \brief Perfect hash table of all the strings in KEYWORDS
+ *
+ * The seed of the hash function is chosen when the table is built so that no two keywords
+ * share a slot. A lookup is then a single hash and at most one string comparison.
+ */
+class CKeywordTable
 {
-    std::string token; // found token
-    std::string sep;   // separators after the token
-    bool stop = first;
+public:
+    CKeywordTable()
+    {
+        for (const auto& it : KEYWORDS.left)
+            m_entries.push_back({it.second.c_str(), it.second.length(), it.first});
+
+        m_mask = 255;
+        while (!Build())
+            m_mask = m_mask * 2 + 1;
+    }
 
-    if (*program == 0) return nullptr;
+    int Find(const char* w, std::size_t length) const
+    {
+        short index = m_slots[Hash(m_seed, w, length) & m_mask];
+        if (index < 0) return -1;
 
-    char c = *(program++);                 // next character
+        const Entry& entry = m_entries[index];
+        if (entry.length != length || memcmp(entry.text, w, length) != 0) return -1;
+        return entry.id;
+    }
 
-    if (!first)
+private:
+    struct Entry
     {
-        token = c;                            // built the word
-        c   = *(program++);                 // next character
+        const char* text;
+        std::size_t length;
+        int id;
+    };
 
-        // special case for strings
-        if (token[0] == '\"' )
+    static uint32_t Hash(uint32_t seed, const char* w, std::size_t length)
+    {
+        uint32_t h = seed ^ static_cast<uint32_t>(length);
+        for (std::size_t i = 0; i < length; i++)
+            h = (h ^ static_cast<unsigned char>(w[i])) * 16777619u;
+        return h ^ (h >> 15);
+    }
+
+    //! Look for a seed without collisions for the current mask
+    bool Build()
+    {
+        for (m_seed = 2166136261u; m_seed < 2166136261u + 4096; m_seed++)
         {
-            while (c != 0 && c != '\"' && !CharInList(c, nch))
-            {
-                if ( c == '\\' )
-                {
-                    token += c;
-                    c = *(program++);
-                    if (c == 0 || CharInList(c, nch)) break;
-                }
-                token += c;
-                c = *(program++);
-            }
-            if ( c == '\"' )
+            m_slots.assign(m_mask + 1, -1);
+            bool perfect = true;
+            for (std::size_t i = 0; i < m_entries.size() && perfect; i++)
             {
-                token += c;                           // string is complete
-                c   = *(program++);                 // next character
+                short& slot = m_slots[Hash(m_seed, m_entries[i].text, m_entries[i].length) & m_mask];
+                perfect = (slot < 0);
+                slot = static_cast<short>(i);
             }
-            stop = true;
+            if (perfect) return true;
         }
+        return false;
+    }
 
-        // special case for characters
-        if (token[0] == '\'')
-        {
-            if (c == '\\')       // escape sequence
-            {
-                token += c;
-                c = *(program++);
-
-                if (c == 'u' || c == 'U') // unicode escape
-                {
-                    int maxlen = (c == 'u') ? 4 : 8;
-                    token += c;
-                    c = *(program++);
-                    for (int i = 0; i < maxlen; i++)
-                    {
-                        if (c == 0 || !CharInList(c, hexnum)) break;
-                        token += c;
-                        c = *(program++);
-                    }
-                }
-                else if (c != 0 && !CharInList(c, nch)) // other escape char
-                {
-                    token += c;
-                    c = *(program++);
-                }
-            }
-            else if (c != 0 && c != '\'' && !CharInList(c, nch)) // single character
-            {
-                token += c;
-                c = *(program++);
-            }
+    std::vector<Entry> m_entries;
+    std::vector<short> m_slots;
+    uint32_t m_seed = 0;
+    uint32_t m_mask = 0;
+};
 
-            if (c == '\'') // close quote
-            {
-                token += c;
-                c = *(program++);
-            }
-            stop = true;
+const CKeywordTable& GetKeywordTable()
+{
+    static const CKeywordTable table;
+    return table;
+}
+
+//! Location of one token in the program string
+struct TokenRange
+{
+    std::size_t start;      //!< beginning of the token
+    std::size_t end;        //!< end of the token, beginning of its separators
+    std::size_t sepEnd;     //!< end of the separators, beginning of the next token
+};
+
+/**
+ * \brief Skip the separators and comments starting at given position
+ * \return Position of the first character that is not a separator
+ */
+std::size_t SkipSeparators(const char* program, std::size_t i)
+{
+    while (true)
+    {
+        while (CHAR_CLASSES.Is(program[i], CHAR_SPACE)) i++;
+
+        if (program[i] == '/' && program[i+1] == '/')         // comment on the heap?
+        {
+            while (program[i] != '\n' && program[i] != 0) i++;
+            continue;
         }
 
-        // special case for numbers
-        if ( CharInList(token[0], num ))
+        if (program[i] == '/' && program[i+1] == '*')         // comment on the heap?
         {
-            bool    bdot = false;   // found a point?
-            bool    bexp = false;   // found an exponent?
+            while (program[i] != 0 && (program[i] != '*' || program[i+1] != '/')) i++;
+            if (program[i] != 0) i += 2;
+            continue;
+        }
 
-            char    bin[] = "01";
-            char*   liste = num;
-            if (token[0] == '0' && c == 'x')          // hexadecimal value?
-            {
-                token += c;
-                c   = *(program++);                 // next character
-                liste = hexnum;
-            }
-            else if (token[0] == '0' && c == 'b')   // binary literal
-            {
-                liste = bin;
-                token += c;
-                c = *(program++);
-            }
-cw:
-            while (c != 0 && CharInList(c, liste))
-            {
-cc:             token += c;
-                c   = *(program++);                 // next character
-            }
-            if ( liste == num )                     // not for hexadecimal
-            {
-                if ( !bdot && c == '.' ) { bdot = true; goto cc; }
-                if ( !bexp && ( c == 'e' || c == 'E' ) )
-                {
-                    bexp = true;
-                    token += c;
-                    c   = *(program++);                 // next character
-                    if ( c == '-' ||
-                         c == '+' ) goto cc;
-                    goto cw;
-                }
+        return i;
+    }
+}
 
-            }
-            stop = true;
-        }
+/**
+ * \brief Find the end of the token beginning at given position
+ *
+ * The token must not start with separators. The separators are part of the previous token.
+ *
+ * \param program The null-terminated program string
+ * \param i Beginning of the token
+ * \return Position right after the last character of the token
+ */
+std::size_t ScanToken(const char* program, std::size_t i)
+{
+    const char first = program[i++];
 
-        if (CharInList(token[0], sep3))               // an operational separator?
+    if (first == '\"')                                      // special case for strings
+    {
+        while (program[i] != 0 && program[i] != '\"' && !CHAR_CLASSES.Is(program[i], CHAR_NCH))
         {
-            std::string  motc = token;
-            while (motc += c, c != 0 && GetKeyWord(motc) > 0)    // operand seeks the longest possible
+            if (program[i] == '\\')
             {
-                token += c;                           // build the word
-                c = *(program++);                   // next character
+                i++;
+                if (program[i] == 0 || CHAR_CLASSES.Is(program[i], CHAR_NCH)) break;
             }
-
-            stop = true;
+            i++;
         }
+        if (program[i] == '\"') i++;                        // string is complete
+        return i;
     }
 
-
-
-    while (true)
+    if (first == '\'')                                      // special case for characters
     {
-        if (stop || c == 0 || CharInList(c, sep1))
+        if (program[i] == '\\')                             // escape sequence
         {
-            if (!first && token.empty()) return nullptr;   // end of the analysis
-bis:
-            while (CharInList(c, sep2))
-            {
-                sep += c;                           // after all the separators
-                c = *(program++);
-            }
-            if (c == '/' && *program == '/')        // comment on the heap?
+            i++;
+            if (program[i] == 'u' || program[i] == 'U')     // unicode escape
             {
-                while( c != '\n' && c != 0 )
-                {
-                    sep += c;
-                    c = *(program++);               // next character
-                }
-                goto bis;
+                int maxlen = (program[i] == 'u') ? 4 : 8;
+                i++;
+                for (int n = 0; n < maxlen && CHAR_CLASSES.Is(program[i], CHAR_HEX); n++) i++;
             }
-
-            if (c == '/' && *program == '*')        // comment on the heap?
+            else if (program[i] != 0 && !CHAR_CLASSES.Is(program[i], CHAR_NCH)) // other escape char
             {
-                while( c != 0 && (c != '*' || *program != '/'))
-                {
-                    sep += c;
-                    c = *(program++);               // next character
-                }
-                if ( c != 0 )
-                {
-                    sep += c;
-                    c = *(program++);               // next character
-                    sep += c;
-                    c = *(program++);               // next character
-                }
-                goto bis;
+                i++;
             }
+        }
+        else if (program[i] != 0 && program[i] != '\'' && !CHAR_CLASSES.Is(program[i], CHAR_NCH)) // single character
+        {
+            i++;
+        }
 
-            program--;
+        if (program[i] == '\'') i++;                        // close quote
+        return i;
+    }
 
-            CBotToken* t = new CBotToken(token, sep);
+    if (CHAR_CLASSES.Is(first, CHAR_NUM))                   // special case for numbers
+    {
+        bool bdot = false;                                  // found a point?
+        bool bexp = false;                                  // found an exponent?
 
-            if (CharInList(token[0], num )) t->m_type = TokenTypNum;
-            if (token[0] == '\"') t->m_type = TokenTypString;
-            if (token[0] == '\'') t->m_type = TokenTypChar;
-            if (first) t->m_type = TokenTypNone;
+        unsigned char digits = CHAR_NUM;
+        if (first == '0' && program[i] == 'x')              // hexadecimal value?
+        {
+            digits = CHAR_HEX;
+            i++;
+        }
+        else if (first == '0' && program[i] == 'b')         // binary literal
+        {
+            digits = CHAR_BIN;
+            i++;
+        }
 
-            t->m_keywordId = GetKeyWord(token);
-            if (t->m_keywordId > 0) t->m_type = TokenTypKeyWord;
-            else GetDefineNum(token, t) ;         // treats DefineNum
+        while (true)
+        {
+            while (CHAR_CLASSES.Is(program[i], digits)) i++;
+            if (digits != CHAR_NUM) break;                  // not for hexadecimal
 
-            return t;
+            if (!bdot && program[i] == '.')
+            {
+                bdot = true;
+                i++;
+                continue;
+            }
+            if (!bexp && (program[i] == 'e' || program[i] == 'E'))
+            {
+                bexp = true;
+                i++;
+                if (program[i] == '-' || program[i] == '+') i++;
+                continue;
+            }
+            break;
         }
+        return i;
+    }
 
-        token += c;                       // built the word
-        c = *(program++);               // next character
+    if (CHAR_CLASSES.Is(first, CHAR_OPER))                  // an operational separator?
+    {
+        const std::size_t start = i - 1;
+        const CKeywordTable& keywords = GetKeywordTable();
+        while (program[i] != 0 && keywords.Find(program + start, i + 1 - start) > 0) i++; // operand seeks the longest possible
+        return i;
     }
+
+    while (program[i] != 0 && !CHAR_CLASSES.Is(program[i], CHAR_SEP)) i++;
+    return i;
 }
 
+} // namespace
+
 ////////////////////////////////////////////////////////////////////////////////
-std::unique_ptr<CBotToken> CBotToken::CompileTokens(const std::string& program)
+std::unique_ptr<CBotTokenList> CBotToken::CompileTokens(const std::string& program)
 {
-    CBotToken       *nxt, *prv, *tokenbase;
-    const char*     p = program.c_str();
-    int             pos = 0;
+    const char* p = program.c_str();
+    if (*p == 0) return nullptr;
 
-    prv = tokenbase = NextToken(p, true);
+    // Step 1. Find the location of all the tokens
+    std::vector<TokenRange> ranges;
+    ranges.reserve(program.length() / 4 + 2);
 
-    if (tokenbase == nullptr) return nullptr;
-
-    tokenbase->m_start  = pos;
-    pos += tokenbase->m_text.length();
-    tokenbase->m_end    = pos;
-    pos += tokenbase->m_sep.length();
-
-    const char* pp = p;
-    while (nullptr != (nxt = NextToken(p, false)))
+    std::size_t pos = SkipSeparators(p, 0);
+    ranges.push_back({0, 0, pos});                          // the first token holds only the separators
+    while (p[pos] != 0)
     {
-        prv->m_next = nxt;              // added after
-        nxt->m_prev = prv;
-        prv = nxt;                      // advance
-
-        nxt->m_start    = pos;
-        pos += (p - pp);                // total size
-        nxt->m_end  = pos - nxt->m_sep.length();
-        pp = p;
+        std::size_t end = ScanToken(p, pos);
+        std::size_t sepEnd = SkipSeparators(p, end);
+        ranges.push_back({pos, end, sepEnd});
+        pos = sepEnd;
     }
+    ranges.push_back({pos, pos, pos});                      // terminator token
 
-    // terminator token
-    nxt = new CBotToken();
-    nxt->m_type = TokenTypNone;
-    nxt->m_end = nxt->m_start = pos;
-    prv->m_next = nxt;
-    nxt->m_prev = prv;
+    // Step 2. Fill the tokens, all allocated at once
+    std::unique_ptr<CBotTokenList> list(new CBotTokenList(ranges.size()));
+    CBotToken* tokens = list->m_tokens.get();
+    for (std::size_t i = 0; i < ranges.size(); i++)
+    {
+        CBotToken& t = tokens[i];
+        const TokenRange& range = ranges[i];
+        t.m_text.assign(p + range.start, range.end - range.start);
+        t.m_sep.assign(p + range.end, range.sepEnd - range.end);
+        t.m_start = static_cast<int>(range.start);
+        t.m_end = static_cast<int>(range.end);
+
+        if (i > 0)
+        {
+            t.m_prev = &tokens[i-1];
+            tokens[i-1].m_next = &t;
+        }
+
+        if (i == 0 || i == ranges.size() - 1)
+        {
+            t.m_type = TokenTypNone;
+            continue;
+        }
+
+        const char first = t.m_text[0];
+        if (CHAR_CLASSES.Is(first, CHAR_NUM)) t.m_type = TokenTypNum;
+        else if (first == '\"') t.m_type = TokenTypString;
+        else if (first == '\'') t.m_type = TokenTypChar;
+
+        t.m_keywordId = GetKeyWord(t.m_text.data(), t.m_text.length());
+        if (t.m_keywordId > 0) t.m_type = TokenTypKeyWord;
+        else if (t.m_type == TokenTypVar) GetDefineNum(t.m_text, &t);   // treats DefineNum
+    }
 
-    return std::unique_ptr<CBotToken>(tokenbase);
+    return list;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-int CBotToken::GetKeyWord(const std::string& w)
+int CBotToken::GetKeyWord(const char* w, std::size_t length)
 {
-    auto it = KEYWORDS.right.find(w);
-    if (it != KEYWORDS.right.end())
-    {
-        return it->second;
-    }
-
-    return -1;
+    return GetKeywordTable().Find(w, length);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool CBotToken::GetDefineNum(const std::string& name, CBotToken* token)
 {
-    if (m_defineNum.count(name) == 0)
+    auto it = m_defineNum.find(name);
+    if (it == m_defineNum.end())
         return false;
 
     token->m_type = TokenTypDef;
-    token->m_keywordId = m_defineNum[name];
+    token->m_keywordId = it->second;
     return true;
 }
 
@@ -538,6 +613,34 @@ bool CBotToken::DefineNum(const std::string& name, long val)
     return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+CBotTokenList::CBotTokenList(std::size_t count) : m_tokens(new CBotToken[count]), m_count(count)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotTokenList::~CBotTokenList()
+{
+    // the tokens are not allocated separately, don't let them delete each other
+    for (std::size_t i = 0; i < m_count; i++)
+    {
+        m_tokens[i].m_next = nullptr;
+        m_tokens[i].m_prev = nullptr;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotToken* CBotTokenList::GetFirst()
+{
+    return m_tokens.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t CBotTokenList::GetCount()
+{
+    return m_count;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool IsOfType(CBotToken* &p, int type1, int type2)
 {
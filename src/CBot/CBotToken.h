@@ -25,6 +25,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <memory>
 
 namespace CBot
@@ -66,8 +67,8 @@ namespace CBot
  *
  * \section Usage Example usage
  * \code
- * std::unique_ptr<CBotToken> tokens = CBotToken::CompileTokens(program);
- * CBotToken* token = tokens.get();
+ * std::unique_ptr<CBotTokenList> tokens = CBotToken::CompileTokens(program);
+ * CBotToken* token = tokens->GetFirst();
  * while(token != nullptr)
  * {
  *     printf("%s\n", token->GetString());
@@ -77,6 +78,8 @@ namespace CBot
  * \endcode
  */
 
+class CBotTokenList;
+
 class CBotToken : public CBotDoublyLinkedList<CBotToken>
 {
 public:
@@ -106,7 +109,8 @@ public:
      *
      * Be careful! This destroys the whole linked list of tokens
      *
-     * Never call in the middle of the sequence - always on the first token in the list
+     * Never call in the middle of the sequence - always on the first token in the list.
+     * Tokens returned by CompileTokens() are owned by their CBotTokenList and must never be deleted directly.
      */
     ~CBotToken();
 
@@ -158,10 +162,13 @@ public:
 
     /**
      * \brief Transforms a CBot program from a string to a list of tokens
+     *
+     * The whole list is allocated in one contiguous block owned by the returned CBotTokenList.
+     *
      * \param prog The program string
-     * \return The first token in the linked list
+     * \return The list of tokens, or nullptr if the program is empty
      */
-    static std::unique_ptr<CBotToken> CompileTokens(const std::string& prog);
+    static std::unique_ptr<CBotTokenList> CompileTokens(const std::string& prog);
 
     /**
      * \brief Define a new constant
@@ -178,18 +185,8 @@ public:
     static void ClearDefineNum();
 
 private:
-    /**
-     * \brief Find the next token in the string
-     *
-     * The string must not start with separators. The separator is part of the previous token.
-     *
-     * \param [in, out] program The program string, modified to point at the next token
-     * \param first true if this is the first call (beginning of the program string)
-     * \return A processed CBotToken
-     */
-    static CBotToken* NextToken(const char*& program, bool first);
+    friend class CBotTokenList;
 
-private:
     //! The token type
     TokenType m_type = TokenTypVar;
     //! The id of the keyword
@@ -206,14 +203,15 @@ private:
     int m_end = 0;
 
     //! Map of all defined constants (see DefineNum())
-    static std::map<std::string, long> m_defineNum;
+    static std::unordered_map<std::string, long> m_defineNum;
 
     /**
      * \brief Check if the word is a keyword
-     * \param w The word to check
+     * \param w Beginning of the word to check, does not need to be null-terminated
+     * \param length Length of the word
      * \return the keyword ID (::CBotTokenId), or -1 if this is not a keyword
      */
-    static int GetKeyWord(const std::string& w);
+    static int GetKeyWord(const char* w, std::size_t length);
 
     /**
      * \brief Resolve a constant defined with DefineNum()
@@ -224,6 +222,49 @@ private:
     static bool GetDefineNum(const std::string& name, CBotToken* token);
 };
 
+/**
+ * \brief A list of tokens created by CBotToken::CompileTokens()
+ *
+ * All the tokens are stored in a single contiguous array and linked together in program order.
+ * The first token holds only the separators found at the beginning of the program,
+ * the last one is an empty ::TokenTypNone terminator.
+ */
+class CBotTokenList
+{
+public:
+    /**
+     * \brief Constructor
+     * \param count Number of tokens to allocate
+     */
+    explicit CBotTokenList(std::size_t count);
+
+    /**
+     * \brief Destructor, frees all the tokens at once
+     */
+    ~CBotTokenList();
+
+    CBotTokenList(const CBotTokenList&) = delete;
+    CBotTokenList& operator=(const CBotTokenList&) = delete;
+
+    /**
+     * \brief Return the first token in the list
+     */
+    CBotToken* GetFirst();
+
+    /**
+     * \brief Return the number of tokens in the list, including the first and the terminator
+     */
+    std::size_t GetCount();
+
+private:
+    friend class CBotToken;
+
+    //! The tokens, linked in order
+    std::unique_ptr<CBotToken[]> m_tokens;
+    //! Number of tokens in m_tokens
+    std::size_t m_count;
+};
+
 /**
  * \brief Check if this token is of specified type
  * \param p The token to compare
@@ -654,28 +654,39 @@ public:
 
     /**
      * \brief Save common variable header (name, type, etc.)
-     * \param ostr Output stream
+     * \param buffer Output buffer
      * \return false on write error
      */
-    virtual bool Save0State(std::ostream &ostr);
+    virtual bool Save0State(CBotBufferWriter &buffer);
 
     /**
      * \brief Save variable data
      *
      * Overriden in child classes
      *
-     * \param ostr Output stream
+     * \param buffer Output buffer
      * \return false on write error
      */
-    virtual bool Save1State(std::ostream &ostr);
+    virtual bool Save1State(CBotBufferWriter &buffer);
 
     /**
      * \brief Restore variable
-     * \param istr Input stream
+     * \param buffer Input buffer
      * \param[out] pVar Pointer to recieve the variable
      * \return false on read error
      */
-    static bool RestoreState(std::istream &istr, CBotVar* &pVar);
+    static bool RestoreState(CBotBufferReader &buffer, CBotVar* &pVar);
+
+    /**
+     * \brief Save a linked list of array elements
+     *
+     * Like SaveVars(), but consecutive elements holding plain numbers are stored as one block
+     *
+     * \param buffer Output buffer
+     * \param pVar First element of the array
+     * \return false on write error
+     */
+    static bool SaveArrayItems(CBotBufferWriter &buffer, CBotVar* pVar);
 
     //@}
 
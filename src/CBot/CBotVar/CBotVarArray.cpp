@@ -136,10 +136,10 @@ std::string CBotVarArray::GetValString()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-bool CBotVarArray::Save1State(std::ostream &ostr)
+bool CBotVarArray::Save1State(CBotBufferWriter &buffer)
 {
-    if (!WriteType(ostr, m_type)) return false;
-    return SaveVars(ostr, m_pInstance);                      // saves the instance that manages the table
+    if (!WriteType(buffer, m_type)) return false;
+    return SaveVars(buffer, m_pInstance);                      // saves the instance that manages the table
 }
 
 } // namespace CBot
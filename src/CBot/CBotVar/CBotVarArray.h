@@ -51,7 +51,7 @@ public:
 
     std::string GetValString() override;
 
-    bool Save1State(std::ostream &ostr) override;
+    bool Save1State(CBotBufferWriter &buffer) override;
 
 private:
     //! Array data
@@ -40,9 +40,9 @@ void CBotVarBoolean::Not()
     SetValInt(!GetValInt());
 }
 
-bool CBotVarBoolean::Save1State(std::ostream &ostr)
+bool CBotVarBoolean::Save1State(CBotBufferWriter &buffer)
 {
-    return WriteByte(ostr, m_val);                          // the value of the variable
+    return WriteByte(buffer, m_val);                          // the value of the variable
 }
 
 } // namespace CBot
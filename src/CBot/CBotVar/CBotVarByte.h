@@ -37,9 +37,9 @@ public:
         SetValByte(static_cast<unsigned char>(left->GetValByte()) >> right->GetValInt());
     }
 
-    bool Save1State(std::ostream &ostr) override
+    bool Save1State(CBotBufferWriter &buffer) override
     {
-        return WriteByte(ostr, m_val);
+        return WriteByte(buffer, m_val);
     }
 };
 
@@ -50,9 +50,9 @@ public:
         SetValChar(left->GetValChar() >> right->GetValInt());
     }
 
-    bool Save1State(std::ostream &ostr) override
+    bool Save1State(CBotBufferWriter &buffer) override
     {
-        return WriteUInt32(ostr, m_val);
+        return WriteUInt32(buffer, m_val);
     }
 };
 
@@ -225,6 +225,15 @@ void CBotVarClass::Update(void* pUser)
     m_pClass->Update(this, pUser);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void CBotVarClass::UpdateField(CBotVar* field, void* pUser)
+{
+    if ( m_pUserPtr != nullptr) pUser = m_pUserPtr;
+    if ( pUser == OBJECTDELETED ||
+         pUser == OBJECTCREATED ) return;
+    m_pClass->UpdateField(this, field, pUser);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 CBotVar* CBotVarClass::GetItem(const std::string& name)
 {
@@ -455,12 +464,15 @@ bool CBotVarClass::Ne(CBotVar* left, CBotVar* right)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-bool CBotVarClass::Save1State(std::ostream &ostr)
+bool CBotVarClass::Save1State(CBotBufferWriter &buffer)
 {
-    if (!WriteType(ostr, m_type)) return false;
-    if (!WriteLong(ostr, m_ItemIdent)) return false;
+    if (!WriteType(buffer, m_type)) return false;
+    if (!WriteLong(buffer, m_ItemIdent)) return false;
+
+    if (m_type.Eq(CBotTypArrayBody))
+        return SaveArrayItems(buffer, m_pVar);                  // elements of the array
 
-    return SaveVars(ostr, m_pVar);                              // content of the object
+    return SaveVars(buffer, m_pVar);                              // content of the object
 }
 
 } // namespace CBot
@@ -54,10 +54,18 @@ public:
     CBotVar* GetItemList() override;
     std::string GetValString() override;
 
-    bool Save1State(std::ostream &ostr) override;
+    bool Save1State(CBotBufferWriter &buffer) override;
 
     void Update(void* pUser) override;
 
+    /**
+     * \brief Call the class update function for a single field of this instance
+     * \param field Field of this instance
+     * \param pUser User pointer to pass to the update function
+     * \see CBotClass::SetFieldUpdateFunc()
+     */
+    void UpdateField(CBotVar* field, void* pUser);
+
     //! \name Reference counter
     //@{
 
@@ -22,9 +22,9 @@
 namespace CBot
 {
 
-bool CBotVarFloat::Save1State(std::ostream &ostr)
+bool CBotVarFloat::Save1State(CBotBufferWriter &buffer)
 {
-    return WriteFloat(ostr, m_val); // the value of the variable
+    return WriteFloat(buffer, m_val); // the value of the variable
 }
 
 } // namespace CBot
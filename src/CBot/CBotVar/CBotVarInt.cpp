@@ -69,20 +69,20 @@ void CBotVarInt::Not()
     m_defnum.clear();
 }
 
-bool CBotVarInt::Save0State(std::ostream &ostr)
+bool CBotVarInt::Save0State(CBotBufferWriter &buffer)
 {
     if (!m_defnum.empty())
     {
-        if(!WriteWord(ostr, 200)) return false; // special marker
-        if(!WriteString(ostr, m_defnum)) return false;
+        if(!WriteWord(buffer, 200)) return false; // special marker
+        if(!WriteString(buffer, m_defnum)) return false;
     }
 
-    return CBotVar::Save0State(ostr);
+    return CBotVar::Save0State(buffer);
 }
 
-bool CBotVarInt::Save1State(std::ostream &ostr)
+bool CBotVarInt::Save1State(CBotBufferWriter &buffer)
 {
-    return WriteInt(ostr, m_val);
+    return WriteInt(buffer, m_val);
 }
 
 } // namespace CBot
@@ -44,8 +44,8 @@ public:
 
     void SR(CBotVar* left, CBotVar* right) override;
 
-    bool Save0State(std::ostream &ostr) override;
-    bool Save1State(std::ostream &ostr) override;
+    bool Save0State(CBotBufferWriter &buffer) override;
+    bool Save1State(CBotBufferWriter &buffer) override;
 
 protected:
 
@@ -37,9 +37,9 @@ public:
         SetValLong(static_cast<unsigned long>(left->GetValLong()) >> right->GetValInt());
     }
 
-    bool Save1State(std::ostream &ostr) override
+    bool Save1State(CBotBufferWriter &buffer) override
     {
-        return WriteLong(ostr, m_val);
+        return WriteLong(buffer, m_val);
     }
 };
 
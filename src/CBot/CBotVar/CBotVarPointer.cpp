@@ -170,21 +170,21 @@ CBotClass* CBotVarPointer::GetClass()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-bool CBotVarPointer::Save1State(std::ostream &ostr)
+bool CBotVarPointer::Save1State(CBotBufferWriter &buffer)
 {
     if ( m_type.GetClass() != nullptr )
     {
-        if (!WriteString(ostr, m_type.GetClass()->GetName())) return false;  // name of the class
+        if (!WriteString(buffer, m_type.GetClass()->GetName())) return false;  // name of the class
     }
     else
     {
-        if (!WriteString(ostr, "")) return false;
+        if (!WriteString(buffer, "")) return false;
     }
 
-    if (!WriteLong(ostr, GetIdent())) return false;      // the unique reference
+    if (!WriteLong(buffer, GetIdent())) return false;      // the unique reference
 
     // also saves the proceedings copies
-    return SaveVars(ostr, GetPointer());
+    return SaveVars(buffer, GetPointer());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
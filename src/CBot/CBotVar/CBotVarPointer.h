@@ -61,7 +61,7 @@ public:
 
     void ConstructorSet() override;
 
-    bool Save1State(std::ostream &ostr) override;
+    bool Save1State(CBotBufferWriter &buffer) override;
 
     void Update(void* pUser) override;
 
@@ -37,9 +37,9 @@ public:
         SetValShort(static_cast<unsigned short>(left->GetValShort()) >> right->GetValInt());
     }
 
-    bool Save1State(std::ostream &ostr) override
+    bool Save1State(CBotBufferWriter &buffer) override
     {
-        return WriteShort(ostr, m_val);
+        return WriteShort(buffer, m_val);
     }
 };
 
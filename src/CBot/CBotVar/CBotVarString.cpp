@@ -37,9 +37,9 @@ bool CBotVarString::Ne(CBotVar* left, CBotVar* right)
     return left->GetValString() != right->GetValString();
 }
 
-bool CBotVarString::Save1State(std::ostream &ostr)
+bool CBotVarString::Save1State(CBotBufferWriter &buffer)
 {
-    return WriteString(ostr, m_val);
+    return WriteString(buffer, m_val);
 }
 
 } // namespace CBot
@@ -40,6 +40,7 @@
 #include "common/thread/thread.h"
 
 #include "graphics/core/nulldevice.h"
+#include "graphics/core/recordingdevice.h"
 
 #include "graphics/opengl/glutil.h"
 
@@ -154,6 +155,8 @@ CApplication::CApplication(CSystemUtils* systemUtils)
     m_runSceneRank = 0;
 
     m_sceneTest = false;
+    m_benchmarkText = false;
+    m_recordCalls = false;
     m_headless = false;
     m_resolutionOverride = false;
 
@@ -268,7 +271,10 @@ ParseArgsStatus CApplication::ParseArguments(int argc, char *argv[])
         OPT_HEADLESS,
         OPT_DEVICE,
         OPT_OPENGL_VERSION,
-        OPT_OPENGL_PROFILE
+        OPT_OPENGL_PROFILE,
+        OPT_BENCHMARK,
+        OPT_BENCHMARK_TEXT,
+        OPT_RECORD_CALLS
     };
 
     option options[] =
@@ -287,6 +293,9 @@ ParseArgsStatus CApplication::ParseArguments(int argc, char *argv[])
         { "graphics", required_argument, nullptr, OPT_DEVICE },
         { "glversion", required_argument, nullptr, OPT_OPENGL_VERSION },
         { "glprofile", required_argument, nullptr, OPT_OPENGL_PROFILE },
+        { "benchmark", required_argument, nullptr, OPT_BENCHMARK },
+        { "benchmarktext", no_argument, nullptr, OPT_BENCHMARK_TEXT },
+        { "recordcalls", no_argument, nullptr, OPT_RECORD_CALLS },
         { nullptr, 0, nullptr, 0}
     };
 
@@ -323,6 +332,8 @@ ParseArgsStatus CApplication::ParseArguments(int argc, char *argv[])
                 GetLogger()->Message("  -runscene sceneNNN  run given scene on start\n");
                 GetLogger()->Message("  -scenetest          win every mission right after it's loaded\n");
                 GetLogger()->Message("  -loglevel level     set log level to level (one of: trace, debug, info, warn, error, none)\n");
+                GetLogger()->Message("                      per category levels can follow, e.g. info,sound=trace,graphics=none\n");
+                GetLogger()->Message("                      (categories: general, graphics, cbot, sound, level, object)\n");
                 GetLogger()->Message("  -langdir path       set custom language directory path\n");
                 GetLogger()->Message("                      environment variable: COLOBOT_LANG_DIR\n");
                 GetLogger()->Message("  -datadir path       set custom data directory path\n");
@@ -332,9 +343,12 @@ ParseArgsStatus CApplication::ParseArguments(int argc, char *argv[])
                 GetLogger()->Message("  -mod path           load datadir mod from given path\n");
                 GetLogger()->Message("  -resolution WxH     set resolution\n");
                 GetLogger()->Message("  -headless           headless mode - disables graphics, sound and user interaction\n");
-                GetLogger()->Message("  -graphics           changes graphics device (one of: default, auto, opengl, gl14, gl21, gl33\n");
+                GetLogger()->Message("  -graphics           changes graphics device (one of: default, auto, opengl, gl14, gl21, gl33, record\n");
                 GetLogger()->Message("  -glversion          sets OpenGL context version to use (either default or version in format #.#)\n");
                 GetLogger()->Message("  -glprofile          sets OpenGL context profile to use (one of: default, core, compatibility, opengles)\n");
+                GetLogger()->Message("  -benchmark file     with -runscene and -graphics record, fly around the scene and write rendering statistics to file\n");
+                GetLogger()->Message("  -benchmarktext      with -benchmark, draw text resembling the program editor over the scene\n");
+                GetLogger()->Message("  -recordcalls        with -graphics record, log every call made to the graphics device (needs -loglevel debug)\n");
                 return PARSE_ARGS_HELP;
             }
             case OPT_DEBUG:
@@ -381,15 +395,13 @@ ParseArgsStatus CApplication::ParseArguments(int argc, char *argv[])
             }
             case OPT_LOGLEVEL:
             {
-                LogLevel logLevel;
-                if (! CLogger::ParseLogLevel(optarg, logLevel))
+                if (! GetLogger()->SetLogLevels(optarg))
                 {
                     GetLogger()->Error("Invalid log level: '%s'\n", optarg);
                     return PARSE_ARGS_FAIL;
                 }
 
                 GetLogger()->Message("[*****] Log level changed to %s\n", optarg);
-                GetLogger()->SetLogLevel(logLevel);
                 break;
             }
             case OPT_DATADIR:
@@ -438,6 +450,21 @@ ParseArgsStatus CApplication::ParseArguments(int argc, char *argv[])
                 m_graphicsOverride = true;
                 break;
             }
+            case OPT_BENCHMARK:
+            {
+                m_benchmarkFile = optarg;
+                break;
+            }
+            case OPT_BENCHMARK_TEXT:
+            {
+                m_benchmarkText = true;
+                break;
+            }
+            case OPT_RECORD_CALLS:
+            {
+                m_recordCalls = true;
+                break;
+            }
             case OPT_OPENGL_VERSION:
             {
                 if (strcmp(optarg, "default") == 0)
@@ -655,7 +682,13 @@ bool CApplication::Create()
         GetLogger()->Info("No joysticks detected\n");
     }
 
-    if (!m_headless)
+    if (m_graphicsOverride && m_graphics == "record")
+    {
+        auto device = MakeUnique<Gfx::CRecordingDevice>();
+        device->SetCallLogging(m_recordCalls);
+        m_device = std::move(device);
+    }
+    else if (!m_headless)
     {
         std::string graphics = "default";
         std::string value;
@@ -1361,7 +1394,8 @@ void CApplication::LogEvent(const Event &event)
     };
 
     // Print the events in debug mode to test the code
-    if (IsDebugModeActive(DEBUG_SYS_EVENTS) || IsDebugModeActive(DEBUG_UPDATE_EVENTS) || IsDebugModeActive(DEBUG_APP_EVENTS))
+    if ((IsDebugModeActive(DEBUG_SYS_EVENTS) || IsDebugModeActive(DEBUG_UPDATE_EVENTS) || IsDebugModeActive(DEBUG_APP_EVENTS)) &&
+        l->IsEnabled(LOG_CATEGORY_GENERAL, LOG_TRACE))
     {
         std::string eventType = ParseEventType(event.type);
 
@@ -1982,6 +2016,16 @@ bool CApplication::GetSceneTestMode()
     return m_sceneTest;
 }
 
+const std::string& CApplication::GetBenchmarkFile()
+{
+    return m_benchmarkFile;
+}
+
+bool CApplication::GetBenchmarkText()
+{
+    return m_benchmarkText;
+}
+
 void CApplication::SetTextInput(bool textInputEnabled, int id)
 {
     m_textInputEnabled[id] = textInputEnabled;
@@ -274,6 +274,11 @@ public:
 
     bool        GetSceneTestMode();
 
+    //! Returns the file to write the rendering benchmark results to, empty if not running a benchmark
+    const std::string& GetBenchmarkFile();
+    //! Returns whether the rendering benchmark draws a text-heavy interface
+    bool        GetBenchmarkText();
+
     //! Renders the image in window
     void        Render();
 
@@ -408,6 +413,13 @@ protected:
     //! Scene test mode
     bool            m_sceneTest;
 
+    //! Rendering benchmark output file
+    std::string     m_benchmarkFile;
+    //! Draw text during the rendering benchmark
+    bool            m_benchmarkText;
+    //! Log every call made to the recording device
+    bool            m_recordCalls;
+
     //! Application language
     Language        m_language;
 
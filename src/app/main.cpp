@@ -27,6 +27,7 @@
 #include "app/app.h"
 #include "app/signal_handlers.h"
 
+#include "common/async_log_queue.h"
 #include "common/logger.h"
 #include "common/make_unique.h"
 #include "common/profiler.h"
@@ -129,6 +130,12 @@ int main(int argc, char *argv[])
     else
         logger.Error("Failed to create log file, writing log to file disabled\n");
 
+    // From now on, messages are written by a background thread
+    logger.SetQueue(MakeUnique<CAsyncLogQueue>([&logger](LogLevel level, const char* message, std::size_t length)
+    {
+        logger.Write(level, message, length);
+    }));
+
 
     // Workaround for character encoding in argv on Windows
     #if PLATFORM_WINDOWS
@@ -19,6 +19,7 @@
 
 #include "app/signal_handlers.h"
 
+#include "common/logger.h"
 #include "common/stringutils.h"
 #include "common/version.h"
 
@@ -117,6 +118,10 @@ void CSignalHandlers::ReportError(const std::string& errorMessage)
 {
     static bool triedSaving = false;
 
+    // Make sure the log leading up to the crash ends up in the log file,
+    // without waiting for a lock that the crashed thread may be holding
+    GetLogger()->TryFlush();
+
     if (SDL_WasInit(SDL_INIT_VIDEO))
     {
         // Close the SDL window on crash, because otherwise the error doesn't show on in fullscreen mode and the game appears to freeze
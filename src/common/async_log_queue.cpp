@@ -0,0 +1,273 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "common/async_log_queue.h"
+
+#include "common/make_unique.h"
+
+#include "common/thread/thread.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+struct CAsyncLogQueue::Ring
+{
+    char data[RING_SIZE];
+    //! Positions grow monotonically, they are wrapped only when indexing data
+    std::atomic<std::size_t> readPos{0};
+    std::atomic<std::size_t> writePos{0};
+    std::atomic<unsigned long> dropped{0};
+    //! Set when the owning thread exits or switches to another queue
+    std::atomic<bool> abandoned{false};
+};
+
+namespace
+{
+
+struct RecordHeader
+{
+    //! Taken from CAsyncLogQueue::m_sequence, orders records across rings
+    std::uint64_t sequence;
+    std::uint32_t length;
+    std::int32_t level;
+};
+
+//! Longer messages are truncated so that a single message never fills a whole ring
+const std::size_t MAX_MESSAGE_LENGTH = CAsyncLogQueue::RING_SIZE / 4;
+
+struct ThreadRing
+{
+    unsigned int queueId = 0;
+    std::shared_ptr<CAsyncLogQueue::Ring> ring;
+
+    ~ThreadRing()
+    {
+        if (ring != nullptr)
+            ring->abandoned.store(true, std::memory_order_release);
+    }
+};
+
+thread_local ThreadRing g_threadRing;
+std::atomic<unsigned int> g_nextQueueId{1};
+
+void CopyToRing(CAsyncLogQueue::Ring& ring, std::size_t pos, const void* src, std::size_t size)
+{
+    std::size_t offset = pos & (CAsyncLogQueue::RING_SIZE - 1);
+    std::size_t first = std::min(size, CAsyncLogQueue::RING_SIZE - offset);
+    memcpy(ring.data + offset, src, first);
+    memcpy(ring.data, static_cast<const char*>(src) + first, size - first);
+}
+
+void CopyFromRing(const CAsyncLogQueue::Ring& ring, std::size_t pos, void* dst, std::size_t size)
+{
+    std::size_t offset = pos & (CAsyncLogQueue::RING_SIZE - 1);
+    std::size_t first = std::min(size, CAsyncLogQueue::RING_SIZE - offset);
+    memcpy(dst, ring.data + offset, first);
+    memcpy(static_cast<char*>(dst) + first, ring.data, size - first);
+}
+
+} // anonymous namespace
+
+CAsyncLogQueue::CAsyncLogQueue(WriteFunction write)
+    : m_write(std::move(write))
+    , m_id(g_nextQueueId++)
+    , m_running(true)
+    , m_dropped(0)
+    , m_sequence(0)
+{
+    static_assert((RING_SIZE & (RING_SIZE - 1)) == 0, "RING_SIZE must be a power of two");
+
+    m_thread = MakeUnique<CThread>([this]() { Run(); }, "Log flush thread");
+    m_thread->Start();
+}
+
+CAsyncLogQueue::~CAsyncLogQueue()
+{
+    m_flushMutex.Lock();
+    m_running = false;
+    m_flushCond.Signal();
+    m_flushMutex.Unlock();
+
+    m_thread->Join();
+
+    Flush();
+}
+
+CAsyncLogQueue::Ring* CAsyncLogQueue::GetRing()
+{
+    if (g_threadRing.queueId == m_id)
+        return g_threadRing.ring.get();
+
+    if (g_threadRing.ring != nullptr)
+        g_threadRing.ring->abandoned.store(true, std::memory_order_release);
+
+    auto ring = std::make_shared<Ring>();
+    m_ringsMutex.Lock();
+    m_rings.push_back(ring);
+    m_ringsMutex.Unlock();
+
+    g_threadRing.queueId = m_id;
+    g_threadRing.ring = ring;
+    return ring.get();
+}
+
+void CAsyncLogQueue::Push(LogLevel level, const char* message, std::size_t length)
+{
+    Ring* ring = GetRing();
+
+    length = std::min(length, MAX_MESSAGE_LENGTH);
+    std::size_t recordSize = sizeof(RecordHeader) + length;
+
+    std::size_t write = ring->writePos.load(std::memory_order_relaxed);
+    std::size_t read = ring->readPos.load(std::memory_order_acquire);
+    if (RING_SIZE - (write - read) < recordSize)
+    {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        m_flushCond.Signal();
+        return;
+    }
+
+    RecordHeader header;
+    header.sequence = m_sequence.fetch_add(1, std::memory_order_relaxed);
+    header.length = static_cast<std::uint32_t>(length);
+    header.level = level;
+    CopyToRing(*ring, write, &header, sizeof(header));
+    CopyToRing(*ring, write + sizeof(header), message, length);
+    ring->writePos.store(write + recordSize, std::memory_order_release);
+
+    if (level == LOG_WARN || level == LOG_ERROR)
+        m_flushCond.Signal();
+}
+
+void CAsyncLogQueue::Flush()
+{
+    m_flushMutex.Lock();
+    Drain(true);
+    m_flushMutex.Unlock();
+}
+
+bool CAsyncLogQueue::TryFlush()
+{
+    if (!m_flushMutex.TryLock())
+        return false;
+
+    bool drained = Drain(false);
+    m_flushMutex.Unlock();
+    return drained;
+}
+
+unsigned long CAsyncLogQueue::GetDroppedCount() const
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+void CAsyncLogQueue::Run()
+{
+    m_flushMutex.Lock();
+    while (m_running)
+    {
+        m_flushCond.WaitTimeout(*m_flushMutex, FLUSH_INTERVAL);
+        Drain(true);
+    }
+    m_flushMutex.Unlock();
+}
+
+bool CAsyncLogQueue::Drain(bool wait)
+{
+    // Work on a copy of the list, so that threads logging for the first time
+    // don't have to wait for the messages to be written
+    if (wait)
+        m_ringsMutex.Lock();
+    else if (!m_ringsMutex.TryLock())
+        return false;
+    std::vector<std::shared_ptr<Ring>> rings = m_rings;
+    m_ringsMutex.Unlock();
+
+    // Only records already pushed when the drain starts are written,
+    // so that a thread logging all the time can't keep the flush busy forever
+    std::vector<bool> abandoned(rings.size());
+    std::vector<std::size_t> ends(rings.size());
+    for (std::size_t i = 0; i < rings.size(); ++i)
+    {
+        abandoned[i] = rings[i]->abandoned.load(std::memory_order_acquire);
+        ends[i] = rings[i]->writePos.load(std::memory_order_acquire);
+    }
+
+    std::vector<char> message;
+    while (true)
+    {
+        // Write the oldest record of all rings
+        Ring* next = nullptr;
+        RecordHeader nextHeader;
+        for (std::size_t i = 0; i < rings.size(); ++i)
+        {
+            Ring& ring = *rings[i];
+            std::size_t read = ring.readPos.load(std::memory_order_relaxed);
+            if (read == ends[i])
+                continue;
+
+            RecordHeader header;
+            CopyFromRing(ring, read, &header, sizeof(header));
+            if (next == nullptr || header.sequence < nextHeader.sequence)
+            {
+                next = &ring;
+                nextHeader = header;
+            }
+        }
+
+        if (next == nullptr)
+            break;
+
+        std::size_t read = next->readPos.load(std::memory_order_relaxed);
+        message.resize(nextHeader.length);
+        CopyFromRing(*next, read + sizeof(nextHeader), message.data(), nextHeader.length);
+        next->readPos.store(read + sizeof(nextHeader) + nextHeader.length, std::memory_order_release);
+
+        m_write(static_cast<LogLevel>(nextHeader.level), message.data(), message.size());
+    }
+
+    for (const auto& ring : rings)
+    {
+        unsigned long dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0)
+        {
+            char text[64];
+            int length = snprintf(text, sizeof(text), "%lu log messages dropped, log queue was full\n", dropped);
+            m_write(LOG_WARN, text, length);
+        }
+    }
+
+    if (std::find(abandoned.begin(), abandoned.end(), true) == abandoned.end())
+        return true;
+
+    // Rings are only ever appended while draining, so the copy is still a prefix of the list
+    if (wait)
+        m_ringsMutex.Lock();
+    else if (!m_ringsMutex.TryLock())
+        return true;
+    for (std::size_t i = rings.size(); i > 0; --i)
+    {
+        if (abandoned[i - 1])
+            m_rings.erase(m_rings.begin() + (i - 1));
+    }
+    m_ringsMutex.Unlock();
+    return true;
+}
@@ -0,0 +1,105 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+/**
+ * \file common/async_log_queue.h
+ * \brief Log queue flushing messages on a background thread
+ */
+
+#pragma once
+
+#include "common/logger.h"
+
+#include "common/thread/sdl_cond_wrapper.h"
+#include "common/thread/sdl_mutex_wrapper.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class CThread;
+
+/**
+ * \class CAsyncLogQueue
+ * \brief Writes log messages on a background thread
+ *
+ * Every thread that logs gets its own single-producer single-consumer ring buffer,
+ * so pushing a message never takes a lock (apart from the first message of each thread,
+ * which registers the ring). The flush thread drains all rings periodically,
+ * and right away after a warning or an error.
+ *
+ * Each message is stamped with a sequence number shared by all threads,
+ * and the flush merges the rings by it, so messages keep the order in which
+ * they were pushed also across threads. The only exception are messages
+ * pushed while a flush is already running, which can end up in the next flush
+ * after a message that was pushed later.
+ *
+ * When a ring is full, the message is dropped and counted instead of blocking the caller.
+ * Drops are reported in the log on the next flush.
+ */
+class CAsyncLogQueue : public CLogQueue
+{
+public:
+    //! Function writing a message to the actual outputs, usually CLogger::Write()
+    using WriteFunction = std::function<void(LogLevel level, const char* message, std::size_t length)>;
+
+    //! Size of each per-thread ring in bytes, must be a power of two
+    static const std::size_t RING_SIZE = 64 * 1024;
+    //! Time between flushes when nothing urgent was logged, in milliseconds
+    static const int FLUSH_INTERVAL = 50;
+
+    explicit CAsyncLogQueue(WriteFunction write);
+    ~CAsyncLogQueue();
+
+    void Push(LogLevel level, const char* message, std::size_t length) override;
+
+    //! Writes all queued messages on the calling thread
+    void Flush() override;
+    //! Like Flush(), but gives up instead of waiting for a flush in progress
+    bool TryFlush() override;
+
+    //! Returns number of messages dropped since creation because a ring was full
+    unsigned long GetDroppedCount() const;
+
+    struct Ring;
+
+private:
+    Ring* GetRing();
+    void Run();
+    /** Drains all rings, must be called with m_flushMutex locked
+     * \param wait - whether to wait for m_ringsMutex, or give up when it is locked
+     * \return \c false if it gave up
+     */
+    bool Drain(bool wait);
+
+private:
+    WriteFunction m_write;
+    const unsigned int m_id;
+
+    CSDLMutexWrapper m_ringsMutex;
+    std::vector<std::shared_ptr<Ring>> m_rings;
+
+    CSDLMutexWrapper m_flushMutex;
+    CSDLCondWrapper m_flushCond;
+    std::atomic<bool> m_running;
+    std::atomic<unsigned long> m_dropped;
+    std::atomic<std::uint64_t> m_sequence;
+    std::unique_ptr<CThread> m_thread;
+};
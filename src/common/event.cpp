@@ -606,74 +606,96 @@ std::string ParseEventType(EventType eventType)
 
 
 CEventQueue::CEventQueue()
-    : m_mutex{},
-      m_fifo(),
-      m_head{0},
-      m_tail{0},
-      m_total{0}
-{}
+    : m_head{nullptr},
+      m_tail{nullptr},
+      m_size{0},
+      m_highWaterMark{0}
+{
+    // The queue always holds one already taken node, so producers never touch the front
+    m_tail = new Node();
+    m_head.store(m_tail);
+}
 
 CEventQueue::~CEventQueue()
-{}
+{
+    while (m_tail != nullptr)
+    {
+        Node* next = m_tail->next.load();
+        delete m_tail;
+        m_tail = next;
+    }
+}
 
 bool CEventQueue::IsEmpty()
 {
-    return m_head == m_tail;
+    return m_tail->next.load(std::memory_order_acquire) == nullptr;
 }
 
-/** If the maximum size of queue has been reached, returns \c false.
-    Else, adds the event to the queue and returns \c true. */
 bool CEventQueue::AddEvent(Event&& event)
 {
-    bool result{};
+    Node* node = new Node();
+    node->event = std::move(event);
 
-    SDL_LockMutex(*m_mutex);
+    int size = m_size.fetch_add(1, std::memory_order_relaxed) + 1;
 
-    if (m_total >= MAX_EVENT_QUEUE)
-    {
-        GetLogger()->Warn("Event queue flood!\n");
+    // Link the node at the end; a consumer sees it once the previous node points to it
+    Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
 
-        result = false;
-    }
-    else
+    int highWaterMark = m_highWaterMark.load(std::memory_order_relaxed);
+    while (size > highWaterMark)
     {
-        m_fifo[m_head++] = std::move(event);
-
-        if (m_head >= MAX_EVENT_QUEUE)
-            m_head = 0;
-
-        m_total++;
-
-        result = true;
+        if (m_highWaterMark.compare_exchange_weak(highWaterMark, size, std::memory_order_relaxed))
+        {
+            if (size == MAX_EVENT_QUEUE + 1)
+                GetLogger()->Warn("Event queue flood!\n");
+            break;
+        }
     }
 
-    SDL_UnlockMutex(*m_mutex);
+    return true;
+}
 
-    return result;
+CEventQueue::Node* CEventQueue::PopNode()
+{
+    Node* next = m_tail->next.load(std::memory_order_acquire);
+    if (next == nullptr)
+        return nullptr;
+
+    delete m_tail;
+    m_tail = next;
+    m_size.fetch_sub(1, std::memory_order_relaxed);
+    return next;
 }
 
 Event CEventQueue::GetEvent()
 {
-    Event event;
-
-    SDL_LockMutex(*m_mutex);
+    Node* node = PopNode();
+    if (node == nullptr)
+        return Event(EVENT_NULL);
 
-    if (m_head == m_tail)
-    {
-        event.type = EVENT_NULL;
-    }
-    else
+    // Only the last position matters, so a flooded queue skips the moves in between
+    if (node->event.type == EVENT_MOUSE_MOVE && GetSize() > MAX_EVENT_QUEUE)
     {
-        event = std::move(m_fifo[m_tail++]);
-
-        if (m_tail >= MAX_EVENT_QUEUE)
-            m_tail = 0;
-
-        m_total--;
+        while (true)
+        {
+            Node* next = m_tail->next.load(std::memory_order_acquire);
+            if (next == nullptr || next->event.type != EVENT_MOUSE_MOVE)
+                break;
 
+            node = PopNode();
+        }
     }
 
-    SDL_UnlockMutex(*m_mutex);
+    return std::move(node->event);
+}
+
+int CEventQueue::GetSize()
+{
+    return m_size.load(std::memory_order_relaxed);
+}
 
-    return event;
+int CEventQueue::GetHighWaterMark()
+{
+    return m_highWaterMark.load(std::memory_order_relaxed);
 }
@@ -27,11 +27,10 @@
 #include "common/key.h"
 #include "common/make_unique.h"
 
-#include "common/thread/sdl_mutex_wrapper.h"
-
 #include "math/point.h"
 #include "math/vector.h"
 
+#include <atomic>
 #include <memory>
 
 /**
@@ -425,6 +424,7 @@ enum EventType
     EVENT_DBG_CRASHSPHERES  = 856,
     EVENT_DBG_LIGHTS        = 857,
     EVENT_DBG_LIGHTS_DUMP   = 858,
+    EVENT_DBG_MODELS_DUMP   = 859,
 
     EVENT_SPAWN_CANCEL      = 860,
     EVENT_SPAWN_ME          = 861,
@@ -908,14 +908,16 @@ std::string ParseEventType(EventType eventType);
  * \brief Global event queue
  *
  * Provides an interface to a global FIFO queue with events (both system- and user-generated).
- * The queue has a fixed maximum size but it should not be a problem.
  *
- * This class is thread-safe
+ * The queue is a lock-free linked list which grows as needed, so no event is ever dropped.
+ * Events may be added from any thread, but only the main thread may take them out.
+ * When more than MAX_EVENT_QUEUE events are waiting, consecutive mouse moves are
+ * coalesced into the last one.
  */
 class CEventQueue
 {
 public:
-    //! Constant maximum size of queue
+    //! Number of waiting events above which the queue is considered flooded
     static const int MAX_EVENT_QUEUE = 100;
 
 public:
@@ -924,17 +926,35 @@ public:
     //! Object's destructor
     ~CEventQueue();
 
-    //! Checks if queue is empty
+    CEventQueue(const CEventQueue&) = delete;
+    CEventQueue& operator=(const CEventQueue&) = delete;
+
+    //! Checks if queue is empty; only for the main thread
     bool IsEmpty();
-    //! Adds an event to the queue
+    //! Adds an event to the queue; always succeeds
     bool AddEvent(Event&& event);
-    //! Removes and returns an event from queue front; if queue is empty, returns event of type EVENT_NULL
+    //! Removes and returns an event from queue front; if queue is empty, returns event of type EVENT_NULL; only for the main thread
     Event GetEvent();
 
+    //! Returns the number of waiting events
+    int GetSize();
+    //! Returns the largest number of events that were waiting at once
+    int GetHighWaterMark();
+
 protected:
-    CSDLMutexWrapper m_mutex;
-    Event        m_fifo[MAX_EVENT_QUEUE];
-    int          m_head;
-    int          m_tail;
-    int          m_total;
+    struct Node
+    {
+        std::atomic<Node*> next{nullptr};
+        Event event;
+    };
+
+    //! Takes the event following the front node, which becomes the new front; nullptr if there is none
+    Node* PopNode();
+
+    //! Last added node, producers append after it
+    std::atomic<Node*> m_head;
+    //! Already taken node, the next one is the queue front; only touched by the main thread
+    Node*              m_tail;
+    std::atomic<int>   m_size;
+    std::atomic<int>   m_highWaterMark;
 };
@@ -190,6 +190,7 @@ void CImage::Free()
 {
     if (m_data != nullptr)
     {
+        FreeMipmaps();
         if (m_data->surface != nullptr)
         {
             SDL_FreeSurface(m_data->surface);
@@ -197,6 +198,23 @@ void CImage::Free()
         }
         m_data.reset();
     }
+    m_storage.reset();
+}
+
+void CImage::FreeMipmaps()
+{
+    for (SDL_Surface* mipmap : m_data->mipmaps)
+        SDL_FreeSurface(mipmap);
+
+    m_data->mipmaps.clear();
+}
+
+void CImage::SetData(std::unique_ptr<ImageData> data, std::shared_ptr<void> storage)
+{
+    Free();
+
+    m_data = std::move(data);
+    m_storage = std::move(storage);
 }
 
 ImageData* CImage::GetData()
@@ -257,6 +275,7 @@ void CImage::BlitToNewRGBASurface(int width, int height)
     assert(convertedSurface != nullptr);
     SDL_BlitSurface(m_data->surface, nullptr, convertedSurface, nullptr);
 
+    FreeMipmaps();
     SDL_FreeSurface(m_data->surface);
 
     m_data->surface = convertedSurface;
@@ -399,7 +418,8 @@ bool CImage::Load(const std::string& fileName)
 
     m_error = "";
 
-    auto file = CResourceManager::GetSDLFileHandler(fileName.c_str());
+    // Decoded straight from the file contents in memory
+    auto file = CResourceManager::GetSDLMemoryHandler(fileName);
     if (!file->IsOpen())
     {
         m_data.reset();
@@ -407,7 +427,7 @@ bool CImage::Load(const std::string& fileName)
         m_error = "Unable to open file";
         return false;
     }
-    m_data->surface = IMG_Load_RW(file->GetHandler(), 1);
+    m_data->surface = IMG_Load_RW(file->GetHandler(), 0);
     if (m_data->surface == nullptr)
     {
         m_data.reset();
@@ -455,6 +475,8 @@ void CImage::SetDataPixels(void *pixels)
         Uint32 pos = line * pitch;
         memcpy(&resultPixels[pos], &srcPixels[pos], pitch);
     }
+
+    FreeMipmaps();
 }
 
 void CImage::FlipVertically()
@@ -482,6 +504,7 @@ void CImage::FlipVertically()
         memcpy(&resultPixels[pos], &srcPixels[(pxLength-pos)-pitch], pitch);
     }
 
+    FreeMipmaps();
     SDL_FreeSurface(m_data->surface);
 
     m_data->surface = result;
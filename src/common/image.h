@@ -30,6 +30,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 
 // Forward declaration without including headers to clutter the code
@@ -42,6 +43,8 @@ struct ImageData
 {
     //! SDL surface with image data
     SDL_Surface* surface = nullptr;
+    //! Precomputed mipmap levels, starting with level 1; empty if they should be generated
+    std::vector<SDL_Surface*> mipmaps;
 };
 
 /**
@@ -112,13 +115,21 @@ public:
     //! sets/replaces the pixels from the surface
     void SetDataPixels(void *pixels);
 
+    //! Replaces the image with given data, which may point into external storage
+    /** The storage is kept alive as long as the image uses the data. */
+    void SetData(std::unique_ptr<ImageData> data, std::shared_ptr<void> storage = nullptr);
+
 private:
     //! Blit to new RGBA surface with given size
     void BlitToNewRGBASurface(int width, int height);
+    //! Frees the precomputed mipmaps, which no longer match the modified image
+    void FreeMipmaps();
 
     //! Last encountered error
     std::string m_error;
     //! Image data
     std::unique_ptr<ImageData> m_data;
+    //! Storage of pixels not owned by the surfaces
+    std::shared_ptr<void> m_storage;
 };
 
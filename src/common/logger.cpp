@@ -22,50 +22,87 @@
 
 #include <stdio.h>
 
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+
+namespace
+{
+
+const char* GetLogLevelPrefix(LogLevel type)
+{
+    switch (type)
+    {
+        case LOG_TRACE:
+            return "[TRACE]: ";
+        case LOG_DEBUG:
+            return "[DEBUG]: ";
+        case LOG_WARN:
+            return "[WARN]: ";
+        case LOG_INFO:
+            return "[INFO]: ";
+        case LOG_ERROR:
+            return "[ERROR]: ";
+        default:
+            return "";
+    }
+}
+
+} // anonymous namespace
+
 CLogger::CLogger()
 {
     #if DEV_BUILD
-    m_logLevel = LOG_DEBUG;
+    SetLogLevel(LOG_DEBUG);
     #else
-    m_logLevel = LOG_INFO;
+    SetLogLevel(LOG_INFO);
     #endif
 }
 
 CLogger::~CLogger()
 {
+    // Flush pending messages before the outputs go away
+    m_queue.reset();
+
     for (FILE* out : m_outputs)
     {
         fclose(out);
     }
 }
 
-void CLogger::Log(LogLevel type, const char* str, va_list args)
+void CLogger::LogV(LogCategory category, LogLevel type, const char* str, va_list args)
 {
-    if (type < m_logLevel)
+    if (!IsEnabled(category, type))
         return;
 
-    for (FILE* out : m_outputs)
+    if (m_queue != nullptr)
     {
-        switch (type)
+        char buffer[512];
+        va_list args2;
+        va_copy(args2, args);
+        int length = vsnprintf(buffer, sizeof(buffer), str, args2);
+        va_end(args2);
+        if (length < 0)
+            return;
+
+        if (static_cast<std::size_t>(length) < sizeof(buffer))
+        {
+            m_queue->Push(type, buffer, length);
+        }
+        else
         {
-            case LOG_TRACE:
-                fprintf(out, "[TRACE]: ");
-                break;
-            case LOG_DEBUG:
-                fprintf(out, "[DEBUG]: ");
-                break;
-            case LOG_WARN:
-                fprintf(out, "[WARN]: ");
-                break;
-            case LOG_INFO:
-                fprintf(out, "[INFO]: ");
-                break;
-            case LOG_ERROR:
-                fprintf(out, "[ERROR]: ");
-                break;
-            default:
-                break;
+            std::vector<char> bigBuffer(length + 1);
+            va_copy(args2, args);
+            vsnprintf(bigBuffer.data(), bigBuffer.size(), str, args2);
+            va_end(args2);
+            m_queue->Push(type, bigBuffer.data(), length);
         }
+        return;
+    }
+
+    for (FILE* out : m_outputs)
+    {
+        fputs(GetLogLevelPrefix(type), out);
 
         va_list args2;
         va_copy(args2, args);
@@ -74,19 +111,47 @@ void CLogger::Log(LogLevel type, const char* str, va_list args)
     }
 }
 
-void CLogger::Trace(const char* str, ...)
+void CLogger::Write(LogLevel level, const char* message, std::size_t length)
+{
+    for (FILE* out : m_outputs)
+    {
+        fputs(GetLogLevelPrefix(level), out);
+        fwrite(message, 1, length, out);
+    }
+}
+
+void CLogger::SetQueue(std::unique_ptr<CLogQueue> queue)
+{
+    m_queue.reset();
+    m_queue = std::move(queue);
+}
+
+void CLogger::Flush()
+{
+    if (m_queue != nullptr)
+        m_queue->Flush();
+}
+
+bool CLogger::TryFlush()
+{
+    if (m_queue != nullptr)
+        return m_queue->TryFlush();
+    return true;
+}
+
+void CLogger::Debug(const char* str, ...)
 {
     va_list args;
     va_start(args, str);
-    Log(LOG_TRACE, str, args);
+    LogV(LOG_CATEGORY_GENERAL, LOG_DEBUG, str, args);
     va_end(args);
 }
 
-void CLogger::Debug(const char* str, ...)
+void CLogger::Debug(LogCategory category, const char* str, ...)
 {
     va_list args;
     va_start(args, str);
-    Log(LOG_DEBUG, str, args);
+    LogV(category, LOG_DEBUG, str, args);
     va_end(args);
 }
 
@@ -94,7 +159,7 @@ void CLogger::Info(const char* str, ...)
 {
     va_list args;
     va_start(args, str);
-    Log(LOG_INFO, str, args);
+    LogV(LOG_CATEGORY_GENERAL, LOG_INFO, str, args);
     va_end(args);
 }
 
@@ -102,7 +167,7 @@ void CLogger::Warn(const char* str, ...)
 {
     va_list args;
     va_start(args, str);
-    Log(LOG_WARN, str, args);
+    LogV(LOG_CATEGORY_GENERAL, LOG_WARN, str, args);
     va_end(args);
 }
 
@@ -110,7 +175,7 @@ void CLogger::Error(const char* str, ...)
 {
     va_list args;
     va_start(args, str);
-    Log(LOG_ERROR, str, args);
+    LogV(LOG_CATEGORY_GENERAL, LOG_ERROR, str, args);
     va_end(args);
 }
 
@@ -118,7 +183,7 @@ void CLogger::Message(const char* str, ...)
 {
     va_list args;
     va_start(args, str);
-    Log(LOG_NONE, str, args);
+    LogV(LOG_CATEGORY_GENERAL, LOG_NONE, str, args);
     va_end(args);
 }
 
@@ -126,7 +191,15 @@ void CLogger::Log(LogLevel logLevel, const char* str, ...)
 {
     va_list args;
     va_start(args, str);
-    Log(logLevel, str, args);
+    LogV(LOG_CATEGORY_GENERAL, logLevel, str, args);
+    va_end(args);
+}
+
+void CLogger::Log(LogCategory category, LogLevel logLevel, const char* str, ...)
+{
+    va_list args;
+    va_start(args, str);
+    LogV(category, logLevel, str, args);
     va_end(args);
 }
 
@@ -138,7 +211,47 @@ void CLogger::AddOutput(FILE* file)
 
 void CLogger::SetLogLevel(LogLevel level)
 {
-    m_logLevel = level;
+    for (int i = 0; i < LOG_CATEGORY_MAX; ++i)
+        m_logLevels[i] = level;
+}
+
+void CLogger::SetLogLevel(LogCategory category, LogLevel level)
+{
+    m_logLevels[category] = level;
+}
+
+bool CLogger::SetLogLevels(const std::string& str)
+{
+    LogLevel levels[LOG_CATEGORY_MAX];
+    std::copy(m_logLevels, m_logLevels + LOG_CATEGORY_MAX, levels);
+
+    std::stringstream stream(str);
+    std::string entry;
+    while (std::getline(stream, entry, ','))
+    {
+        LogLevel level;
+        std::size_t separator = entry.find('=');
+        if (separator == std::string::npos)
+        {
+            if (!ParseLogLevel(entry, level))
+                return false;
+
+            std::fill(levels, levels + LOG_CATEGORY_MAX, level);
+        }
+        else
+        {
+            LogCategory category;
+            if (!ParseLogCategory(entry.substr(0, separator), category))
+                return false;
+            if (!ParseLogLevel(entry.substr(separator + 1), level))
+                return false;
+
+            levels[category] = level;
+        }
+    }
+
+    std::copy(levels, levels + LOG_CATEGORY_MAX, m_logLevels);
+    return true;
 }
 
 bool CLogger::ParseLogLevel(const std::string& str, LogLevel& logLevel)
@@ -177,3 +290,26 @@ bool CLogger::ParseLogLevel(const std::string& str, LogLevel& logLevel)
     return false;
 }
 
+bool CLogger::ParseLogCategory(const std::string& str, LogCategory& category)
+{
+    static const char* const names[LOG_CATEGORY_MAX] =
+    {
+        "general",
+        "graphics",
+        "cbot",
+        "sound",
+        "level",
+        "object",
+    };
+
+    for (int i = 0; i < LOG_CATEGORY_MAX; ++i)
+    {
+        if (str == names[i])
+        {
+            category = static_cast<LogCategory>(i);
+            return true;
+        }
+    }
+
+    return false;
+}
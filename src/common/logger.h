@@ -30,6 +30,7 @@
 #include <string>
 #include <cstdarg>
 #include <cstdio>
+#include <memory>
 #include <vector>
 
 
@@ -48,6 +49,52 @@ enum LogLevel
     LOG_NONE  = 6  /*!< none level, used for custom messages */
 };
 
+/**
+ * \public
+ * \enum    LogCategory common/logger.h
+ * \brief   Subsystem a log message belongs to, each one has its own log level
+**/
+enum LogCategory
+{
+    LOG_CATEGORY_GENERAL = 0, /*!< everything not covered by other categories */
+    LOG_CATEGORY_GRAPHICS,    /*!< graphics engine, textures and models */
+    LOG_CATEGORY_CBOT,        /*!< CBot programs and their storage */
+    LOG_CATEGORY_SOUND,       /*!< sound and music */
+    LOG_CATEGORY_LEVEL,       /*!< level loading and scene management */
+    LOG_CATEGORY_OBJECT,      /*!< game objects */
+    LOG_CATEGORY_MAX
+};
+
+/**
+ * \class CLogQueue
+ * \brief Interface for deferring log output to another thread
+ *
+ * When set on the logger, messages are formatted on the calling thread
+ * and handed over to the queue instead of being written to the outputs directly.
+ * The queue is responsible for eventually passing them to CLogger::Write().
+ */
+class CLogQueue
+{
+public:
+    virtual ~CLogQueue() {}
+
+    /** Queue an already formatted message
+     * \param level - log level of the message
+     * \param message - formatted message, not null-terminated
+     * \param length - length of the message in bytes
+     */
+    virtual void Push(LogLevel level, const char* message, std::size_t length) = 0;
+
+    //! Write all queued messages before returning
+    virtual void Flush() = 0;
+
+    /** Write all queued messages, unless that would mean waiting for another thread
+     * Meant for crash handlers, where the thread holding a lock may be the one that crashed.
+     * \return \c false if the messages could not be written
+     */
+    virtual bool TryFlush() = 0;
+};
+
 
 /**
 * @class CLogger
@@ -68,10 +115,30 @@ public:
     void Message(const char *str, ...);
 
     /** Write message to console or file with LOG_TRACE level
+    * Compiled out entirely when building with NO_LOG_TRACE.
     * \param str - message to write
-    * \param ... - additional arguments
+    * \param args - additional arguments
     */
-    void Trace(const char *str, ...);
+    template<typename... Args>
+    void Trace(const char *str, Args... args)
+    {
+        Trace(LOG_CATEGORY_GENERAL, str, args...);
+    }
+
+    /** Write message in given category with LOG_TRACE level
+    * Compiled out entirely when building with NO_LOG_TRACE.
+    * \param category - category of the message
+    * \param str - message to write
+    * \param args - additional arguments
+    */
+    template<typename... Args>
+    void Trace(LogCategory category, const char *str, Args... args)
+    {
+#ifndef NO_LOG_TRACE
+        if (IsEnabled(category, LOG_TRACE))
+            Log(category, LOG_TRACE, str, args...);
+#endif
+    }
 
     /** Write message to console or file with LOG_DEBUG level
     * \param str - message to write
@@ -79,6 +146,13 @@ public:
     */
     void Debug(const char *str, ...);
 
+    /** Write message in given category with LOG_DEBUG level
+    * \param category - category of the message
+    * \param str - message to write
+    * \param ... - additional arguments
+    */
+    void Debug(LogCategory category, const char *str, ...);
+
     /** Write message to console or file with LOG_INFO level
     * \param str - message to write
     * \param ... - additional arguments
@@ -104,17 +178,74 @@ public:
     */
     void Log(LogLevel logLevel, const char *str, ...);
 
+    /** Write message in given category with given log level
+    * \param category - category of the message
+    * \param logLevel - log level
+    * \param str - message to write
+    * \param ... - additional arguments
+    */
+    void Log(LogCategory category, LogLevel logLevel, const char *str, ...);
+
+    /** Check whether messages of given level in given category would be written
+    * Allows skipping expensive preparation of arguments for disabled messages.
+    */
+    bool IsEnabled(LogCategory category, LogLevel level) const
+    {
+        return level >= m_logLevels[category];
+    }
+
+    /** Write already formatted message to all outputs right away
+    * Used by the log queue to flush queued messages.
+    * \param level - log level of the message
+    * \param message - message to write, not null-terminated
+    * \param length - length of the message in bytes
+    */
+    void Write(LogLevel level, const char* message, std::size_t length);
+
+    /** Set queue that defers writing messages
+    * The previous queue, if any, is destroyed first so that it can flush its messages.
+    * Passing nullptr makes the logger write synchronously again.
+    * \param queue - new queue
+    */
+    void SetQueue(std::unique_ptr<CLogQueue> queue);
+
+    /** Write all messages still waiting in the queue
+    * Does nothing when no queue is set.
+    */
+    void Flush();
+
+    /** Write all messages still waiting in the queue without blocking
+    * Used when crashing; see CLogQueue::TryFlush().
+    * \return \c false if some messages could not be written
+    */
+    bool TryFlush();
+
     /** Set output file to write logs to
     * The given file will be automatically closed when the logger exits
     * \param file - file pointer to write to
     */
     void AddOutput(FILE* file);
 
-    /** Set log level. Logs with level below will not be shown
+    /** Set log level of all categories. Logs with level below will not be shown
     * \param level - minimum log level to write
     */
     void SetLogLevel(LogLevel level);
 
+    /** Set log level of a single category
+    * \param category - category to change
+    * \param level - minimum log level to write
+    */
+    void SetLogLevel(LogCategory category, LogLevel level);
+
+    /** Set log levels from a comma-separated list
+     * \param str string to parse, e.g. "info,sound=trace,graphics=none"
+     *
+     * Entries without a category set the level of all categories,
+     * later entries override earlier ones.
+     * On invalid value, returns \c false and leaves the levels unchanged.
+     */
+    bool SetLogLevels(const std::string& str);
+
     /** Parses string as a log level
      * \param str string to parse
      * \param logLevel result log level
@@ -124,10 +255,20 @@ public:
      */
     static bool ParseLogLevel(const std::string& str, LogLevel& logLevel);
 
+    /** Parses string as a log category
+     * \param str string to parse
+     * \param category result category
+     *
+     * Valid values are "general", "graphics", "cbot", "sound", "level" and "object".
+     * On invalid value, returns \c false.
+     */
+    static bool ParseLogCategory(const std::string& str, LogCategory& category);
+
 private:
     std::vector<FILE*> m_outputs;
-    LogLevel m_logLevel;
-    void Log(LogLevel type, const char* str, va_list args);
+    LogLevel m_logLevels[LOG_CATEGORY_MAX];
+    std::unique_ptr<CLogQueue> m_queue;
+    void LogV(LogCategory category, LogLevel type, const char* str, va_list args);
 };
 
 
@@ -0,0 +1,230 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "common/resources/cache_directory.h"
+
+#include "common/logger.h"
+
+#include "common/resources/mapped_file.h"
+#include "common/resources/outputstream.h"
+#include "common/resources/resourcemanager.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+
+namespace
+{
+
+struct CacheFileHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t keyLength;
+};
+
+//! Returns FNV-1a hash of the string
+uint64_t HashKey(const std::string& key)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : key)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+} // anonymous namespace
+
+
+const std::size_t CCacheDirectory::ALIGNMENT;
+
+CCacheDirectory::CCacheDirectory(const std::string& directory, const char (&magic)[4], uint32_t version)
+    : m_directory(directory)
+    , m_version(version)
+{
+    memcpy(m_magic, magic, sizeof(m_magic));
+
+    std::string saveLocation = CResourceManager::GetSaveLocation();
+    if (saveLocation.empty())
+        return;
+
+    if (!CResourceManager::CreateDirectory(m_directory))
+    {
+        GetLogger()->Warn("Couldn't create cache directory '%s', cache disabled\n", m_directory.c_str());
+        return;
+    }
+
+    m_realDirectory = saveLocation + "/" + m_directory;
+}
+
+bool CCacheDirectory::IsEnabled() const
+{
+    return !m_realDirectory.empty();
+}
+
+std::string CCacheDirectory::GetFileName(const std::string& key)
+{
+    std::stringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << HashKey(key) << ".cache";
+    return name.str();
+}
+
+std::size_t CCacheDirectory::Align(std::size_t offset)
+{
+    return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+bool CCacheDirectory::OpenRead(const std::string& fileName, const std::string& key, CMappedFile& file,
+                               void* header, std::size_t headerSize, std::size_t& offset) const
+{
+    if (!IsEnabled())
+        return false;
+
+    if (!file.Open(m_realDirectory + "/" + fileName))
+        return false;
+
+    const char* data = file.GetData();
+    std::size_t size = file.GetSize();
+
+    CacheFileHeader fileHeader;
+    if (size < sizeof(fileHeader) + key.size() + headerSize)
+    {
+        file.Close();
+        return false;
+    }
+
+    memcpy(&fileHeader, data, sizeof(fileHeader));
+    if (memcmp(fileHeader.magic, m_magic, sizeof(m_magic)) != 0 || fileHeader.version != m_version ||
+        fileHeader.keyLength != key.size() || memcmp(data + sizeof(fileHeader), key.data(), key.size()) != 0)
+    {
+        file.Close();
+        return false;
+    }
+
+    offset = sizeof(fileHeader) + key.size();
+    memcpy(header, data + offset, headerSize);
+    offset += headerSize;
+    return true;
+}
+
+bool CCacheDirectory::OpenWrite(const std::string& fileName, const std::string& key, COutputStream& stream,
+                                const void* header, std::size_t headerSize, std::size_t& offset) const
+{
+    if (!IsEnabled())
+        return false;
+
+    stream.open(m_directory + "/" + fileName);
+    if (!stream.is_open())
+        return false;
+
+    CacheFileHeader fileHeader;
+    memcpy(fileHeader.magic, m_magic, sizeof(m_magic));
+    fileHeader.version = m_version;
+    fileHeader.keyLength = key.size();
+
+    stream.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+    stream.write(key.data(), key.size());
+    stream.write(static_cast<const char*>(header), headerSize);
+
+    offset = sizeof(fileHeader) + key.size() + headerSize;
+    return true;
+}
+
+void CCacheDirectory::WritePadding(COutputStream& stream, std::size_t& offset, std::size_t alignedOffset)
+{
+    const char padding[ALIGNMENT] = {};
+    while (offset < alignedOffset)
+    {
+        std::size_t count = std::min(alignedOffset - offset, ALIGNMENT);
+        stream.write(padding, count);
+        offset += count;
+    }
+}
+
+void CCacheDirectory::Sweep(const std::function<bool(const std::string&)>& isStale, long long sizeLimit) const
+{
+    if (!IsEnabled())
+        return;
+
+    struct CacheFile
+    {
+        std::string path;
+        long long size;
+        long long time;
+    };
+    std::vector<CacheFile> files;
+    long long totalSize = 0;
+    int staleCount = 0;
+
+    for (const std::string& fileName : CResourceManager::ListFiles(m_directory, true))
+    {
+        std::string path = m_directory + "/" + fileName;
+
+        bool stale = true;
+        CMappedFile file;
+        if (file.Open(m_realDirectory + "/" + fileName) && file.GetSize() >= sizeof(CacheFileHeader))
+        {
+            CacheFileHeader fileHeader;
+            memcpy(&fileHeader, file.GetData(), sizeof(fileHeader));
+            if (memcmp(fileHeader.magic, m_magic, sizeof(m_magic)) == 0 && fileHeader.version == m_version &&
+                file.GetSize() >= sizeof(fileHeader) + fileHeader.keyLength)
+            {
+                stale = isStale && isStale(std::string(file.GetData() + sizeof(fileHeader), fileHeader.keyLength));
+            }
+        }
+        file.Close();
+
+        if (stale)
+        {
+            CResourceManager::Remove(path);
+            ++staleCount;
+            continue;
+        }
+
+        CacheFile entry;
+        entry.path = path;
+        entry.size = CResourceManager::GetFileSize(path);
+        entry.time = CResourceManager::GetLastModificationTime(path);
+        files.push_back(entry);
+        totalSize += entry.size;
+    }
+
+    std::sort(files.begin(), files.end(), [](const CacheFile& a, const CacheFile& b) { return a.time < b.time; });
+
+    int evictedCount = 0;
+    for (std::size_t i = 0; i < files.size() && totalSize > sizeLimit; ++i)
+    {
+        if (!CResourceManager::Remove(files[i].path))
+            continue;
+
+        totalSize -= files[i].size;
+        ++evictedCount;
+    }
+
+    if (staleCount > 0 || evictedCount > 0)
+    {
+        GetLogger()->Debug("Cache '%s': removed %d stale and %d old files\n",
+                           m_directory.c_str(), staleCount, evictedCount);
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file common/resources/cache_directory.h
+ * \brief Files of on-disk caches in the save location - CCacheDirectory class
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+class CMappedFile;
+class COutputStream;
+
+
+/**
+ * \class CCacheDirectory
+ * \brief Directory of cache files in the save location
+ *
+ * All cache files start with the same header:
+ *   magic (4 bytes), identifies the kind of cache
+ *   version of the file layout, files with other versions are ignored
+ *   key length
+ *   key (key length bytes, no terminator)
+ *   header of the cache (fixed size, specific to the kind of cache)
+ * Offsets following the header are relative to the start of the file;
+ * Align() gives offsets suitable for data mapped in place.
+ *
+ * A file is found by the hash of its key, see GetFileName(). Different keys
+ * may have the same hash, so the full key is compared when the file is opened.
+ *
+ * The functions do not change the object, they may be called from multiple threads at once.
+ */
+class CCacheDirectory
+{
+public:
+    //! Alignment of the data in cache files
+    static const std::size_t ALIGNMENT = 16;
+
+    //! Creates \a directory in the save location; the cache is disabled if that is not possible
+    CCacheDirectory(const std::string& directory, const char (&magic)[4], uint32_t version);
+
+    //! Returns true if the cache can be used
+    bool IsEnabled() const;
+
+    //! Returns the name of the cache file for the key
+    static std::string GetFileName(const std::string& key);
+    //! Rounds \a offset up to ALIGNMENT
+    static std::size_t Align(std::size_t offset);
+
+    //! Maps the cache file and checks its header and key
+    /**
+     * \param fileName name of the file within the directory
+     * \param key key which the file must have been written with
+     * \param file mapped file, stays open only if the function succeeds
+     * \param header header of the cache, \a headerSize bytes
+     * \param offset set to the end of the header
+     */
+    bool OpenRead(const std::string& fileName, const std::string& key, CMappedFile& file,
+                  void* header, std::size_t headerSize, std::size_t& offset) const;
+    //! Creates the cache file and writes its header
+    /** \a offset is set to the end of the header */
+    bool OpenWrite(const std::string& fileName, const std::string& key, COutputStream& stream,
+                   const void* header, std::size_t headerSize, std::size_t& offset) const;
+    //! Writes zero bytes until \a offset reaches \a alignedOffset
+    static void WritePadding(COutputStream& stream, std::size_t& offset, std::size_t alignedOffset);
+
+    //! Removes stale files, then the oldest files until the total size is at most \a sizeLimit
+    /**
+     * Files of other kinds or versions are stale, as well as those
+     * for which \a isStale returns true; \a isStale receives the key of the file
+     * and may be null. Files are never modified once written, so the oldest files
+     * are those written longest ago.
+     */
+    void Sweep(const std::function<bool(const std::string&)>& isStale, long long sizeLimit) const;
+
+private:
+    //! Directory relative to the save location
+    std::string m_directory;
+    //! Directory in the real file system, empty if the cache is disabled
+    std::string m_realDirectory;
+    char m_magic[4];
+    uint32_t m_version;
+};
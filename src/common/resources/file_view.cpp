@@ -0,0 +1,145 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "common/resources/file_view.h"
+
+#include "common/make_unique.h"
+
+#include "common/resources/resourcemanager.h"
+
+#include <physfs.h>
+
+
+CFileView::CFileView()
+    : m_open(false)
+    , m_data(nullptr)
+    , m_size(0)
+{
+}
+
+CFileView::~CFileView()
+{
+    Close();
+}
+
+bool CFileView::Open(const std::string& filename)
+{
+    Close();
+
+    if (!PHYSFS_isInit())
+        return false;
+
+    m_cachedData = CResourceManager::ReadCachedFile(filename);
+    if (m_cachedData != nullptr)
+    {
+        m_data = m_cachedData->data();
+        m_size = m_cachedData->size();
+        m_open = true;
+        return true;
+    }
+
+    m_open = OpenMapped(filename) || OpenRead(filename);
+    return m_open;
+}
+
+bool CFileView::OpenMapped(const std::string& filename)
+{
+    const char* realDir = PHYSFS_getRealDir(filename.c_str());
+    if (realDir == nullptr)
+        return false;
+
+    // The path inside the location is the path without the mount point
+    std::string path = filename;
+    const char* mountPoint = PHYSFS_getMountPoint(realDir);
+    if (mountPoint != nullptr)
+    {
+        std::string prefix = mountPoint;
+        while (!prefix.empty() && prefix[0] == '/')
+            prefix.erase(0, 1);
+        if (path.compare(0, prefix.size(), prefix) != 0)
+            return false;
+        path.erase(0, prefix.size());
+    }
+
+    // Fails for members of archives, as the location is not a directory then
+    if (!m_mappedFile.Open(std::string(realDir) + "/" + path))
+        return false;
+
+    m_data = m_mappedFile.GetData();
+    m_size = m_mappedFile.GetSize();
+    return true;
+}
+
+bool CFileView::OpenRead(const std::string& filename)
+{
+    PHYSFS_File* file = PHYSFS_openRead(filename.c_str());
+    if (file == nullptr)
+        return false;
+
+    PHYSFS_sint64 length = PHYSFS_fileLength(file);
+    if (length < 0)
+    {
+        PHYSFS_close(file);
+        return false;
+    }
+
+    std::size_t size = static_cast<std::size_t>(length);
+    m_buffer = MakeUniqueArray<char>(size);
+    if (size > 0 && PHYSFS_read(file, m_buffer.get(), 1, size) != length)
+    {
+        PHYSFS_close(file);
+        m_buffer.reset();
+        return false;
+    }
+    PHYSFS_close(file);
+
+    m_data = m_buffer.get();
+    m_size = size;
+    return true;
+}
+
+void CFileView::Close()
+{
+    m_mappedFile.Close();
+    m_buffer.reset();
+    m_cachedData.reset();
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+bool CFileView::IsOpen() const
+{
+    return m_open;
+}
+
+bool CFileView::IsMapped() const
+{
+    return m_mappedFile.IsOpen();
+}
+
+const char* CFileView::GetData() const
+{
+    return m_data;
+}
+
+std::size_t CFileView::GetSize() const
+{
+    return m_size;
+}
@@ -0,0 +1,77 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file common/resources/file_view.h
+ * \brief Read-only view of the whole contents of a resource file
+ */
+
+#pragma once
+
+#include "common/resources/mapped_file.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * \class CFileView
+ * \brief Contents of a file from the search path, available in memory without copying
+ *
+ * Files in plain directories are mapped into memory. Members of archives
+ * are decompressed once into a single buffer owned by the view. Small files
+ * already kept in memory by CResourceManager are shared with it.
+ */
+class CFileView
+{
+public:
+    CFileView();
+    ~CFileView();
+
+    CFileView(const CFileView&) = delete;
+    CFileView& operator=(const CFileView&) = delete;
+
+    //! Opens the file with given (clean) name in the search path
+    bool Open(const std::string& filename);
+    //! Releases the contents
+    void Close();
+
+    bool IsOpen() const;
+    //! Returns true if the contents are mapped from a file in a plain directory
+    bool IsMapped() const;
+
+    //! Returns the contents of the file
+    const char* GetData() const;
+    //! Returns the size of the file in bytes
+    std::size_t GetSize() const;
+
+private:
+    //! Maps the file if it comes from a plain directory
+    bool OpenMapped(const std::string& filename);
+    //! Reads the whole file through PhysFS
+    bool OpenRead(const std::string& filename);
+
+    bool m_open;
+    const char* m_data;
+    std::size_t m_size;
+    CMappedFile m_mappedFile;
+    std::unique_ptr<char[]> m_buffer;
+    std::shared_ptr<const std::vector<char>> m_cachedData;
+};
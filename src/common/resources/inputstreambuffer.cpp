@@ -47,26 +47,42 @@ CInputStreamBuffer::~CInputStreamBuffer()
 
 void CInputStreamBuffer::open(const std::string &filename)
 {
-    if (PHYSFS_isInit())
-        m_file = PHYSFS_openRead(CResourceManager::CleanPath(filename).c_str());
+    if (!PHYSFS_isInit())
+        return;
+
+    m_data = CResourceManager::ReadCachedFile(filename);
+    if (m_data != nullptr)
+    {
+        // the whole file is the get area, the data is never written
+        char* data = const_cast<char*>(m_data->data());
+        setg(data, data, data + m_data->size());
+        return;
+    }
+
+    m_file = PHYSFS_openRead(CResourceManager::CleanPath(filename).c_str());
 }
 
 
 void CInputStreamBuffer::close()
 {
-    if (is_open())
+    if (m_file != nullptr)
         PHYSFS_close(m_file);
+    setg(nullptr, nullptr, nullptr);
+    m_data.reset();
 }
 
 
 bool CInputStreamBuffer::is_open()
 {
-    return m_file != nullptr;
+    return m_file != nullptr || m_data != nullptr;
 }
 
 
 std::size_t CInputStreamBuffer::size()
 {
+    if (m_data != nullptr)
+        return m_data->size();
+
     return PHYSFS_fileLength(m_file);
 }
 
@@ -76,6 +92,9 @@ std::streambuf::int_type CInputStreamBuffer::underflow()
     if (gptr() < egptr())
         return traits_type::to_int_type(*gptr());
 
+    if (m_data != nullptr)
+        return traits_type::eof();
+
     if (PHYSFS_eof(m_file))
         return traits_type::eof();
 
@@ -106,6 +125,33 @@ std::streampos CInputStreamBuffer::seekoff(std::streamoff off, std::ios_base::se
 
     std::streamoff new_position{};
 
+    if (m_data != nullptr)
+    {
+        switch (way)
+        {
+            case std::ios_base::beg:
+                new_position = off;
+                break;
+
+            case std::ios_base::cur:
+                new_position = off + (gptr() - eback());
+                break;
+
+            case std::ios_base::end:
+                new_position = off + static_cast<off_type>(m_data->size());
+                break;
+
+            default:
+                break;
+        }
+
+        if (new_position < 0 || new_position > static_cast<off_type>(m_data->size()))
+            return pos_type(off_type(-1));
+
+        setg(eback(), eback() + new_position, egptr());
+        return pos_type(new_position);
+    }
+
     switch (way)
     {
         case std::ios_base::beg:
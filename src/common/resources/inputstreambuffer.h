@@ -23,6 +23,7 @@
 #include <memory>
 #include <streambuf>
 #include <string>
+#include <vector>
 
 #include <physfs.h>
 
@@ -49,4 +50,6 @@ private:
     const std::size_t m_bufferSize;
     PHYSFS_File *m_file;
     std::unique_ptr<char[]> m_buffer;
+    //! Contents of a small file kept in memory by CResourceManager, read instead of m_file
+    std::shared_ptr<const std::vector<char>> m_data;
 };
@@ -0,0 +1,130 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "common/resources/mapped_file.h"
+
+#include "common/config.h"
+
+#if PLATFORM_WINDOWS
+    #include "common/system/system_windows.h"
+
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+CMappedFile::CMappedFile()
+    : m_data(nullptr)
+    , m_size(0)
+{
+}
+
+CMappedFile::~CMappedFile()
+{
+    Close();
+}
+
+bool CMappedFile::Open(const std::string& path)
+{
+    Close();
+
+#if PLATFORM_WINDOWS
+    HANDLE file = CreateFileW(CSystemUtilsWindows::UTF8_Decode(path).c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+        return false;
+
+    // The view keeps the mapping alive
+    void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == nullptr)
+        return false;
+
+    m_data = static_cast<char*>(data);
+    m_size = static_cast<std::size_t>(size.QuadPart);
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0)
+    {
+        close(file);
+        return false;
+    }
+
+    // The mapping stays valid after closing the file
+    void* data = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED)
+        return false;
+
+    m_data = static_cast<char*>(data);
+    m_size = static_cast<std::size_t>(info.st_size);
+#endif
+
+    return true;
+}
+
+void CMappedFile::Close()
+{
+    if (m_data == nullptr)
+        return;
+
+#if PLATFORM_WINDOWS
+    UnmapViewOfFile(m_data);
+#else
+    munmap(m_data, m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+bool CMappedFile::IsOpen() const
+{
+    return m_data != nullptr;
+}
+
+char* CMappedFile::GetData() const
+{
+    return m_data;
+}
+
+std::size_t CMappedFile::GetSize() const
+{
+    return m_size;
+}
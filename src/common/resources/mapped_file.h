@@ -0,0 +1,61 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file common/resources/mapped_file.h
+ * \brief Read access to files mapped into memory
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * \class CMappedFile
+ * \brief File on the real file system, mapped into memory
+ *
+ * The mapping is private: the data may be modified in memory,
+ * but the changes are never written back to the file.
+ */
+class CMappedFile
+{
+public:
+    CMappedFile();
+    ~CMappedFile();
+
+    CMappedFile(const CMappedFile&) = delete;
+    CMappedFile& operator=(const CMappedFile&) = delete;
+
+    //! Maps the whole file with given path in the real file system
+    bool Open(const std::string& path);
+    //! Unmaps the file
+    void Close();
+
+    bool IsOpen() const;
+
+    //! Returns the mapped data, or nullptr if the file is not open
+    char* GetData() const;
+    //! Returns the size of mapped data in bytes
+    std::size_t GetSize() const;
+
+private:
+    char* m_data;
+    std::size_t m_size;
+};
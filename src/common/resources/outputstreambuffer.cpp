@@ -51,6 +51,12 @@ void COutputStreamBuffer::open(const std::string &filename, std::ios_base::openm
     {
         if ( mode == std::ios_base::out ) m_file = PHYSFS_openWrite(CResourceManager::CleanPath(filename).c_str());
         else if ( mode == std::ios_base::app ) m_file = PHYSFS_openAppend(CResourceManager::CleanPath(filename).c_str());
+
+        if (is_open())
+        {
+            m_filename = filename;
+            CResourceManager::FileChanged(m_filename);
+        }
     }
 }
 
@@ -59,7 +65,11 @@ void COutputStreamBuffer::close()
 {
     sync();
     if (is_open())
+    {
         PHYSFS_close(m_file);
+        m_file = nullptr;
+        CResourceManager::FileChanged(m_filename);
+    }
 }
 
 
@@ -51,4 +51,5 @@ private:
 
     PHYSFS_File *m_file;
     std::unique_ptr<char[]> m_buffer;
+    std::string m_filename;
 };
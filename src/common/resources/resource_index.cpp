@@ -0,0 +1,497 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "common/resources/resource_index.h"
+
+#include "common/config.h"
+#include "common/logger.h"
+#include "common/make_unique.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <physfs.h>
+
+
+namespace
+{
+
+//! Size or time which wasn't asked from PhysFS yet
+const long long UNKNOWN = -2;
+//! Deeper directories are considered symbolic link loops
+const int MAX_DIRECTORY_DEPTH = 32;
+//! Files larger than this are never cached
+const std::size_t MAX_CACHED_FILE_SIZE = 256 * 1024;
+//! Default total size of cached files
+const std::size_t DEFAULT_CACHE_SIZE = 8 * 1024 * 1024;
+//! Number of latest changed paths remembered, reads overlapping older changes are discarded
+const std::size_t MAX_TRACKED_CHANGES = 64;
+
+/* On file systems that ignore case, PhysFS finds paths which differ in case from
+ * the indexed ones, so paths missing in the index must still be checked by PhysFS */
+#if PLATFORM_WINDOWS || PLATFORM_MACOSX
+const bool INDEX_MISSES_ARE_FINAL = false;
+#else
+const bool INDEX_MISSES_ARE_FINAL = true;
+#endif
+
+//! Converts the path to the form used by the index; returns false if it isn't possible
+bool NormalizePath(const std::string& path, std::string& result)
+{
+    result.clear();
+    std::size_t start = 0;
+    while (start <= path.size())
+    {
+        std::size_t end = path.find('/', start);
+        if (end == std::string::npos)
+            end = path.size();
+
+        std::string part = path.substr(start, end - start);
+        if (part == "." || part == ".." || part.find_first_of("\\:") != std::string::npos)
+            return false;
+
+        if (!part.empty())
+        {
+            if (!result.empty())
+                result += '/';
+            result += part;
+        }
+        start = end + 1;
+    }
+    return true;
+}
+
+std::string JoinPath(const std::string& directory, const std::string& name)
+{
+    return directory.empty() ? name : directory + "/" + name;
+}
+
+std::string GetParentPath(const std::string& path)
+{
+    std::size_t slash = path.rfind('/');
+    return slash == std::string::npos ? "" : path.substr(0, slash);
+}
+
+std::string GetFileName(const std::string& path)
+{
+    std::size_t slash = path.rfind('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+long long ReadFileSize(const std::string& path)
+{
+    PHYSFS_File* file = PHYSFS_openRead(path.c_str());
+    if (file == nullptr)
+        return -1;
+    long long size = PHYSFS_fileLength(file);
+    PHYSFS_close(file);
+    return size;
+}
+
+} // anonymous namespace
+
+
+CResourceIndex::Entry::Entry()
+    : size(UNKNOWN),
+      modificationTime(UNKNOWN)
+{
+}
+
+CResourceIndex::CResourceIndex()
+    : m_built(false),
+      m_usable(true),
+      m_generation(0),
+      m_cacheSize(0),
+      m_cacheCapacity(DEFAULT_CACHE_SIZE)
+{
+}
+
+CResourceIndex::~CResourceIndex()
+{
+}
+
+void CResourceIndex::Invalidate()
+{
+    m_mutex.Lock();
+    m_built = false;
+    m_usable = true;
+    m_entries.clear();
+    m_files.clear();
+    m_lru.clear();
+    m_cacheSize = 0;
+    AddChange("");
+    m_mutex.Unlock();
+}
+
+void CResourceIndex::Update(const std::string& path)
+{
+    std::string normalized;
+    if (!NormalizePath(path, normalized))
+    {
+        Invalidate();
+        return;
+    }
+
+    m_mutex.Lock();
+    AddChange(normalized);
+    RemoveCachedFiles(normalized);
+    if (m_built && m_usable)
+    {
+        RemovePath(normalized);
+        if (PHYSFS_exists(normalized.c_str()))
+            AddPath(normalized);
+    }
+    m_mutex.Unlock();
+}
+
+CResourceIndex::Entry* CResourceIndex::Find(const std::string& path)
+{
+    if (!m_built)
+        Build();
+
+    auto it = m_entries.find(path);
+    return it != m_entries.end() ? &it->second : nullptr;
+}
+
+void CResourceIndex::Build()
+{
+    auto start = std::chrono::steady_clock::now();
+
+    m_entries.clear();
+    m_entries[""].directory = true;
+    m_usable = AddDirectory("", 0);
+    m_built = true;
+
+    if (!m_usable)
+    {
+        GetLogger()->Warn("Directories in the search path are too deep, resource index disabled\n");
+        m_entries.clear();
+        return;
+    }
+
+    auto time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    GetLogger()->Debug("Indexed %d resource paths in %d ms\n", static_cast<int>(m_entries.size()),
+                       static_cast<int>(time.count()));
+}
+
+bool CResourceIndex::AddDirectory(const std::string& directory, int depth)
+{
+    if (depth > MAX_DIRECTORY_DEPTH)
+        return false;
+
+    std::vector<std::string> children;
+    char** files = PHYSFS_enumerateFiles(directory.c_str());
+    for (char** i = files; *i != nullptr; ++i)
+        children.push_back(*i);
+    PHYSFS_freeList(files);
+
+    std::sort(children.begin(), children.end());
+
+    for (const std::string& name : children)
+    {
+        std::string path = JoinPath(directory, name);
+        bool isDirectory = PHYSFS_isDirectory(path.c_str()) != 0;
+        m_entries[path].directory = isDirectory;
+        if (isDirectory && !AddDirectory(path, depth + 1))
+            return false;
+    }
+
+    m_entries[directory].children = std::move(children);
+    return true;
+}
+
+void CResourceIndex::AddPath(const std::string& path)
+{
+    bool isDirectory = PHYSFS_isDirectory(path.c_str()) != 0;
+    m_entries[path].directory = isDirectory;
+    if (isDirectory && !AddDirectory(path, 0))
+    {
+        m_usable = false;
+        m_entries.clear();
+        return;
+    }
+
+    // Link the path to its parents, adding the parents which are new
+    std::string child = path;
+    while (!child.empty())
+    {
+        std::string parent = GetParentPath(child);
+        std::string name = GetFileName(child);
+        bool parentExisted = m_entries.find(parent) != m_entries.end();
+
+        Entry& parentEntry = m_entries[parent];
+        parentEntry.directory = true;
+        auto position = std::lower_bound(parentEntry.children.begin(), parentEntry.children.end(), name);
+        if (position == parentEntry.children.end() || *position != name)
+            parentEntry.children.insert(position, name);
+
+        if (parentExisted)
+            break;
+        child = parent;
+    }
+}
+
+void CResourceIndex::RemovePath(const std::string& path)
+{
+    auto it = m_entries.find(path);
+    if (it == m_entries.end())
+        return;
+
+    std::vector<std::string> children = std::move(it->second.children);
+    m_entries.erase(it);
+    for (const std::string& name : children)
+        RemovePath(JoinPath(path, name));
+
+    if (path.empty())
+        return;
+
+    auto parent = m_entries.find(GetParentPath(path));
+    if (parent != m_entries.end())
+    {
+        auto& siblings = parent->second.children;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), GetFileName(path)), siblings.end());
+    }
+}
+
+bool CResourceIndex::Exists(const std::string& path, bool& exists)
+{
+    std::string normalized;
+    if (!NormalizePath(path, normalized))
+        return false;
+
+    m_mutex.Lock();
+    Entry* entry = Find(normalized);
+    bool answered = m_usable && (entry != nullptr || INDEX_MISSES_ARE_FINAL);
+    exists = entry != nullptr;
+    m_mutex.Unlock();
+    return answered;
+}
+
+bool CResourceIndex::IsDirectory(const std::string& path, bool& directory)
+{
+    std::string normalized;
+    if (!NormalizePath(path, normalized))
+        return false;
+
+    m_mutex.Lock();
+    Entry* entry = Find(normalized);
+    bool answered = m_usable && (entry != nullptr || INDEX_MISSES_ARE_FINAL);
+    directory = entry != nullptr && entry->directory;
+    m_mutex.Unlock();
+    return answered;
+}
+
+bool CResourceIndex::List(const std::string& directory, bool files, bool directories, std::vector<std::string>& names)
+{
+    std::string normalized;
+    if (!NormalizePath(directory, normalized))
+        return false;
+
+    m_mutex.Lock();
+    Entry* entry = Find(normalized);
+    bool answered = m_usable && (entry != nullptr || INDEX_MISSES_ARE_FINAL);
+    names.clear();
+    if (answered && entry != nullptr)
+    {
+        for (const std::string& name : entry->children)
+        {
+            auto child = m_entries.find(JoinPath(normalized, name));
+            bool isDirectory = child != m_entries.end() && child->second.directory;
+            if (isDirectory ? directories : files)
+                names.push_back(name);
+        }
+    }
+    m_mutex.Unlock();
+    return answered;
+}
+
+bool CResourceIndex::GetFileSize(const std::string& path, long long& size)
+{
+    std::string normalized;
+    if (!NormalizePath(path, normalized))
+        return false;
+
+    m_mutex.Lock();
+    Entry* entry = Find(normalized);
+    bool answered = m_usable && (entry != nullptr || INDEX_MISSES_ARE_FINAL);
+    size = entry == nullptr || entry->directory ? -1 : entry->size;
+    unsigned int generation = m_generation;
+    m_mutex.Unlock();
+
+    if (!answered || size != UNKNOWN)
+        return answered;
+
+    size = ReadFileSize(normalized);
+
+    m_mutex.Lock();
+    if (!ChangedSince(generation, normalized))
+    {
+        entry = Find(normalized);
+        if (entry != nullptr)
+            entry->size = size;
+    }
+    m_mutex.Unlock();
+    return true;
+}
+
+bool CResourceIndex::GetLastModificationTime(const std::string& path, long long& time)
+{
+    std::string normalized;
+    if (!NormalizePath(path, normalized))
+        return false;
+
+    m_mutex.Lock();
+    Entry* entry = Find(normalized);
+    bool answered = m_usable && (entry != nullptr || INDEX_MISSES_ARE_FINAL);
+    time = entry == nullptr ? -1 : entry->modificationTime;
+    unsigned int generation = m_generation;
+    m_mutex.Unlock();
+
+    if (!answered || time != UNKNOWN)
+        return answered;
+
+    time = PHYSFS_getLastModTime(normalized.c_str());
+
+    m_mutex.Lock();
+    if (!ChangedSince(generation, normalized))
+    {
+        entry = Find(normalized);
+        if (entry != nullptr)
+            entry->modificationTime = time;
+    }
+    m_mutex.Unlock();
+    return true;
+}
+
+void CResourceIndex::SetCacheSize(std::size_t size)
+{
+    m_mutex.Lock();
+    m_cacheCapacity = size;
+    EvictCachedFiles();
+    m_mutex.Unlock();
+}
+
+std::shared_ptr<const std::vector<char>> CResourceIndex::ReadFile(const std::string& path)
+{
+    std::string normalized;
+    if (!NormalizePath(path, normalized))
+        return nullptr;
+
+    m_mutex.Lock();
+    std::shared_ptr<const std::vector<char>> data;
+    auto it = m_files.find(normalized);
+    if (it != m_files.end())
+    {
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lruPosition);
+        data = it->second.data;
+    }
+    std::size_t maxSize = std::min(MAX_CACHED_FILE_SIZE, m_cacheCapacity / 4);
+    unsigned int generation = m_generation;
+    m_mutex.Unlock();
+
+    if (data != nullptr || maxSize == 0)
+        return data;
+
+    long long size = 0;
+    if (!GetFileSize(normalized, size))
+        size = ReadFileSize(normalized);
+    if (size < 0 || static_cast<std::size_t>(size) > maxSize)
+        return nullptr;
+
+    PHYSFS_File* file = PHYSFS_openRead(normalized.c_str());
+    if (file == nullptr)
+        return nullptr;
+
+    auto contents = std::make_shared<std::vector<char>>(size);
+    bool complete = PHYSFS_read(file, contents->data(), 1, size) == size;
+    PHYSFS_close(file);
+    if (!complete)
+        return nullptr;
+
+    m_mutex.Lock();
+    // Changes of other paths, e.g. files written by other threads meanwhile, don't matter
+    if (!ChangedSince(generation, normalized) && m_files.find(normalized) == m_files.end())
+    {
+        m_lru.push_front(normalized);
+        CachedFile& cached = m_files[normalized];
+        cached.data = contents;
+        cached.lruPosition = m_lru.begin();
+        m_cacheSize += contents->size();
+        EvictCachedFiles();
+    }
+    m_mutex.Unlock();
+
+    return contents;
+}
+
+void CResourceIndex::AddChange(const std::string& path)
+{
+    ++m_generation;
+    m_changes.push_back(path);
+    if (m_changes.size() > MAX_TRACKED_CHANGES)
+        m_changes.pop_front();
+}
+
+bool CResourceIndex::ChangedSince(unsigned int generation, const std::string& path) const
+{
+    std::size_t count = m_generation - generation;
+    if (count > m_changes.size())
+        return true;
+
+    // a change of a directory changes the paths in it
+    for (auto it = m_changes.end() - count; it != m_changes.end(); ++it)
+    {
+        if (it->empty() || *it == path ||
+            (path.size() > it->size() && path.compare(0, it->size(), *it) == 0 && path[it->size()] == '/'))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CResourceIndex::RemoveCachedFiles(const std::string& path)
+{
+    // a removed directory takes the files in it with it
+    std::string prefix = path + "/";
+    for (auto it = m_files.begin(); it != m_files.end(); )
+    {
+        if (it->first == path || it->first.compare(0, prefix.size(), prefix) == 0)
+        {
+            m_cacheSize -= it->second.data->size();
+            m_lru.erase(it->second.lruPosition);
+            it = m_files.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void CResourceIndex::EvictCachedFiles()
+{
+    while (m_cacheSize > m_cacheCapacity && !m_lru.empty())
+    {
+        auto it = m_files.find(m_lru.back());
+        m_cacheSize -= it->second.data->size();
+        m_files.erase(it);
+        m_lru.pop_back();
+    }
+}
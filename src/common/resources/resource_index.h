@@ -0,0 +1,123 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file common/resources/resource_index.h
+ * \brief Index of the paths in the search path and cache of small files
+ */
+
+#pragma once
+
+#include "common/thread/sdl_mutex_wrapper.h"
+
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * \class CResourceIndex
+ * \brief Answers queries about files in the search path without asking PhysFS
+ *
+ * The index of all files and directories in the search path is built on the first
+ * query. It must be invalidated when locations are added or removed, and updated
+ * for each path that is written or removed.
+ *
+ * Queries return false if they can't be answered from the index, e.g. for paths
+ * containing "." or "..", and PhysFS must be asked instead.
+ *
+ * Small files may also be kept in memory, up to the cache size; least recently
+ * used files are dropped first.
+ */
+class CResourceIndex
+{
+public:
+    CResourceIndex();
+    ~CResourceIndex();
+
+    CResourceIndex(const CResourceIndex&) = delete;
+    CResourceIndex& operator=(const CResourceIndex&) = delete;
+
+    //! Drops the index and all cached files; the index is built again on the next query
+    void Invalidate();
+    //! Updates the index after the file or directory was written or removed
+    void Update(const std::string& path);
+
+    bool Exists(const std::string& path, bool& exists);
+    bool IsDirectory(const std::string& path, bool& directory);
+    //! Lists the names of files and/or directories in the directory
+    bool List(const std::string& directory, bool files, bool directories, std::vector<std::string>& names);
+    bool GetFileSize(const std::string& path, long long& size);
+    bool GetLastModificationTime(const std::string& path, long long& time);
+
+    //! Sets the maximum total size of cached files in bytes, 0 disables the cache
+    void SetCacheSize(std::size_t size);
+    //! Returns the contents of the file, or nullptr if the file is not small enough to be cached
+    std::shared_ptr<const std::vector<char>> ReadFile(const std::string& path);
+
+private:
+    struct Entry
+    {
+        bool directory = false;
+        long long size;
+        long long modificationTime;
+        //! Sorted names of the files and directories in a directory
+        std::vector<std::string> children;
+
+        Entry();
+    };
+
+    struct CachedFile
+    {
+        std::shared_ptr<const std::vector<char>> data;
+        std::list<std::string>::iterator lruPosition;
+    };
+
+    //! Returns the entry of the path, building the index if needed; must be called with the mutex locked
+    Entry* Find(const std::string& path);
+    void Build();
+    bool AddDirectory(const std::string& directory, int depth);
+    void AddPath(const std::string& path);
+    void RemovePath(const std::string& path);
+    void RemoveCachedFiles(const std::string& path);
+    void EvictCachedFiles();
+    //! Records a change of the path, an empty path changes everything; must be called with the mutex locked
+    void AddChange(const std::string& path);
+    //! Returns true if the path may have changed after the given generation; must be called with the mutex locked
+    bool ChangedSince(unsigned int generation, const std::string& path) const;
+
+    CSDLMutexWrapper m_mutex;
+    bool m_built;
+    //! False if the index couldn't be built, all queries go to PhysFS then
+    bool m_usable;
+    std::unordered_map<std::string, Entry> m_entries;
+    //! Incremented on each change, data of paths read during their change is not kept
+    unsigned int m_generation;
+    //! Paths of the latest changes, the last one made in the current generation
+    std::deque<std::string> m_changes;
+
+    std::unordered_map<std::string, CachedFile> m_files;
+    //! Paths of cached files, the most recently used first
+    std::list<std::string> m_lru;
+    std::size_t m_cacheSize;
+    std::size_t m_cacheCapacity;
+};
@@ -29,11 +29,16 @@
 #include "common/logger.h"
 #include "common/make_unique.h"
 
+#include "common/resources/resource_index.h"
+
 #include <physfs.h>
 
 #include <boost/regex.hpp>
 
 
+std::unique_ptr<CResourceIndex> CResourceManager::m_index;
+
+
 CResourceManager::CResourceManager(const char *argv0)
 {
     if (!PHYSFS_init(argv0))
@@ -42,11 +47,14 @@ CResourceManager::CResourceManager(const char *argv0)
         assert(false);
     }
     PHYSFS_permitSymbolicLinks(1);
+    m_index = MakeUnique<CResourceIndex>();
 }
 
 
 CResourceManager::~CResourceManager()
 {
+    m_index.reset();
+
     if (PHYSFS_isInit())
     {
         if (!PHYSFS_deinit())
@@ -70,6 +78,9 @@ bool CResourceManager::AddLocation(const std::string &location, bool prepend, co
         return false;
     }
 
+    if (m_index != nullptr)
+        m_index->Invalidate();
+
     return true;
 }
 
@@ -82,6 +93,9 @@ bool CResourceManager::RemoveLocation(const std::string &location)
         return false;
     }
 
+    if (m_index != nullptr)
+        m_index->Invalidate();
+
     return true;
 }
 
@@ -102,6 +116,17 @@ bool CResourceManager::LocationExists(const std::string& location)
     return it != locations.cend();
 }
 
+std::string CResourceManager::GetLocation(const std::string &filename)
+{
+    if (PHYSFS_isInit())
+    {
+        const char* location = PHYSFS_getRealDir(CleanPath(filename).c_str());
+        if (location != nullptr)
+            return location;
+    }
+    return "";
+}
+
 bool CResourceManager::SetSaveLocation(const std::string &location)
 {
     if (!PHYSFS_setWriteDir(location.c_str()))
@@ -137,11 +162,22 @@ std::unique_ptr<CSNDFileWrapper> CResourceManager::GetSNDFileHandler(const std::
     return MakeUnique<CSNDFileWrapper>(CleanPath(filename));
 }
 
+std::unique_ptr<CFileView> CResourceManager::GetFileView(const std::string &filename)
+{
+    auto view = MakeUnique<CFileView>();
+    view->Open(CleanPath(filename));
+    return view;
+}
+
 
 bool CResourceManager::Exists(const std::string &filename)
 {
     if (PHYSFS_isInit())
     {
+        bool exists = false;
+        if (m_index != nullptr && m_index->Exists(CleanPath(filename), exists))
+            return exists;
+
         return PHYSFS_exists(CleanPath(filename).c_str());
     }
     return false;
@@ -151,6 +187,10 @@ bool CResourceManager::DirectoryExists(const std::string& directory)
 {
     if (PHYSFS_isInit())
     {
+        bool isDirectory = false;
+        if (m_index != nullptr && m_index->IsDirectory(CleanPath(directory), isDirectory))
+            return isDirectory;
+
         return PHYSFS_exists(CleanPath(directory).c_str()) && PHYSFS_isDirectory(CleanPath(directory).c_str());
     }
     return false;
@@ -160,7 +200,9 @@ bool CResourceManager::CreateDirectory(const std::string& directory)
 {
     if (PHYSFS_isInit())
     {
-        return PHYSFS_mkdir(CleanPath(directory).c_str());
+        bool created = PHYSFS_mkdir(CleanPath(directory).c_str());
+        FileChanged(directory);
+        return created;
     }
     return false;
 }
@@ -170,12 +212,18 @@ bool CResourceManager::RemoveDirectory(const std::string& directory)
     if (PHYSFS_isInit())
     {
         std::string path = CleanPath(directory);
+        bool removed = true;
         for (auto file : ListFiles(path))
         {
             if (PHYSFS_delete((path + "/" + file).c_str()) == 0)
-                return false;
+            {
+                removed = false;
+                break;
+            }
         }
-        return PHYSFS_delete(path.c_str()) != 0;
+        removed = removed && PHYSFS_delete(path.c_str()) != 0;
+        FileChanged(path);
+        return removed;
     }
     return false;
 }
@@ -186,6 +234,9 @@ std::vector<std::string> CResourceManager::ListFiles(const std::string &director
 
     if (PHYSFS_isInit())
     {
+        if (m_index != nullptr && m_index->List(CleanPath(directory), true, !excludeDirs, result))
+            return result;
+
         char **files = PHYSFS_enumerateFiles(CleanPath(directory).c_str());
 
         for (char **i = files; *i != nullptr; i++)
@@ -210,6 +261,9 @@ std::vector<std::string> CResourceManager::ListDirectories(const std::string &di
 
     if (PHYSFS_isInit())
     {
+        if (m_index != nullptr && m_index->List(CleanPath(directory), false, true, result))
+            return result;
+
         char **files = PHYSFS_enumerateFiles(CleanPath(directory).c_str());
 
         for (char **i = files; *i != nullptr; i++)
@@ -231,9 +285,13 @@ long long CResourceManager::GetFileSize(const std::string& filename)
 {
     if (PHYSFS_isInit())
     {
+        long long size = -1;
+        if (m_index != nullptr && m_index->GetFileSize(CleanPath(filename), size))
+            return size;
+
         PHYSFS_File* file = PHYSFS_openRead(CleanPath(filename).c_str());
         if(file == nullptr) return -1;
-        long long size = PHYSFS_fileLength(file);
+        size = PHYSFS_fileLength(file);
         PHYSFS_close(file);
         return size;
     }
@@ -244,6 +302,10 @@ long long CResourceManager::GetLastModificationTime(const std::string& filename)
 {
     if (PHYSFS_isInit())
     {
+        long long time = -1;
+        if (m_index != nullptr && m_index->GetLastModificationTime(CleanPath(filename), time))
+            return time;
+
         return PHYSFS_getLastModTime(CleanPath(filename).c_str());
     }
     return -1;
@@ -253,7 +315,28 @@ bool CResourceManager::Remove(const std::string& filename)
 {
     if (PHYSFS_isInit())
     {
-        return PHYSFS_delete(filename.c_str()) != 0;
+        bool removed = PHYSFS_delete(filename.c_str()) != 0;
+        FileChanged(filename);
+        return removed;
     }
     return false;
 }
+
+void CResourceManager::FileChanged(const std::string& filename)
+{
+    if (m_index != nullptr)
+        m_index->Update(CleanPath(filename));
+}
+
+std::shared_ptr<const std::vector<char>> CResourceManager::ReadCachedFile(const std::string& filename)
+{
+    if (PHYSFS_isInit() && m_index != nullptr)
+        return m_index->ReadFile(CleanPath(filename));
+    return nullptr;
+}
+
+void CResourceManager::SetFileCacheSize(std::size_t size)
+{
+    if (m_index != nullptr)
+        m_index->SetCacheSize(size);
+}
@@ -19,14 +19,18 @@
 
 #pragma once
 
+#include "common/resources/file_view.h"
 #include "common/resources/sdl_file_wrapper.h"
 #include "common/resources/sdl_memory_wrapper.h"
 #include "common/resources/sndfile_wrapper.h"
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
 
+class CResourceIndex;
+
 class CResourceManager
 {
 public:
@@ -43,6 +47,8 @@ public:
     static std::vector<std::string> GetLocations();
     //! Check if given location is in the search path
     static bool LocationExists(const std::string &location);
+    //! Returns the location in the search path the file is read from, or empty string if it doesn't exist
+    static std::string GetLocation(const std::string &filename);
 
     static bool SetSaveLocation(const std::string &location);
     static std::string GetSaveLocation();
@@ -50,6 +56,8 @@ public:
     static std::unique_ptr<CSDLFileWrapper> GetSDLFileHandler(const std::string &filename);
     static std::unique_ptr<CSDLMemoryWrapper> GetSDLMemoryHandler(const std::string &filename);
     static std::unique_ptr<CSNDFileWrapper> GetSNDFileHandler(const std::string &filename);
+    //! Returns a read-only view of the whole file, check IsOpen() for errors
+    static std::unique_ptr<CFileView> GetFileView(const std::string &filename);
 
     //! Check if file exists
     static bool Exists(const std::string &filename);
@@ -74,4 +82,16 @@ public:
 
     //! Remove file
     static bool Remove(const std::string& filename);
+
+    //! Updates the index of files after the file was written outside of CResourceManager
+    static void FileChanged(const std::string& filename);
+    //! Returns the contents of a small file, kept in memory for later reads
+    /** Returns nullptr if the file doesn't exist or is too large to be kept in memory */
+    static std::shared_ptr<const std::vector<char>> ReadCachedFile(const std::string& filename);
+    //! Sets the maximum total size of files kept in memory, 0 disables it
+    static void SetFileCacheSize(std::size_t size);
+
+private:
+    //! Index of paths in the search path, so that queries don't go through all locations
+    static std::unique_ptr<CResourceIndex> m_index;
 };
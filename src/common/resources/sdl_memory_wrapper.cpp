@@ -23,7 +23,7 @@
 #include "common/logger.h"
 #include "common/make_unique.h"
 
-#include <physfs.h>
+#include "common/resources/file_view.h"
 
 
 CSDLMemoryWrapper::CSDLMemoryWrapper(const std::string& filename)
@@ -31,29 +31,14 @@ CSDLMemoryWrapper::CSDLMemoryWrapper(const std::string& filename)
 {
     GetLogger()->Trace("Opening SDL memory wrapper for file '%s'\n", filename.c_str());
 
-    if (!PHYSFS_isInit())
-    {
-        GetLogger()->Error("PHYSFS not initialized!\n");
-        return;
-    }
-
-    PHYSFS_File *file = PHYSFS_openRead(filename.c_str());
-    if (file == nullptr)
+    m_view = MakeUnique<CFileView>();
+    if (!m_view->Open(filename))
     {
         GetLogger()->Error("Error opening file with PHYSFS: \"%s\"\n", filename.c_str());
         return;
     }
 
-    PHYSFS_sint64 length = PHYSFS_fileLength(file);
-    m_buffer = MakeUniqueArray<char>(length);
-    if (PHYSFS_read(file, m_buffer.get(), 1, length) != length)
-    {
-        GetLogger()->Error("Unable to read data for \"%s\"\n", filename.c_str());
-        PHYSFS_close(file);
-        return;
-    }
-    PHYSFS_close(file);
-    m_rwops = SDL_RWFromMem(m_buffer.get(), length);
+    m_rwops = SDL_RWFromConstMem(m_view->GetData(), static_cast<int>(m_view->GetSize()));
 
     if (m_rwops == nullptr)
     {
@@ -65,7 +50,7 @@ CSDLMemoryWrapper::CSDLMemoryWrapper(const std::string& filename)
 CSDLMemoryWrapper::~CSDLMemoryWrapper()
 {
     SDL_FreeRW(m_rwops);
-    m_buffer.reset();
+    m_view.reset();
 }
 
 SDL_RWops* CSDLMemoryWrapper::GetHandler()
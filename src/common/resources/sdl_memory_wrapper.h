@@ -25,6 +25,8 @@
 
 #include <SDL.h>
 
+class CFileView;
+
 class CSDLMemoryWrapper
 {
 public:
@@ -39,5 +41,5 @@ public:
 
 private:
     SDL_RWops* m_rwops;
-    std::unique_ptr<char[]> m_buffer;
+    std::unique_ptr<CFileView> m_view;
 };
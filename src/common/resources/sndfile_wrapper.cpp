@@ -19,27 +19,31 @@
 
 #include "common/resources/sndfile_wrapper.h"
 
+#include "common/make_unique.h"
+
+#include "common/resources/file_view.h"
+
+#include <algorithm>
 #include <cstring>
 
+#include <physfs.h>
+
 
 CSNDFileWrapper::CSNDFileWrapper(const std::string& filename)
     : m_file_info{}
     , m_snd_file{nullptr}
-    , m_file{nullptr}
+    , m_file{MakeUnique<CFileView>()}
+    , m_position{0}
     , m_last_error{}
 {
     m_snd_callbacks = { SNDLength, SNDSeek, SNDRead, SNDWrite, SNDTell };
-    if (PHYSFS_isInit())
-    {
-        m_file = PHYSFS_openRead(filename.c_str());
-    }
-    else
+    if (!PHYSFS_isInit())
     {
         m_last_error = "Resource system not started!";
     }
-    if (m_file)
+    else if (m_file->Open(filename))
     {
-        m_snd_file = sf_open_virtual(&m_snd_callbacks, SFM_READ, &m_file_info, m_file);
+        m_snd_file = sf_open_virtual(&m_snd_callbacks, SFM_READ, &m_file_info, this);
         if (!m_snd_file)
         {
             m_last_error = "Could not load file";
@@ -54,20 +58,16 @@ CSNDFileWrapper::CSNDFileWrapper(const std::string& filename)
 
 CSNDFileWrapper::~CSNDFileWrapper()
 {
-    if (m_file)
+    if (m_snd_file)
     {
-        PHYSFS_close(m_file);
-        if (m_snd_file)
-        {
-            sf_close(m_snd_file);
-        }
+        sf_close(m_snd_file);
     }
 }
 
 
 bool CSNDFileWrapper::IsOpen()
 {
-    return m_file && m_snd_file;
+    return m_file->IsOpen() && m_snd_file;
 }
 
 
@@ -89,45 +89,58 @@ sf_count_t CSNDFileWrapper::Read(short int *ptr, sf_count_t items)
 }
 
 
+sf_count_t CSNDFileWrapper::Seek(sf_count_t frames, int whence)
+{
+    return sf_seek(m_snd_file, frames, whence);
+}
+
+
 sf_count_t CSNDFileWrapper::SNDLength(void *data)
 {
-    return PHYSFS_fileLength(static_cast<PHYSFS_File *>(data));
+    return static_cast<CSNDFileWrapper *>(data)->m_file->GetSize();
 }
 
 
 sf_count_t CSNDFileWrapper::SNDRead(void *ptr, sf_count_t count, void *data)
 {
-    return PHYSFS_read(static_cast<PHYSFS_File *>(data), ptr, 1, count);
+    CSNDFileWrapper *wrapper = static_cast<CSNDFileWrapper *>(data);
+    sf_count_t size = wrapper->m_file->GetSize();
+    count = std::max<sf_count_t>(0, std::min(count, size - wrapper->m_position));
+    memcpy(ptr, wrapper->m_file->GetData() + wrapper->m_position, count);
+    wrapper->m_position += count;
+    return count;
 }
 
 
 sf_count_t CSNDFileWrapper::SNDSeek(sf_count_t offset, int whence, void *data)
 {
-    PHYSFS_File *file = static_cast<PHYSFS_File *>(data);
+    CSNDFileWrapper *wrapper = static_cast<CSNDFileWrapper *>(data);
+    sf_count_t size = wrapper->m_file->GetSize();
     switch(whence)
     {
         case SEEK_CUR:
-            PHYSFS_seek(file, PHYSFS_tell(file) + offset);
-            break;
-        case SEEK_SET:
-            PHYSFS_seek(file, offset);
+            offset += wrapper->m_position;
             break;
         case SEEK_END:
-            PHYSFS_seek(file, PHYSFS_fileLength(file) + offset);
+            offset += size;
             break;
     }
 
-    return PHYSFS_tell(file);
+    if (offset >= 0 && offset <= size)
+        wrapper->m_position = offset;
+
+    return wrapper->m_position;
 }
 
 
 sf_count_t CSNDFileWrapper::SNDTell(void *data)
 {
-    return PHYSFS_tell(static_cast<PHYSFS_File *>(data));
+    return static_cast<CSNDFileWrapper *>(data)->m_position;
 }
 
 
 sf_count_t CSNDFileWrapper::SNDWrite(const void *ptr, sf_count_t count, void *data)
 {
-    return PHYSFS_write(static_cast<PHYSFS_File *>(data), ptr, 1, count);
+    // Sound files are only read
+    return 0;
 }
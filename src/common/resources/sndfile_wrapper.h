@@ -19,11 +19,13 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 
-#include <physfs.h>
 #include <sndfile.h>
 
+class CFileView;
+
 
 class CSNDFileWrapper
 {
@@ -38,6 +40,7 @@ public:
     bool IsOpen();
     std::string &GetLastError();
     sf_count_t Read(short int *ptr, sf_count_t items);
+    sf_count_t Seek(sf_count_t frames, int whence);
 
 private:
     static sf_count_t SNDLength(void *data);
@@ -47,7 +50,9 @@ private:
     static sf_count_t SNDTell(void *data);
     SF_INFO m_file_info;
     SNDFILE *m_snd_file;
-    PHYSFS_File *m_file;
+    //! Encoded contents of the file, decoded in place
+    std::unique_ptr<CFileView> m_file;
+    sf_count_t m_position;
     std::string m_last_error;
     SF_VIRTUAL_IO m_snd_callbacks;
 };
@@ -946,3 +946,29 @@ bool GetResource(ResType type, unsigned int num, std::string& text)
         return true;
     }
 }
+
+// Returns the text of all resources in the current language.
+
+std::string GetAllResourceText()
+{
+    std::string text;
+    auto append = [&text](const char* const* strings, int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            if (strings[i] == nullptr)
+                continue;
+
+            text += gettext(strings[i]);
+            text += '\n';
+        }
+    };
+
+    append(stringsText, RT_MAX);
+    append(stringsEvent, EVENT_STD_MAX);
+    append(stringsObject, OBJECT_MAX);
+    append(stringsErr, ERR_MAX);
+    append(stringsCbot, CBot::CBotErrMAX);
+
+    return text;
+}
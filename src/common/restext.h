@@ -177,3 +177,5 @@ void     InitializeRestext();
 
 void     SetGlobalGamerName(std::string name);
 bool     GetResource(ResType type, unsigned int num, std::string& text);
+//! Returns the text of all resources in the current language, one per line
+std::string GetAllResourceText();
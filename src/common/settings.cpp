@@ -101,6 +101,9 @@ void CSettings::SaveSettings()
     GetConfigFile().SetIntProperty("Setup", "Anisotropy", engine->GetTextureAnisotropyLevel());
     GetConfigFile().SetFloatProperty("Setup", "ShadowColor", engine->GetShadowColor());
     GetConfigFile().SetFloatProperty("Setup", "ShadowRange", engine->GetShadowRange());
+    GetConfigFile().SetFloatProperty("Setup", "LodMediumDistance", engine->GetLodDistance(Gfx::ENG_LOD_MEDIUM));
+    GetConfigFile().SetFloatProperty("Setup", "LodLowDistance", engine->GetLodDistance(Gfx::ENG_LOD_LOW));
+    GetConfigFile().SetFloatProperty("Setup", "ImpostorDistance", engine->GetImpostorDistance());
     GetConfigFile().SetIntProperty("Setup", "MSAA", engine->GetMultiSample());
     GetConfigFile().SetIntProperty("Setup", "FilterMode", engine->GetTextureFilterMode());
     GetConfigFile().SetBoolProperty("Setup", "ShadowMapping", engine->GetShadowMapping());
@@ -260,6 +263,15 @@ void CSettings::LoadSettings()
     if (GetConfigFile().GetFloatProperty("Setup", "ShadowRange", fValue))
         engine->SetShadowRange(fValue);
 
+    if (GetConfigFile().GetFloatProperty("Setup", "LodMediumDistance", fValue))
+        engine->SetLodDistance(Gfx::ENG_LOD_MEDIUM, fValue);
+
+    if (GetConfigFile().GetFloatProperty("Setup", "LodLowDistance", fValue))
+        engine->SetLodDistance(Gfx::ENG_LOD_LOW, fValue);
+
+    if (GetConfigFile().GetFloatProperty("Setup", "ImpostorDistance", fValue))
+        engine->SetImpostorDistance(fValue);
+
     if (GetConfigFile().GetIntProperty("Setup", "MSAA", iValue))
         engine->SetMultiSample(iValue);
 
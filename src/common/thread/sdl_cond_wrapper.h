@@ -52,11 +52,22 @@ public:
         SDL_CondSignal(m_cond);
     }
 
+    void Broadcast()
+    {
+        SDL_CondBroadcast(m_cond);
+    }
+
     void Wait(SDL_mutex* mutex)
     {
         SDL_CondWait(m_cond, mutex);
     }
 
+    //! Waits at most given time in milliseconds, returns false on timeout
+    bool WaitTimeout(SDL_mutex* mutex, unsigned int ms)
+    {
+        return SDL_CondWaitTimeout(m_cond, mutex, ms) == 0;
+    }
+
 private:
     SDL_cond* m_cond;
 };
@@ -50,6 +50,12 @@ public:
         SDL_LockMutex(m_mutex);
     }
 
+    //! Locks the mutex only if it is free, returns true on success
+    bool TryLock()
+    {
+        return SDL_TryLockMutex(m_mutex) == 0;
+    }
+
     void Unlock()
     {
         SDL_UnlockMutex(m_mutex);
@@ -0,0 +1,141 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#pragma once
+
+#include "common/make_unique.h"
+
+#include "common/thread/sdl_cond_wrapper.h"
+#include "common/thread/sdl_mutex_wrapper.h"
+#include "common/thread/thread.h"
+
+#include <functional>
+#include <memory>
+#include <queue>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * \class CWorkerPool
+ * \brief Threads running queued functions in parallel
+ *
+ * Functions are started in the order they were queued. Each queued function gets an id
+ * which can be used to wait until it finishes. Functions still queued when the pool is
+ * destroyed are dropped, the running ones are waited for.
+ */
+class CWorkerPool
+{
+public:
+    using ThreadFunctionPtr = std::function<void()>;
+
+public:
+    CWorkerPool(int threadCount, std::string name = "")
+    {
+        for (int i = 0; i < threadCount; i++)
+        {
+            m_threads.push_back(MakeUnique<CThread>(std::bind(&CWorkerPool::Run, this), name));
+            m_threads.back()->Start();
+        }
+    }
+
+    ~CWorkerPool()
+    {
+        m_mutex.Lock();
+        m_running = false;
+        m_cond.Broadcast();
+        m_mutex.Unlock();
+
+        for (auto& thread : m_threads)
+            thread->Join();
+    }
+
+    //! Queues the function, returns its id
+    int Start(ThreadFunctionPtr func)
+    {
+        m_mutex.Lock();
+        int id = m_nextId++;
+        m_queue.push(Job{id, std::move(func)});
+        m_unfinished.insert(id);
+        m_cond.Signal();
+        m_mutex.Unlock();
+        return id;
+    }
+
+    //! Waits until the function with given id is finished
+    void Wait(int id)
+    {
+        m_mutex.Lock();
+        while (m_unfinished.count(id) > 0)
+            m_finishedCond.Wait(*m_mutex);
+        m_mutex.Unlock();
+    }
+
+    //! Waits until all queued functions are finished
+    void WaitAll()
+    {
+        m_mutex.Lock();
+        while (!m_unfinished.empty())
+            m_finishedCond.Wait(*m_mutex);
+        m_mutex.Unlock();
+    }
+
+    CWorkerPool(const CWorkerPool&) = delete;
+    CWorkerPool& operator=(const CWorkerPool&) = delete;
+
+private:
+    struct Job
+    {
+        int id;
+        ThreadFunctionPtr func;
+    };
+
+    void Run()
+    {
+        m_mutex.Lock();
+        while (true)
+        {
+            while (m_queue.empty() && m_running)
+            {
+                m_cond.Wait(*m_mutex);
+            }
+            if (!m_running) break;
+
+            Job job = std::move(m_queue.front());
+            m_queue.pop();
+
+            m_mutex.Unlock();
+            job.func();
+            m_mutex.Lock();
+
+            m_unfinished.erase(job.id);
+            m_finishedCond.Broadcast();
+        }
+        m_mutex.Unlock();
+    }
+
+    std::vector<std::unique_ptr<CThread>> m_threads;
+    CSDLMutexWrapper m_mutex;
+    CSDLCondWrapper m_cond;
+    CSDLCondWrapper m_finishedCond;
+    bool m_running = true;
+    int m_nextId = 0;
+    std::queue<Job> m_queue;
+    std::set<int> m_unfinished;
+};
@@ -458,6 +458,10 @@ public:
     //! Draws a static buffer
     virtual void DrawStaticBuffer(unsigned int bufferId) = 0;
 
+    //! Draws a static buffer once for each of given world matrices
+    /** The world transform set with SetTransform() is undefined afterwards. */
+    virtual void DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* worldMatrices, int instanceCount) = 0;
+
     //! Deletes a static buffer
     virtual void DestroyStaticBuffer(unsigned int bufferId) = 0;
 
@@ -214,6 +214,10 @@ void CNullDevice::DrawStaticBuffer(unsigned int bufferId)
 {
 }
 
+void CNullDevice::DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* worldMatrices, int instanceCount)
+{
+}
+
 void CNullDevice::DestroyStaticBuffer(unsigned int bufferId)
 {
 }
@@ -101,6 +101,7 @@ public:
     void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount) override;
     void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexCol* vertices, int vertexCount) override;
     void DrawStaticBuffer(unsigned int bufferId) override;
+    void DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* worldMatrices, int instanceCount) override;
     void DestroyStaticBuffer(unsigned int bufferId) override;
 
     int ComputeSphereVisibility(const Math::Vector &center, float radius) override;
@@ -0,0 +1,412 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/core/recordingdevice.h"
+
+#include "common/image.h"
+#include "common/logger.h"
+
+#include <SDL.h>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+CRecordingDevice::CRecordingDevice()
+{
+}
+
+CRecordingDevice::~CRecordingDevice()
+{
+}
+
+std::string CRecordingDevice::GetName()
+{
+    return std::string("Recording Device");
+}
+
+void CRecordingDevice::BeginScene()
+{
+    LogCall("BeginScene");
+    m_sceneStart = std::chrono::steady_clock::now();
+}
+
+void CRecordingDevice::EndScene()
+{
+    LogCall("EndScene");
+    auto time = std::chrono::steady_clock::now() - m_sceneStart;
+    m_frame.cpuTime = std::chrono::duration_cast<std::chrono::microseconds>(time).count();
+
+    if (m_recording)
+        m_history.push_back(m_frame);
+    m_frame = RecordingFrameStats();
+}
+
+void CRecordingDevice::SetTransform(TransformType type, const Math::Matrix &matrix)
+{
+    LogCall("SetTransform");
+    m_frame.transformChanges++;
+}
+
+void CRecordingDevice::SetMaterial(const Material &material)
+{
+    LogCall("SetMaterial");
+    m_frame.materialChanges++;
+}
+
+void CRecordingDevice::SetLight(int index, const Light &light)
+{
+    LogCall("SetLight");
+    m_frame.lightChanges++;
+}
+
+void CRecordingDevice::SetLightEnabled(int index, bool enabled)
+{
+    LogCall("SetLightEnabled");
+    m_frame.lightChanges++;
+}
+
+Texture CRecordingDevice::CreateTexture(CImage *image, const TextureCreateParams &params)
+{
+    LogCall("CreateTexture");
+    RecordTextureUpload(image->GetData());
+    Texture texture = CNullDevice::CreateTexture(image, params);
+    texture.id = m_nextTextureId++;
+    return texture;
+}
+
+Texture CRecordingDevice::CreateTexture(ImageData *data, const TextureCreateParams &params)
+{
+    LogCall("CreateTexture");
+    RecordTextureUpload(data);
+    Texture texture = CNullDevice::CreateTexture(data, params);
+    texture.id = m_nextTextureId++;
+    return texture;
+}
+
+Texture CRecordingDevice::CreateDepthTexture(int width, int height, int depth)
+{
+    LogCall("CreateDepthTexture");
+    Texture texture = CNullDevice::CreateDepthTexture(width, height, depth);
+    texture.id = m_nextTextureId++;
+    return texture;
+}
+
+void CRecordingDevice::UpdateTexture(const Texture& texture, Math::IntPoint offset, ImageData* data, TexImgFormat format)
+{
+    LogCall("UpdateTexture");
+    RecordTextureUpload(data);
+}
+
+void CRecordingDevice::SetTexture(int index, const Texture &texture)
+{
+    LogCall("SetTexture");
+    m_frame.textureChanges++;
+}
+
+void CRecordingDevice::SetTexture(int index, unsigned int textureId)
+{
+    LogCall("SetTexture");
+    m_frame.textureChanges++;
+}
+
+void CRecordingDevice::SetTextureEnabled(int index, bool enabled)
+{
+    LogCall("SetTextureEnabled");
+    m_frame.textureChanges++;
+}
+
+void CRecordingDevice::SetTextureStageParams(int index, const TextureStageParams &params)
+{
+    LogCall("SetTextureStageParams");
+    m_frame.textureChanges++;
+}
+
+void CRecordingDevice::SetTextureStageWrap(int index, TexWrapMode wrapS, TexWrapMode wrapT)
+{
+    LogCall("SetTextureStageWrap");
+    m_frame.textureChanges++;
+}
+
+void CRecordingDevice::DrawPrimitive(PrimitiveType type, const Vertex *vertices, int vertexCount,
+                              Color color)
+{
+    LogCall("DrawPrimitive");
+    RecordDraw(vertexCount);
+    m_frame.vertexUploads += vertexCount;
+    m_frame.bytesTransferred += vertexCount * sizeof(Vertex);
+}
+
+void CRecordingDevice::DrawPrimitive(PrimitiveType type, const VertexTex2 *vertices, int vertexCount,
+                              Color color)
+{
+    LogCall("DrawPrimitive");
+    RecordDraw(vertexCount);
+    m_frame.vertexUploads += vertexCount;
+    m_frame.bytesTransferred += vertexCount * sizeof(VertexTex2);
+}
+
+void CRecordingDevice::DrawPrimitive(PrimitiveType type, const VertexCol *vertices, int vertexCount)
+{
+    LogCall("DrawPrimitive");
+    RecordDraw(vertexCount);
+    m_frame.vertexUploads += vertexCount;
+    m_frame.bytesTransferred += vertexCount * sizeof(VertexCol);
+}
+
+void CRecordingDevice::DrawPrimitives(PrimitiveType type, const Vertex *vertices,
+    int first[], int count[], int drawCount, Color color)
+{
+    LogCall("DrawPrimitives");
+    for (int i = 0; i < drawCount; i++)
+    {
+        RecordDraw(count[i]);
+        m_frame.vertexUploads += count[i];
+        m_frame.bytesTransferred += count[i] * sizeof(Vertex);
+    }
+}
+
+void CRecordingDevice::DrawPrimitives(PrimitiveType type, const VertexTex2 *vertices,
+    int first[], int count[], int drawCount, Color color)
+{
+    LogCall("DrawPrimitives");
+    for (int i = 0; i < drawCount; i++)
+    {
+        RecordDraw(count[i]);
+        m_frame.vertexUploads += count[i];
+        m_frame.bytesTransferred += count[i] * sizeof(VertexTex2);
+    }
+}
+
+void CRecordingDevice::DrawPrimitives(PrimitiveType type, const VertexCol *vertices,
+    int first[], int count[], int drawCount)
+{
+    LogCall("DrawPrimitives");
+    for (int i = 0; i < drawCount; i++)
+    {
+        RecordDraw(count[i]);
+        m_frame.vertexUploads += count[i];
+        m_frame.bytesTransferred += count[i] * sizeof(VertexCol);
+    }
+}
+
+unsigned int CRecordingDevice::CreateStaticBuffer(PrimitiveType primitiveType, const Vertex* vertices, int vertexCount)
+{
+    LogCall("CreateStaticBuffer");
+    return RecordBufferUpload(m_nextBufferId++, vertexCount, sizeof(Vertex));
+}
+
+unsigned int CRecordingDevice::CreateStaticBuffer(PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount)
+{
+    LogCall("CreateStaticBuffer");
+    return RecordBufferUpload(m_nextBufferId++, vertexCount, sizeof(VertexTex2));
+}
+
+unsigned int CRecordingDevice::CreateStaticBuffer(PrimitiveType primitiveType, const VertexCol* vertices, int vertexCount)
+{
+    LogCall("CreateStaticBuffer");
+    return RecordBufferUpload(m_nextBufferId++, vertexCount, sizeof(VertexCol));
+}
+
+void CRecordingDevice::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const Vertex* vertices, int vertexCount)
+{
+    LogCall("UpdateStaticBuffer");
+    RecordBufferUpload(bufferId, vertexCount, sizeof(Vertex));
+}
+
+void CRecordingDevice::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount)
+{
+    LogCall("UpdateStaticBuffer");
+    RecordBufferUpload(bufferId, vertexCount, sizeof(VertexTex2));
+}
+
+void CRecordingDevice::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexCol* vertices, int vertexCount)
+{
+    LogCall("UpdateStaticBuffer");
+    RecordBufferUpload(bufferId, vertexCount, sizeof(VertexCol));
+}
+
+void CRecordingDevice::DrawStaticBuffer(unsigned int bufferId)
+{
+    LogCall("DrawStaticBuffer");
+    auto it = m_bufferVertexCount.find(bufferId);
+    RecordDraw(it != m_bufferVertexCount.end() ? it->second : 0);
+}
+
+void CRecordingDevice::DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* worldMatrices, int instanceCount)
+{
+    LogCall("DrawStaticBufferInstanced");
+    auto it = m_bufferVertexCount.find(bufferId);
+    RecordDraw(it != m_bufferVertexCount.end() ? static_cast<long long>(it->second) * instanceCount : 0);
+    m_frame.instances += instanceCount;
+    m_frame.bytesTransferred += instanceCount * sizeof(Math::Matrix);
+}
+
+void CRecordingDevice::DestroyStaticBuffer(unsigned int bufferId)
+{
+    LogCall("DestroyStaticBuffer");
+    m_bufferVertexCount.erase(bufferId);
+}
+
+void CRecordingDevice::SetRenderState(RenderState state, bool enabled)
+{
+    LogCall("SetRenderState");
+    m_frame.stateChanges++;
+}
+
+void CRecordingDevice::SetColorMask(bool red, bool green, bool blue, bool alpha)
+{
+    LogCall("SetColorMask");
+    m_frame.stateChanges++;
+}
+
+void CRecordingDevice::SetDepthTestFunc(CompFunc func)
+{
+    LogCall("SetDepthTestFunc");
+    m_frame.stateChanges++;
+}
+
+void CRecordingDevice::SetDepthBias(float factor, float units)
+{
+    LogCall("SetDepthBias");
+    m_frame.stateChanges++;
+}
+
+void CRecordingDevice::SetAlphaTestFunc(CompFunc func, float refValue)
+{
+    LogCall("SetAlphaTestFunc");
+    m_frame.stateChanges++;
+}
+
+void CRecordingDevice::SetBlendFunc(BlendFunc srcBlend, BlendFunc dstBlend)
+{
+    LogCall("SetBlendFunc");
+    m_frame.stateChanges++;
+}
+
+void CRecordingDevice::SetGlobalAmbient(const Color &color)
+{
+    LogCall("SetGlobalAmbient");
+    m_frame.stateChanges++;
+}
+
+void CRecordingDevice::SetFogParams(FogMode mode, const Color &color, float start, float end, float density)
+{
+    LogCall("SetFogParams");
+    m_frame.stateChanges++;
+}
+
+void CRecordingDevice::SetCullMode(CullMode mode)
+{
+    LogCall("SetCullMode");
+    m_frame.stateChanges++;
+}
+
+void CRecordingDevice::SetShadeModel(ShadeModel model)
+{
+    LogCall("SetShadeModel");
+    m_frame.stateChanges++;
+}
+
+void CRecordingDevice::SetFillMode(FillMode mode)
+{
+    LogCall("SetFillMode");
+    m_frame.stateChanges++;
+}
+
+void CRecordingDevice::SetCallLogging(bool enabled)
+{
+    m_callLogging = enabled;
+}
+
+void CRecordingDevice::SetRecording(bool enabled)
+{
+    m_recording = enabled;
+}
+
+const RecordingFrameStats& CRecordingDevice::GetCurrentFrameStats()
+{
+    return m_frame;
+}
+
+const std::vector<RecordingFrameStats>& CRecordingDevice::GetFrameHistory()
+{
+    return m_history;
+}
+
+void CRecordingDevice::ClearFrameHistory()
+{
+    m_history.clear();
+}
+
+void CRecordingDevice::WriteFrameHistoryJson(std::ostream& stream)
+{
+    stream << "[\n";
+    for (std::size_t i = 0; i < m_history.size(); i++)
+    {
+        const RecordingFrameStats& frame = m_history[i];
+        stream << "  {\"frame\": " << i
+               << ", \"drawCalls\": " << frame.drawCalls
+               << ", \"vertices\": " << frame.vertices
+               << ", \"instances\": " << frame.instances
+               << ", \"stateChanges\": " << frame.stateChanges
+               << ", \"textureChanges\": " << frame.textureChanges
+               << ", \"transformChanges\": " << frame.transformChanges
+               << ", \"materialChanges\": " << frame.materialChanges
+               << ", \"lightChanges\": " << frame.lightChanges
+               << ", \"vertexUploads\": " << frame.vertexUploads
+               << ", \"bufferUploads\": " << frame.bufferUploads
+               << ", \"textureUploads\": " << frame.textureUploads
+               << ", \"bytesTransferred\": " << frame.bytesTransferred
+               << ", \"cpuTimeUs\": " << frame.cpuTime
+               << "}" << (i + 1 < m_history.size() ? "," : "") << "\n";
+    }
+    stream << "]\n";
+}
+
+void CRecordingDevice::RecordDraw(long long vertexCount)
+{
+    m_frame.drawCalls++;
+    m_frame.vertices += vertexCount;
+}
+
+unsigned int CRecordingDevice::RecordBufferUpload(unsigned int bufferId, int vertexCount, std::size_t vertexSize)
+{
+    m_bufferVertexCount[bufferId] = vertexCount;
+    m_frame.bufferUploads++;
+    m_frame.bytesTransferred += vertexCount * vertexSize;
+    return bufferId;
+}
+
+void CRecordingDevice::RecordTextureUpload(ImageData* data)
+{
+    m_frame.textureUploads++;
+    if (data != nullptr && data->surface != nullptr)
+        m_frame.bytesTransferred += data->surface->h * data->surface->pitch;
+}
+
+void CRecordingDevice::LogCall(const char* name)
+{
+    if (m_callLogging)
+        GetLogger()->Debug("CRecordingDevice: %s\n", name);
+}
+
+
+} // namespace Gfx
@@ -0,0 +1,185 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file graphics/core/recordingdevice.h
+ * \brief Device implementation that records statistics of the rendering calls - CRecordingDevice class
+ */
+
+#pragma once
+
+#include "graphics/core/nulldevice.h"
+
+#include <chrono>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+/**
+ * \struct RecordingFrameStats
+ * \brief Statistics of the calls made to CRecordingDevice during one frame
+ */
+struct RecordingFrameStats
+{
+    //! Number of draw calls, both immediate and from static buffers
+    int drawCalls = 0;
+    //! Number of vertices drawn
+    long long vertices = 0;
+    //! Number of instances drawn with instanced draw calls
+    int instances = 0;
+    //! Number of render state changes (SetRenderState, blending, depth, fog, culling, ...)
+    int stateChanges = 0;
+    //! Number of texture changes (SetTexture, SetTextureEnabled, texture stage parameters)
+    int textureChanges = 0;
+    //! Number of SetTransform() calls
+    int transformChanges = 0;
+    //! Number of SetMaterial() calls
+    int materialChanges = 0;
+    //! Number of light updates
+    int lightChanges = 0;
+    //! Number of vertices sent with immediate draw calls
+    long long vertexUploads = 0;
+    //! Number of static buffers created or updated
+    int bufferUploads = 0;
+    //! Number of textures created or updated
+    int textureUploads = 0;
+    //! Bytes of vertex and texture data sent to the device
+    long long bytesTransferred = 0;
+    //! CPU time spent between BeginScene() and EndScene(), in microseconds
+    long long cpuTime = 0;
+};
+
+/**
+ * \class CRecordingDevice
+ * \brief Device implementation that doesn't render anything, but counts the calls made to it
+ *
+ * Used to measure the CPU side of rendering without a GPU (-graphics record).
+ * The statistics are collected for each frame, ended by EndScene().
+ */
+class CRecordingDevice : public CNullDevice
+{
+public:
+    CRecordingDevice();
+    virtual ~CRecordingDevice();
+
+    std::string GetName() override;
+
+    void BeginScene() override;
+    void EndScene() override;
+
+    void SetTransform(TransformType type, const Math::Matrix &matrix) override;
+
+    void SetMaterial(const Material &material) override;
+
+    void SetLight(int index, const Light &light) override;
+    void SetLightEnabled(int index, bool enabled) override;
+
+    Texture CreateTexture(CImage *image, const TextureCreateParams &params) override;
+    Texture CreateTexture(ImageData *data, const TextureCreateParams &params) override;
+    Texture CreateDepthTexture(int width, int height, int depth) override;
+    void UpdateTexture(const Texture& texture, Math::IntPoint offset, ImageData* data, TexImgFormat format) override;
+
+    void SetTexture(int index, const Texture &texture) override;
+    void SetTexture(int index, unsigned int textureId) override;
+    void SetTextureEnabled(int index, bool enabled) override;
+    void SetTextureStageParams(int index, const TextureStageParams &params) override;
+    void SetTextureStageWrap(int index, Gfx::TexWrapMode wrapS, Gfx::TexWrapMode wrapT) override;
+
+    void DrawPrimitive(PrimitiveType type, const Vertex* vertices, int vertexCount, Color color = Color(1.0f, 1.0f, 1.0f, 1.0f)) override;
+    void DrawPrimitive(PrimitiveType type, const VertexTex2* vertices, int vertexCount, Color color = Color(1.0f, 1.0f, 1.0f, 1.0f)) override;
+    void DrawPrimitive(PrimitiveType type, const VertexCol *vertices, int vertexCount) override;
+
+    void DrawPrimitives(PrimitiveType type, const Vertex *vertices,
+        int first[], int count[], int drawCount,
+        Color color = Color(1.0f, 1.0f, 1.0f, 1.0f)) override;
+    void DrawPrimitives(PrimitiveType type, const VertexTex2 *vertices,
+        int first[], int count[], int drawCount,
+        Color color = Color(1.0f, 1.0f, 1.0f, 1.0f)) override;
+    void DrawPrimitives(PrimitiveType type, const VertexCol *vertices,
+        int first[], int count[], int drawCount) override;
+
+    unsigned int CreateStaticBuffer(PrimitiveType primitiveType, const Vertex* vertices, int vertexCount) override;
+    unsigned int CreateStaticBuffer(PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount) override;
+    unsigned int CreateStaticBuffer(PrimitiveType primitiveType, const VertexCol* vertices, int vertexCount) override;
+    void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const Vertex* vertices, int vertexCount) override;
+    void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount) override;
+    void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexCol* vertices, int vertexCount) override;
+    void DrawStaticBuffer(unsigned int bufferId) override;
+    void DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* worldMatrices, int instanceCount) override;
+    void DestroyStaticBuffer(unsigned int bufferId) override;
+
+    void SetRenderState(RenderState state, bool enabled) override;
+    void SetColorMask(bool red, bool green, bool blue, bool alpha) override;
+    void SetDepthTestFunc(CompFunc func) override;
+    void SetDepthBias(float factor, float units) override;
+    void SetAlphaTestFunc(CompFunc func, float refValue) override;
+    void SetBlendFunc(BlendFunc srcBlend, BlendFunc dstBlend) override;
+    void SetGlobalAmbient(const Color &color) override;
+    void SetFogParams(FogMode mode, const Color &color, float start, float end, float density) override;
+    void SetCullMode(CullMode mode) override;
+    void SetShadeModel(ShadeModel model) override;
+    void SetFillMode(FillMode mode) override;
+
+    //! Enables logging of every call made to the device
+    void SetCallLogging(bool enabled);
+
+    //! Returns the statistics of the frame being rendered
+    const RecordingFrameStats& GetCurrentFrameStats();
+    //! Starts or stops adding the statistics of rendered frames to the history
+    void SetRecording(bool enabled);
+    //! Returns the statistics of the frames recorded since the last ClearFrameHistory()
+    const std::vector<RecordingFrameStats>& GetFrameHistory();
+    //! Forgets the statistics of the frames rendered so far
+    void ClearFrameHistory();
+
+    //! Writes the frame history as a JSON array of objects
+    void WriteFrameHistoryJson(std::ostream& stream);
+
+private:
+    //! Counts a draw call of \a vertexCount vertices
+    void RecordDraw(long long vertexCount);
+    //! Counts a static buffer upload
+    unsigned int RecordBufferUpload(unsigned int bufferId, int vertexCount, std::size_t vertexSize);
+    //! Counts a texture upload
+    void RecordTextureUpload(ImageData* data);
+    //! Logs the call if enabled
+    void LogCall(const char* name);
+
+private:
+    bool m_callLogging = false;
+    bool m_recording = false;
+    RecordingFrameStats m_frame;
+    std::vector<RecordingFrameStats> m_history;
+    std::chrono::steady_clock::time_point m_sceneStart;
+
+    //! Next texture id, so that the engine can tell textures apart
+    unsigned int m_nextTextureId = 1;
+    //! Next static buffer id
+    unsigned int m_nextBufferId = 1;
+    //! Vertex count of every static buffer
+    std::unordered_map<unsigned int, int> m_bufferVertexCount;
+};
+
+
+} // namespace Gfx
@@ -28,6 +28,7 @@
 #include "common/logger.h"
 #include "common/make_unique.h"
 #include "common/profiler.h"
+#include "common/restext.h"
 #include "common/stringutils.h"
 
 #include "common/system/system.h"
@@ -47,6 +48,8 @@
 #include "graphics/engine/pyro_manager.h"
 #include "graphics/engine/terrain.h"
 #include "graphics/engine/text.h"
+#include "graphics/engine/texture_atlas.h"
+#include "graphics/engine/texture_loader.h"
 #include "graphics/engine/water.h"
 
 #include "graphics/model/model_mesh.h"
@@ -60,6 +63,9 @@
 
 #include "ui/controls/interface.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iomanip>
 #include <SDL_surface.h>
 #include <SDL_thread.h>
@@ -196,6 +202,11 @@ CEngine::CEngine(CApplication *app, CSystemUtils* systemUtils)
     m_qualityShadows = true;
     m_terrainShadows = false;
     m_shadowRange = 0.0f;
+    m_lodDistance[ENG_LOD_MEDIUM] = 100.0f;
+    m_lodDistance[ENG_LOD_LOW] = 200.0f;
+    m_impostorDistance = 300.0f;
+    m_impostorsSupported = true;
+    m_impostorsDirty = false;
     m_multisample = 2;
     m_vsync = 0;
 
@@ -237,6 +248,12 @@ CEngine::CEngine(CApplication *app, CSystemUtils* systemUtils)
 
     m_lastState = -1;
     m_statisticTriangle = 0;
+    m_statisticTriangleSaved = 0;
+    m_statisticLodObjects = 0;
+    m_statisticImpostors = 0;
+    m_statisticInterfaceStrips = 0;
+    m_statisticInterfaceDraws = 0;
+    m_currentTexScale = Math::Point(1.0f, 1.0f);
     m_fps = 0.0f;
     m_firstGroundSpot = false;
 }
@@ -335,6 +352,8 @@ bool CEngine::Create()
     m_cloud      = MakeUnique<CCloud>(this);
     m_lightning  = MakeUnique<CLightning>(this);
     m_planet     = MakeUnique<CPlanet>(this);
+    m_textureLoader = MakeUnique<CTextureLoader>();
+    m_textureAtlas = MakeUnique<CTextureAtlas>(m_device);
 
     m_lightMan->SetDevice(m_device);
     m_particle->SetDevice(m_device);
@@ -346,6 +365,7 @@ bool CEngine::Create()
         GetLogger()->Error("Error creating CText: %s\n", error.c_str());
         return false;
     }
+    PrewarmText();
 
     m_device->SetClearColor(Color(0.0f, 0.0f, 0.0f, 0.0f));
     m_device->SetShadeModel(SHADE_SMOOTH);
@@ -364,6 +384,8 @@ bool CEngine::Create()
     params.mipmap = false;
     m_miceTexture = LoadTexture("textures/interface/mouse.png", params);
 
+    BuildTextureAtlas();
+
     m_systemUtils->GetCurrentTimeStamp(m_currentFrameTime);
     m_systemUtils->GetCurrentTimeStamp(m_lastFrameTime);
 
@@ -391,6 +413,8 @@ void CEngine::Destroy()
     m_cloud.reset();
     m_lightning.reset();
     m_planet.reset();
+    m_textureLoader.reset();
+    m_textureAtlas.reset();
 }
 
 void CEngine::ResetAfterVideoConfigChanged()
@@ -402,6 +426,14 @@ void CEngine::ResetAfterVideoConfigChanged()
 
     // This needs to be recreated on resolution change
     m_device->DeleteFramebuffer("multisample");
+
+    // Font sizes depend on the window size
+    PrewarmText();
+}
+
+void CEngine::PrewarmText()
+{
+    m_text->PrewarmGlyphs(GetAllResourceText());
 }
 
 void CEngine::ReloadAllTextures()
@@ -409,6 +441,7 @@ void CEngine::ReloadAllTextures()
     FlushTextureCache();
     m_text->FlushCache();
     m_text->ReloadFonts();
+    PrewarmText();
 
     m_app->GetEventQueue()->AddEvent(Event(EVENT_RELOAD_TEXTURES));
     UpdateGroundSpotTextures();
@@ -541,6 +574,12 @@ bool CEngine::GetShowStats()
     return m_showStats;
 }
 
+void CEngine::SetTextBenchmark(bool enable)
+{
+    m_textBenchmark = enable;
+    m_textBenchmarkFrame = 0;
+}
+
 void CEngine::SetRenderEnable(bool enable)
 {
     m_render = enable;
@@ -665,6 +704,7 @@ int CEngine::CreateBaseObject()
 
 
     m_baseObjects[baseObjRank].used = true;
+    MarkBaseObjectTreeDirty(baseObjRank);
 
     return baseObjRank;
 }
@@ -685,14 +725,22 @@ void CEngine::DeleteBaseObject(int baseObjRank)
         for (int l3 = 0; l3 < static_cast<int>( p2.next.size() ); l3++)
         {
             EngineBaseObjDataTier& p3 = p2.next[l3];
-            m_device->DestroyStaticBuffer(p3.staticBufferId);
-            p3.staticBufferId = 0;
+
+            // The static buffer still belongs to the copies sharing this geometry
+            if (p3.geometry.use_count() > 1)
+                continue;
+
+            m_device->DestroyStaticBuffer(p3.geometry->staticBufferId);
+            p3.geometry->staticBufferId = 0;
         }
     }
 
     p1.next.clear();
 
+    ReleaseImpostor(baseObjRank);
+
     p1.used = false;
+    MarkBaseObjectTreeDirty(baseObjRank);
 }
 
 void CEngine::DeleteAllBaseObjects()
@@ -710,13 +758,24 @@ void CEngine::DeleteAllBaseObjects()
             for (int l3 = 0; l3 < static_cast<int>( p2.next.size() ); l3++)
             {
                 EngineBaseObjDataTier& p3 = p2.next[l3];
-                m_device->DestroyStaticBuffer(p3.staticBufferId);
-                p3.staticBufferId = 0;
+
+                // Shared geometry is visited once per copy
+                if (p3.geometry->staticBufferId == 0)
+                    continue;
+
+                m_device->DestroyStaticBuffer(p3.geometry->staticBufferId);
+                p3.geometry->staticBufferId = 0;
             }
         }
     }
 
     m_baseObjects.clear();
+
+    m_impostorSlots.assign(m_impostorSlots.size(), -1);
+    m_impostorReady.assign(m_impostorReady.size(), false);
+
+    for (int objRank = 0; objRank < static_cast<int>( m_objects.size() ); objRank++)
+        MarkObjectTreeDirty(objRank);
 }
 
 void CEngine::CopyBaseObject(int sourceBaseObjRank, int destBaseObjRank)
@@ -724,21 +783,65 @@ void CEngine::CopyBaseObject(int sourceBaseObjRank, int destBaseObjRank)
     assert(sourceBaseObjRank >= 0 && sourceBaseObjRank < static_cast<int>( m_baseObjects.size() ));
     assert(destBaseObjRank >= 0 && destBaseObjRank < static_cast<int>( m_baseObjects.size() ));
 
+    ReleaseImpostor(destBaseObjRank);
+
     m_baseObjects[destBaseObjRank] = m_baseObjects[sourceBaseObjRank];
+    MarkBaseObjectTreeDirty(destBaseObjRank);
 
     EngineBaseObject& p1 = m_baseObjects[destBaseObjRank];
 
-    if (! p1.used)
-        return;
+    // Copies are made to alter textures or geometry, which the shared
+    // reduced detail versions and the impostor would not reflect
+    for (int lodLevel = 0; lodLevel < ENG_LOD_COUNT; lodLevel++)
+        p1.lodBaseObjRank[lodLevel] = -1;
+
+    p1.impostorSlot = -1;
+
+    // The geometry and its static buffer stay shared with the source
+    // until one of the copies modifies its vertices
+}
+
+void CEngine::ChangeBaseObjTexture(int baseObjRank, const std::string& tex1Name, const std::string& newTex1Name)
+{
+    assert(baseObjRank >= 0 && baseObjRank < static_cast<int>( m_baseObjects.size() ));
+
+    EngineBaseObject& p1 = m_baseObjects[baseObjRank];
 
     for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
     {
         EngineBaseObjTexTier& p2 = p1.next[l2];
+        if (p2.tex1Name != tex1Name)
+            continue;
 
-        for (int l3 = 0; l3 < static_cast<int>( p2.next.size() ); l3++)
+        // The texture is loaded with the others by LoadAllTextures()
+        p2.tex1Name = newTex1Name;
+        p2.tex1 = Texture();
+        PrefetchTexture("textures/"+newTex1Name);
+    }
+
+    ReleaseImpostor(baseObjRank);
+}
+
+void CEngine::GetBaseObjectMemory(int baseObjRank, std::size_t& uniqueBytes, std::size_t& sharedBytes)
+{
+    assert(baseObjRank >= 0 && baseObjRank < static_cast<int>( m_baseObjects.size() ));
+
+    uniqueBytes = 0;
+    sharedBytes = 0;
+
+    const EngineBaseObject& p1 = m_baseObjects[baseObjRank];
+    if (! p1.used)
+        return;
+
+    for (const EngineBaseObjTexTier& p2 : p1.next)
+    {
+        for (const EngineBaseObjDataTier& p3 : p2.next)
         {
-            EngineBaseObjDataTier& p3 = p2.next[l3];
-            p3.staticBufferId = 0;
+            std::size_t bytes = p3.geometry->vertices.size() * sizeof(VertexTex2);
+            if (p3.geometry.use_count() > 1)
+                sharedBytes += bytes;
+            else
+                uniqueBytes += bytes;
         }
     }
 }
@@ -753,9 +856,10 @@ void CEngine::AddBaseObjTriangles(int baseObjRank, const std::vector<VertexTex2>
     EngineBaseObjTexTier&  p2 = AddLevel2(p1, tex1Name, tex2Name);
     EngineBaseObjDataTier& p3 = AddLevel3(p2, ENG_TRIANGLE_TYPE_TRIANGLES, material, state);
 
-    p3.vertices.insert(p3.vertices.end(), vertices.begin(), vertices.end());
+    DetachGeometry(p3);
+    p3.geometry->vertices.insert(p3.geometry->vertices.end(), vertices.begin(), vertices.end());
 
-    p3.updateStaticBuffer = true;
+    p3.geometry->updateStaticBuffer = true;
     m_updateStaticBuffers = true;
 
     for (int i = 0; i < static_cast<int>( vertices.size() ); i++)
@@ -769,6 +873,8 @@ void CEngine::AddBaseObjTriangles(int baseObjRank, const std::vector<VertexTex2>
     }
 
     p1.boundingSphere = Math::BoundingSphereForBox(p1.bboxMin, p1.bboxMax);
+    MarkBaseObjectTreeDirty(baseObjRank);
+    ReleaseImpostor(baseObjRank);
 
     p1.totalTriangles += vertices.size() / 3;
 }
@@ -783,9 +889,14 @@ void CEngine::AddBaseObjQuick(int baseObjRank, const EngineBaseObjDataTier& buff
     EngineBaseObjTexTier&  p2 = AddLevel2(p1, tex1Name, tex2Name);
 
     p2.next.push_back(buffer);
+    ReleaseImpostor(baseObjRank);
 
     EngineBaseObjDataTier& p3 = p2.next.back();
 
+    // The caller keeps its buffer, so the base object gets its own geometry
+    p3.geometry = std::make_shared<EngineGeometry>(*buffer.geometry);
+    p3.geometry->staticBufferId = 0;
+
     UpdateStaticBuffer(p3);
 
     if (globalUpdate)
@@ -794,23 +905,32 @@ void CEngine::AddBaseObjQuick(int baseObjRank, const EngineBaseObjDataTier& buff
     }
     else
     {
-        for (int i = 0; i < static_cast<int>( p3.vertices.size() ); i++)
+        for (int i = 0; i < static_cast<int>( p3.geometry->vertices.size() ); i++)
         {
-            p1.bboxMin.x = Math::Min(p3.vertices[i].coord.x, p1.bboxMin.x);
-            p1.bboxMin.y = Math::Min(p3.vertices[i].coord.y, p1.bboxMin.y);
-            p1.bboxMin.z = Math::Min(p3.vertices[i].coord.z, p1.bboxMin.z);
-            p1.bboxMax.x = Math::Max(p3.vertices[i].coord.x, p1.bboxMax.x);
-            p1.bboxMax.y = Math::Max(p3.vertices[i].coord.y, p1.bboxMax.y);
-            p1.bboxMax.z = Math::Max(p3.vertices[i].coord.z, p1.bboxMax.z);
+            p1.bboxMin.x = Math::Min(p3.geometry->vertices[i].coord.x, p1.bboxMin.x);
+            p1.bboxMin.y = Math::Min(p3.geometry->vertices[i].coord.y, p1.bboxMin.y);
+            p1.bboxMin.z = Math::Min(p3.geometry->vertices[i].coord.z, p1.bboxMin.z);
+            p1.bboxMax.x = Math::Max(p3.geometry->vertices[i].coord.x, p1.bboxMax.x);
+            p1.bboxMax.y = Math::Max(p3.geometry->vertices[i].coord.y, p1.bboxMax.y);
+            p1.bboxMax.z = Math::Max(p3.geometry->vertices[i].coord.z, p1.bboxMax.z);
         }
 
         p1.boundingSphere = Math::BoundingSphereForBox(p1.bboxMin, p1.bboxMax);
+        MarkBaseObjectTreeDirty(baseObjRank);
     }
 
     if (p3.type == ENG_TRIANGLE_TYPE_TRIANGLES)
-        p1.totalTriangles += p3.vertices.size() / 3;
+        p1.totalTriangles += p3.geometry->vertices.size() / 3;
     else if (p3.type == ENG_TRIANGLE_TYPE_SURFACE)
-        p1.totalTriangles += p3.vertices.size() - 2;
+        p1.totalTriangles += p3.geometry->vertices.size() - 2;
+}
+
+void CEngine::SetBaseObjectLod(int baseObjRank, EngineLodLevel lodLevel, int lodBaseObjRank)
+{
+    assert(baseObjRank >= 0 && baseObjRank < static_cast<int>( m_baseObjects.size() ));
+    assert(lodBaseObjRank >= -1 && lodBaseObjRank < static_cast<int>( m_baseObjects.size() ));
+
+    m_baseObjects[baseObjRank].lodBaseObjRank[lodLevel] = lodBaseObjRank;
 }
 
 void CEngine::DebugObject(int objRank)
@@ -876,8 +996,8 @@ void CEngine::DebugObject(int objRank)
             l->Debug("   l3:\n");
             l->Debug("    type: %d\n", p3.type);
             l->Debug("    state: %d\n", p3.state);
-            l->Debug("    staticBufferId: %u\n", p3.staticBufferId);
-            l->Debug("    updateStaticBuffer: %s\n", p3.updateStaticBuffer ? "true" : "false");
+            l->Debug("    staticBufferId: %u\n", p3.geometry->staticBufferId);
+            l->Debug("    updateStaticBuffer: %s\n", p3.geometry->updateStaticBuffer ? "true" : "false");
         }
     }
 }
@@ -915,6 +1035,10 @@ int CEngine::CreateObject()
 void CEngine::DeleteAllObjects()
 {
     m_objects.clear();
+    m_objectTree.Clear();
+    m_objectTreeDirty.clear();
+    m_visibleObjects.clear();
+    m_shadowObjects.clear();
     m_shadowSpots.clear();
 
     DeleteAllGroundSpots();
@@ -926,6 +1050,7 @@ void CEngine::DeleteObject(int objRank)
 
     // Mark object as deleted
     m_objects[objRank].used = false;
+    MarkObjectTreeDirty(objRank);
 
     // Delete associated shadows
     DeleteShadowSpot(objRank);
@@ -936,6 +1061,7 @@ void CEngine::SetObjectBaseRank(int objRank, int baseObjRank)
     assert(objRank == -1 || (objRank >= 0 && objRank < static_cast<int>( m_objects.size() )));
 
     m_objects[objRank].baseObjRank = baseObjRank;
+    MarkObjectTreeDirty(objRank);
 }
 
 int CEngine::GetObjectBaseRank(int objRank)
@@ -965,6 +1091,7 @@ void CEngine::SetObjectTransform(int objRank, const Math::Matrix& transform)
     assert(objRank >= 0 && objRank < static_cast<int>( m_objects.size() ));
 
     m_objects[objRank].transform = transform;
+    MarkObjectTreeDirty(objRank);
 }
 
 void CEngine::GetObjectTransform(int objRank, Math::Matrix& transform)
@@ -988,6 +1115,13 @@ void CEngine::SetObjectDrawFront(int objRank, bool draw)
     m_objects[objRank].drawFront = draw;
 }
 
+void CEngine::SetObjectImpostor(int objRank, bool enabled)
+{
+    assert(objRank >= 0 && objRank < static_cast<int>( m_objects.size() ));
+
+    m_objects[objRank].impostor = enabled;
+}
+
 void CEngine::SetObjectTransparency(int objRank, float value)
 {
     assert(objRank >= 0 && objRank < static_cast<int>( m_objects.size() ));
@@ -1088,7 +1222,7 @@ int CEngine::GetPartialTriangles(int objRank, float percent, int maxCount,
 
             if (p3.type == ENG_TRIANGLE_TYPE_TRIANGLES)
             {
-                for (int i = 0; i < static_cast<int>( p3.vertices.size() ); i += 3)
+                for (int i = 0; i < static_cast<int>( p3.geometry->vertices.size() ); i += 3)
                 {
                     if (static_cast<float>(actualCount) / total >= percent)
                         break;
@@ -1097,9 +1231,9 @@ int CEngine::GetPartialTriangles(int objRank, float percent, int maxCount,
                         break;
 
                     EngineTriangle t;
-                    t.triangle[0] = p3.vertices[i];
-                    t.triangle[1] = p3.vertices[i+1];
-                    t.triangle[2] = p3.vertices[i+2];
+                    t.triangle[0] = p3.geometry->vertices[i];
+                    t.triangle[1] = p3.geometry->vertices[i+1];
+                    t.triangle[2] = p3.geometry->vertices[i+2];
                     t.material = p3.material;
                     t.state = p3.state;
                     t.tex1Name = p2.tex1Name;
@@ -1112,7 +1246,7 @@ int CEngine::GetPartialTriangles(int objRank, float percent, int maxCount,
             }
             else if (p3.type == ENG_TRIANGLE_TYPE_SURFACE)
             {
-                for (int i = 0; i < static_cast<int>( p3.vertices.size() ); i += 1)
+                for (int i = 0; i < static_cast<int>( p3.geometry->vertices.size() ); i += 1)
                 {
                     if (static_cast<float>(actualCount) / total >= percent)
                         break;
@@ -1121,9 +1255,9 @@ int CEngine::GetPartialTriangles(int objRank, float percent, int maxCount,
                         break;
 
                     EngineTriangle t;
-                    t.triangle[0] = p3.vertices[i];
-                    t.triangle[1] = p3.vertices[i+1];
-                    t.triangle[2] = p3.vertices[i+2];
+                    t.triangle[0] = p3.geometry->vertices[i];
+                    t.triangle[1] = p3.geometry->vertices[i+1];
+                    t.triangle[2] = p3.geometry->vertices[i+2];
                     t.material = p3.material;
                     t.state = p3.state;
                     t.tex1Name = p2.tex1Name;
@@ -1181,51 +1315,53 @@ void CEngine::ChangeTextureMapping(int objRank, const Material& mat, int state,
     if (p4 == nullptr)
         return;
 
-    int nb = p4->vertices.size();
+    DetachGeometry(*p4);
+
+    int nb = p4->geometry->vertices.size();
 
     if (mode == ENG_TEX_MAPPING_X)
     {
         for (int i = 0; i < nb; i++)
         {
-            p4->vertices[i].texCoord.x = p4->vertices[i].coord.z * au + bu;
-            p4->vertices[i].texCoord.y = p4->vertices[i].coord.y * av + bv;
+            p4->geometry->vertices[i].texCoord.x = p4->geometry->vertices[i].coord.z * au + bu;
+            p4->geometry->vertices[i].texCoord.y = p4->geometry->vertices[i].coord.y * av + bv;
         }
     }
     else if (mode == ENG_TEX_MAPPING_Y)
     {
         for (int i = 0; i < nb; i++)
         {
-            p4->vertices[i].texCoord.x = p4->vertices[i].coord.x * au + bu;
-            p4->vertices[i].texCoord.y = p4->vertices[i].coord.z * av + bv;
+            p4->geometry->vertices[i].texCoord.x = p4->geometry->vertices[i].coord.x * au + bu;
+            p4->geometry->vertices[i].texCoord.y = p4->geometry->vertices[i].coord.z * av + bv;
         }
     }
     else if (mode == ENG_TEX_MAPPING_Z)
     {
         for (int i = 0; i < nb; i++)
         {
-            p4->vertices[i].texCoord.x = p4->vertices[i].coord.x * au + bu;
-            p4->vertices[i].texCoord.y = p4->vertices[i].coord.y * av + bv;
+            p4->geometry->vertices[i].texCoord.x = p4->geometry->vertices[i].coord.x * au + bu;
+            p4->geometry->vertices[i].texCoord.y = p4->geometry->vertices[i].coord.y * av + bv;
         }
     }
     else if (mode == ENG_TEX_MAPPING_1X)
     {
         for (int i = 0; i < nb; i++)
         {
-            p4->vertices[i].texCoord.x = p4->vertices[i].coord.x * au + bu;
+            p4->geometry->vertices[i].texCoord.x = p4->geometry->vertices[i].coord.x * au + bu;
         }
     }
     else if (mode == ENG_TEX_MAPPING_1Y)
     {
         for (int i = 0; i < nb; i++)
         {
-            p4->vertices[i].texCoord.y = p4->vertices[i].coord.y * au + bu;
+            p4->geometry->vertices[i].texCoord.y = p4->geometry->vertices[i].coord.y * au + bu;
         }
     }
     else if (mode == ENG_TEX_MAPPING_1Z)
     {
         for (int i = 0; i < nb; i++)
         {
-            p4->vertices[i].texCoord.x = p4->vertices[i].coord.z * au + bu;
+            p4->geometry->vertices[i].texCoord.x = p4->geometry->vertices[i].coord.z * au + bu;
         }
     }
 
@@ -1243,11 +1379,13 @@ void CEngine::TrackTextureMapping(int objRank, const Material& mat, int state,
     if (p4 == nullptr)
         return;
 
-    int tNum = p4->vertices.size();
+    int tNum = p4->geometry->vertices.size();
     if (tNum < 12 || tNum % 6 != 0)
         return;
 
-    std::vector<Gfx::VertexTex2>& vs = p4->vertices;
+    DetachGeometry(*p4);
+
+    std::vector<Gfx::VertexTex2>& vs = p4->geometry->vertices;
 
     while (pos < 0.0f)
         pos += 1.0f;  // never negative!
@@ -1671,24 +1809,36 @@ void CEngine::UpdateGeometry()
             {
                 EngineBaseObjDataTier& p3 = p2.next[l3];
 
-                for (int i = 0; i < static_cast<int>( p3.vertices.size() ); i++)
+                for (int i = 0; i < static_cast<int>( p3.geometry->vertices.size() ); i++)
                 {
-                        p1.bboxMin.x = Math::Min(p3.vertices[i].coord.x, p1.bboxMin.x);
-                        p1.bboxMin.y = Math::Min(p3.vertices[i].coord.y, p1.bboxMin.y);
-                        p1.bboxMin.z = Math::Min(p3.vertices[i].coord.z, p1.bboxMin.z);
-                        p1.bboxMax.x = Math::Max(p3.vertices[i].coord.x, p1.bboxMax.x);
-                        p1.bboxMax.y = Math::Max(p3.vertices[i].coord.y, p1.bboxMax.y);
-                        p1.bboxMax.z = Math::Max(p3.vertices[i].coord.z, p1.bboxMax.z);
+                        p1.bboxMin.x = Math::Min(p3.geometry->vertices[i].coord.x, p1.bboxMin.x);
+                        p1.bboxMin.y = Math::Min(p3.geometry->vertices[i].coord.y, p1.bboxMin.y);
+                        p1.bboxMin.z = Math::Min(p3.geometry->vertices[i].coord.z, p1.bboxMin.z);
+                        p1.bboxMax.x = Math::Max(p3.geometry->vertices[i].coord.x, p1.bboxMax.x);
+                        p1.bboxMax.y = Math::Max(p3.geometry->vertices[i].coord.y, p1.bboxMax.y);
+                        p1.bboxMax.z = Math::Max(p3.geometry->vertices[i].coord.z, p1.bboxMax.z);
                 }
             }
         }
 
         p1.boundingSphere = Math::BoundingSphereForBox(p1.bboxMin, p1.bboxMax);
+        MarkBaseObjectTreeDirty(baseObjRank);
     }
 
     m_updateGeometry = false;
 }
 
+void CEngine::DetachGeometry(EngineBaseObjDataTier& p4)
+{
+    if (p4.geometry.use_count() <= 1)
+        return;
+
+    p4.geometry = std::make_shared<EngineGeometry>(*p4.geometry);
+    p4.geometry->staticBufferId = 0;
+    p4.geometry->updateStaticBuffer = true;
+    m_updateStaticBuffers = true;
+}
+
 void CEngine::UpdateStaticBuffer(EngineBaseObjDataTier& p4)
 {
     PrimitiveType type;
@@ -1697,12 +1847,12 @@ void CEngine::UpdateStaticBuffer(EngineBaseObjDataTier& p4)
     else
         type = PRIMITIVE_TRIANGLE_STRIP;
 
-    if (p4.staticBufferId == 0)
-        p4.staticBufferId = m_device->CreateStaticBuffer(type, &p4.vertices[0], p4.vertices.size());
+    if (p4.geometry->staticBufferId == 0)
+        p4.geometry->staticBufferId = m_device->CreateStaticBuffer(type, &p4.geometry->vertices[0], p4.geometry->vertices.size());
     else
-        m_device->UpdateStaticBuffer(p4.staticBufferId, type, &p4.vertices[0], p4.vertices.size());
+        m_device->UpdateStaticBuffer(p4.geometry->staticBufferId, type, &p4.geometry->vertices[0], p4.geometry->vertices.size());
 
-    p4.updateStaticBuffer = false;
+    p4.geometry->updateStaticBuffer = false;
 }
 
 void CEngine::UpdateStaticBuffers()
@@ -1726,7 +1876,7 @@ void CEngine::UpdateStaticBuffers()
             {
                 EngineBaseObjDataTier& p3 = p2.next[l3];
 
-                if (! p3.updateStaticBuffer)
+                if (! p3.geometry->updateStaticBuffer)
                         continue;
 
                 UpdateStaticBuffer(p3);
@@ -1824,10 +1974,10 @@ int CEngine::DetectObject(Math::Point mouse, Math::Vector& targetPos, bool terra
 
                 if (p3.type == ENG_TRIANGLE_TYPE_TRIANGLES)
                 {
-                    for (int i = 0; i < static_cast<int>( p3.vertices.size() ); i += 3)
+                    for (int i = 0; i < static_cast<int>( p3.geometry->vertices.size() ); i += 3)
                     {
                         float dist = 0.0f;
-                        if (DetectTriangle(mouse, &p3.vertices[i], objRank, dist, pos) && dist < min)
+                        if (DetectTriangle(mouse, &p3.geometry->vertices[i], objRank, dist, pos) && dist < min)
                         {
                             min = dist;
                             nearest = objRank;
@@ -1837,10 +1987,10 @@ int CEngine::DetectObject(Math::Point mouse, Math::Vector& targetPos, bool terra
                 }
                 else if (p3.type == ENG_TRIANGLE_TYPE_SURFACE)
                 {
-                    for (int i = 0; i < static_cast<int>( p3.vertices.size() ) - 2; i += 1)
+                    for (int i = 0; i < static_cast<int>( p3.geometry->vertices.size() ) - 2; i += 1)
                     {
                         float dist = 0.0f;
-                        if (DetectTriangle(mouse, &p3.vertices[i], objRank, dist, pos) && dist < min)
+                        if (DetectTriangle(mouse, &p3.geometry->vertices[i], objRank, dist, pos) && dist < min)
                         {
                             min = dist;
                             nearest = objRank;
@@ -1938,6 +2088,66 @@ bool CEngine::IsVisible(int objRank)
     return false;
 }
 
+void CEngine::MarkObjectTreeDirty(int objRank)
+{
+    if (m_objects[objRank].treeDirty)
+        return;
+
+    m_objects[objRank].treeDirty = true;
+    m_objectTreeDirty.push_back(objRank);
+}
+
+void CEngine::MarkBaseObjectTreeDirty(int baseObjRank)
+{
+    m_objectTreeDirtyBases.insert(baseObjRank);
+}
+
+void CEngine::UpdateObjectTree()
+{
+    if (! m_objectTreeDirtyBases.empty())
+    {
+        for (int objRank = 0; objRank < static_cast<int>(m_objects.size()); objRank++)
+        {
+            if (m_objectTreeDirtyBases.count(m_objects[objRank].baseObjRank) != 0)
+                MarkObjectTreeDirty(objRank);
+        }
+
+        m_objectTreeDirtyBases.clear();
+    }
+
+    for (int objRank : m_objectTreeDirty)
+    {
+        if (objRank >= static_cast<int>(m_objects.size()))
+            continue;
+
+        EngineObject& object = m_objects[objRank];
+        object.treeDirty = false;
+
+        int baseObjRank = object.baseObjRank;
+        if (! object.used || baseObjRank < 0 || baseObjRank >= static_cast<int>(m_baseObjects.size()) ||
+            ! m_baseObjects[baseObjRank].used)
+        {
+            m_objectTree.Remove(objRank);
+            continue;
+        }
+
+        const Math::Matrix& transform = object.transform;
+        const auto& sphere = m_baseObjects[baseObjRank].boundingSphere;
+
+        // Largest axis scale of the transform bounds the scaled radius
+        float scale = 0.0f;
+        for (int col = 0; col < 3; col++)
+        {
+            Math::Vector axis(transform.m[4 * col], transform.m[4 * col + 1], transform.m[4 * col + 2]);
+            scale = Math::Max(scale, axis.Length());
+        }
+
+        m_objectTree.Update(objRank, Math::Transform(transform, sphere.pos), sphere.radius * scale);
+    }
+
+    m_objectTreeDirty.clear();
+}
+
 bool CEngine::TransformPoint(Math::Vector& p2D, int objRank, Math::Vector p3D)
 {
     assert(objRank >= 0 && objRank < static_cast<int>(m_objects.size()));
@@ -1971,6 +2181,8 @@ void CEngine::SetState(int state, const Color& color)
     if (state == m_lastState && color == m_lastColor)
         return;
 
+    FlushInterfaceBatch();
+
     m_lastState = state;
     m_lastColor = color;
 
@@ -2254,17 +2466,34 @@ Texture CEngine::CreateTexture(const std::string& texName, const TextureCreatePa
     Texture tex;
     CImage img;
 
+    std::unique_ptr<CImage> decoded;
+
     if (image == nullptr)
     {
-        if (!img.Load(texName))
+        // Claim the image if it is decoded in background already, instead of decoding it twice
+        std::string error;
+        bool loaded = false;
+        if (m_textureLoader != nullptr)
+        {
+            if (!m_textureLoader->Take(texName, decoded, error))
+                m_textureLoader->Decode(texName, decoded, error);
+            loaded = decoded != nullptr;
+        }
+        else
+            loaded = img.Load(texName);
+
+        if (!loaded)
         {
-            std::string error = img.GetError();
+            if (decoded == nullptr && error.empty())
+                error = img.GetError();
             GetLogger()->Error("Couldn't load texture '%s': %s, blacklisting\n", texName.c_str(), error.c_str());
             m_texBlacklist.insert(texName);
+            m_streamedTextures.erase(texName);
+            ReplaceStreamedTexture(texName, Texture());
             return Texture(); // invalid texture
         }
 
-        image = &img;
+        image = decoded != nullptr ? decoded.get() : &img;
     }
 
     tex = m_device->CreateTexture(image, params);
@@ -2273,12 +2502,17 @@ Texture CEngine::CreateTexture(const std::string& texName, const TextureCreatePa
     {
         GetLogger()->Error("Couldn't load texture '%s', blacklisting\n", texName.c_str());
         m_texBlacklist.insert(texName);
+        m_streamedTextures.erase(texName);
+        ReplaceStreamedTexture(texName, Texture());
         return tex;
     }
 
     m_texNameMap[texName] = tex;
     m_revTexNameMap[tex] = texName;
 
+    if (m_streamedTextures.erase(texName) > 0)
+        ReplaceStreamedTexture(texName, tex);
+
     return tex;
 }
 
@@ -2305,6 +2539,141 @@ Texture CEngine::LoadTexture(const std::string& name, const TextureCreateParams&
     return CreateTexture(name, params);
 }
 
+void CEngine::PrefetchTexture(const std::string& name)
+{
+    if (name.empty() || m_textureLoader == nullptr)
+        return;
+
+    if (m_texBlacklist.find(name) != m_texBlacklist.end())
+        return;
+
+    if (m_texNameMap.find(name) != m_texNameMap.end())
+        return;
+
+    m_textureLoader->Request(name);
+}
+
+Texture CEngine::StreamTexture(const std::string& name, const TextureCreateParams& params)
+{
+    if (m_texBlacklist.find(name) != m_texBlacklist.end())
+        return Texture();
+
+    auto it = m_texNameMap.find(name);
+    if (it != m_texNameMap.end())
+        return (*it).second;
+
+    if (m_textureLoader == nullptr)
+        return CreateTexture(name, params);
+
+    if (m_streamedTextures.find(name) == m_streamedTextures.end())
+    {
+        m_streamedTextures[name] = params;
+        m_textureLoader->Request(name);
+    }
+
+    return GetPlaceholderTexture();
+}
+
+void CEngine::UpdateTextureStreaming()
+{
+    if (m_streamedTextures.empty())
+        return;
+
+    // Upload time per frame, so that finishing many textures at once does not stall the game
+    const auto budget = std::chrono::milliseconds(4);
+    auto start = std::chrono::steady_clock::now();
+
+    auto it = m_streamedTextures.begin();
+    while (it != m_streamedTextures.end() && std::chrono::steady_clock::now() - start < budget)
+    {
+        std::string name = (*it).first;
+        TextureCreateParams params = (*it).second;
+        ++it;
+
+        std::unique_ptr<CImage> image;
+        std::string error;
+        if (! m_textureLoader->TryTake(name, image, error))
+            continue;
+
+        if (image == nullptr)
+        {
+            GetLogger()->Error("Couldn't load texture '%s': %s, blacklisting\n", name.c_str(), error.c_str());
+            m_texBlacklist.insert(name);
+            m_streamedTextures.erase(name);
+            ReplaceStreamedTexture(name, Texture());
+            continue;
+        }
+
+        // Also removes the texture from m_streamedTextures
+        CreateTexture(name, params, image.get());
+    }
+
+    if (m_streamedTextures.empty())
+    {
+        GetLogger()->Info("Texture streaming finished, average decoding time %.2f ms, "
+                          "%d textures from cache saved %.2f ms\n",
+                          m_textureLoader->GetAverageDecodeTime(),
+                          m_textureLoader->GetCacheHits(), m_textureLoader->GetCacheSavedTime());
+    }
+}
+
+void CEngine::ReplaceStreamedTexture(const std::string& name, const Texture& tex)
+{
+    for (auto& p1 : m_baseObjects)
+    {
+        if (! p1.used)
+            continue;
+
+        for (auto& p2 : p1.next)
+        {
+            if (! p2.tex1Name.empty() && "textures/"+p2.tex1Name == name)
+                p2.tex1 = tex;
+
+            if (! p2.tex2Name.empty() && "textures/"+p2.tex2Name == name)
+                p2.tex2 = tex;
+        }
+    }
+}
+
+Texture CEngine::GetPlaceholderTexture()
+{
+    if (! m_placeholderTexture.Valid())
+    {
+        CImage image(Math::IntPoint(1, 1));
+        image.Fill(IntColor(255, 255, 255, 255));
+
+        TextureCreateParams params;
+        params.format = TEX_IMG_RGBA;
+        params.filter = TEX_FILTER_NEAREST;
+        params.mipmap = false;
+        m_placeholderTexture = m_device->CreateTexture(&image, params);
+    }
+
+    return m_placeholderTexture;
+}
+
+void CEngine::BuildTextureAtlas()
+{
+    // Effect sheets are drawn by particles with their own transforms and the mouse with nearest filtering,
+    // so only the button sheets of the interface are packed
+    static const std::vector<std::string> names =
+    {
+        "textures/interface/button1.png",
+        "textures/interface/button2.png",
+        "textures/interface/button3.png",
+        "textures/interface/button4.png",
+    };
+
+    TextureCreateParams params;
+    params.format = TEX_IMG_AUTO;
+    params.filter = TEX_FILTER_BILINEAR;
+    params.mipmap = false;
+
+    int pageSize = std::min(1024, m_device->GetMaxTextureSize());
+    if (! m_textureAtlas->Build(names, params, pageSize))
+        GetLogger()->Warn("Could not build interface texture atlas, drawing interface textures separately\n");
+}
+
 bool CEngine::LoadAllTextures()
 {
     m_miceTexture = LoadTexture("textures/interface/mouse.png");
@@ -2317,6 +2686,9 @@ bool CEngine::LoadAllTextures()
     LoadTexture("textures/effect02.png");
     LoadTexture("textures/effect03.png");
 
+    if (m_textureAtlas->GetPageCount() == 0)
+        BuildTextureAtlas();
+
     if (! m_backgroundName.empty())
     {
         TextureCreateParams params = m_defaultTexParams;
@@ -2361,9 +2733,9 @@ bool CEngine::LoadAllTextures()
             if (! p2.tex1Name.empty())
             {
                 if (terrain)
-                    p2.tex1 = LoadTexture("textures/"+p2.tex1Name, m_terrainTexParams);
+                    p2.tex1 = StreamTexture("textures/"+p2.tex1Name, m_terrainTexParams);
                 else
-                    p2.tex1 = LoadTexture("textures/"+p2.tex1Name);
+                    p2.tex1 = StreamTexture("textures/"+p2.tex1Name, m_defaultTexParams);
 
                 if (! p2.tex1.Valid())
                     ok = false;
@@ -2372,9 +2744,9 @@ bool CEngine::LoadAllTextures()
             if (! p2.tex2Name.empty())
             {
                 if (terrain)
-                    p2.tex2 = LoadTexture("textures/"+p2.tex2Name, m_terrainTexParams);
+                    p2.tex2 = StreamTexture("textures/"+p2.tex2Name, m_terrainTexParams);
                 else
-                    p2.tex2 = LoadTexture("textures/"+p2.tex2Name);
+                    p2.tex2 = StreamTexture("textures/"+p2.tex2Name, m_defaultTexParams);
 
                 if (! p2.tex2.Valid())
                     ok = false;
@@ -2382,6 +2754,15 @@ bool CEngine::LoadAllTextures()
         }
     }
 
+    // The level is loaded, prefetched images it did not use would stay in memory until FlushTextureCache()
+    if (m_textureLoader != nullptr)
+    {
+        m_textureLoader->Clear([this](const std::string& name)
+        {
+            return m_streamedTextures.find(name) != m_streamedTextures.end();
+        });
+    }
+
     return ok;
 }
 
@@ -2574,10 +2955,14 @@ void CEngine::CreateOrUpdateTexture(const std::string& texName, CImage* img)
     {
         m_device->UpdateTexture((*it).second, Math::IntPoint(0, 0), img->GetData(), m_defaultTexParams.format);
     }
+
+    m_textureAtlas->Update(texName, img, m_defaultTexParams.format);
 }
 
 void CEngine::FlushTextureCache()
 {
+    FlushInterfaceBatch();
+    m_textureAtlas->Clear();
     m_device->DestroyAllTextures();
 
     m_backgroundTex.SetInvalid();
@@ -2587,40 +2972,124 @@ void CEngine::FlushTextureCache()
     m_revTexNameMap.clear();
     m_texBlacklist.clear();
 
+    m_streamedTextures.clear();
+    if (m_textureLoader != nullptr)
+        m_textureLoader->Clear();
+    m_placeholderTexture.SetInvalid();
+    m_currentTexture.SetInvalid();
+    m_interfaceBatchTexture.SetInvalid();
+
     m_firstGroundSpot = true;
 }
 
 bool CEngine::SetTexture(const std::string& name, int stage)
 {
+    if (stage == 0 && m_interfaceMode)
+    {
+        const TextureAtlasRegion* region = m_textureAtlas->Find(name);
+        if (region != nullptr)
+        {
+            SetTexture(region->page, 0);
+            m_currentTexOffset = region->offset;
+            m_currentTexScale = region->scale;
+            return true;
+        }
+    }
+
     auto it = m_texNameMap.find(name);
     if (it != m_texNameMap.end())
     {
-        m_device->SetTexture(stage, (*it).second);
+        SetTexture((*it).second, stage);
         return true;
     }
 
     if (! LoadTexture(name).Valid())
     {
-        m_device->SetTexture(stage, 0); // invalid texture
+        SetTexture(Texture(), stage); // invalid texture
         return false;
     }
 
     it = m_texNameMap.find(name);
     if (it != m_texNameMap.end())
     {
-        m_device->SetTexture(stage, (*it).second);
+        SetTexture((*it).second, stage);
         return true;
     }
 
-    m_device->SetTexture(stage, 0); // invalid texture
+    SetTexture(Texture(), stage); // invalid texture
     return false; // should not happen normally
 }
 
 void CEngine::SetTexture(const Texture& tex, int stage)
 {
+    if (stage == 0)
+    {
+        if (tex.id != m_interfaceBatchTexture.id)
+            FlushInterfaceBatch();
+
+        m_currentTexture = tex;
+        m_currentTexOffset = Math::Point(0.0f, 0.0f);
+        m_currentTexScale = Math::Point(1.0f, 1.0f);
+    }
+
     m_device->SetTexture(stage, tex);
 }
 
+void CEngine::DrawInterfaceStrip(const Vertex* vertices, int vertexCount)
+{
+    if (vertexCount < 3)
+        return;
+
+    if (m_interfaceBatchCounts.empty())
+        m_interfaceBatchTexture = m_currentTexture;
+
+    m_interfaceBatchFirsts.push_back(static_cast<int>(m_interfaceBatchVertices.size()));
+    m_interfaceBatchCounts.push_back(vertexCount);
+
+    for (int i = 0; i < vertexCount; i++)
+    {
+        Vertex vertex = vertices[i];
+        vertex.texCoord.x = m_currentTexOffset.x + vertex.texCoord.x * m_currentTexScale.x;
+        vertex.texCoord.y = m_currentTexOffset.y + vertex.texCoord.y * m_currentTexScale.y;
+        m_interfaceBatchVertices.push_back(vertex);
+    }
+
+    m_statisticInterfaceStrips++;
+
+    if (! m_interfaceMode)
+        FlushInterfaceBatch();
+}
+
+void CEngine::DrawInterfaceStrip(const VertexCol* vertices, int vertexCount)
+{
+    FlushInterfaceBatch();
+
+    m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, vertices, vertexCount);
+    m_statisticInterfaceStrips++;
+    m_statisticInterfaceDraws++;
+}
+
+void CEngine::FlushInterfaceBatch()
+{
+    if (m_interfaceBatchCounts.empty())
+        return;
+
+    m_device->SetTexture(0, m_interfaceBatchTexture);
+    m_device->DrawPrimitives(PRIMITIVE_TRIANGLE_STRIP, m_interfaceBatchVertices.data(),
+                             m_interfaceBatchFirsts.data(), m_interfaceBatchCounts.data(),
+                             static_cast<int>(m_interfaceBatchCounts.size()));
+    m_statisticInterfaceDraws++;
+
+    // Strips may have been batched before the current texture was set directly on the device
+    if (m_interfaceBatchTexture.id != m_currentTexture.id)
+        m_device->SetTexture(0, m_currentTexture);
+
+    m_interfaceBatchVertices.clear();
+    m_interfaceBatchFirsts.clear();
+    m_interfaceBatchCounts.clear();
+    m_interfaceBatchTexture.SetInvalid();
+}
+
 void CEngine::SetTerrainVision(float vision)
 {
     m_terrainVision = vision;
@@ -2676,6 +3145,26 @@ float CEngine::GetShadowRange()
     return m_shadowRange;
 }
 
+void CEngine::SetLodDistance(EngineLodLevel lodLevel, float value)
+{
+    m_lodDistance[lodLevel] = value;
+}
+
+float CEngine::GetLodDistance(EngineLodLevel lodLevel)
+{
+    return m_lodDistance[lodLevel];
+}
+
+void CEngine::SetImpostorDistance(float value)
+{
+    m_impostorDistance = value;
+}
+
+float CEngine::GetImpostorDistance()
+{
+    return m_impostorDistance;
+}
+
 void CEngine::SetMultiSample(int value)
 {
     if(value == m_multisample) return;
@@ -3188,7 +3677,14 @@ void CEngine::Render()
     if (! m_render)
         return;
 
+    UpdateTextureStreaming();
+
     m_statisticTriangle = 0;
+    m_statisticTriangleSaved = 0;
+    m_statisticLodObjects = 0;
+    m_statisticImpostors = 0;
+    m_statisticInterfaceStrips = 0;
+    m_statisticInterfaceDraws = 0;
     m_lastState = -1;
     m_lastColor = Color(-1.0f);
     m_lastMaterial = Material();
@@ -3215,6 +3711,13 @@ void CEngine::Render()
     }
     else
     {
+        // Render images of newly assigned impostors
+        if (m_drawWorld && m_impostorsDirty)
+        {
+            RenderImpostors();
+            m_device->SetClearColor(color);
+        }
+
         // Render shadow map
         if (m_drawWorld && m_shadowMapping)
             RenderShadowMap();
@@ -3280,186 +3783,39 @@ void CEngine::Draw3DScene()
     // So I'll just leave it like that for now ~krzys_h
     //m_water->DrawBack();  // draws water background
 
+    // Cull once and sort the draws of all passes to minimize state changes
+    BuildRenderQueue();
+
     CProfiler::StartPerformanceCounter(PCNT_RENDER_TERRAIN);
 
     // Draw terrain
 
-    m_lightMan->UpdateDeviceLights(ENG_OBJTYPE_TERRAIN);
-
     UseShadowMapping(true);
 
-    for (int objRank = 0; objRank < static_cast<int>(m_objects.size()); objRank++)
-    {
-        if (! m_objects[objRank].used)
-            continue;
+    DrawRenderQueue(ENG_RPASS_TERRAIN);
 
-        if (m_objects[objRank].type != ENG_OBJTYPE_TERRAIN)
-            continue;
+    if (!m_qualityShadows)
+        UseShadowMapping(false);
 
-        if (! m_objects[objRank].drawWorld)
-            continue;
+    // Draws the old-style shadow spots, if shadow mapping disabled
+    if (!m_shadowMapping)
+        DrawShadowSpots();
 
-        m_device->SetTransform(TRANSFORM_WORLD, m_objects[objRank].transform);
+    CProfiler::StopPerformanceCounter(PCNT_RENDER_TERRAIN);
 
-        if (! IsVisible(objRank))
-            continue;
+    // Draw other objects
 
-        int baseObjRank = m_objects[objRank].baseObjRank;
-        if (baseObjRank == -1)
-            continue;
+    CProfiler::StartPerformanceCounter(PCNT_RENDER_OBJECTS);
 
-        assert(baseObjRank >= 0 && baseObjRank < static_cast<int>( m_baseObjects.size() ));
+    DrawRenderQueue(ENG_RPASS_OPAQUE);
+    DrawImpostors();
+    DrawRenderQueue(ENG_RPASS_BLENDED);
 
-        EngineBaseObject& p1 = m_baseObjects[baseObjRank];
-        if (! p1.used)
-            continue;
-
-        for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
-        {
-            EngineBaseObjTexTier& p2 = p1.next[l2];
-
-            SetTexture(p2.tex1, 0);
-            SetTexture(p2.tex2, 1);
-
-            for (int l3 = 0; l3 < static_cast<int>( p2.next.size() ); l3++)
-            {
-                EngineBaseObjDataTier& p3 = p2.next[l3];
-
-                SetMaterial(p3.material);
-                SetState(p3.state);
-
-                DrawObject(p3);
-            }
-        }
-    }
-
-    if (!m_qualityShadows)
-        UseShadowMapping(false);
-
-    // Draws the old-style shadow spots, if shadow mapping disabled
-    if (!m_shadowMapping)
-        DrawShadowSpots();
-
-    CProfiler::StopPerformanceCounter(PCNT_RENDER_TERRAIN);
-
-    // Draw other objects
-
-    CProfiler::StartPerformanceCounter(PCNT_RENDER_OBJECTS);
-
-    bool transparent = false;
-
-    for (int objRank = 0; objRank < static_cast<int>(m_objects.size()); objRank++)
-    {
-        if (! m_objects[objRank].used)
-            continue;
-
-        if (m_objects[objRank].type == ENG_OBJTYPE_TERRAIN)
-            continue;
-
-        if (! m_objects[objRank].drawWorld)
-            continue;
-
-        m_device->SetTransform(TRANSFORM_WORLD, m_objects[objRank].transform);
-
-        if (! IsVisible(objRank))
-            continue;
-
-        int baseObjRank = m_objects[objRank].baseObjRank;
-        if (baseObjRank == -1)
-            continue;
-
-        assert(baseObjRank >= 0 && baseObjRank < static_cast<int>( m_baseObjects.size() ));
-
-        EngineBaseObject& p1 = m_baseObjects[baseObjRank];
-        if (! p1.used)
-            continue;
-
-        m_lightMan->UpdateDeviceLights(m_objects[objRank].type);
-
-        for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
-        {
-            EngineBaseObjTexTier& p2 = p1.next[l2];
-
-            SetTexture(p2.tex1, 0);
-            SetTexture(p2.tex2, 1);
-
-            for (int l3 = 0; l3 < static_cast<int>( p2.next.size() ); l3++)
-            {
-                EngineBaseObjDataTier& p3 = p2.next[l3];
-
-                if (m_objects[objRank].transparency != 0.0f)  // transparent ?
-                {
-                    transparent = true;
-                    continue;
-                }
-
-                SetMaterial(p3.material);
-                SetState(p3.state);
-
-                DrawObject(p3);
-            }
-        }
-    }
-
-    UseShadowMapping(false);
+    UseShadowMapping(false);
 
     // Draw transparent objects
 
-    if (transparent)
-    {
-        int tState = ENG_RSTATE_TTEXTURE_BLACK | ENG_RSTATE_2FACE;
-        Color tColor = Color(68.0f / 255.0f, 68.0f / 255.0f, 68.0f / 255.0f, 68.0f / 255.0f);
-
-        for (int objRank = 0; objRank < static_cast<int>(m_objects.size()); objRank++)
-        {
-            if (! m_objects[objRank].used)
-                continue;
-
-            if (m_objects[objRank].type == ENG_OBJTYPE_TERRAIN)
-                continue;
-
-            if (! m_objects[objRank].drawWorld)
-                continue;
-
-            m_device->SetTransform(TRANSFORM_WORLD, m_objects[objRank].transform);
-
-            if (! IsVisible(objRank))
-                continue;
-
-            int baseObjRank = m_objects[objRank].baseObjRank;
-            if (baseObjRank == -1)
-                continue;
-
-            assert(baseObjRank >= 0 && baseObjRank < static_cast<int>( m_baseObjects.size() ));
-
-            EngineBaseObject& p1 = m_baseObjects[baseObjRank];
-            if (! p1.used)
-                continue;
-
-            m_lightMan->UpdateDeviceLights(m_objects[objRank].type);
-
-            for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
-            {
-                EngineBaseObjTexTier& p2 = p1.next[l2];
-
-                SetTexture(p2.tex1, 0);
-                SetTexture(p2.tex2, 1);
-
-                for (int l3 = 0; l3 < static_cast<int>( p2.next.size() ); l3++)
-                {
-                    EngineBaseObjDataTier& p3 = p2.next[l3];
-
-                    if (m_objects[objRank].transparency == 0.0f)
-                        continue;
-
-                    SetMaterial(p3.material);
-                    SetState(tState, tColor);
-
-                    DrawObject(p3);
-                }
-            }
-        }
-    }
+    DrawRenderQueue(ENG_RPASS_TRANSPARENT);
 
     CProfiler::StopPerformanceCounter(PCNT_RENDER_OBJECTS);
 
@@ -3919,11 +4275,16 @@ void CEngine::RenderShadowMap()
     m_device->SetTexture(2, 0);
 
     // render objects into shadow map
-    for (int objRank = 0; objRank < static_cast<int>(m_objects.size()); objRank++)
-    {
-        if (!m_objects[objRank].used)
-            continue;
+    UpdateObjectTree();
+
+    m_shadowFrustum.LoadFromMatrices(m_shadowProjMat, m_shadowViewMat);
+
+    m_shadowObjects.clear();
+    m_objectTree.Cull(m_shadowFrustum, m_shadowObjects);
+    std::sort(m_shadowObjects.begin(), m_shadowObjects.end());
 
+    for (int objRank : m_shadowObjects)
+    {
         bool terrain = (m_objects[objRank].type == ENG_OBJTYPE_TERRAIN);
 
         if (terrain)
@@ -3945,13 +4306,7 @@ void CEngine::RenderShadowMap()
 
         m_device->SetTransform(TRANSFORM_WORLD, m_objects[objRank].transform);
 
-        if (!IsVisible(objRank))
-            continue;
-
         int baseObjRank = m_objects[objRank].baseObjRank;
-        if (baseObjRank == -1)
-            continue;
-
         assert(baseObjRank >= 0 && baseObjRank < static_cast<int>(m_baseObjects.size()));
 
         EngineBaseObject& p1 = m_baseObjects[baseObjRank];
@@ -4080,30 +4435,553 @@ void CEngine::UseMSAA(bool enable)
 
 void CEngine::DrawObject(const EngineBaseObjDataTier& p4)
 {
-    if (p4.staticBufferId != 0)
+    if (p4.geometry->staticBufferId != 0)
     {
-        m_device->DrawStaticBuffer(p4.staticBufferId);
+        m_device->DrawStaticBuffer(p4.geometry->staticBufferId);
 
         if (p4.type == ENG_TRIANGLE_TYPE_TRIANGLES)
-            m_statisticTriangle += p4.vertices.size() / 3;
+            m_statisticTriangle += p4.geometry->vertices.size() / 3;
         else
-            m_statisticTriangle += p4.vertices.size() - 2;
+            m_statisticTriangle += p4.geometry->vertices.size() - 2;
     }
     else
     {
         if (p4.type == ENG_TRIANGLE_TYPE_TRIANGLES)
         {
-            m_device->DrawPrimitive(PRIMITIVE_TRIANGLES, &p4.vertices[0], p4.vertices.size());
-            m_statisticTriangle += p4.vertices.size() / 3;
+            m_device->DrawPrimitive(PRIMITIVE_TRIANGLES, &p4.geometry->vertices[0], p4.geometry->vertices.size());
+            m_statisticTriangle += p4.geometry->vertices.size() / 3;
         }
         else
         {
-            m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, &p4.vertices[0], p4.vertices.size() );
-            m_statisticTriangle += p4.vertices.size() - 2;
+            m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, &p4.geometry->vertices[0], p4.geometry->vertices.size() );
+            m_statisticTriangle += p4.geometry->vertices.size() - 2;
         }
     }
 }
 
+// Layout of render queue sort keys, from the most significant bits
+static const int RENDER_QUEUE_PASS_SHIFT     = 62;
+static const int RENDER_QUEUE_TYPE_SHIFT     = 59;
+static const int RENDER_QUEUE_STATE_SHIFT    = 48;
+static const int RENDER_QUEUE_STATE_BITS     = 11;
+static const int RENDER_QUEUE_TEXTURE_SHIFT  = 32;
+static const int RENDER_QUEUE_TEXTURE_BITS   = 16;
+static const int RENDER_QUEUE_MATERIAL_SHIFT = 20;
+static const int RENDER_QUEUE_MATERIAL_BITS  = 12;
+static const int RENDER_QUEUE_ORDER_BITS     = 20;
+
+//! Size of the square texture holding impostor images
+static const int IMPOSTOR_ATLAS_SIZE  = 1024;
+//! Size of one impostor image
+static const int IMPOSTOR_SLOT_SIZE   = 128;
+//! Number of impostor images in a row of the atlas
+static const int IMPOSTOR_ATLAS_SLOTS = IMPOSTOR_ATLAS_SIZE / IMPOSTOR_SLOT_SIZE;
+
+//! States which blend with what is already drawn, so their draw order matters
+static const int RENDER_QUEUE_BLENDED_STATES = ENG_RSTATE_TTEXTURE_BLACK | ENG_RSTATE_TTEXTURE_WHITE |
+                                               ENG_RSTATE_TTEXTURE_ALPHA | ENG_RSTATE_TCOLOR_BLACK |
+                                               ENG_RSTATE_TCOLOR_WHITE | ENG_RSTATE_TCOLOR_ALPHA;
+
+//! Returns a small index of value, assigned in order of first use and saturated to given bit count
+static uint64_t GetRenderQueueIndex(std::unordered_map<uint64_t, int>& indices, uint64_t value, int bits)
+{
+    auto it = indices.find(value);
+    int index = 0;
+    if (it != indices.end())
+    {
+        index = it->second;
+    }
+    else
+    {
+        index = static_cast<int>(indices.size());
+        indices[value] = index;
+    }
+
+    return static_cast<uint64_t>(std::min(index, (1 << bits) - 1));
+}
+
+static uint64_t HashMaterial(const Material& mat)
+{
+    const float values[] =
+    {
+        mat.diffuse.r,  mat.diffuse.g,  mat.diffuse.b,  mat.diffuse.a,
+        mat.ambient.r,  mat.ambient.g,  mat.ambient.b,  mat.ambient.a,
+        mat.specular.r, mat.specular.g, mat.specular.b, mat.specular.a
+    };
+
+    uint64_t hash = 14695981039346656037ULL;
+    for (float value : values)
+    {
+        uint32_t bits = 0;
+        memcpy(&bits, &value, sizeof(bits));
+        hash = (hash ^ bits) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+void CEngine::BuildRenderQueue()
+{
+    m_renderQueue.clear();
+    m_renderQueueStates.clear();
+    m_renderQueueTextures.clear();
+    m_renderQueueMaterials.clear();
+    m_impostorVertices.clear();
+
+    UpdateObjectTree();
+
+    for (int objRank : m_visibleObjects)
+        m_objects[objRank].visible = false;
+
+    m_frustum.LoadFromMatrices(m_matProj, m_matView);
+
+    m_visibleObjects.clear();
+    m_objectTree.Cull(m_frustum, m_visibleObjects);
+    std::sort(m_visibleObjects.begin(), m_visibleObjects.end());
+
+    const uint64_t orderMask = (1ULL << RENDER_QUEUE_ORDER_BITS) - 1;
+    uint64_t order = 0;
+
+    for (int objRank : m_visibleObjects)
+    {
+        EngineObject& object = m_objects[objRank];
+
+        if (! object.drawWorld)
+            continue;
+
+        object.visible = true;
+
+        int baseObjRank = object.baseObjRank;
+        assert(baseObjRank >= 0 && baseObjRank < static_cast<int>( m_baseObjects.size() ));
+
+        const EngineBaseObject& p1 = m_baseObjects[baseObjRank];
+        if (! p1.used)
+            continue;
+
+        bool terrain = object.type == ENG_OBJTYPE_TERRAIN;
+        bool transparent = !terrain && object.transparency != 0.0f;
+
+        if (!terrain && !transparent)
+        {
+            if (object.impostor && AddImpostor(object))
+            {
+                m_statisticTriangleSaved += p1.totalTriangles - 2;
+                m_statisticImpostors++;
+                continue;
+            }
+
+            int lodBaseObjRank = GetLodBaseObjRank(object);
+            if (lodBaseObjRank != baseObjRank)
+            {
+                m_statisticTriangleSaved += p1.totalTriangles - m_baseObjects[lodBaseObjRank].totalTriangles;
+                m_statisticLodObjects++;
+                baseObjRank = lodBaseObjRank;
+            }
+        }
+
+        for (const EngineBaseObjTexTier& p2 : m_baseObjects[baseObjRank].next)
+        {
+            for (const EngineBaseObjDataTier& p3 : p2.next)
+            {
+                EngineRenderPass pass = ENG_RPASS_OPAQUE;
+                if (terrain)
+                    pass = ENG_RPASS_TERRAIN;
+                else if (transparent)
+                    pass = ENG_RPASS_TRANSPARENT;
+                else if ((p3.state & RENDER_QUEUE_BLENDED_STATES) != 0)
+                    pass = ENG_RPASS_BLENDED;
+
+                EngineDrawRecord record;
+                record.objRank = objRank;
+                record.p2 = &p2;
+                record.p3 = &p3;
+                record.key = static_cast<uint64_t>(pass) << RENDER_QUEUE_PASS_SHIFT;
+
+                if (pass == ENG_RPASS_TERRAIN || pass == ENG_RPASS_OPAQUE)
+                {
+                    uint64_t textures = (static_cast<uint64_t>(p2.tex1.id) << 32) | p2.tex2.id;
+
+                    record.key |= static_cast<uint64_t>(object.type) << RENDER_QUEUE_TYPE_SHIFT;
+                    record.key |= GetRenderQueueIndex(m_renderQueueStates, static_cast<uint32_t>(p3.state),
+                                                      RENDER_QUEUE_STATE_BITS) << RENDER_QUEUE_STATE_SHIFT;
+                    record.key |= GetRenderQueueIndex(m_renderQueueTextures, textures,
+                                                      RENDER_QUEUE_TEXTURE_BITS) << RENDER_QUEUE_TEXTURE_SHIFT;
+                    record.key |= GetRenderQueueIndex(m_renderQueueMaterials, HashMaterial(p3.material),
+                                                      RENDER_QUEUE_MATERIAL_BITS) << RENDER_QUEUE_MATERIAL_SHIFT;
+                    // Base object rank, so instances of shared geometry end up next to each other
+                    record.key |= std::min(static_cast<uint64_t>(baseObjRank), orderMask);
+                }
+                else
+                {
+                    // Blended draws keep the order of the scene
+                    record.key |= std::min(order, orderMask);
+                }
+
+                order++;
+                m_renderQueue.push_back(record);
+            }
+        }
+    }
+
+    SortRenderQueue();
+
+    int record = 0;
+    for (int pass = 0; pass <= ENG_RPASS_COUNT; pass++)
+    {
+        while (record < static_cast<int>(m_renderQueue.size()) &&
+               static_cast<int>(m_renderQueue[record].key >> RENDER_QUEUE_PASS_SHIFT) < pass)
+        {
+            record++;
+        }
+
+        m_renderQueuePassStart[pass] = record;
+    }
+}
+
+void CEngine::SortRenderQueue()
+{
+    // LSD radix sort, one byte of the key at a time; stable, so equal keys keep scene order
+    const std::size_t count = m_renderQueue.size();
+    if (count < 2)
+        return;
+
+    m_renderQueueScratch.resize(count);
+
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        std::size_t offsets[256] = {};
+        for (const EngineDrawRecord& record : m_renderQueue)
+            offsets[(record.key >> shift) & 0xFF]++;
+
+        // All keys share this byte
+        if (offsets[(m_renderQueue[0].key >> shift) & 0xFF] == count)
+            continue;
+
+        std::size_t offset = 0;
+        for (std::size_t& bucket : offsets)
+        {
+            std::size_t size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+
+        for (const EngineDrawRecord& record : m_renderQueue)
+            m_renderQueueScratch[offsets[(record.key >> shift) & 0xFF]++] = record;
+
+        m_renderQueue.swap(m_renderQueueScratch);
+    }
+}
+
+void CEngine::DrawRenderQueue(EngineRenderPass pass)
+{
+    int begin = m_renderQueuePassStart[pass];
+    int end = m_renderQueuePassStart[pass + 1];
+
+    int tState = ENG_RSTATE_TTEXTURE_BLACK | ENG_RSTATE_2FACE;
+    Color tColor = Color(68.0f / 255.0f, 68.0f / 255.0f, 68.0f / 255.0f, 68.0f / 255.0f);
+
+    // Draw order does not matter in these passes, so instances of shared geometry can be drawn together
+    bool instancing = (pass == ENG_RPASS_TERRAIN || pass == ENG_RPASS_OPAQUE);
+
+    const EngineDrawRecord* last = nullptr;
+    int lastObjRank = -1;  // -1 when the world transform is not known
+    int lastType = -1;
+
+    for (int i = begin; i < end; i++)
+    {
+        EngineDrawRecord& record = m_renderQueue[i];
+        if (record.p3 == nullptr)
+            continue;  // already drawn as an instance
+
+        const EngineObject& object = m_objects[record.objRank];
+
+        if (lastType != object.type)
+        {
+            m_lightMan->UpdateDeviceLights(object.type);
+            lastType = object.type;
+        }
+
+        if (last == nullptr || last->p2 != record.p2)
+        {
+            if (last == nullptr || !(last->p2->tex1 == record.p2->tex1))
+                SetTexture(record.p2->tex1, 0);
+            if (last == nullptr || !(last->p2->tex2 == record.p2->tex2))
+                SetTexture(record.p2->tex2, 1);
+        }
+
+        if (last == nullptr || last->p3->material != record.p3->material)
+            SetMaterial(record.p3->material);
+
+        if (pass == ENG_RPASS_TRANSPARENT)
+            SetState(tState, tColor);
+        else
+            SetState(record.p3->state);
+
+        last = &record;
+
+        if (instancing && record.p3->geometry->staticBufferId != 0)
+        {
+            // Records with equal keys share state, textures, material and base object,
+            // collect all of them drawing the same data
+            m_instanceMatrices.clear();
+            m_instanceMatrices.push_back(object.transform);
+
+            for (int j = i + 1; j < end && m_renderQueue[j].key == record.key; j++)
+            {
+                if (m_renderQueue[j].p3 != record.p3)
+                    continue;
+
+                m_instanceMatrices.push_back(m_objects[m_renderQueue[j].objRank].transform);
+                m_renderQueue[j].p3 = nullptr;
+            }
+
+            if (m_instanceMatrices.size() > 1)
+            {
+                int count = static_cast<int>(m_instanceMatrices.size());
+                m_device->DrawStaticBufferInstanced(record.p3->geometry->staticBufferId, m_instanceMatrices.data(), count);
+                lastObjRank = -1;
+
+                if (record.p3->type == ENG_TRIANGLE_TYPE_TRIANGLES)
+                    m_statisticTriangle += count * (record.p3->geometry->vertices.size() / 3);
+                else
+                    m_statisticTriangle += count * (record.p3->geometry->vertices.size() - 2);
+
+                continue;
+            }
+        }
+
+        if (lastObjRank != record.objRank)
+        {
+            m_device->SetTransform(TRANSFORM_WORLD, object.transform);
+            lastObjRank = record.objRank;
+        }
+
+        DrawObject(*record.p3);
+    }
+}
+
+int CEngine::GetLodBaseObjRank(const EngineObject& object)
+{
+    const EngineBaseObject& p1 = m_baseObjects[object.baseObjRank];
+
+    int baseObjRank = object.baseObjRank;
+
+    // The farthest level reached wins, missing levels keep the better geometry
+    for (int lodLevel = 0; lodLevel < ENG_LOD_COUNT; lodLevel++)
+    {
+        if (m_lodDistance[lodLevel] <= 0.0f || object.distance < m_lodDistance[lodLevel])
+            continue;
+
+        int lodBaseObjRank = p1.lodBaseObjRank[lodLevel];
+        if (lodBaseObjRank != -1 && m_baseObjects[lodBaseObjRank].used)
+            baseObjRank = lodBaseObjRank;
+    }
+
+    return baseObjRank;
+}
+
+bool CEngine::AddImpostor(const EngineObject& object)
+{
+    if (!m_impostorsSupported || m_impostorDistance <= 0.0f || object.distance < m_impostorDistance)
+        return false;
+
+    EngineBaseObject& p1 = m_baseObjects[object.baseObjRank];
+
+    if (p1.impostorSlot == -1)
+    {
+        if (m_impostorSlots.empty())
+        {
+            if (!m_device->IsFramebufferSupported() || m_device->GetMaxTextureSize() < IMPOSTOR_ATLAS_SIZE)
+            {
+                m_impostorsSupported = false;
+                return false;
+            }
+
+            m_impostorSlots.assign(IMPOSTOR_ATLAS_SLOTS * IMPOSTOR_ATLAS_SLOTS, -1);
+            m_impostorReady.assign(m_impostorSlots.size(), false);
+        }
+
+        auto it = std::find(m_impostorSlots.begin(), m_impostorSlots.end(), -1);
+        if (it == m_impostorSlots.end())
+            return false;  // atlas full, keep drawing the mesh
+
+        *it = object.baseObjRank;
+        p1.impostorSlot = it - m_impostorSlots.begin();
+        m_impostorsDirty = true;
+    }
+
+    // The image is rendered at the beginning of next frame
+    if (!m_impostorReady[p1.impostorSlot])
+        return false;
+
+    const float* m = object.transform.m;
+    float scale = Math::Max(Math::Vector(m[0], m[1], m[2]).Length(),
+                            Math::Vector(m[4], m[5], m[6]).Length(),
+                            Math::Vector(m[8], m[9], m[10]).Length());
+
+    Math::Vector center = Math::Transform(object.transform, p1.boundingSphere.pos);
+    float size = p1.boundingSphere.radius * scale;
+
+    // Quad facing the camera, turning only around the vertical axis
+    Math::Vector normal = m_eyePt - center;
+    normal.y = 0.0f;
+    if (normal.Length() < 0.001f)
+        normal = Math::Vector(0.0f, 0.0f, 1.0f);
+    else
+        normal.Normalize();
+
+    Math::Vector right = Math::CrossProduct(Math::Vector(0.0f, 1.0f, 0.0f), normal) * size;
+    Math::Vector up = Math::Vector(0.0f, size, 0.0f);
+
+    // Half a texel inside the slot, so that filtering does not pick up the neighbours
+    const float texel = 1.0f / IMPOSTOR_ATLAS_SIZE;
+    const float slotSize = static_cast<float>(IMPOSTOR_SLOT_SIZE) / IMPOSTOR_ATLAS_SIZE;
+    float u0 = (p1.impostorSlot % IMPOSTOR_ATLAS_SLOTS) * slotSize + 0.5f * texel;
+    float v0 = (p1.impostorSlot / IMPOSTOR_ATLAS_SLOTS) * slotSize + 0.5f * texel;
+    float u1 = u0 + slotSize - texel;
+    float v1 = v0 + slotSize - texel;
+
+    // Framebuffer images have their first row at the bottom
+    Vertex bottomLeft (center - right - up, normal, Math::Point(u0, v0));
+    Vertex bottomRight(center + right - up, normal, Math::Point(u1, v0));
+    Vertex topLeft    (center - right + up, normal, Math::Point(u0, v1));
+    Vertex topRight   (center + right + up, normal, Math::Point(u1, v1));
+
+    m_impostorVertices.push_back(bottomLeft);
+    m_impostorVertices.push_back(bottomRight);
+    m_impostorVertices.push_back(topLeft);
+    m_impostorVertices.push_back(topLeft);
+    m_impostorVertices.push_back(bottomRight);
+    m_impostorVertices.push_back(topRight);
+
+    return true;
+}
+
+void CEngine::ReleaseImpostor(int baseObjRank)
+{
+    EngineBaseObject& p1 = m_baseObjects[baseObjRank];
+    if (p1.impostorSlot == -1)
+        return;
+
+    m_impostorSlots[p1.impostorSlot] = -1;
+    m_impostorReady[p1.impostorSlot] = false;
+    p1.impostorSlot = -1;
+}
+
+void CEngine::RenderImpostors()
+{
+    m_impostorsDirty = false;
+
+    CFramebuffer* framebuffer = m_device->GetFramebuffer("impostors");
+    if (framebuffer == nullptr)
+    {
+        FramebufferParams params;
+        params.width = params.height = IMPOSTOR_ATLAS_SIZE;
+        params.depth = 24;
+        params.colorAttachment = FramebufferParams::AttachmentType::Texture;
+        params.depthAttachment = FramebufferParams::AttachmentType::Renderbuffer;
+
+        framebuffer = m_device->CreateFramebuffer("impostors", params);
+        if (framebuffer == nullptr)
+        {
+            GetLogger()->Error("Could not create impostor framebuffer, disabling impostors\n");
+            m_impostorsSupported = false;
+            return;
+        }
+    }
+
+    // Clearing affects the whole atlas, so all assigned slots are rendered again
+    framebuffer->Bind();
+
+    m_device->SetClearColor(Color(0.0f, 0.0f, 0.0f, 0.0f));
+    m_device->Clear();
+
+    m_device->SetRenderState(RENDER_STATE_DEPTH_TEST, true);
+    m_device->SetRenderState(RENDER_STATE_LIGHTING, true);
+
+    // Fog is enabled by some states, push it beyond the images
+    m_device->SetFogParams(FOG_LINEAR, m_fogColor[m_rankView], 1.0e6f, 2.0e6f, 1.0f);
+
+    Math::Matrix worldMatrix;
+    worldMatrix.LoadIdentity();
+    m_device->SetTransform(TRANSFORM_WORLD, worldMatrix);
+
+    m_lightMan->UpdateDeviceLights(ENG_OBJTYPE_FIX);
+
+    for (int slot = 0; slot < static_cast<int>( m_impostorSlots.size() ); slot++)
+    {
+        int baseObjRank = m_impostorSlots[slot];
+        if (baseObjRank == -1)
+            continue;
+
+        const EngineBaseObject& p1 = m_baseObjects[baseObjRank];
+
+        m_device->SetViewport((slot % IMPOSTOR_ATLAS_SLOTS) * IMPOSTOR_SLOT_SIZE,
+                              (slot / IMPOSTOR_ATLAS_SLOTS) * IMPOSTOR_SLOT_SIZE,
+                              IMPOSTOR_SLOT_SIZE, IMPOSTOR_SLOT_SIZE);
+
+        // Side view of the bounding sphere, the same image is used for every orientation
+        Math::Vector center = p1.boundingSphere.pos;
+        float radius = Math::Max(p1.boundingSphere.radius, 0.01f);
+
+        Math::Matrix projectionMatrix, viewMatrix;
+        Math::LoadOrthoProjectionMatrix(projectionMatrix, -radius, radius, -radius, radius, -radius, radius);
+        Math::LoadViewMatrix(viewMatrix, center, center + Math::Vector(0.0f, 0.0f, 1.0f), Math::Vector(0.0f, 1.0f, 0.0f));
+
+        m_device->SetTransform(TRANSFORM_PROJECTION, projectionMatrix);
+        m_device->SetTransform(TRANSFORM_VIEW, viewMatrix);
+
+        for (const EngineBaseObjTexTier& p2 : p1.next)
+        {
+            SetTexture(p2.tex1, 0);
+            SetTexture(p2.tex2, 1);
+
+            for (const EngineBaseObjDataTier& p3 : p2.next)
+            {
+                SetMaterial(p3.material);
+                SetState(p3.state);
+
+                DrawObject(p3);
+            }
+        }
+
+        m_impostorReady[slot] = true;
+    }
+
+    framebuffer->Unbind();
+
+    m_device->SetViewport(0, 0, m_size.x, m_size.y);
+}
+
+void CEngine::DrawImpostors()
+{
+    if (m_impostorVertices.empty())
+        return;
+
+    CFramebuffer* framebuffer = m_device->GetFramebuffer("impostors");
+    assert(framebuffer != nullptr);
+
+    Texture texture;
+    texture.id = framebuffer->GetColorTexture();
+    texture.size = Math::IntPoint(IMPOSTOR_ATLAS_SIZE, IMPOSTOR_ATLAS_SIZE);
+    texture.alpha = true;
+
+    Math::Matrix worldMatrix;
+    worldMatrix.LoadIdentity();
+    m_device->SetTransform(TRANSFORM_WORLD, worldMatrix);
+
+    // The images are already lit
+    m_device->SetRenderState(RENDER_STATE_LIGHTING, false);
+
+    SetTexture(texture, 0);
+    SetTexture(Texture(), 1);
+    SetState(ENG_RSTATE_ALPHA | ENG_RSTATE_2FACE);
+
+    m_device->DrawPrimitive(PRIMITIVE_TRIANGLES, m_impostorVertices.data(), m_impostorVertices.size());
+    AddStatisticTriangle(m_impostorVertices.size() / 3);
+
+    m_device->SetRenderState(RENDER_STATE_LIGHTING, true);
+}
+
 void CEngine::DrawInterface()
 {
     m_device->SetRenderMode(RENDER_MODE_INTERFACE);
@@ -4126,6 +5004,7 @@ void CEngine::DrawInterface()
         interface->Draw();
     }
 
+    FlushInterfaceBatch();
     m_interfaceMode = false;
     m_lastState = -1;
     SetState(Gfx::ENG_RSTATE_NORMAL);
@@ -4226,6 +5105,7 @@ void CEngine::DrawInterface()
 
     DrawTimer();
     DrawStats();
+    DrawTextBenchmark();
 
     if (m_renderInterface)
         DrawMouse();
@@ -5140,7 +6020,7 @@ void CEngine::DrawStats()
 
     float height = m_text->GetAscent(FONT_COMMON, 13.0f);
     float width = 0.4f;
-    const int TOTAL_LINES = 22;
+    const int TOTAL_LINES = 27;
 
     Math::Point pos(0.05f * m_size.x/m_size.y, 0.05f + TOTAL_LINES * height);
 
@@ -5228,6 +6108,20 @@ void CEngine::DrawStats()
     drawStatsCounter("Swap buffers & VSync",  PCNT_SWAP_BUFFERS);
     drawStatsLine(   "", "", "");
     drawStatsLine(   "Triangles",         StrUtils::ToString<int>(m_statisticTriangle), "");
+    drawStatsLine(   "    saved by LOD",  StrUtils::ToString<int>(m_statisticTriangleSaved),
+                     StrUtils::Format("%d lod, %d imp", m_statisticLodObjects, m_statisticImpostors));
+    drawStatsLine(   "Textures queued",   StrUtils::ToString<int>(m_textureLoader->GetQueueDepth()),
+                     StrUtils::Format("%.2f ms", m_textureLoader->GetAverageDecodeTime()));
+    drawStatsLine(   "UI draws",          StrUtils::ToString<int>(m_statisticInterfaceDraws),
+                     StrUtils::Format("%d strips", m_statisticInterfaceStrips));
+    int realVoices = 0, virtualVoices = 0;
+    if (m_sound != nullptr)
+        m_sound->GetVoiceCount(realVoices, virtualVoices);
+    drawStatsLine(   "Sound voices",      StrUtils::ToString<int>(realVoices),
+                     StrUtils::Format("%d virtual", virtualVoices));
+    CEventQueue* eventQueue = m_app->GetEventQueue();
+    drawStatsLine(   "Events queued",     StrUtils::ToString<int>(eventQueue->GetSize()),
+                     StrUtils::Format("%d max", eventQueue->GetHighWaterMark()));
     drawStatsLine(   "FPS",               StrUtils::Format("%.3f", m_fps), "");
     drawStatsLine(   "", "", "");
     std::stringstream str;
@@ -5235,6 +6129,56 @@ void CEngine::DrawStats()
     drawStatsLine(   "Position",          str.str(), "");
 }
 
+void CEngine::DrawTextBenchmark()
+{
+    if (!m_textBenchmark)
+        return;
+
+    // A program, drawn like in the editor (per-character format) and like console and
+    // label text (single font, aligned and wrapped). Only the frame counter changes between frames.
+    static const char* const program[] =
+    {
+        "extern void object::CollectTitanium()",
+        "{",
+        "\tobject item = radar(TitaniumOre);",
+        "\twhile (item != null)",
+        "\t{",
+        "\t\tgoto(item.position);",
+        "\t\tgrab();",
+        "\t\tmessage(\"Ore found at \" + item.position.x);",
+        "\t\titem = radar(TitaniumOre);",
+        "\t}",
+        "}",
+    };
+    const int PROGRAM_LINES = sizeof(program) / sizeof(program[0]);
+    const int TOTAL_LINES = 40;
+
+    float height = m_text->GetHeight(FONT_STUDIO, FONT_SIZE_SMALL);
+    Math::Point pos(0.02f, 0.95f);
+    std::vector<FontMetaChar> format;
+    for (int i = 0; i < TOTAL_LINES; i++)
+    {
+        std::string line = program[i % PROGRAM_LINES];
+
+        format.assign(line.size(), FONT_STUDIO);
+        std::size_t type = line.find("object");
+        if (type != std::string::npos)
+            std::fill(format.begin() + type, format.begin() + type + 6, static_cast<FontMetaChar>(FONT_STUDIO | FONT_HIGHLIGHT_TYPE));
+
+        SetState(ENG_RSTATE_TEXT);
+        m_text->DrawText(line, format.begin(), format.end(), FONT_SIZE_SMALL, pos, 0.45f, TEXT_ALIGN_LEFT, 0);
+        m_text->Justify(line, format.begin(), format.end(), FONT_SIZE_SMALL, 0.2f);
+
+        m_text->DrawText(line, FONT_COMMON, FONT_SIZE_SMALL, Math::Point(0.75f, pos.y), 0.45f, TEXT_ALIGN_CENTER, 0);
+        m_text->Justify(line, FONT_COMMON, FONT_SIZE_SMALL, 0.2f);
+
+        pos.y -= height;
+    }
+
+    m_text->DrawText(StrUtils::Format("Frame %d", m_textBenchmarkFrame++), FONT_COMMON, FONT_SIZE_BIG,
+                     Math::Point(0.5f, 0.02f), 1.0f, TEXT_ALIGN_CENTER, 0);
+}
+
 void CEngine::DrawTimer()
 {
     SetState(ENG_RSTATE_TEXT);
@@ -5522,6 +6466,9 @@ void CEngine::SetDebugGotoBitmap(std::unique_ptr<CImage> debugImage)
 
 void CEngine::SetInterfaceCoordinates()
 {
+    // Batched strips are drawn with the transforms they were added under
+    FlushInterfaceBatch();
+
     m_device->SetTransform(TRANSFORM_VIEW,       m_matViewInterface);
     m_device->SetTransform(TRANSFORM_PROJECTION, m_matProjInterface);
     m_device->SetTransform(TRANSFORM_WORLD,      m_matWorldInterface);
@@ -5543,6 +6490,9 @@ void CEngine::DisablePauseBlur()
 
 void CEngine::SetWindowCoordinates()
 {
+    // Batched strips are drawn with the transforms they were added under
+    FlushInterfaceBatch();
+
     Math::Matrix matWorldWindow;
     matWorldWindow.LoadIdentity();
 
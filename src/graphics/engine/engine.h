@@ -31,6 +31,8 @@
 #include "graphics/core/texture.h"
 #include "graphics/core/vertex.h"
 
+#include "graphics/engine/object_bvh.h"
+
 #include "math/intpoint.h"
 #include "math/matrix.h"
 #include "math/point.h"
@@ -38,6 +40,7 @@
 #include "math/vector.h"
 
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <map>
@@ -70,6 +73,8 @@ class CLightning;
 class CPlanet;
 class CTerrain;
 class CPyroManager;
+class CTextureAtlas;
+class CTextureLoader;
 class CModelMesh;
 struct ModelShadowSpot;
 struct ModelTriangle;
@@ -187,6 +192,20 @@ enum EngineObjectType
 };
 
 
+/**
+ * \struct EngineGeometry
+ * \brief Vertex data of a tier 3 object, shared between copies of a base object
+ *
+ * Copies of a base object reference the same geometry and static buffer.
+ * The geometry is detached (cloned) before it is modified through one of them.
+ */
+struct EngineGeometry
+{
+    std::vector<VertexTex2> vertices;
+    unsigned int            staticBufferId = 0;
+    bool                    updateStaticBuffer = false;
+};
+
 /**
  * \struct EngineBaseObjDataTier
  * \brief Tier 3 of object tree (data)
@@ -196,9 +215,7 @@ struct EngineBaseObjDataTier
     EngineTriangleType      type;
     Material                material;
     int                     state;
-    std::vector<VertexTex2> vertices;
-    unsigned int            staticBufferId;
-    bool                    updateStaticBuffer;
+    std::shared_ptr<EngineGeometry> geometry;
 
     inline EngineBaseObjDataTier(EngineTriangleType type = ENG_TRIANGLE_TYPE_TRIANGLES,
                                  const Material& material = Material(),
@@ -206,8 +223,7 @@ struct EngineBaseObjDataTier
      : type(type)
      , material(material)
      , state(state)
-     , staticBufferId(0)
-     , updateStaticBuffer(false)
+     , geometry(std::make_shared<EngineGeometry>())
     {}
 };
 
@@ -230,6 +246,20 @@ struct EngineBaseObjTexTier
     {}
 };
 
+/**
+ * \enum EngineLodLevel
+ * \brief Reduced levels of detail used for distant objects
+ */
+enum EngineLodLevel
+{
+    //! Medium detail
+    ENG_LOD_MEDIUM = 0,
+    //! Low detail
+    ENG_LOD_LOW    = 1,
+    //! Number of reduced levels
+    ENG_LOD_COUNT
+};
+
 /**
  * \struct BaseEngineObject
  * \brief Base (template) object - geometry for engine objects
@@ -248,6 +278,10 @@ struct EngineBaseObject
     Math::Vector           bboxMax;
     //! A bounding sphere that contains all the vertices in this EngineBaseObject
     Math::Sphere           boundingSphere;
+    //! Base objects drawn instead of this one at a distance, -1 if the level is missing
+    int                    lodBaseObjRank[ENG_LOD_COUNT] = { -1, -1 };
+    //! Slot in the impostor atlas, -1 if none is assigned
+    int                    impostorSlot = -1;
     //! Next tier (Tex)
     std::vector<EngineBaseObjTexTier> next;
 
@@ -283,6 +317,10 @@ struct EngineObject
     int                    shadowRank = -1;
     //! Transparency of the object [0, 1]
     float                  transparency = 0.0f;
+    //! If true, the object is queued for refitting in the object tree
+    bool                   treeDirty = false;
+    //! If true, the object can be drawn as an impostor at a distance
+    bool                   impostor = false;
 
     //! Loads default values
     inline void LoadDefault()
@@ -291,6 +329,42 @@ struct EngineObject
     }
 };
 
+/**
+ * \enum EngineRenderPass
+ * \brief Pass of the 3D scene in which a draw record is submitted
+ *
+ * Passes are drawn in the order of their values.
+ */
+enum EngineRenderPass
+{
+    //! Terrain, drawn first with shadow mapping
+    ENG_RPASS_TERRAIN       = 0,
+    //! Opaque parts of objects
+    ENG_RPASS_OPAQUE        = 1,
+    //! Blended parts of non-transparent objects, drawn in scene order
+    ENG_RPASS_BLENDED       = 2,
+    //! Objects with transparency set, drawn in scene order
+    ENG_RPASS_TRANSPARENT   = 3,
+    //! Number of passes
+    ENG_RPASS_COUNT
+};
+
+/**
+ * \struct EngineDrawRecord
+ * \brief Single draw of the sorted 3D render queue
+ */
+struct EngineDrawRecord
+{
+    //! Sort key: pass, object type, state, textures, material and base object rank (from most significant)
+    uint64_t                        key = 0;
+    //! Rank of the drawn object
+    int                             objRank = -1;
+    //! Texture tier of the drawn data
+    const EngineBaseObjTexTier*     p2 = nullptr;
+    //! Drawn data
+    const EngineBaseObjDataTier*    p3 = nullptr;
+};
+
 /**
  * \struct EngineShadowType
  * \brief Type of shadow drawn by the graphics engine
@@ -647,6 +721,9 @@ public:
     //! Management of displaying statistic information
     void            SetShowStats(bool show);
     bool            GetShowStats();
+
+    //! Draws a text-heavy interface over the scene, used by the rendering benchmark
+    void            SetTextBenchmark(bool enable);
     //@}
 
     //! Enables/disables rendering
@@ -727,8 +804,13 @@ public:
     //! Deletes all base objects
     void            DeleteAllBaseObjects();
 
-    //! Copies geometry between two base objects
+    //! Copies a base object, sharing its geometry with the source
     void            CopyBaseObject(int sourceBaseObjRank, int destBaseObjRank);
+    //! Replaces the 1st texture of a base object without touching its geometry
+    void            ChangeBaseObjTexture(int baseObjRank, const std::string& tex1Name,
+                                         const std::string& newTex1Name);
+    //! Returns the vertex memory of a base object, split into geometry owned alone and shared with copies
+    void            GetBaseObjectMemory(int baseObjRank, std::size_t& uniqueBytes, std::size_t& sharedBytes);
 
     //! Adds triangles to given object with the specified params
     void AddBaseObjTriangles(int baseObjRank, const std::vector<Gfx::ModelTriangle>& triangles);
@@ -738,6 +820,9 @@ public:
                                     std::string tex1Name, std::string tex2Name,
                                     bool globalUpdate);
 
+    //! Sets the base object drawn instead of the given one at the given level of detail
+    void            SetBaseObjectLod(int baseObjRank, EngineLodLevel lodLevel, int lodBaseObjRank);
+
     // Objects
 
     //! Print debug info about an object
@@ -773,6 +858,9 @@ public:
     //! Sets drawFront for given object
     void            SetObjectDrawFront(int objRank, bool draw);
 
+    //! Allows drawing the object as an impostor, only for objects that look the same from every side
+    void            SetObjectImpostor(int objRank, bool enabled);
+
     //! Sets the transparency level for given object
     void            SetObjectTransparency(int objRank, float value);
 
@@ -881,6 +969,15 @@ public:
     //! Loads all necessary textures
     bool            LoadAllTextures();
 
+    //! Starts decoding the texture in background, so that loading it later does not stall
+    /** The texture is not uploaded until it is loaded or streamed with its own parameters.
+        Images not used by the next LoadAllTextures() are dropped. */
+    void            PrefetchTexture(const std::string& name);
+    //! Returns the texture if it is loaded, otherwise queues it for decoding and returns a placeholder
+    /** Tier 2 textures referring to the placeholder are replaced when the texture is ready.
+        Returns invalid texture if loading the texture failed before. */
+    Texture         StreamTexture(const std::string& name, const TextureCreateParams& params);
+
     //! Changes colors in a texture
     //@{
     bool            ChangeTextureColor(const std::string& texName,
@@ -906,6 +1003,15 @@ public:
     //! Sets texture for given stage
     void            SetTexture(const Texture& tex, int stage = 0);
 
+    //! Draws a textured triangle strip of the interface with the current texture and state
+    /** Texture coordinates refer to the texture set by name and are mapped into its atlas page.
+        While drawing the interface, strips are batched until the texture or state changes. */
+    void            DrawInterfaceStrip(const Vertex* vertices, int vertexCount);
+    //! Draws an untextured triangle strip of the interface, after the batched strips
+    void            DrawInterfaceStrip(const VertexCol* vertices, int vertexCount);
+    //! Draws the batched interface triangle strips
+    void            FlushInterfaceBatch();
+
     //! Deletes the given texture, unloading it and removing from cache
     void            DeleteTexture(const std::string& texName);
     //! Deletes the given texture, unloading it and removing from cache
@@ -1093,6 +1199,20 @@ public:
     float           GetShadowRange();
     //@}
 
+    //@{
+    //! Management of the distances beyond which reduced detail geometry is used
+    // NOTE: This is a setting configurable only in INI file
+    void            SetLodDistance(EngineLodLevel lodLevel, float value);
+    float           GetLodDistance(EngineLodLevel lodLevel);
+    //@}
+
+    //@{
+    //! Management of the distance beyond which objects allowed by SetObjectImpostor() are drawn as impostors, 0 disables them
+    // NOTE: This is a setting configurable only in INI file
+    void            SetImpostorDistance(float value);
+    float           GetImpostorDistance();
+    //@}
+
     //@{
     //! Management of shadow range
     // NOTE: This is an user configuration setting
@@ -1193,6 +1313,9 @@ public:
     /** This additionally sends EVENT_RELOAD_TEXTURES to reload all textures not maintained by CEngine **/
     void ReloadAllTextures();
 
+    //! Renders the characters of the interface text in the current language in advance
+    void PrewarmText();
+
 protected:
     //! Resets some states and flushes textures after device was changed (e.g. resoulution changed)
     /** Instead of calling this directly, send EVENT_RESOLUTION_CHANGED event **/
@@ -1237,6 +1360,8 @@ protected:
     void        DrawMouseSprite(Math::IntPoint pos, Math::IntPoint size, int icon);
     //! Draw statistic texts
     void        DrawStats();
+    //! Draws the text of the text benchmark
+    void        DrawTextBenchmark();
     //! Draw mission timer
     void        DrawTimer();
     void        RenderPendingDebugDraws();
@@ -1250,9 +1375,43 @@ protected:
     //! Create texture and add it to cache
     Texture CreateTexture(const std::string &texName, const TextureCreateParams &params, CImage* image = nullptr);
 
+    //! Uploads the streamed textures decoded since the last frame, within the frame time budget
+    void        UpdateTextureStreaming();
+    //! Replaces the placeholder with the given texture in tier 2 objects using the named texture
+    void        ReplaceStreamedTexture(const std::string& name, const Texture& tex);
+    //! Returns the texture drawn in place of streamed textures, creating it if needed
+    Texture     GetPlaceholderTexture();
+    //! Packs the interface textures into the atlas
+    void        BuildTextureAtlas();
+
     //! Tests whether the given object is visible
     bool        IsVisible(int objRank);
 
+    //! Queues the object for refitting in the object tree
+    void        MarkObjectTreeDirty(int objRank);
+    //! Queues all objects using the base object for refitting in the object tree
+    void        MarkBaseObjectTreeDirty(int baseObjRank);
+    //! Refits the object tree for queued objects
+    void        UpdateObjectTree();
+
+    //! Culls the objects of the 3D scene and fills the sorted render queue
+    void        BuildRenderQueue();
+    //! Sorts the render queue by key
+    void        SortRenderQueue();
+    //! Draws the records of one pass of the render queue, skipping redundant state changes
+    void        DrawRenderQueue(EngineRenderPass pass);
+
+    //! Returns the base object to draw for the object at its current distance
+    int         GetLodBaseObjRank(const EngineObject& object);
+    //! Queues an impostor for the object, returns false if it must be drawn as a mesh
+    bool        AddImpostor(const EngineObject& object);
+    //! Frees the impostor slot of a base object
+    void        ReleaseImpostor(int baseObjRank);
+    //! Renders the images of newly assigned impostors
+    void        RenderImpostors();
+    //! Draws the impostors queued by BuildRenderQueue
+    void        DrawImpostors();
+
     //! Detects whether an object is affected by the mouse
     bool        DetectBBox(int objRank, Math::Point mouse);
 
@@ -1272,6 +1431,9 @@ protected:
     //! Updates geometric parameters of objects (bounding box and radius)
     void        UpdateGeometry();
 
+    //! Gives the tier 3 object its own copy of shared geometry before it is modified
+    void        DetachGeometry(EngineBaseObjDataTier& p4);
+
     //! Updates a given static buffer
     void        UpdateStaticBuffer(EngineBaseObjDataTier& p4);
 
@@ -1317,6 +1479,10 @@ protected:
 
     //! Whether to show stats (FPS, etc)
     bool            m_showStats;
+    //! Whether to draw the text benchmark
+    bool            m_textBenchmark = false;
+    //! Frames drawn by the text benchmark
+    int             m_textBenchmarkFrame = 0;
     //! Rendering enabled?
     bool            m_render;
     //! Render / hide the UI?
@@ -1360,6 +1526,47 @@ protected:
     std::vector<EngineBaseObject> m_baseObjects;
     //! Object parameters
     std::vector<EngineObject>     m_objects;
+
+    //! Bounding volume hierarchy over world space bounding spheres of objects
+    CObjectBVH                    m_objectTree;
+    //! Objects queued for refitting in the object tree
+    std::vector<int>              m_objectTreeDirty;
+    //! Base objects whose bounding spheres changed since last refit
+    std::set<int>                 m_objectTreeDirtyBases;
+    //! Frustum of the camera
+    EngineFrustum                 m_frustum;
+    //! Frustum of the shadow map
+    EngineFrustum                 m_shadowFrustum;
+    //! Objects inside the camera frustum, sorted by rank
+    std::vector<int>              m_visibleObjects;
+    //! Objects inside the shadow map frustum, sorted by rank
+    std::vector<int>              m_shadowObjects;
+    //! Sorted draw records of the current frame
+    std::vector<EngineDrawRecord> m_renderQueue;
+    //! Scratch buffer for sorting the render queue
+    std::vector<EngineDrawRecord> m_renderQueueScratch;
+    //! World matrices of instances drawn together
+    std::vector<Math::Matrix>     m_instanceMatrices;
+    //! Index of first record of each pass in the render queue
+    int                           m_renderQueuePassStart[ENG_RPASS_COUNT + 1] = {};
+    //! Compact indices of states, texture pairs and materials used in sort keys
+    std::unordered_map<uint64_t, int> m_renderQueueStates;
+    std::unordered_map<uint64_t, int> m_renderQueueTextures;
+    std::unordered_map<uint64_t, int> m_renderQueueMaterials;
+    //! Distances beyond which reduced detail geometry is used
+    float                         m_lodDistance[ENG_LOD_COUNT];
+    //! Distance beyond which static objects are drawn as impostors
+    float                         m_impostorDistance;
+    //! Whether the impostor framebuffer can be used
+    bool                          m_impostorsSupported;
+    //! Whether some assigned impostor images have not been rendered yet
+    bool                          m_impostorsDirty;
+    //! Base object rank of each impostor atlas slot, -1 if free
+    std::vector<int>              m_impostorSlots;
+    //! Whether the image of each impostor atlas slot is rendered
+    std::vector<bool>             m_impostorReady;
+    //! Impostor quads of the current frame
+    std::vector<Vertex>           m_impostorVertices;
     //! Shadow list
     std::vector<EngineShadow>     m_shadowSpots;
     //! Ground spot list
@@ -1381,6 +1588,11 @@ protected:
     float           m_fogStart[2];
     Color           m_waterAddColor;
     int             m_statisticTriangle;
+    int             m_statisticTriangleSaved;
+    int             m_statisticLodObjects;
+    int             m_statisticImpostors;
+    int             m_statisticInterfaceStrips;
+    int             m_statisticInterfaceDraws;
     Math::Vector    m_statisticPos;
     bool            m_updateGeometry;
     bool            m_updateStaticBuffers;
@@ -1469,6 +1681,25 @@ protected:
     /** Textures on this list were not successful in first loading,
      *  so are disabled for subsequent load calls. */
     std::set<std::string> m_texBlacklist;
+    //! Decodes textures in background
+    std::unique_ptr<CTextureLoader> m_textureLoader;
+    //! Textures being streamed, with parameters used to create them when decoded
+    std::map<std::string, TextureCreateParams> m_streamedTextures;
+    //! Texture drawn until the streamed texture is ready
+    Texture         m_placeholderTexture;
+    //! Interface textures packed together
+    std::unique_ptr<CTextureAtlas> m_textureAtlas;
+    //! Texture set for stage 0 through the engine
+    Texture         m_currentTexture;
+    //! Mapping of texture coordinates into the atlas page of the current texture
+    Math::Point     m_currentTexOffset;
+    Math::Point     m_currentTexScale;
+    //! Interface triangle strips waiting for drawing
+    std::vector<Vertex> m_interfaceBatchVertices;
+    std::vector<int> m_interfaceBatchFirsts;
+    std::vector<int> m_interfaceBatchCounts;
+    //! Texture of the batched interface strips
+    Texture         m_interfaceBatchTexture;
 
     //! Texture with mouse cursors
     Texture         m_miceTexture;
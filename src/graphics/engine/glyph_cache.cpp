@@ -0,0 +1,222 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/glyph_cache.h"
+
+#include "common/image.h"
+#include "common/logger.h"
+#include "common/make_unique.h"
+
+#include "common/resources/mapped_file.h"
+#include "common/resources/outputstream.h"
+#include "common/resources/resourcemanager.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include <SDL.h>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+namespace
+{
+
+//! Directory of the cache, relative to the save location
+const std::string CACHE_DIRECTORY = "cache/fonts";
+//! Identifies glyph cache files
+const char CACHE_MAGIC[4] = { 'C', 'G', 'L', 'Y' };
+//! Version of the file layout
+const uint32_t CACHE_VERSION = 2;
+//! Total size of cache files kept at startup
+const long long CACHE_SIZE_LIMIT = 64LL * 1024 * 1024;
+//! Bytes per pixel of the font textures
+const int BYTES_PER_PIXEL = 4;
+
+/*
+ * Layout of the cache file, following the header of CCacheDirectory:
+ *   CacheHeader
+ *   CacheGlyph[glyphCount]
+ *   pixel data of each page, rows without padding, aligned to CCacheDirectory::ALIGNMENT
+ */
+
+struct CacheHeader
+{
+    uint32_t pageWidth;
+    uint32_t pageHeight;
+    uint32_t pageCount;
+    uint32_t glyphCount;
+};
+
+struct CacheGlyph
+{
+    int32_t font;
+    int32_t pointSize;
+    char ch[4];
+    uint32_t page;
+    int32_t x, y;
+    int32_t width, height;
+};
+
+} // anonymous namespace
+
+
+CGlyphCache::CGlyphCache()
+    : m_directory(CACHE_DIRECTORY, CACHE_MAGIC, CACHE_VERSION)
+{
+    // Keys do not tell if the fonts are still used, so only the size of the cache is limited
+    m_directory.Sweep(nullptr, CACHE_SIZE_LIMIT);
+}
+
+bool CGlyphCache::IsEnabled() const
+{
+    return m_directory.IsEnabled();
+}
+
+bool CGlyphCache::Load(const std::string& key, Math::IntPoint pageSize,
+                       std::vector<std::unique_ptr<CImage>>& pages, std::vector<GlyphPlacement>& glyphs)
+{
+    if (!IsEnabled())
+        return false;
+
+    auto file = std::make_shared<CMappedFile>();
+    CacheHeader header;
+    std::size_t tableOffset = 0;
+    if (!m_directory.OpenRead(CCacheDirectory::GetFileName(key), key, *file, &header, sizeof(header), tableOffset))
+        return false;
+
+    const char* data = file->GetData();
+    std::size_t size = file->GetSize();
+
+    if (static_cast<int>(header.pageWidth) != pageSize.x || static_cast<int>(header.pageHeight) != pageSize.y)
+        return false;
+
+    std::size_t pageBytes = static_cast<std::size_t>(pageSize.x) * pageSize.y * BYTES_PER_PIXEL;
+    std::size_t pixelsOffset = CCacheDirectory::Align(tableOffset + header.glyphCount * sizeof(CacheGlyph));
+    if (size < pixelsOffset + header.pageCount * pageBytes)
+        return false;
+
+    std::vector<CacheGlyph> table(header.glyphCount);
+    memcpy(table.data(), data + tableOffset, table.size() * sizeof(CacheGlyph));
+
+    std::vector<GlyphPlacement> newGlyphs;
+    for (const CacheGlyph& entry : table)
+    {
+        if (entry.page >= header.pageCount)
+            return false;
+
+        GlyphPlacement glyph;
+        glyph.font = static_cast<FontType>(entry.font);
+        glyph.pointSize = entry.pointSize;
+        glyph.ch = UTF8Char(entry.ch[0], entry.ch[1], entry.ch[2]);
+        glyph.page = entry.page;
+        glyph.pos = Math::IntPoint(entry.x, entry.y);
+        glyph.size = Math::IntPoint(entry.width, entry.height);
+        newGlyphs.push_back(glyph);
+    }
+
+    std::vector<std::unique_ptr<CImage>> newPages;
+    for (uint32_t i = 0; i < header.pageCount; ++i)
+    {
+        // The surface refers to the mapped file, the pixels are not copied
+        SDL_Surface* surface = SDL_CreateRGBSurfaceFrom(file->GetData() + pixelsOffset + i * pageBytes,
+                                                        pageSize.x, pageSize.y, BYTES_PER_PIXEL * 8,
+                                                        pageSize.x * BYTES_PER_PIXEL,
+                                                        0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+        if (surface == nullptr)
+            return false;
+
+        auto imageData = MakeUnique<ImageData>();
+        imageData->surface = surface;
+        auto image = MakeUnique<CImage>();
+        image->SetData(std::move(imageData), file);
+        newPages.push_back(std::move(image));
+    }
+
+    pages = std::move(newPages);
+    glyphs = std::move(newGlyphs);
+    return true;
+}
+
+bool CGlyphCache::Store(const std::string& key, Math::IntPoint pageSize,
+                        const std::vector<std::unique_ptr<CImage>>& pages, const std::vector<GlyphPlacement>& glyphs)
+{
+    if (!IsEnabled())
+        return false;
+
+    CacheHeader header;
+    header.pageWidth = pageSize.x;
+    header.pageHeight = pageSize.y;
+    header.pageCount = pages.size();
+    header.glyphCount = glyphs.size();
+
+    std::vector<CacheGlyph> table;
+    for (const GlyphPlacement& glyph : glyphs)
+    {
+        CacheGlyph entry;
+        entry.font = glyph.font;
+        entry.pointSize = glyph.pointSize;
+        entry.ch[0] = glyph.ch.c1;
+        entry.ch[1] = glyph.ch.c2;
+        entry.ch[2] = glyph.ch.c3;
+        entry.ch[3] = '\0';
+        entry.page = glyph.page;
+        entry.x = glyph.pos.x;
+        entry.y = glyph.pos.y;
+        entry.width = glyph.size.x;
+        entry.height = glyph.size.y;
+        table.push_back(entry);
+    }
+
+    COutputStream stream;
+    std::size_t position = 0;
+    if (!m_directory.OpenWrite(CCacheDirectory::GetFileName(key), key, stream, &header, sizeof(header), position))
+        return false;
+
+    stream.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(CacheGlyph));
+    position += table.size() * sizeof(CacheGlyph);
+    CCacheDirectory::WritePadding(stream, position, CCacheDirectory::Align(position));
+
+    for (const auto& page : pages)
+    {
+        SDL_Surface* surface = page->GetData()->surface;
+        assert(surface->w == pageSize.x && surface->h == pageSize.y && surface->format->BytesPerPixel == BYTES_PER_PIXEL);
+
+        SDL_LockSurface(surface);
+        for (int y = 0; y < surface->h; ++y)
+        {
+            stream.write(static_cast<const char*>(surface->pixels) + y * surface->pitch,
+                         surface->w * BYTES_PER_PIXEL);
+        }
+        SDL_UnlockSurface(surface);
+    }
+
+    bool ok = stream.good();
+    stream.close();
+
+    if (!ok)
+        GetLogger()->Warn("Couldn't write font cache file\n");
+
+    return ok;
+}
+
+} // namespace Gfx
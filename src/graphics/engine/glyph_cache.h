@@ -0,0 +1,93 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file graphics/engine/glyph_cache.h
+ * \brief On-disk cache of prerendered font textures - CGlyphCache class
+ */
+
+#pragma once
+
+#include "common/resources/cache_directory.h"
+
+#include "graphics/engine/text.h"
+
+#include "math/intpoint.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class CImage;
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+/**
+ * \struct GlyphPlacement
+ * \brief Place of a rendered character in the font textures
+ */
+struct GlyphPlacement
+{
+    //! Font type of the character
+    FontType font = FONT_COMMON;
+    //! Point size of the font
+    int pointSize = 0;
+    UTF8Char ch;
+    //! Index of the font texture
+    int page = 0;
+    Math::IntPoint pos;
+    Math::IntPoint size;
+};
+
+/**
+ * \class CGlyphCache
+ * \brief Cache of font textures filled with prerendered characters
+ *
+ * The textures are stored uncompressed in the cache directory of the save location,
+ * together with the places of the characters in them. The key identifies the fonts,
+ * their sizes and the set of characters, so the same textures can be used again
+ * on the next start without rendering the characters. The files written
+ * longest ago are removed when the cache grows over its size limit.
+ */
+class CGlyphCache
+{
+public:
+    //! Creates the cache directory; the cache is disabled if there is no save location
+    CGlyphCache();
+
+    //! Returns true if the cache can be used
+    bool IsEnabled() const;
+
+    //! Loads the font textures and character places stored with the given key
+    /** Texture images refer to the cache file mapped into memory. */
+    bool Load(const std::string& key, Math::IntPoint pageSize,
+              std::vector<std::unique_ptr<CImage>>& pages, std::vector<GlyphPlacement>& glyphs);
+    //! Stores the font textures and character places with the given key
+    /** All textures must be 32-bit images of \a pageSize. */
+    bool Store(const std::string& key, Math::IntPoint pageSize,
+               const std::vector<std::unique_ptr<CImage>>& pages, const std::vector<GlyphPlacement>& glyphs);
+
+private:
+    CCacheDirectory m_directory;
+};
+
+} // namespace Gfx
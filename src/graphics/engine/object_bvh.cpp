@@ -0,0 +1,520 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/object_bvh.h"
+
+#include "math/func.h"
+#include "math/geometry.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+
+void EngineFrustum::LoadFromMatrices(const Math::Matrix& proj, const Math::Matrix& view)
+{
+    // Devices flip the Z axis of view space, same planes as in CDevice::ComputeSphereVisibility()
+    Math::Matrix scale;
+    scale.Set(3, 3, -1.0f);
+    Math::Matrix projView = Math::MultiplyMatrices(proj, Math::MultiplyMatrices(scale, view));
+
+    for (int i = 0; i < 6; i++)
+    {
+        int row = 1 + i / 2;
+        float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+
+        Math::Vector planeNormal;
+        planeNormal.x = projView.Get(4, 1) + sign * projView.Get(row, 1);
+        planeNormal.y = projView.Get(4, 2) + sign * projView.Get(row, 2);
+        planeNormal.z = projView.Get(4, 3) + sign * projView.Get(row, 3);
+
+        float length = planeNormal.Length();
+        normal[i] = planeNormal * (1.0f / length);
+        distance[i] = (projView.Get(4, 4) + sign * projView.Get(row, 4)) / length;
+    }
+}
+
+bool EngineFrustum::IsSphereVisible(const Math::Vector& center, float radius) const
+{
+    for (int i = 0; i < 6; i++)
+    {
+        if (distance[i] + Math::DotProduct(normal[i], center) < -radius)
+            return false;
+    }
+
+    return true;
+}
+
+
+//! Returns surface area of the box, the cost measure for choosing tree layout
+static float BoxArea(const Math::Vector& min, const Math::Vector& max)
+{
+    Math::Vector size = max - min;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+static void CombineBoxes(const Math::Vector& min1, const Math::Vector& max1,
+                         const Math::Vector& min2, const Math::Vector& max2,
+                         Math::Vector& min, Math::Vector& max)
+{
+    min = Math::Vector(Math::Min(min1.x, min2.x), Math::Min(min1.y, min2.y), Math::Min(min1.z, min2.z));
+    max = Math::Vector(Math::Max(max1.x, max2.x), Math::Max(max1.y, max2.y), Math::Max(max1.z, max2.z));
+}
+
+
+CObjectBVH::CObjectBVH()
+{
+}
+
+CObjectBVH::~CObjectBVH()
+{
+}
+
+void CObjectBVH::Clear()
+{
+    m_nodes.clear();
+    m_leaves.clear();
+    m_root = -1;
+    m_freeList = -1;
+    m_objectCount = 0;
+}
+
+void CObjectBVH::Update(int objRank, const Math::Vector& center, float radius)
+{
+    assert(objRank >= 0);
+
+    if (objRank >= static_cast<int>( m_leaves.size() ))
+        m_leaves.resize(objRank + 1, -1);
+
+    Math::Vector min = center - Math::Vector(radius, radius, radius);
+    Math::Vector max = center + Math::Vector(radius, radius, radius);
+
+    int leaf = m_leaves[objRank];
+    if (leaf != -1)
+    {
+        Node& node = m_nodes[leaf];
+        node.center = center;
+        node.radius = radius;
+
+        // Still inside the enlarged box, the tree stays valid
+        if (node.min.x <= min.x && node.min.y <= min.y && node.min.z <= min.z &&
+            node.max.x >= max.x && node.max.y >= max.y && node.max.z >= max.z)
+            return;
+
+        RemoveLeaf(leaf);
+    }
+    else
+    {
+        leaf = AllocateNode();
+        m_nodes[leaf].objRank = objRank;
+        m_nodes[leaf].height = 0;
+        m_nodes[leaf].center = center;
+        m_nodes[leaf].radius = radius;
+        m_leaves[objRank] = leaf;
+        m_objectCount++;
+    }
+
+    // Enlarge the box so that moving objects are not reinserted every frame
+    float margin = 2.0f + 0.25f * radius;
+    m_nodes[leaf].min = min - Math::Vector(margin, margin, margin);
+    m_nodes[leaf].max = max + Math::Vector(margin, margin, margin);
+
+    InsertLeaf(leaf);
+}
+
+void CObjectBVH::Remove(int objRank)
+{
+    if (! Contains(objRank))
+        return;
+
+    int leaf = m_leaves[objRank];
+    RemoveLeaf(leaf);
+    FreeNode(leaf);
+    m_leaves[objRank] = -1;
+    m_objectCount--;
+}
+
+bool CObjectBVH::Contains(int objRank) const
+{
+    return objRank >= 0 && objRank < static_cast<int>( m_leaves.size() ) && m_leaves[objRank] != -1;
+}
+
+int CObjectBVH::GetObjectCount() const
+{
+    return m_objectCount;
+}
+
+int CObjectBVH::GetHeight() const
+{
+    if (m_root == -1)
+        return 0;
+
+    return m_nodes[m_root].height + 1;
+}
+
+void CObjectBVH::Cull(const EngineFrustum& frustum, std::vector<int>& objRanks) const
+{
+    if (m_root == -1)
+        return;
+
+    CullSubtree(m_root, frustum, (1 << 6) - 1, objRanks);
+}
+
+int CObjectBVH::AllocateNode()
+{
+    int node = m_freeList;
+    if (node != -1)
+    {
+        m_freeList = m_nodes[node].objRank;
+        m_nodes[node] = Node();
+    }
+    else
+    {
+        node = static_cast<int>( m_nodes.size() );
+        m_nodes.push_back(Node());
+    }
+
+    return node;
+}
+
+void CObjectBVH::FreeNode(int node)
+{
+    m_nodes[node] = Node();
+    m_nodes[node].objRank = m_freeList;
+    m_freeList = node;
+}
+
+void CObjectBVH::InsertLeaf(int leaf)
+{
+    if (m_root == -1)
+    {
+        m_root = leaf;
+        m_nodes[leaf].parent = -1;
+        return;
+    }
+
+    // Find the best sibling, descending where the growth of the boxes costs least
+    Math::Vector leafMin = m_nodes[leaf].min;
+    Math::Vector leafMax = m_nodes[leaf].max;
+
+    int index = m_root;
+    while (! m_nodes[index].IsLeaf())
+    {
+        const Node& node = m_nodes[index];
+
+        Math::Vector min, max;
+        CombineBoxes(node.min, node.max, leafMin, leafMax, min, max);
+
+        float area = BoxArea(node.min, node.max);
+        float combinedArea = BoxArea(min, max);
+
+        // Cost of creating a new parent for this node and the leaf
+        float cost = 2.0f * combinedArea;
+        // Minimum cost of pushing the leaf further down the tree
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        float childCost[2];
+        int children[2] = { node.child1, node.child2 };
+        for (int i = 0; i < 2; i++)
+        {
+            const Node& child = m_nodes[children[i]];
+            CombineBoxes(child.min, child.max, leafMin, leafMax, min, max);
+
+            if (child.IsLeaf())
+                childCost[i] = BoxArea(min, max) + inheritanceCost;
+            else
+                childCost[i] = BoxArea(min, max) - BoxArea(child.min, child.max) + inheritanceCost;
+        }
+
+        if (cost < childCost[0] && cost < childCost[1])
+            break;
+
+        index = (childCost[0] < childCost[1]) ? children[0] : children[1];
+    }
+
+    int sibling = index;
+
+    // Create a new parent for the sibling and the leaf
+    int newParent = AllocateNode();
+    int oldParent = m_nodes[sibling].parent;
+
+    Node& parent = m_nodes[newParent];
+    parent.parent = oldParent;
+    parent.height = m_nodes[sibling].height + 1;
+    parent.child1 = sibling;
+    parent.child2 = leaf;
+    CombineBoxes(m_nodes[sibling].min, m_nodes[sibling].max, leafMin, leafMax, parent.min, parent.max);
+
+    if (oldParent != -1)
+    {
+        if (m_nodes[oldParent].child1 == sibling)
+            m_nodes[oldParent].child1 = newParent;
+        else
+            m_nodes[oldParent].child2 = newParent;
+    }
+    else
+    {
+        m_root = newParent;
+    }
+
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    FixUpwards(newParent);
+}
+
+void CObjectBVH::RemoveLeaf(int leaf)
+{
+    if (leaf == m_root)
+    {
+        m_root = -1;
+        return;
+    }
+
+    int parent = m_nodes[leaf].parent;
+    int grandParent = m_nodes[parent].parent;
+    int sibling = (m_nodes[parent].child1 == leaf) ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    if (grandParent != -1)
+    {
+        // Put the sibling in place of the parent
+        if (m_nodes[grandParent].child1 == parent)
+            m_nodes[grandParent].child1 = sibling;
+        else
+            m_nodes[grandParent].child2 = sibling;
+
+        m_nodes[sibling].parent = grandParent;
+        FreeNode(parent);
+
+        FixUpwards(grandParent);
+    }
+    else
+    {
+        m_root = sibling;
+        m_nodes[sibling].parent = -1;
+        FreeNode(parent);
+    }
+
+    m_nodes[leaf].parent = -1;
+}
+
+void CObjectBVH::FixUpwards(int node)
+{
+    while (node != -1)
+    {
+        node = Balance(node);
+
+        Node& n = m_nodes[node];
+        const Node& child1 = m_nodes[n.child1];
+        const Node& child2 = m_nodes[n.child2];
+
+        n.height = 1 + std::max(child1.height, child2.height);
+        CombineBoxes(child1.min, child1.max, child2.min, child2.max, n.min, n.max);
+
+        node = n.parent;
+    }
+}
+
+/**
+ * Performs a left or right rotation if the subtree at \a iA is imbalanced.
+ * Returns the new root of the subtree.
+ */
+int CObjectBVH::Balance(int iA)
+{
+    Node& A = m_nodes[iA];
+    if (A.IsLeaf() || A.height < 2)
+        return iA;
+
+    int iB = A.child1;
+    int iC = A.child2;
+    Node& B = m_nodes[iB];
+    Node& C = m_nodes[iC];
+
+    int balance = C.height - B.height;
+
+    // Rotate C up
+    if (balance > 1)
+    {
+        int iF = C.child1;
+        int iG = C.child2;
+        Node& F = m_nodes[iF];
+        Node& G = m_nodes[iG];
+
+        C.child1 = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+
+        if (C.parent != -1)
+        {
+            if (m_nodes[C.parent].child1 == iA)
+                m_nodes[C.parent].child1 = iC;
+            else
+                m_nodes[C.parent].child2 = iC;
+        }
+        else
+        {
+            m_root = iC;
+        }
+
+        if (F.height > G.height)
+        {
+            C.child2 = iF;
+            A.child2 = iG;
+            G.parent = iA;
+            CombineBoxes(B.min, B.max, G.min, G.max, A.min, A.max);
+            CombineBoxes(A.min, A.max, F.min, F.max, C.min, C.max);
+            A.height = 1 + std::max(B.height, G.height);
+            C.height = 1 + std::max(A.height, F.height);
+        }
+        else
+        {
+            C.child2 = iG;
+            A.child2 = iF;
+            F.parent = iA;
+            CombineBoxes(B.min, B.max, F.min, F.max, A.min, A.max);
+            CombineBoxes(A.min, A.max, G.min, G.max, C.min, C.max);
+            A.height = 1 + std::max(B.height, F.height);
+            C.height = 1 + std::max(A.height, G.height);
+        }
+
+        return iC;
+    }
+
+    // Rotate B up
+    if (balance < -1)
+    {
+        int iD = B.child1;
+        int iE = B.child2;
+        Node& D = m_nodes[iD];
+        Node& E = m_nodes[iE];
+
+        B.child1 = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+
+        if (B.parent != -1)
+        {
+            if (m_nodes[B.parent].child1 == iA)
+                m_nodes[B.parent].child1 = iB;
+            else
+                m_nodes[B.parent].child2 = iB;
+        }
+        else
+        {
+            m_root = iB;
+        }
+
+        if (D.height > E.height)
+        {
+            B.child2 = iD;
+            A.child1 = iE;
+            E.parent = iA;
+            CombineBoxes(C.min, C.max, E.min, E.max, A.min, A.max);
+            CombineBoxes(A.min, A.max, D.min, D.max, B.min, B.max);
+            A.height = 1 + std::max(C.height, E.height);
+            B.height = 1 + std::max(A.height, D.height);
+        }
+        else
+        {
+            B.child2 = iE;
+            A.child1 = iD;
+            D.parent = iA;
+            CombineBoxes(C.min, C.max, D.min, D.max, A.min, A.max);
+            CombineBoxes(A.min, A.max, E.min, E.max, B.min, B.max);
+            A.height = 1 + std::max(C.height, D.height);
+            B.height = 1 + std::max(A.height, E.height);
+        }
+
+        return iB;
+    }
+
+    return iA;
+}
+
+void CObjectBVH::CullSubtree(int index, const EngineFrustum& frustum, int planeMask, std::vector<int>& objRanks) const
+{
+    const Node& node = m_nodes[index];
+
+    for (int i = 0; i < 6; i++)
+    {
+        if ((planeMask & (1 << i)) == 0)
+            continue;
+
+        const Math::Vector& normal = frustum.normal[i];
+
+        // Corners of the box farthest along and against the plane normal
+        Math::Vector positive(normal.x >= 0.0f ? node.max.x : node.min.x,
+                              normal.y >= 0.0f ? node.max.y : node.min.y,
+                              normal.z >= 0.0f ? node.max.z : node.min.z);
+        Math::Vector negative(normal.x >= 0.0f ? node.min.x : node.max.x,
+                              normal.y >= 0.0f ? node.min.y : node.max.y,
+                              normal.z >= 0.0f ? node.min.z : node.max.z);
+
+        if (Math::DotProduct(normal, positive) + frustum.distance[i] < 0.0f)
+            return;  // completely outside
+
+        if (Math::DotProduct(normal, negative) + frustum.distance[i] >= 0.0f)
+            planeMask &= ~(1 << i);  // completely inside, children need not test this plane
+    }
+
+    if (planeMask == 0)
+    {
+        AddSubtree(index, objRanks);
+        return;
+    }
+
+    if (node.IsLeaf())
+    {
+        for (int i = 0; i < 6; i++)
+        {
+            if ((planeMask & (1 << i)) == 0)
+                continue;
+
+            if (frustum.distance[i] + Math::DotProduct(frustum.normal[i], node.center) < -node.radius)
+                return;
+        }
+
+        objRanks.push_back(node.objRank);
+        return;
+    }
+
+    CullSubtree(node.child1, frustum, planeMask, objRanks);
+    CullSubtree(node.child2, frustum, planeMask, objRanks);
+}
+
+void CObjectBVH::AddSubtree(int index, std::vector<int>& objRanks) const
+{
+    const Node& node = m_nodes[index];
+
+    if (node.IsLeaf())
+    {
+        objRanks.push_back(node.objRank);
+        return;
+    }
+
+    AddSubtree(node.child1, objRanks);
+    AddSubtree(node.child2, objRanks);
+}
+
+
+} // namespace Gfx
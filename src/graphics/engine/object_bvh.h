@@ -0,0 +1,130 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file graphics/engine/object_bvh.h
+ * \brief Bounding volume hierarchy of engine objects - CObjectBVH class
+ */
+
+#pragma once
+
+#include "math/matrix.h"
+#include "math/vector.h"
+
+#include <vector>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+/**
+ * \struct EngineFrustum
+ * \brief View frustum given by 6 world space planes
+ *
+ * Points with DotProduct(normal, p) + distance >= 0 for all planes are inside.
+ */
+struct EngineFrustum
+{
+    //! Normals of planes (left, right, bottom, top, front, back)
+    Math::Vector normal[6];
+    //! Distances of planes from origin
+    float        distance[6] = {};
+
+    //! Extracts planes from projection and view matrices, as given to CDevice::SetTransform()
+    void LoadFromMatrices(const Math::Matrix& proj, const Math::Matrix& view);
+    //! Tests whether the sphere is at least partly inside
+    bool IsSphereVisible(const Math::Vector& center, float radius) const;
+};
+
+/**
+ * \class CObjectBVH
+ * \brief Dynamic bounding volume hierarchy over bounding spheres of engine objects
+ *
+ * Leaves hold enlarged boxes around the object spheres, so small movements
+ * only update the stored sphere and a leaf is reinserted only when its sphere
+ * leaves the box. Inner nodes are kept balanced by rotations on insertion and
+ * removal.
+ */
+class CObjectBVH
+{
+public:
+    CObjectBVH();
+    ~CObjectBVH();
+
+    //! Removes all objects
+    void Clear();
+
+    //! Adds or moves the object with given rank
+    void Update(int objRank, const Math::Vector& center, float radius);
+    //! Removes the object with given rank, if present
+    void Remove(int objRank);
+    //! Returns whether the object with given rank is present
+    bool Contains(int objRank) const;
+
+    //! Returns number of objects
+    int GetObjectCount() const;
+    //! Returns height of the tree (0 when empty, 1 for single leaf)
+    int GetHeight() const;
+
+    //! Appends ranks of objects whose spheres are at least partly inside the frustum, in no particular order
+    void Cull(const EngineFrustum& frustum, std::vector<int>& objRanks) const;
+
+private:
+    struct Node
+    {
+        Math::Vector min;
+        Math::Vector max;
+        //! Bounding sphere of the object (leaves only)
+        Math::Vector center;
+        float        radius = 0.0f;
+        int          parent = -1;
+        int          child1 = -1;
+        int          child2 = -1;
+        //! Rank of the object (leaves only), next free node for free nodes
+        int          objRank = -1;
+        //! 0 for leaves, -1 for free nodes
+        int          height = -1;
+
+        bool IsLeaf() const
+        {
+            return child1 == -1;
+        }
+    };
+
+    int  AllocateNode();
+    void FreeNode(int node);
+    void InsertLeaf(int leaf);
+    void RemoveLeaf(int leaf);
+    int  Balance(int node);
+    void FixUpwards(int node);
+    void CullSubtree(int index, const EngineFrustum& frustum, int planeMask, std::vector<int>& objRanks) const;
+    void AddSubtree(int index, std::vector<int>& objRanks) const;
+
+private:
+    std::vector<Node> m_nodes;
+    //! Leaf node of each object rank, -1 if absent
+    std::vector<int>  m_leaves;
+    int               m_root = -1;
+    int               m_freeList = -1;
+    int               m_objectCount = 0;
+};
+
+
+} // namespace Gfx
@@ -24,14 +24,16 @@
 #include "common/logger.h"
 #include "common/stringutils.h"
 
-#include "common/resources/inputstream.h"
+#include "common/resources/resourcemanager.h"
 
 #include "graphics/engine/engine.h"
 
 #include "graphics/model/model_input.h"
 #include "graphics/model/model_io_exception.h"
+#include "graphics/model/model_manager.h"
 
 #include <cstdio>
+#include <set>
 
 namespace Gfx
 {
@@ -47,28 +49,44 @@ COldModelManager::~COldModelManager()
 
 bool COldModelManager::LoadModel(const std::string& fileName, bool mirrored, int variant)
 {
-    GetLogger()->Debug("Loading model '%s'\n", fileName.c_str());
+    if (variant != 0)
+        return LoadModelVariant(fileName, mirrored, variant);
+
+    GetLogger()->Debug(LOG_CATEGORY_GRAPHICS, "Loading model '%s'\n", fileName.c_str());
 
     CModel model;
     try
     {
-        CInputStream stream;
-        stream.open("models/" + fileName);
-        if (!stream.is_open())
-            throw CModelIOException(std::string("Could not open file '") + fileName + "'");
-
         std::string::size_type extension_index = fileName.find_last_of('.');
         if (extension_index == std::string::npos)
             throw CModelIOException(std::string("Filename '") + fileName + "' has no extension");
 
         std::string extension = fileName.substr(extension_index + 1);
 
+        ModelFormat format = ModelFormat::Old;
         if (extension == "mod")
-            model = ModelInput::Read(stream, ModelFormat::Old);
+            format = ModelFormat::Old;
         else if (extension == "txt")
-            model = ModelInput::Read(stream, ModelFormat::Text);
+            format = ModelFormat::Text;
+        else if (extension == "bin")
+            format = ModelFormat::Binary;
         else
             throw CModelIOException(std::string("Filename '") + fileName + "' has unknown extension");
+
+        // Converted binary models are preferred, as they load much faster
+        std::string filePath = "models/" + fileName;
+        std::string binaryPath = CModelManager::GetBinaryModelPath(filePath);
+        if (!binaryPath.empty())
+        {
+            filePath = binaryPath;
+            format = ModelFormat::Binary;
+        }
+
+        auto file = CResourceManager::GetFileView(filePath);
+        if (!file->IsOpen())
+            throw CModelIOException(std::string("Could not open file '") + fileName + "'");
+
+        model = ModelInput::Read(file->GetData(), file->GetSize(), format);
     }
     catch (const CModelIOException& e)
     {
@@ -81,18 +99,80 @@ bool COldModelManager::LoadModel(const std::string& fileName, bool mirrored, int
 
     ModelInfo modelInfo;
     modelInfo.baseObjRank = m_engine->CreateBaseObject();
-    modelInfo.triangles = mesh->GetTriangles();
 
-    if (mirrored)
-        Mirror(modelInfo.triangles);
+    // Start decoding the textures now, they are needed when the scene is done loading
+    std::set<std::string> textures;
+    for (const auto& triangle : mesh->GetTriangles())
+    {
+        if (!triangle.tex1Name.empty())
+            textures.insert(triangle.tex1Name);
+        if (!triangle.tex2Name.empty())
+            textures.insert(triangle.tex2Name);
+    }
+    for (const auto& texture : textures)
+        m_engine->PrefetchTexture("textures/" + texture);
 
-    if (variant != 0)
-        ChangeVariant(modelInfo.triangles, variant);
+    AddTriangles(modelInfo.baseObjRank, mesh->GetTriangles(), mirrored);
+
+    for (int lodLevel = 0; lodLevel < MODEL_MESH_LOD_COUNT; lodLevel++)
+    {
+        const std::vector<ModelTriangle>& triangles = mesh->GetLodTriangles(lodLevel);
+        if (triangles.empty())
+        {
+            modelInfo.lodBaseObjRanks.push_back(-1);
+            continue;
+        }
+
+        int lodBaseObjRank = m_engine->CreateBaseObject();
+        AddTriangles(lodBaseObjRank, triangles, mirrored);
+        m_engine->SetBaseObjectLod(modelInfo.baseObjRank, static_cast<EngineLodLevel>(lodLevel), lodBaseObjRank);
+
+        modelInfo.lodBaseObjRanks.push_back(lodBaseObjRank);
+    }
 
     FileInfo fileInfo(fileName, mirrored, variant);
     m_models[fileInfo] = modelInfo;
 
-    m_engine->AddBaseObjTriangles(modelInfo.baseObjRank, modelInfo.triangles);
+    return true;
+}
+
+bool COldModelManager::LoadModelVariant(const std::string& fileName, bool mirrored, int variant)
+{
+    auto it = m_models.find(FileInfo(fileName, mirrored));
+    if (it == m_models.end())
+    {
+        if (!LoadModel(fileName, mirrored))
+            return false;
+
+        it = m_models.find(FileInfo(fileName, mirrored));
+    }
+
+    const ModelInfo& baseModelInfo = (*it).second;
+
+    // Variants only differ in textures, so they share the geometry of the base model
+    ModelInfo modelInfo;
+    modelInfo.baseObjRank = m_engine->CreateBaseObject();
+    m_engine->CopyBaseObject(baseModelInfo.baseObjRank, modelInfo.baseObjRank);
+    ChangeVariant(modelInfo.baseObjRank, variant);
+
+    for (int lodLevel = 0; lodLevel < static_cast<int>( baseModelInfo.lodBaseObjRanks.size() ); lodLevel++)
+    {
+        int baseLodObjRank = baseModelInfo.lodBaseObjRanks[lodLevel];
+        if (baseLodObjRank == -1)
+        {
+            modelInfo.lodBaseObjRanks.push_back(-1);
+            continue;
+        }
+
+        int lodBaseObjRank = m_engine->CreateBaseObject();
+        m_engine->CopyBaseObject(baseLodObjRank, lodBaseObjRank);
+        ChangeVariant(lodBaseObjRank, variant);
+        m_engine->SetBaseObjectLod(modelInfo.baseObjRank, static_cast<EngineLodLevel>(lodLevel), lodBaseObjRank);
+
+        modelInfo.lodBaseObjRanks.push_back(lodBaseObjRank);
+    }
+
+    m_models[FileInfo(fileName, mirrored, variant)] = modelInfo;
 
     return true;
 }
@@ -163,7 +243,7 @@ void COldModelManager::UnloadModel(const std::string& fileName, bool mirrored, i
     if (it == m_models.end())
         return;
 
-    m_engine->DeleteBaseObject((*it).second.baseObjRank);
+    DeleteModelBaseObjects((*it).second);
 
     m_models.erase(it);
 }
@@ -171,11 +251,64 @@ void COldModelManager::UnloadModel(const std::string& fileName, bool mirrored, i
 void COldModelManager::UnloadAllModels()
 {
     for (auto& mf : m_models)
-        m_engine->DeleteBaseObject(mf.second.baseObjRank);
+        DeleteModelBaseObjects(mf.second);
 
     m_models.clear();
 }
 
+void COldModelManager::DebugDumpModels()
+{
+    CLogger* l = GetLogger();
+
+    std::size_t totalUniqueBytes = 0;
+    std::size_t totalSharedBytes = 0;
+
+    l->Info("Loaded models:\n");
+    for (const auto& mf : m_models)
+    {
+        std::size_t uniqueBytes = 0;
+        std::size_t sharedBytes = 0;
+        m_engine->GetBaseObjectMemory(mf.second.baseObjRank, uniqueBytes, sharedBytes);
+
+        // Models are made of triangle lists
+        int triangles = (uniqueBytes + sharedBytes) / (3 * sizeof(VertexTex2));
+
+        for (int lodBaseObjRank : mf.second.lodBaseObjRanks)
+        {
+            if (lodBaseObjRank == -1)
+                continue;
+
+            std::size_t lodUniqueBytes = 0;
+            std::size_t lodSharedBytes = 0;
+            m_engine->GetBaseObjectMemory(lodBaseObjRank, lodUniqueBytes, lodSharedBytes);
+            uniqueBytes += lodUniqueBytes;
+            sharedBytes += lodSharedBytes;
+        }
+
+        l->Info("  %s%s variant %d: %d triangles, %d KiB own, %d KiB shared\n",
+                mf.first.fileName.c_str(), mf.first.mirrored ? " (mirrored)" : "", mf.first.variant,
+                triangles, static_cast<int>(uniqueBytes / 1024), static_cast<int>(sharedBytes / 1024));
+
+        totalUniqueBytes += uniqueBytes;
+        totalSharedBytes += sharedBytes;
+    }
+
+    l->Info("Total: %d models, %d copies, %d KiB own, %d KiB shared\n",
+            static_cast<int>(m_models.size()), static_cast<int>(m_copiesBaseRanks.size()),
+            static_cast<int>(totalUniqueBytes / 1024), static_cast<int>(totalSharedBytes / 1024));
+}
+
+void COldModelManager::DeleteModelBaseObjects(const ModelInfo& modelInfo)
+{
+    m_engine->DeleteBaseObject(modelInfo.baseObjRank);
+
+    for (int lodBaseObjRank : modelInfo.lodBaseObjRanks)
+    {
+        if (lodBaseObjRank != -1)
+            m_engine->DeleteBaseObject(lodBaseObjRank);
+    }
+}
+
 void COldModelManager::Mirror(std::vector<ModelTriangle>& triangles)
 {
     for (int i = 0; i < static_cast<int>( triangles.size() ); i++)
@@ -194,23 +327,39 @@ void COldModelManager::Mirror(std::vector<ModelTriangle>& triangles)
     }
 }
 
-void COldModelManager::ChangeVariant(std::vector<ModelTriangle>& triangles, int variant)
+void COldModelManager::AddTriangles(int baseObjRank, const std::vector<ModelTriangle>& triangles, bool mirrored)
 {
-    for (int i = 0; i < static_cast<int>( triangles.size() ); i++)
+    if (!mirrored)
     {
-        if (triangles[i].tex1Name == "base1.png"   ||
-            triangles[i].tex1Name == "convert.png" ||
-            triangles[i].tex1Name == "derrick.png" ||
-            triangles[i].tex1Name == "factory.png" ||
-            triangles[i].tex1Name == "lemt.png"    ||
-            triangles[i].tex1Name == "roller.png"  ||
-            triangles[i].tex1Name == "rollert.png" ||
-            triangles[i].tex1Name == "search.png"  ||
-            triangles[i].tex1Name == "drawer.png"  ||
-            triangles[i].tex1Name == "subm.png"     )
-        {
-            triangles[i].tex1Name += StrUtils::ToString<int>(variant);
-        }
+        m_engine->AddBaseObjTriangles(baseObjRank, triangles);
+        return;
+    }
+
+    std::vector<ModelTriangle> mirroredTriangles = triangles;
+    Mirror(mirroredTriangles);
+    m_engine->AddBaseObjTriangles(baseObjRank, mirroredTriangles);
+}
+
+void COldModelManager::ChangeVariant(int baseObjRank, int variant)
+{
+    static const char* const VARIANT_TEXTURES[] =
+    {
+        "base1.png",
+        "convert.png",
+        "derrick.png",
+        "factory.png",
+        "lemt.png",
+        "roller.png",
+        "rollert.png",
+        "search.png",
+        "drawer.png",
+        "subm.png"
+    };
+
+    for (const char* texName : VARIANT_TEXTURES)
+    {
+        std::string tex1Name = texName;
+        m_engine->ChangeBaseObjTexture(baseObjRank, tex1Name, tex1Name + StrUtils::ToString<int>(variant));
     }
 }
 
@@ -49,7 +49,10 @@ class CEngine;
  *
  * There is also a possibility of creating a copy of model so it has
  * its own and unique base engine object. This is especially useful
- * for models where the geometry must be altered.
+ * for models where the geometry must be altered. The copy shares
+ * the vertex data with the model until it is actually modified.
+ *
+ * Variants of a model are copies of it with changed textures.
  */
 class COldModelManager
 {
@@ -80,17 +83,26 @@ public:
     //! Unloads all models
     void UnloadAllModels();
 
+    //! Prints the memory used by each loaded model to the log
+    void DebugDumpModels();
+
 protected:
     //! Mirrors the model along the Z axis
     void Mirror(std::vector<ModelTriangle>& triangles);
-    //! Changes variant
-    void ChangeVariant(std::vector<ModelTriangle>& triangles, int variant);
+    //! Adds triangles to a base object, mirroring a temporary copy if needed
+    void AddTriangles(int baseObjRank, const std::vector<ModelTriangle>& triangles, bool mirrored);
+    //! Changes variant of a base object by replacing its textures
+    void ChangeVariant(int baseObjRank, int variant);
 
 private:
+    //! Loads a variant of a model as a copy of the base model
+    bool LoadModelVariant(const std::string& fileName, bool mirrored, int variant);
+
     struct ModelInfo
     {
-        std::vector<ModelTriangle> triangles;
         int baseObjRank = -1;
+        //! Base objects with reduced detail geometry (medium, low), -1 if missing
+        std::vector<int> lodBaseObjRanks;
     };
     struct FileInfo
     {
@@ -118,6 +130,9 @@ private:
             return !mirrored && mirrored != other.mirrored;
         }
     };
+    //! Deletes the base objects of a loaded model
+    void DeleteModelBaseObjects(const ModelInfo& modelInfo);
+
     std::map<FileInfo, ModelInfo> m_models;
     std::vector<int> m_copiesBaseRanks;
     CEngine* m_engine;
@@ -646,13 +646,13 @@ bool CParticle::CheckChannel(int &channel)
 
     if (!m_particle[channel].used)
     {
-        GetLogger()->Trace("Particle %d:%d doesn't exist anymore (used=false)\n", channel, uniqueStamp);
+        GetLogger()->Trace(LOG_CATEGORY_GRAPHICS, "Particle %d:%d doesn't exist anymore (used=false)\n", channel, uniqueStamp);
         return false;
     }
 
     if (m_particle[channel].uniqueStamp != uniqueStamp)
     {
-        GetLogger()->Trace("Particle %d:%d doesn't exist anymore (uniqueStamp changed)\n", channel, uniqueStamp);
+        GetLogger()->Trace(LOG_CATEGORY_GRAPHICS, "Particle %d:%d doesn't exist anymore (uniqueStamp changed)\n", channel, uniqueStamp);
         return false;
     }
 
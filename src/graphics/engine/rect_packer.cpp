@@ -0,0 +1,85 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/rect_packer.h"
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+CRectPacker::CRectPacker(Math::IntPoint size)
+    : m_size(size)
+    , m_usedArea(0)
+{
+}
+
+bool CRectPacker::Insert(Math::IntPoint size, Math::IntPoint& pos)
+{
+    if (size.x <= 0 || size.y <= 0 || size.x > m_size.x || size.y > m_size.y)
+        return false;
+
+    Shelf* best = nullptr;
+    for (Shelf& shelf : m_shelves)
+    {
+        if (shelf.height < size.y || shelf.width + size.x > m_size.x)
+            continue;
+
+        if (best == nullptr || shelf.height < best->height)
+            best = &shelf;
+    }
+
+    if (best == nullptr)
+    {
+        int y = m_shelves.empty() ? 0 : m_shelves.back().y + m_shelves.back().height;
+        if (y + size.y > m_size.y)
+            return false;
+
+        Shelf shelf;
+        shelf.y = y;
+        shelf.height = size.y;
+        m_shelves.push_back(shelf);
+        best = &m_shelves.back();
+    }
+
+    pos.x = best->width;
+    pos.y = best->y;
+    best->width += size.x;
+
+    m_usedArea += static_cast<long long>(size.x) * size.y;
+    return true;
+}
+
+void CRectPacker::Clear()
+{
+    m_shelves.clear();
+    m_usedArea = 0;
+}
+
+Math::IntPoint CRectPacker::GetSize() const
+{
+    return m_size;
+}
+
+float CRectPacker::GetOccupancy() const
+{
+    return static_cast<float>(m_usedArea) / (static_cast<float>(m_size.x) * m_size.y);
+}
+
+} // namespace Gfx
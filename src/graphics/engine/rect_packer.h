@@ -0,0 +1,76 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file graphics/engine/rect_packer.h
+ * \brief Packing of rectangles into a texture page - CRectPacker class
+ */
+
+#pragma once
+
+#include "math/intpoint.h"
+
+#include <vector>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+/**
+ * \class CRectPacker
+ * \brief Places rectangles into a fixed size area using horizontal shelves
+ *
+ * Each shelf is a row as high as the first rectangle placed in it.
+ * A rectangle goes to the shelf that wastes the least height, or to a new
+ * shelf below the others. Packing works best when rectangles are inserted
+ * from the tallest.
+ */
+class CRectPacker
+{
+public:
+    explicit CRectPacker(Math::IntPoint size);
+
+    //! Finds a place for the rectangle of given size; returns false if it does not fit
+    bool Insert(Math::IntPoint size, Math::IntPoint& pos);
+
+    //! Removes all rectangles
+    void Clear();
+
+    //! Returns the size of the whole area
+    Math::IntPoint GetSize() const;
+    //! Returns the fraction of area taken by inserted rectangles
+    float GetOccupancy() const;
+
+private:
+    struct Shelf
+    {
+        int y = 0;
+        int height = 0;
+        //! Width already taken
+        int width = 0;
+    };
+
+    Math::IntPoint m_size;
+    std::vector<Shelf> m_shelves;
+    //! Area taken by inserted rectangles
+    long long m_usedArea;
+};
+
+} // namespace Gfx
@@ -25,6 +25,8 @@
 #include "common/image.h"
 #include "common/logger.h"
 
+#include "common/thread/worker_pool.h"
+
 #include "graphics/engine/engine.h"
 #include "graphics/engine/water.h"
 
@@ -221,6 +223,11 @@ bool CTerrain::LoadResources(const std::string& fileName)
         return false;
     }
 
+    return LoadResources(img);
+}
+
+bool CTerrain::LoadResources(CImage& img)
+{
     ImageData *data = img.GetData();
 
     int size = (m_mosaicCount*m_brickCount)+1;
@@ -298,8 +305,6 @@ void CTerrain::FlushRelief()
 bool CTerrain::LoadRelief(const std::string &fileName, float scaleRelief,
                           bool adjustBorder)
 {
-    m_scaleRelief = scaleRelief;
-
     CImage img;
 
     if (! img.Load(fileName))
@@ -308,6 +313,13 @@ bool CTerrain::LoadRelief(const std::string &fileName, float scaleRelief,
         return false;
     }
 
+    return LoadRelief(img, scaleRelief, adjustBorder);
+}
+
+bool CTerrain::LoadRelief(CImage& img, float scaleRelief, bool adjustBorder)
+{
+    m_scaleRelief = scaleRelief;
+
     ImageData *data = img.GetData();
 
     int size = (m_mosaicCount*m_brickCount)+1;
@@ -572,16 +584,22 @@ VertexTex2 CTerrain::GetVertex(int x, int y, int step)
   |
   +-------------------> x
 \endverbatim */
-bool CTerrain::CreateMosaic(int ox, int oy, int step, int objRank,
-                            const Material &mat)
+struct CTerrain::MosaicGeometry
 {
-    int baseObjRank = m_engine->GetObjectBaseRank(objRank);
-    if (baseObjRank == -1)
+    struct Strip
     {
-        baseObjRank = m_engine->CreateBaseObject();
-        m_engine->SetObjectBaseRank(objRank, baseObjRank);
-    }
+        EngineBaseObjDataTier buffer;
+        std::string texName1;
+    };
 
+    std::vector<Strip> strips;
+    std::string texName2;
+    //! Position of the mosaic center, vertices are relative to it
+    Math::Vector origin;
+};
+
+void CTerrain::BuildMosaic(int ox, int oy, int step, const Material &mat, MosaicGeometry& geometry)
+{
     std::string texName1;
     std::string texName2;
 
@@ -602,6 +620,10 @@ bool CTerrain::CreateMosaic(int ox, int oy, int step, int objRank,
     VertexTex2 o = GetVertex(ox*m_brickCount+m_brickCount/2, oy*m_brickCount+m_brickCount/2, step);
     int total = ((brick/step)+1)*2;
 
+    geometry.strips.clear();
+    geometry.texName2 = texName2;
+    geometry.origin = o.coord;
+
     float pixel = 1.0f/256.0f;  // 1 pixel cover (*)
     float dp = 1.0f/512.0f;
 
@@ -632,7 +654,7 @@ bool CTerrain::CreateMosaic(int ox, int oy, int step, int objRank,
             for (int y = 0; y < brick; y += step)
             {
                 EngineBaseObjDataTier buffer;
-                buffer.vertices.reserve(total);
+                buffer.geometry->vertices.reserve(total);
 
                 buffer.type = ENG_TRIANGLE_TYPE_SURFACE;
                 buffer.material = mat;
@@ -725,21 +747,44 @@ bool CTerrain::CreateMosaic(int ox, int oy, int step, int objRank,
                     p2.texCoord2.y = (p2.texCoord2.y+pixel)*(1.0f-pixel)/(1.0f+pixel);
 
 
-                    buffer.vertices.push_back(p1);
-                    buffer.vertices.push_back(p2);
+                    buffer.geometry->vertices.push_back(p1);
+                    buffer.geometry->vertices.push_back(p2);
                 }
 
-                m_engine->AddBaseObjQuick(baseObjRank, buffer, texName1, texName2, true);
+                MosaicGeometry::Strip strip;
+                strip.buffer = std::move(buffer);
+                strip.texName1 = texName1;
+                geometry.strips.push_back(std::move(strip));
             }
         }
     }
+}
+
+void CTerrain::AddMosaic(int objRank, const MosaicGeometry& geometry)
+{
+    int baseObjRank = m_engine->GetObjectBaseRank(objRank);
+    if (baseObjRank == -1)
+    {
+        baseObjRank = m_engine->CreateBaseObject();
+        m_engine->SetObjectBaseRank(objRank, baseObjRank);
+    }
+
+    for (const MosaicGeometry::Strip& strip : geometry.strips)
+        m_engine->AddBaseObjQuick(baseObjRank, strip.buffer, strip.texName1, geometry.texName2, true);
 
     Math::Matrix transform;
     transform.LoadIdentity();
-    transform.Set(1, 4, o.coord.x);
-    transform.Set(3, 4, o.coord.z);
+    transform.Set(1, 4, geometry.origin.x);
+    transform.Set(3, 4, geometry.origin.z);
     m_engine->SetObjectTransform(objRank, transform);
+}
 
+bool CTerrain::CreateMosaic(int ox, int oy, int step, int objRank,
+                            const Material &mat)
+{
+    MosaicGeometry geometry;
+    BuildMosaic(ox, oy, step, mat, geometry);
+    AddMosaic(objRank, geometry);
     return true;
 }
 
@@ -1271,10 +1316,51 @@ bool CTerrain::CreateObjects()
 {
     AdjustRelief();
 
+    int threadCount = SDL_GetCPUCount();
+    if (threadCount <= 1)
+    {
+        for (int y = 0; y < m_mosaicCount; y++)
+        {
+            for (int x = 0; x < m_mosaicCount; x++)
+                CreateSquare(x, y);
+        }
+        return true;
+    }
+
+    Material mat;
+    mat.diffuse = Color(1.0f, 1.0f, 1.0f);
+    mat.ambient = Color(0.0f, 0.0f, 0.0f);
+
+    // The geometry is computed in parallel, the engine objects are created in the same order as by CreateSquare()
+    std::vector<MosaicGeometry> geometries(m_mosaicCount * m_mosaicCount * m_depth);
+    {
+        CWorkerPool pool(threadCount, "Terrain builder");
+        for (int y = 0; y < m_mosaicCount; y++)
+        {
+            pool.Start([this, y, &mat, &geometries]()
+            {
+                for (int x = 0; x < m_mosaicCount; x++)
+                {
+                    for (int step = 0; step < m_depth; step++)
+                        BuildMosaic(x, y, 1 << step, mat, geometries[(x + y*m_mosaicCount)*m_depth + step]);
+                }
+            });
+        }
+        pool.WaitAll();
+    }
+
     for (int y = 0; y < m_mosaicCount; y++)
     {
         for (int x = 0; x < m_mosaicCount; x++)
-            CreateSquare(x, y);
+        {
+            int objRank = m_engine->CreateObject();
+            m_engine->SetObjectType(objRank, ENG_OBJTYPE_TERRAIN);
+
+            m_objRanks[x+y*m_mosaicCount] = objRank;
+
+            for (int step = 0; step < m_depth; step++)
+                AddMosaic(objRank, geometries[(x + y*m_mosaicCount)*m_depth + step]);
+        }
     }
 
     return true;
@@ -33,6 +33,8 @@
 #include <string>
 #include <vector>
 
+class CImage;
+
 
 // Graphics module namespace
 namespace Gfx
@@ -170,11 +172,15 @@ public:
     void        FlushRelief();
     //! Load relief from image
     bool        LoadRelief(const std::string& fileName, float scaleRelief, bool adjustBorder);
+    //! Load relief from already decoded image
+    bool        LoadRelief(CImage& image, float scaleRelief, bool adjustBorder);
     //! Load ramdomized relief
     bool        RandomizeRelief();
 
     //! Load resources from image
     bool        LoadResources(const std::string& fileName);
+    //! Load resources from already decoded image
+    bool        LoadResources(CImage& image);
 
     //! Creates all objects of the terrain within the 3D engine
     bool        CreateObjects();
@@ -255,6 +261,11 @@ protected:
     Math::Vector GetVector(int x, int y);
     //! Calculates a vertex of the terrain
     VertexTex2  GetVertex(int x, int y, int step);
+    struct MosaicGeometry;
+    //! Computes the geometry of a mosaic, only reads the terrain data so it may run on worker threads
+    void        BuildMosaic(int ox, int oy, int step, const Material& mat, MosaicGeometry& geometry);
+    //! Adds the geometry of a mosaic to the engine object
+    void        AddMosaic(int objRank, const MosaicGeometry& geometry);
     //! Creates all objects of a mosaic
     bool        CreateMosaic(int ox, int oy, int step, int objRank, const Material& mat);
     //! Creates all objects in a mesh square ground
@@ -29,12 +29,24 @@
 
 #include "common/resources/resourcemanager.h"
 
+#include "common/thread/sdl_mutex_wrapper.h"
+#include "common/thread/worker_pool.h"
+
 #include "graphics/engine/engine.h"
+#include "graphics/engine/glyph_cache.h"
+#include "graphics/engine/rect_packer.h"
 
 #include "math/func.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <set>
+#include <sstream>
+#include <unordered_map>
 #include <SDL.h>
+#include <SDL_cpuinfo.h>
 #include <SDL_ttf.h>
 
 
@@ -62,8 +74,8 @@ struct MultisizeFont
 struct FontTexture
 {
     unsigned int id = 0;
-    Math::IntPoint tileSize;
-    int freeSlots = 0;
+    //! Free space of the texture; null for textures filled at once by CText::PrewarmGlyphs()
+    std::unique_ptr<CRectPacker> packer;
 };
 
 /**
@@ -75,6 +87,8 @@ struct CachedFont
     std::unique_ptr<CSDLMemoryWrapper> fontFile;
     TTF_Font* font = nullptr;
     std::map<UTF8Char, CharTexture> cache;
+    //! Widths of characters measured without creating their textures
+    std::map<UTF8Char, int> widths;
 
     CachedFont(std::unique_ptr<CSDLMemoryWrapper> fontFile, int pointSize)
         : fontFile(std::move(fontFile))
@@ -90,10 +104,205 @@ struct CachedFont
 };
 
 
+/**
+ * \struct TextGlyph
+ * \brief Quad of a laid out character
+ */
+struct TextGlyph
+{
+    Vertex quad[4];
+    unsigned int texID = 0;
+    //! Tabs are drawn in red regardless of the text color
+    bool tab = false;
+};
+
+/**
+ * \struct TextRun
+ * \brief String laid out with a single font
+ *
+ * Glyph quads are relative to the start of the baseline, in window coordinates.
+ */
+struct TextRun
+{
+    std::string text;
+    std::vector<TextGlyph> glyphs;
+    bool laidOut = false;
+    //! Width measured by SDL_ttf in window pixels, -1 if not measured yet
+    int width = -1;
+};
+
+
 namespace
 {
 const Math::IntPoint REFERENCE_SIZE(800, 600);
-const Math::IntPoint FONT_TEXTURE_SIZE(256, 256);
+const Math::IntPoint FONT_TEXTURE_SIZE(512, 512);
+//! Empty pixels right and below each character in font textures
+const int GLYPH_MARGIN = 1;
+//! Number of text runs kept in one generation of the run cache
+const std::size_t MAX_TEXT_RUNS = 2048;
+
+int GetCachedCharWidth(CachedFont* cf, UTF8Char ch)
+{
+    auto it = cf->cache.find(ch);
+    if (it != cf->cache.end())
+        return (*it).second.charSize.x;
+
+    auto jt = cf->widths.find(ch);
+    if (jt != cf->widths.end())
+        return (*jt).second;
+
+    Math::IntPoint wndSize;
+    std::string text;
+    text.append({ch.c1, ch.c2, ch.c3});
+    TTF_SizeUTF8(cf->font, text.c_str(), &wndSize.x, &wndSize.y);
+    cf->widths[ch] = wndSize.x;
+    return wndSize.x;
+}
+
+/**
+ * \struct GlyphJob
+ * \brief Characters of one font and size rendered by CText::PrewarmGlyphs()
+ */
+struct GlyphJob
+{
+    FontType font = FONT_COMMON;
+    int pointSize = 0;
+    std::string fileName;
+    CachedFont* cachedFont = nullptr;
+    std::vector<UTF8Char> chars;
+    //! Rendered characters, in the same order as chars; null if rendering failed
+    std::vector<SDL_Surface*> surfaces;
+};
+
+//! Renders the characters of all jobs, each job on one of the worker threads
+void RenderGlyphs(std::vector<GlyphJob>& jobs)
+{
+    // Each job renders with its own copy of the font. FreeType allows using
+    // different fonts at once, but opening and closing them must be serialized.
+    CSDLMutexWrapper mutex;
+
+    int threadCount = std::max(1, std::min(static_cast<int>(jobs.size()), SDL_GetCPUCount()));
+    CWorkerPool pool(threadCount, "Glyph renderer");
+
+    for (GlyphJob& job : jobs)
+    {
+        pool.Start([&job, &mutex]()
+        {
+            job.surfaces.assign(job.chars.size(), nullptr);
+
+            mutex.Lock();
+            std::unique_ptr<CachedFont> font;
+            auto file = CResourceManager::GetSDLMemoryHandler(job.fileName);
+            if (file->IsOpen())
+                font = MakeUnique<CachedFont>(std::move(file), job.pointSize);
+            mutex.Unlock();
+
+            if (font == nullptr || font->font == nullptr)
+                return;
+
+            SDL_Color white = {255, 255, 255, 0};
+            for (std::size_t i = 0; i < job.chars.size(); ++i)
+            {
+                const UTF8Char& ch = job.chars[i];
+                char str[] = { ch.c1, ch.c2, ch.c3, '\0' };
+                job.surfaces[i] = TTF_RenderUTF8_Blended(font->font, str, white);
+            }
+
+            mutex.Lock();
+            font.reset();
+            mutex.Unlock();
+        });
+    }
+
+    pool.WaitAll();
+}
+
+//! Copies the surface into the font texture image at given position
+void CopyGlyph(SDL_Surface* glyph, CImage* page, Math::IntPoint pos)
+{
+    SDL_Surface* pageSurface = page->GetData()->surface;
+    SDL_Surface* converted = SDL_ConvertSurface(glyph, pageSurface->format, 0);
+    if (converted == nullptr)
+        return;
+
+    SDL_LockSurface(converted);
+    SDL_LockSurface(pageSurface);
+    int bytesPerPixel = pageSurface->format->BytesPerPixel;
+    for (int y = 0; y < converted->h; ++y)
+    {
+        memcpy(static_cast<char*>(pageSurface->pixels) + (pos.y + y) * pageSurface->pitch + pos.x * bytesPerPixel,
+               static_cast<const char*>(converted->pixels) + y * converted->pitch,
+               converted->w * bytesPerPixel);
+    }
+    SDL_UnlockSurface(pageSurface);
+    SDL_UnlockSurface(converted);
+
+    SDL_FreeSurface(converted);
+}
+
+//! Packs the rendered characters of all jobs into new font texture images and frees them
+void PackGlyphs(std::vector<GlyphJob>& jobs, std::vector<std::unique_ptr<CImage>>& pages,
+                std::vector<GlyphPlacement>& glyphs)
+{
+    struct Item
+    {
+        const GlyphJob* job;
+        std::size_t index;
+        SDL_Surface* surface;
+    };
+
+    std::vector<Item> items;
+    for (const GlyphJob& job : jobs)
+    {
+        for (std::size_t i = 0; i < job.surfaces.size(); ++i)
+        {
+            if (job.surfaces[i] != nullptr)
+                items.push_back(Item{&job, i, job.surfaces[i]});
+        }
+    }
+
+    // Tallest first, so that the shelves are filled well
+    std::stable_sort(items.begin(), items.end(), [](const Item& a, const Item& b)
+    {
+        return a.surface->h > b.surface->h;
+    });
+
+    std::vector<std::unique_ptr<CRectPacker>> packers;
+    for (const Item& item : items)
+    {
+        Math::IntPoint size(item.surface->w + GLYPH_MARGIN, item.surface->h + GLYPH_MARGIN);
+        if (size.x <= FONT_TEXTURE_SIZE.x && size.y <= FONT_TEXTURE_SIZE.y)
+        {
+            Math::IntPoint pos;
+            std::size_t page = 0;
+            while (page < packers.size() && !packers[page]->Insert(size, pos))
+                ++page;
+
+            if (page == packers.size())
+            {
+                packers.push_back(MakeUnique<CRectPacker>(FONT_TEXTURE_SIZE));
+                pages.push_back(MakeUnique<CImage>(FONT_TEXTURE_SIZE));
+                packers.back()->Insert(size, pos);
+            }
+
+            CopyGlyph(item.surface, pages[page].get(), pos);
+
+            GlyphPlacement glyph;
+            glyph.font = item.job->font;
+            glyph.pointSize = item.job->pointSize;
+            glyph.ch = item.job->chars[item.index];
+            glyph.page = page;
+            glyph.pos = pos;
+            glyph.size = Math::IntPoint(item.surface->w, item.surface->h);
+            glyphs.push_back(glyph);
+        }
+
+        SDL_FreeSurface(item.surface);
+    }
+
+    for (GlyphJob& job : jobs)
+        job.surfaces.clear();
+}
 } // anonymous namespace
 
 /// The QuadBatch is responsible for collecting as many quad (aka rectangle) draws as possible and
@@ -130,6 +339,8 @@ public:
     {
         if (m_quads.empty()) return;
 
+        // Interface strips batched by the engine are drawn below the text
+        m_engine.FlushInterfaceBatch();
         m_engine.SetState(m_renderState);
         m_engine.GetDevice()->SetTexture(0, m_texID);
 
@@ -167,6 +378,78 @@ private:
     EngineRenderState m_renderState{};
 };
 
+/// The RunCache keeps the text runs of recently used strings, keyed by string hash, font and point size.
+/// Runs are kept in two generations: when the current one is full, it replaces the previous one,
+/// and runs looked up again are moved back from the previous generation. Text that changes
+/// every frame, like timers, only evicts other such text and not the static labels.
+class CText::CRunCache
+{
+public:
+    /// Returns the run of the given text, which is empty if the text was not used recently.
+    TextRun& Get(const std::string& text, FontType font, int pointSize)
+    {
+        Key key{std::hash<std::string>()(text), font, pointSize};
+
+        auto it = m_current.find(key);
+        if (it == m_current.end())
+        {
+            if (m_current.size() >= MAX_TEXT_RUNS)
+            {
+                m_previous = std::move(m_current);
+                m_current.clear();
+            }
+
+            it = m_current.emplace(key, TextRun()).first;
+
+            auto jt = m_previous.find(key);
+            if (jt != m_previous.end())
+            {
+                it->second = std::move(jt->second);
+                m_previous.erase(jt);
+            }
+        }
+
+        TextRun& run = it->second;
+        if (run.text != text) // new run or hash collision
+        {
+            run = TextRun();
+            run.text = text;
+        }
+        return run;
+    }
+
+    /// Removes all runs; needed when the glyph textures are destroyed.
+    void Clear()
+    {
+        m_current.clear();
+        m_previous.clear();
+    }
+
+private:
+    struct Key
+    {
+        std::size_t hash;
+        FontType font;
+        int pointSize;
+
+        bool operator==(const Key& other) const
+        {
+            return hash == other.hash && font == other.font && pointSize == other.pointSize;
+        }
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const
+        {
+            return (key.hash * 31 + static_cast<std::size_t>(key.font)) * 31 + static_cast<std::size_t>(key.pointSize);
+        }
+    };
+
+    std::unordered_map<Key, TextRun, KeyHash> m_current;
+    std::unordered_map<Key, TextRun, KeyHash> m_previous;
+};
+
 
 CText::CText(CEngine* engine)
 {
@@ -180,7 +463,12 @@ CText::CText(CEngine* engine)
     m_lastFontSize = 0;
     m_lastCachedFont = nullptr;
 
+    for (unsigned int& texID : m_buttonTexIDs)
+        texID = 0;
+
     m_quadBatch = MakeUnique<CQuadBatch>(*engine);
+    m_runCache = MakeUnique<CRunCache>();
+    m_glyphCache = MakeUnique<CGlyphCache>();
 }
 
 CText::~CText()
@@ -216,6 +504,7 @@ bool CText::ReloadFonts()
     // Backup previous fonts
     auto fonts = std::move(m_fonts);
     m_fonts.clear();
+    m_runCache->Clear();
 
     for (auto type : {FONT_COMMON, FONT_STUDIO, FONT_SATCOM})
     {
@@ -241,6 +530,7 @@ bool CText::ReloadFonts()
 void CText::Destroy()
 {
     m_fonts.clear();
+    m_runCache->Clear();
 
     m_lastCachedFont = nullptr;
     m_lastFontType = FONT_COMMON;
@@ -268,6 +558,7 @@ void CText::FlushCache()
         m_device->DestroyTexture(tex);
     }
     m_fontTextures.clear();
+    m_runCache->Clear();
 
     for (auto& multisizeFont : m_fonts)
     {
@@ -280,6 +571,10 @@ void CText::FlushCache()
     m_lastCachedFont = nullptr;
     m_lastFontType = FONT_COMMON;
     m_lastFontSize = 0;
+
+    // The engine reloads its textures together with the fonts
+    for (unsigned int& texID : m_buttonTexIDs)
+        texID = 0;
 }
 
 int CText::GetTabSize()
@@ -289,7 +584,12 @@ int CText::GetTabSize()
 
 void CText::SetTabSize(int tabSize)
 {
+    if (tabSize == m_tabSize)
+        return;
+
     m_tabSize = tabSize;
+    // Cached runs have the tab width baked into their glyph positions
+    m_runCache->Clear();
 }
 
 void CText::DrawText(const std::string &text, std::vector<FontMetaChar>::iterator format,
@@ -469,18 +769,24 @@ float CText::GetStringWidth(std::string text, FontType font, float size)
 {
     assert(font != FONT_BUTTON);
 
-    // Skip special chars
-    for (char& c : text)
+    TextRun& run = GetTextRun(text, font, size);
+    if (run.width < 0)
     {
-        if (c < 32 && c >= 0)
-            c = ':';
+        // Skip special chars
+        for (char& c : text)
+        {
+            if (c < 32 && c >= 0)
+                c = ':';
+        }
+
+        CachedFont* cf = GetOrOpenFont(font, size);
+        assert(cf != nullptr);
+        Math::IntPoint wndSize;
+        TTF_SizeUTF8(cf->font, text.c_str(), &wndSize.x, &wndSize.y);
+        run.width = wndSize.x;
     }
 
-    CachedFont* cf = GetOrOpenFont(font, size);
-    assert(cf != nullptr);
-    Math::IntPoint wndSize;
-    TTF_SizeUTF8(cf->font, text.c_str(), &wndSize.x, &wndSize.y);
-    Math::Point ifSize = m_engine->WindowToInterfaceSize(wndSize);
+    Math::Point ifSize = m_engine->WindowToInterfaceSize(Math::IntPoint(run.width, 0));
     return ifSize.x;
 }
 
@@ -508,21 +814,7 @@ float CText::GetCharWidth(UTF8Char ch, FontType font, float size, float offset)
     CachedFont* cf = GetOrOpenFont(font, size);
     assert(cf != nullptr);
 
-    Math::Point charSize;
-    auto it = cf->cache.find(ch);
-    if (it != cf->cache.end())
-    {
-        charSize = m_engine->WindowToInterfaceSize((*it).second.charSize);
-    }
-    else
-    {
-        Math::IntPoint wndSize;
-        std::string text;
-        text.append({ch.c1, ch.c2, ch.c3});
-        TTF_SizeUTF8(cf->font, text.c_str(), &wndSize.x, &wndSize.y);
-        charSize = m_engine->WindowToInterfaceSize(wndSize);
-    }
-
+    Math::Point charSize = m_engine->WindowToInterfaceSize(Math::IntPoint(GetCachedCharWidth(cf, ch), 0));
     return charSize.x * width;
 }
 
@@ -550,20 +842,7 @@ int CText::GetCharWidthInt(UTF8Char ch, FontType font, float size, float offset)
     CachedFont* cf = GetOrOpenFont(font, size);
     assert(cf != nullptr);
 
-    Math::IntPoint charSize;
-    auto it = cf->cache.find(ch);
-    if (it != cf->cache.end())
-    {
-        charSize = (*it).second.charSize;
-    }
-    else
-    {
-        std::string text;
-        text.append({ch.c1, ch.c2, ch.c3});
-        TTF_SizeUTF8(cf->font, text.c_str(), &charSize.x, &charSize.y);
-    }
-
-    return charSize.x * width;
+    return GetCachedCharWidth(cf, ch) * width;
 }
 
 
@@ -947,12 +1226,22 @@ void CText::DrawString(const std::string &text, FontType font,
 {
     assert(font != FONT_BUTTON);
 
-    std::vector<UTF8Char> chars;
-    StringToUTFCharList(text, chars);
+    TextRun& run = GetTextRun(text, font, size);
+    if (!run.laidOut)
+        LayoutTextRun(run, text, font, size);
+
     m_engine->SetWindowCoordinates();
-    for (auto it = chars.begin(); it != chars.end(); ++it)
+    for (const TextGlyph& glyph : run.glyphs)
     {
-        DrawCharAndAdjustPos(*it, font, size, pos, color);
+        Vertex quad[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            quad[i] = glyph.quad[i];
+            quad[i].coord.x += pos.x;
+            quad[i].coord.y += pos.y;
+        }
+
+        m_quadBatch->Add(quad, glyph.texID, ENG_RSTATE_TEXT, glyph.tab ? Color(1.0f, 0.0f, 0.0f, 1.0f) : color);
     }
     m_quadBatch->Flush();
     m_engine->SetInterfaceCoordinates();
@@ -960,6 +1249,8 @@ void CText::DrawString(const std::string &text, FontType font,
 
 void CText::DrawHighlight(FontMetaChar hl, Math::IntPoint pos, Math::IntPoint size)
 {
+    m_engine->FlushInterfaceBatch();
+
     // Gradient colors
     Color grad[4];
 
@@ -1032,7 +1323,9 @@ void CText::DrawCharAndAdjustPos(UTF8Char ch, FontType font, float size, Math::I
         unsigned char icon = static_cast<unsigned char>(ch.c1);
 
         // TODO: A bit of code duplication, see CControl::SetButtonTextureForIcon()
-        unsigned int texID = m_engine->LoadTexture("textures/interface/button" + StrUtils::ToString<int>((icon/64) + 1) + ".png").id;
+        unsigned int& texID = m_buttonTexIDs[icon/64];
+        if (texID == 0)
+            texID = m_engine->LoadTexture("textures/interface/button" + StrUtils::ToString<int>((icon/64) + 1) + ".png").id;
         icon = icon%64;
 
         Math::Point uv1, uv2;
@@ -1061,48 +1354,80 @@ void CText::DrawCharAndAdjustPos(UTF8Char ch, FontType font, float size, Math::I
     }
     else
     {
-        int width = 1;
-        if (ch.c1 > 0 && ch.c1 < 32)
-        {
-            if (ch.c1 == '\t')
-            {
-                color = Color(1.0f, 0.0f, 0.0f, 1.0f);
-                width = m_tabSize;
-            }
+        TextGlyph glyph;
+        LayoutChar(ch, font, size, pos, glyph);
+        m_quadBatch->Add(glyph.quad, glyph.texID, ENG_RSTATE_TEXT, glyph.tab ? Color(1.0f, 0.0f, 0.0f, 1.0f) : color);
+    }
+}
 
-            ch = TranslateSpecialChar(ch.c1);
+void CText::LayoutChar(UTF8Char ch, FontType font, float size, Math::IntPoint &pos, TextGlyph &glyph)
+{
+    int width = 1;
+    glyph.tab = false;
+    if (ch.c1 > 0 && ch.c1 < 32)
+    {
+        if (ch.c1 == '\t')
+        {
+            glyph.tab = true;
+            width = m_tabSize;
         }
 
-        CharTexture tex = GetCharTexture(ch, font, size);
+        ch = TranslateSpecialChar(ch.c1);
+    }
 
-        Math::Point p1(pos.x, pos.y - tex.charSize.y);
-        Math::Point p2(pos.x + tex.charSize.x, pos.y);
+    CharTexture tex = GetCharTexture(ch, font, size);
 
-        const float halfPixelMargin = 0.5f;
-        Math::Point texCoord1(static_cast<float>(tex.charPos.x + halfPixelMargin) / FONT_TEXTURE_SIZE.x,
-                              static_cast<float>(tex.charPos.y + halfPixelMargin) / FONT_TEXTURE_SIZE.y);
-        Math::Point texCoord2(static_cast<float>(tex.charPos.x + tex.charSize.x - halfPixelMargin) / FONT_TEXTURE_SIZE.x,
-                              static_cast<float>(tex.charPos.y + tex.charSize.y - halfPixelMargin) / FONT_TEXTURE_SIZE.y);
-        Math::Vector n(0.0f, 0.0f, -1.0f);  // normal
+    Math::Point p1(pos.x, pos.y - tex.charSize.y);
+    Math::Point p2(pos.x + tex.charSize.x, pos.y);
 
-        Vertex quad[4] =
-        {
-            Vertex(Math::Vector(p1.x, p2.y, 0.0f), n, Math::Point(texCoord1.x, texCoord2.y)),
-            Vertex(Math::Vector(p1.x, p1.y, 0.0f), n, Math::Point(texCoord1.x, texCoord1.y)),
-            Vertex(Math::Vector(p2.x, p2.y, 0.0f), n, Math::Point(texCoord2.x, texCoord2.y)),
-            Vertex(Math::Vector(p2.x, p1.y, 0.0f), n, Math::Point(texCoord2.x, texCoord1.y))
-        };
+    const float halfPixelMargin = 0.5f;
+    Math::Point texCoord1(static_cast<float>(tex.charPos.x + halfPixelMargin) / FONT_TEXTURE_SIZE.x,
+                          static_cast<float>(tex.charPos.y + halfPixelMargin) / FONT_TEXTURE_SIZE.y);
+    Math::Point texCoord2(static_cast<float>(tex.charPos.x + tex.charSize.x - halfPixelMargin) / FONT_TEXTURE_SIZE.x,
+                          static_cast<float>(tex.charPos.y + tex.charSize.y - halfPixelMargin) / FONT_TEXTURE_SIZE.y);
+    Math::Vector n(0.0f, 0.0f, -1.0f);  // normal
+
+    glyph.quad[0] = Vertex(Math::Vector(p1.x, p2.y, 0.0f), n, Math::Point(texCoord1.x, texCoord2.y));
+    glyph.quad[1] = Vertex(Math::Vector(p1.x, p1.y, 0.0f), n, Math::Point(texCoord1.x, texCoord1.y));
+    glyph.quad[2] = Vertex(Math::Vector(p2.x, p2.y, 0.0f), n, Math::Point(texCoord2.x, texCoord2.y));
+    glyph.quad[3] = Vertex(Math::Vector(p2.x, p1.y, 0.0f), n, Math::Point(texCoord2.x, texCoord1.y));
+    glyph.texID = tex.id;
+
+    pos.x += tex.charSize.x * width;
+}
+
+TextRun& CText::GetTextRun(const std::string &text, FontType font, float size)
+{
+    return m_runCache->Get(text, font, GetFontPointSize(size));
+}
 
-        m_quadBatch->Add(quad, tex.id, ENG_RSTATE_TEXT, color);
+void CText::LayoutTextRun(TextRun &run, const std::string &text, FontType font, float size)
+{
+    std::vector<UTF8Char> chars;
+    StringToUTFCharList(text, chars);
+
+    Math::IntPoint pos(0, 0);
+    run.glyphs.resize(chars.size());
+    run.laidOut = true;
+    for (std::size_t i = 0; i < chars.size(); ++i)
+    {
+        LayoutChar(chars[i], font, size, pos, run.glyphs[i]);
 
-        pos.x += tex.charSize.x * width;
+        // Characters without texture are retried the next time the text is drawn
+        if (run.glyphs[i].texID == 0)
+            run.laidOut = false;
     }
 }
 
-CachedFont* CText::GetOrOpenFont(FontType font, float size)
+int CText::GetFontPointSize(float size)
 {
     Math::IntPoint windowSize = m_engine->GetWindowSize();
-    int pointSize = static_cast<int>(size * (windowSize.Length() / REFERENCE_SIZE.Length()));
+    return static_cast<int>(size * (windowSize.Length() / REFERENCE_SIZE.Length()));
+}
+
+CachedFont* CText::GetOrOpenFont(FontType font, float size)
+{
+    int pointSize = GetFontPointSize(size);
 
     if (m_lastCachedFont != nullptr &&
         m_lastFontType == font &&
@@ -1135,7 +1460,7 @@ CachedFont* CText::GetOrOpenFont(FontType font, float size)
         m_error = std::string("Unable to open file '") + mf->fileName + "' (font size = " + StrUtils::ToString<float>(size) + ")";
         return nullptr;
     }
-    GetLogger()->Debug("Loaded font file %s (font size = %.1f)\n", mf->fileName.c_str(), size);
+    GetLogger()->Debug(LOG_CATEGORY_GRAPHICS, "Loaded font file %s (font size = %.1f)\n", mf->fileName.c_str(), size);
 
     auto newFont = MakeUnique<CachedFont>(std::move(file), pointSize);
     if (newFont->font == nullptr)
@@ -1194,11 +1519,10 @@ CharTexture CText::CreateCharTexture(UTF8Char ch, CachedFont* font)
         return texture;
     }
 
-    const int pixelMargin = 1;
-    Math::IntPoint tileSize(Math::Max(16, Math::NextPowerOfTwo(textSurface->w)) + pixelMargin,
-                            Math::Max(16, Math::NextPowerOfTwo(textSurface->h)) + pixelMargin);
+    Math::IntPoint glyphSize(textSurface->w + GLYPH_MARGIN, textSurface->h + GLYPH_MARGIN);
 
-    FontTexture* fontTexture = GetOrCreateFontTexture(tileSize);
+    Math::IntPoint pos;
+    FontTexture* fontTexture = GetOrCreateFontTexture(glyphSize, pos);
 
     if (fontTexture == nullptr)
     {
@@ -1207,7 +1531,7 @@ CharTexture CText::CreateCharTexture(UTF8Char ch, CachedFont* font)
     else
     {
         texture.id = fontTexture->id;
-        texture.charPos = GetNextTilePos(*fontTexture);
+        texture.charPos = pos;
         texture.charSize = Math::IntPoint(textSurface->w, textSurface->h);
 
         ImageData imageData;
@@ -1218,8 +1542,6 @@ CharTexture CText::CreateCharTexture(UTF8Char ch, CachedFont* font)
         m_device->UpdateTexture(tex, texture.charPos, &imageData, TEX_IMG_RGBA);
 
         imageData.surface = nullptr;
-
-        --fontTexture->freeSlots;
     }
 
     SDL_FreeSurface(textSurface);
@@ -1227,30 +1549,42 @@ CharTexture CText::CreateCharTexture(UTF8Char ch, CachedFont* font)
     return texture;
 }
 
-FontTexture* CText::GetOrCreateFontTexture(Math::IntPoint tileSize)
+FontTexture* CText::GetOrCreateFontTexture(Math::IntPoint glyphSize, Math::IntPoint &pos)
 {
+    if (glyphSize.x > FONT_TEXTURE_SIZE.x || glyphSize.y > FONT_TEXTURE_SIZE.y)
+        return nullptr;
+
     for (auto& fontTexture : m_fontTextures)
     {
-       if (fontTexture.tileSize == tileSize && fontTexture.freeSlots > 0)
-           return &fontTexture;
+        if (fontTexture.packer != nullptr && fontTexture.packer->Insert(glyphSize, pos))
+            return &fontTexture;
     }
 
-    FontTexture newFontTexture = CreateFontTexture(tileSize);
+    FontTexture newFontTexture = CreateFontTexture();
     if (newFontTexture.id == 0)
     {
         return nullptr;
     }
 
-    m_fontTextures.push_back(newFontTexture);
+    newFontTexture.packer->Insert(glyphSize, pos);
+    m_fontTextures.push_back(std::move(newFontTexture));
     return &m_fontTextures.back();
 }
 
-FontTexture CText::CreateFontTexture(Math::IntPoint tileSize)
+FontTexture CText::CreateFontTexture(CImage* image)
 {
-    SDL_Surface* textureSurface = SDL_CreateRGBSurface(0, FONT_TEXTURE_SIZE.x, FONT_TEXTURE_SIZE.y, 32,
-                                                       0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000);
+    SDL_Surface* textureSurface = nullptr;
     ImageData data;
-    data.surface = textureSurface;
+    if (image != nullptr)
+    {
+        data.surface = image->GetData()->surface;
+    }
+    else
+    {
+        textureSurface = SDL_CreateRGBSurface(0, FONT_TEXTURE_SIZE.x, FONT_TEXTURE_SIZE.y, 32,
+                                              0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000);
+        data.surface = textureSurface;
+    }
 
     TextureCreateParams createParams;
     createParams.format = TEX_IMG_RGBA;
@@ -1260,30 +1594,121 @@ FontTexture CText::CreateFontTexture(Math::IntPoint tileSize)
     Texture tex = m_device->CreateTexture(&data, createParams);
 
     data.surface = nullptr;
-    SDL_FreeSurface(textureSurface);
+    if (textureSurface != nullptr)
+        SDL_FreeSurface(textureSurface);
 
     FontTexture fontTexture;
     fontTexture.id = tex.id;
-    fontTexture.tileSize = tileSize;
-    int horizontalTiles = FONT_TEXTURE_SIZE.x / tileSize.x;
-    int verticalTiles = FONT_TEXTURE_SIZE.y / tileSize.y;
-    fontTexture.freeSlots = horizontalTiles * verticalTiles;
+    if (image == nullptr)
+        fontTexture.packer = MakeUnique<CRectPacker>(FONT_TEXTURE_SIZE);
     return fontTexture;
 }
 
-Math::IntPoint CText::GetNextTilePos(const FontTexture& fontTexture)
+void CText::PrewarmGlyphs(const std::string &text)
 {
-    int horizontalTiles = FONT_TEXTURE_SIZE.x / std::max(1, fontTexture.tileSize.x); //this should prevent crashes in some combinations of resolution and font size, see issue #1128
-    int verticalTiles = FONT_TEXTURE_SIZE.y / std::max(1, fontTexture.tileSize.y);
+    auto start = std::chrono::steady_clock::now();
 
-    int totalTiles = horizontalTiles * verticalTiles;
-    int tileNumber = totalTiles - fontTexture.freeSlots;
+    std::vector<UTF8Char> chars;
+    StringToUTFCharList(text, chars);
+    for (char c = 32; c < 127; ++c)
+        chars.push_back(UTF8Char(c));
+    for (int specialChar : { CHAR_NEWLINE, CHAR_DOT, CHAR_SQUARE, CHAR_SKIP_RIGHT, CHAR_SKIP_LEFT })
+        chars.push_back(TranslateSpecialChar(specialChar));
+
+    std::set<UTF8Char> charSet;
+    for (const UTF8Char& ch : chars)
+    {
+        if (ch.c1 < 0 || ch.c1 >= 32) // skip control chars
+            charSet.insert(ch);
+    }
+
+    // The key identifies the characters, fonts and their sizes, so that textures from the cache can be used as they are
+    std::stringstream key;
+    key << FONT_TEXTURE_SIZE.x << 'x' << FONT_TEXTURE_SIZE.y;
+    for (const std::string& location : CResourceManager::GetLocations())
+        key << '\n' << location;
+
+    std::vector<GlyphJob> jobs;
+    for (const auto& multisizeFont : m_fonts)
+    {
+        for (float size : { FONT_SIZE_SMALL, FONT_SIZE_BIG })
+        {
+            CachedFont* cf = GetOrOpenFont(multisizeFont.first, size);
+            if (cf == nullptr || cf->font == nullptr)
+                continue;
+
+            GlyphJob job;
+            job.font = multisizeFont.first;
+            job.pointSize = GetFontPointSize(size);
+            job.fileName = multisizeFont.second->fileName;
+            job.cachedFont = cf;
+            for (const UTF8Char& ch : charSet)
+            {
+                if (cf->cache.find(ch) == cf->cache.end())
+                    job.chars.push_back(ch);
+            }
 
-    int verticalTileIndex = tileNumber / std::max(1, horizontalTiles);
-    int horizontalTileIndex = tileNumber % horizontalTiles;
+            key << '\n' << job.font << ' ' << job.pointSize << ' ' << CResourceManager::CleanPath(job.fileName)
+                << ' ' << CResourceManager::GetLastModificationTime(job.fileName);
+
+            if (!job.chars.empty())
+                jobs.push_back(std::move(job));
+        }
+    }
+
+    if (jobs.empty())
+        return;
+
+    key << '\n';
+    for (const UTF8Char& ch : charSet)
+        key << ch.c1 << ch.c2 << ch.c3;
+
+    std::vector<std::unique_ptr<CImage>> pages;
+    std::vector<GlyphPlacement> glyphs;
+    bool cached = m_glyphCache->Load(key.str(), FONT_TEXTURE_SIZE, pages, glyphs);
+    if (!cached)
+    {
+        RenderGlyphs(jobs);
+        PackGlyphs(jobs, pages, glyphs);
+        m_glyphCache->Store(key.str(), FONT_TEXTURE_SIZE, pages, glyphs);
+    }
+
+    std::vector<unsigned int> pageIDs;
+    for (const auto& page : pages)
+    {
+        FontTexture fontTexture = CreateFontTexture(page.get());
+        pageIDs.push_back(fontTexture.id);
+        if (fontTexture.id != 0)
+            m_fontTextures.push_back(std::move(fontTexture));
+    }
+
+    int count = 0;
+    for (const GlyphPlacement& glyph : glyphs)
+    {
+        auto job = std::find_if(jobs.begin(), jobs.end(), [&glyph](const GlyphJob& job)
+        {
+            return job.font == glyph.font && job.pointSize == glyph.pointSize;
+        });
+
+        if (job == jobs.end() || pageIDs[glyph.page] == 0)
+            continue;
+
+        // Characters rendered in the meantime are already in other textures
+        CachedFont* cf = job->cachedFont;
+        if (cf->cache.find(glyph.ch) != cf->cache.end())
+            continue;
+
+        CharTexture tex;
+        tex.id = pageIDs[glyph.page];
+        tex.charPos = glyph.pos;
+        tex.charSize = glyph.size;
+        cf->cache[glyph.ch] = tex;
+        ++count;
+    }
 
-    return Math::IntPoint(horizontalTileIndex * fontTexture.tileSize.x,
-                          verticalTileIndex * fontTexture.tileSize.y);
+    auto time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    GetLogger()->Info("Prepared %d characters in %d font textures %s in %d ms\n", count, static_cast<int>(pages.size()),
+                      cached ? "from cache" : "on worker threads", static_cast<int>(time.count()));
 }
 
 } // namespace Gfx
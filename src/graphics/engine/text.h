@@ -32,8 +32,11 @@
 
 #include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
+class CImage;
+
 
 // Graphics module namespace
 namespace Gfx
@@ -41,6 +44,7 @@ namespace Gfx
 
 class CEngine;
 class CDevice;
+class CGlyphCache;
 
 //! Standard small font size
 const float FONT_SIZE_SMALL = 12.0f;
@@ -207,6 +211,8 @@ struct CharTexture
 struct CachedFont;
 struct MultisizeFont;
 struct FontTexture;
+struct TextGlyph;
+struct TextRun;
 
 /**
  * \enum SpecialChar
@@ -236,6 +242,9 @@ enum SpecialChar
  *   with per-character formatting information (font, highlights and some other info used by CEdit)
  *
  * All font rendering is done in UTF-8.
+ *
+ * Strings drawn or measured with a single font are laid out once into a text run
+ * (glyph quads and width) which is kept in a cache and reused on subsequent frames.
  */
 class CText
 {
@@ -256,6 +265,10 @@ public:
 
     //! Flushes cached textures
     void        FlushCache();
+    //! Renders the characters of given text and printable ASCII in advance, for all fonts in the standard sizes
+    /** Characters are rendered on worker threads and packed into new font textures,
+        which are stored in the font cache and loaded from it on the next call with the same characters. */
+    void        PrewarmGlyphs(const std::string &text);
     //! Try to load new font files
     bool        ReloadFonts();
 
@@ -323,11 +336,14 @@ public:
     Math::IntPoint GetFontTextureSize();
 
 protected:
+    int         GetFontPointSize(float size);
     CachedFont* GetOrOpenFont(FontType font, float size);
+    TextRun&    GetTextRun(const std::string &text, FontType font, float size);
+    void        LayoutTextRun(TextRun &run, const std::string &text, FontType font, float size);
+    void        LayoutChar(UTF8Char ch, FontType font, float size, Math::IntPoint &pos, TextGlyph &glyph);
     CharTexture CreateCharTexture(UTF8Char ch, CachedFont* font);
-    FontTexture* GetOrCreateFontTexture(Math::IntPoint tileSize);
-    FontTexture CreateFontTexture(Math::IntPoint tileSize);
-    Math::IntPoint GetNextTilePos(const FontTexture& fontTexture);
+    FontTexture* GetOrCreateFontTexture(Math::IntPoint glyphSize, Math::IntPoint &pos);
+    FontTexture CreateFontTexture(CImage* image = nullptr);
 
     void        DrawString(const std::string &text, std::vector<FontMetaChar>::iterator format,
                            std::vector<FontMetaChar>::iterator end,
@@ -351,13 +367,20 @@ protected:
 
     std::map<FontType, std::unique_ptr<MultisizeFont>> m_fonts;
     std::vector<FontTexture> m_fontTextures;
+    std::unique_ptr<CGlyphCache> m_glyphCache;
 
     FontType     m_lastFontType;
     int          m_lastFontSize;
     CachedFont*  m_lastCachedFont;
 
+    //! Textures of the button sheets used by FONT_BUTTON, 0 until first used
+    unsigned int m_buttonTexIDs[4];
+
     class CQuadBatch;
     std::unique_ptr<CQuadBatch> m_quadBatch;
+
+    class CRunCache;
+    std::unique_ptr<CRunCache> m_runCache;
 };
 
 
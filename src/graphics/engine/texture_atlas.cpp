@@ -0,0 +1,204 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/texture_atlas.h"
+
+#include "common/image.h"
+#include "common/logger.h"
+#include "common/make_unique.h"
+
+#include "graphics/core/device.h"
+
+#include "graphics/engine/rect_packer.h"
+
+#include "math/func.h"
+
+#include <algorithm>
+#include <memory>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+namespace
+{
+//! Width of the border around each texture in pixels
+const int ATLAS_BORDER = 2;
+} // anonymous namespace
+
+CTextureAtlas::CTextureAtlas(CDevice* device)
+    : m_device(device)
+{
+}
+
+CTextureAtlas::~CTextureAtlas()
+{
+    Clear();
+}
+
+bool CTextureAtlas::Build(const std::vector<std::string>& names, const TextureCreateParams& params, int pageSize)
+{
+    Clear();
+
+    std::vector<std::unique_ptr<CImage>> images;
+    std::vector<std::string> loadedNames;
+    for (const std::string& name : names)
+    {
+        auto image = MakeUnique<CImage>();
+        if (!image->Load(name))
+        {
+            GetLogger()->Warn("Couldn't load texture '%s' for atlas: %s\n", name.c_str(), image->GetError().c_str());
+            continue;
+        }
+
+        images.push_back(std::move(image));
+        loadedNames.push_back(name);
+    }
+
+    // Tallest first, so that the shelves are filled well
+    std::vector<int> order;
+    for (int i = 0; i < static_cast<int>(images.size()); ++i)
+        order.push_back(i);
+
+    std::sort(order.begin(), order.end(), [&images](int a, int b)
+    {
+        return images[a]->GetSize().y > images[b]->GetSize().y;
+    });
+
+    std::vector<std::unique_ptr<CImage>> pageImages;
+    std::vector<std::unique_ptr<CRectPacker>> packers;
+    std::unordered_map<std::string, int> regionPages;
+
+    for (int index : order)
+    {
+        CImage& image = *images[index];
+        Math::IntPoint size = image.GetSize();
+        Math::IntPoint borderSize(size.x + 2 * ATLAS_BORDER, size.y + 2 * ATLAS_BORDER);
+
+        Math::IntPoint pos;
+        int page = 0;
+        for (; page < static_cast<int>(packers.size()); ++page)
+        {
+            if (packers[page]->Insert(borderSize, pos))
+                break;
+        }
+
+        if (page == static_cast<int>(packers.size()))
+        {
+            auto packer = MakeUnique<CRectPacker>(Math::IntPoint(pageSize, pageSize));
+            if (!packer->Insert(borderSize, pos))
+            {
+                GetLogger()->Warn("Texture '%s' is too large for atlas\n", loadedNames[index].c_str());
+                continue;
+            }
+
+            packers.push_back(std::move(packer));
+            pageImages.push_back(MakeUnique<CImage>(Math::IntPoint(pageSize, pageSize)));
+            pageImages.back()->Fill(IntColor(0, 0, 0, 0));
+        }
+
+        pos.x += ATLAS_BORDER;
+        pos.y += ATLAS_BORDER;
+        CopyWithBorder(*pageImages[page], image, pos);
+
+        TextureAtlasRegion region;
+        region.offset = Math::Point(static_cast<float>(pos.x) / pageSize, static_cast<float>(pos.y) / pageSize);
+        region.scale = Math::Point(static_cast<float>(size.x) / pageSize, static_cast<float>(size.y) / pageSize);
+        region.pos = pos;
+        region.size = size;
+        m_regions[loadedNames[index]] = region;
+        regionPages[loadedNames[index]] = page;
+    }
+
+    for (auto& pageImage : pageImages)
+    {
+        Texture page = m_device->CreateTexture(pageImage.get(), params);
+        if (!page.Valid())
+        {
+            GetLogger()->Error("Couldn't create texture atlas page\n");
+            Clear();
+            return false;
+        }
+
+        m_pages.push_back(page);
+    }
+
+    for (auto& region : m_regions)
+        region.second.page = m_pages[regionPages[region.first]];
+
+    GetLogger()->Debug("Packed %d textures into %d atlas pages\n",
+                       static_cast<int>(m_regions.size()), static_cast<int>(m_pages.size()));
+
+    return !m_regions.empty();
+}
+
+void CTextureAtlas::Clear()
+{
+    for (const Texture& page : m_pages)
+        m_device->DestroyTexture(page);
+
+    m_pages.clear();
+    m_regions.clear();
+}
+
+const TextureAtlasRegion* CTextureAtlas::Find(const std::string& name) const
+{
+    auto it = m_regions.find(name);
+    if (it == m_regions.end())
+        return nullptr;
+
+    return &(*it).second;
+}
+
+bool CTextureAtlas::Update(const std::string& name, CImage* image, TexImgFormat format)
+{
+    auto it = m_regions.find(name);
+    if (it == m_regions.end())
+        return false;
+
+    const TextureAtlasRegion& region = (*it).second;
+    if (image->GetSize() != region.size)
+        return false;
+
+    m_device->UpdateTexture(region.page, region.pos, image->GetData(), format);
+    return true;
+}
+
+int CTextureAtlas::GetPageCount() const
+{
+    return m_pages.size();
+}
+
+void CTextureAtlas::CopyWithBorder(CImage& page, CImage& image, Math::IntPoint pos)
+{
+    Math::IntPoint size = image.GetSize();
+
+    for (int y = -ATLAS_BORDER; y < size.y + ATLAS_BORDER; ++y)
+    {
+        int srcY = Math::Clamp(y, 0, size.y - 1);
+        for (int x = -ATLAS_BORDER; x < size.x + ATLAS_BORDER; ++x)
+        {
+            int srcX = Math::Clamp(x, 0, size.x - 1);
+            page.SetPixelInt(Math::IntPoint(pos.x + x, pos.y + y), image.GetPixelInt(Math::IntPoint(srcX, srcY)));
+        }
+    }
+}
+
+} // namespace Gfx
@@ -0,0 +1,107 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file graphics/engine/texture_atlas.h
+ * \brief Textures packed into shared pages - CTextureAtlas class
+ */
+
+#pragma once
+
+#include "graphics/core/texture.h"
+
+#include "math/intpoint.h"
+#include "math/point.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class CImage;
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+class CDevice;
+
+/**
+ * \struct TextureAtlasRegion
+ * \brief Place of a texture in an atlas page
+ *
+ * Texture coordinates of the original texture are mapped to the page
+ * as offset + uv * scale.
+ */
+struct TextureAtlasRegion
+{
+    //! Page containing the texture
+    Texture page;
+    //! Offset of the texture in page texture coordinates
+    Math::Point offset;
+    //! Size of the texture in page texture coordinates
+    Math::Point scale;
+    //! Position of the texture in the page, in pixels
+    Math::IntPoint pos;
+    //! Size of the texture in pixels
+    Math::IntPoint size;
+};
+
+/**
+ * \class CTextureAtlas
+ * \brief Packs several small textures into a few larger pages
+ *
+ * Drawing from one page instead of many textures lets consecutive draws
+ * be batched. Each texture is surrounded by a border of its repeated
+ * edge pixels, so filtering does not pick up neighbouring textures.
+ */
+class CTextureAtlas
+{
+public:
+    explicit CTextureAtlas(CDevice* device);
+    ~CTextureAtlas();
+
+    CTextureAtlas(const CTextureAtlas&) = delete;
+    CTextureAtlas& operator=(const CTextureAtlas&) = delete;
+
+    //! Loads the given image files and packs them into pages of given size
+    /** Files that cannot be loaded or do not fit are left out.
+        Returns false if no file was packed. */
+    bool Build(const std::vector<std::string>& names, const TextureCreateParams& params, int pageSize);
+    //! Destroys the pages and forgets all regions
+    void Clear();
+
+    //! Returns the region of texture with given name, or nullptr if it is not in the atlas
+    const TextureAtlasRegion* Find(const std::string& name) const;
+    //! Replaces the pixels of a packed texture with the image of the same size
+    bool Update(const std::string& name, CImage* image, TexImgFormat format);
+
+    //! Returns the number of pages
+    int GetPageCount() const;
+
+private:
+    //! Copies the image into page at given position, repeating the edges into the border
+    void CopyWithBorder(CImage& page, CImage& image, Math::IntPoint pos);
+
+    CDevice* m_device;
+    std::vector<Texture> m_pages;
+    std::unordered_map<std::string, TextureAtlasRegion> m_regions;
+};
+
+} // namespace Gfx
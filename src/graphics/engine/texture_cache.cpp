@@ -0,0 +1,304 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/texture_cache.h"
+
+#include "common/image.h"
+#include "common/logger.h"
+#include "common/make_unique.h"
+
+#include "common/resources/mapped_file.h"
+#include "common/resources/outputstream.h"
+#include "common/resources/resourcemanager.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#include <SDL.h>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+namespace
+{
+
+//! Directory of the cache, relative to the save location
+const std::string CACHE_DIRECTORY = "cache/textures";
+//! Identifies texture cache files
+const char CACHE_MAGIC[4] = { 'C', 'T', 'E', 'X' };
+//! Version of the file layout
+const uint32_t CACHE_VERSION = 2;
+//! Maximum number of mipmap levels, including the base level
+const uint32_t CACHE_MAX_LEVELS = 32;
+//! Total size of cache files kept at startup
+const long long CACHE_SIZE_LIMIT = 512LL * 1024 * 1024;
+
+/*
+ * Layout of the cache file, following the header of CCacheDirectory:
+ *   CacheHeader
+ *   CacheLevel[levelCount]
+ *   pixel data of each level, rows without padding, aligned to CCacheDirectory::ALIGNMENT
+ */
+
+struct CacheHeader
+{
+    uint32_t bytesPerPixel;
+    uint32_t masks[4];
+    uint32_t levelCount;
+    //! Time of decoding the original file in milliseconds
+    float decodeTime;
+};
+
+struct CacheLevel
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t offset;
+};
+
+struct MipmapLevel
+{
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels;
+};
+
+//! Computes the next mipmap level, averaging 2x2 blocks of pixels
+MipmapLevel Downsample(const MipmapLevel& src, int bytesPerPixel)
+{
+    MipmapLevel dst;
+    dst.width = std::max(1, src.width / 2);
+    dst.height = std::max(1, src.height / 2);
+    dst.pixels.resize(dst.width * dst.height * bytesPerPixel);
+
+    for (int y = 0; y < dst.height; ++y)
+    {
+        int y0 = std::min(2 * y, src.height - 1);
+        int y1 = std::min(2 * y + 1, src.height - 1);
+
+        for (int x = 0; x < dst.width; ++x)
+        {
+            int x0 = std::min(2 * x, src.width - 1);
+            int x1 = std::min(2 * x + 1, src.width - 1);
+
+            for (int c = 0; c < bytesPerPixel; ++c)
+            {
+                int sum = src.pixels[(y0 * src.width + x0) * bytesPerPixel + c] +
+                          src.pixels[(y0 * src.width + x1) * bytesPerPixel + c] +
+                          src.pixels[(y1 * src.width + x0) * bytesPerPixel + c] +
+                          src.pixels[(y1 * src.width + x1) * bytesPerPixel + c];
+
+                dst.pixels[(y * dst.width + x) * bytesPerPixel + c] = static_cast<unsigned char>((sum + 2) / 4);
+            }
+        }
+    }
+
+    return dst;
+}
+
+} // anonymous namespace
+
+
+CTextureCache::CTextureCache()
+    : m_directory(CACHE_DIRECTORY, CACHE_MAGIC, CACHE_VERSION)
+{
+    std::string locations;
+    for (const std::string& location : CResourceManager::GetLocations())
+        locations += '\n' + location;
+
+    // Entries made with the current search path are stale once their file changes,
+    // entries of other search paths stay until the size limit, as the mods can be switched back
+    m_directory.Sweep([this, &locations](const std::string& key)
+    {
+        std::size_t nameEnd = key.find('\n');
+        if (nameEnd == std::string::npos)
+            return true;
+
+        std::size_t timeEnd = std::min(key.find('\n', nameEnd + 1), key.size());
+        return key.compare(timeEnd, std::string::npos, locations) == 0 && key != GetKey(key.substr(0, nameEnd));
+    }, CACHE_SIZE_LIMIT);
+}
+
+bool CTextureCache::IsEnabled() const
+{
+    return m_directory.IsEnabled();
+}
+
+bool CTextureCache::Load(const std::string& name, CImage& image, float& decodeTime)
+{
+    if (!IsEnabled())
+        return false;
+
+    std::string key = GetKey(name);
+    if (key.empty())
+        return false;
+
+    auto file = std::make_shared<CMappedFile>();
+    CacheHeader header;
+    std::size_t tableOffset = 0;
+    if (!m_directory.OpenRead(CCacheDirectory::GetFileName(key), key, *file, &header, sizeof(header), tableOffset))
+        return false;
+
+    const char* data = file->GetData();
+    std::size_t size = file->GetSize();
+
+    if (header.bytesPerPixel != 3 && header.bytesPerPixel != 4)
+        return false;
+
+    if (header.levelCount == 0 || header.levelCount > CACHE_MAX_LEVELS)
+        return false;
+
+    if (size < tableOffset + header.levelCount * sizeof(CacheLevel))
+        return false;
+
+    std::vector<CacheLevel> levels(header.levelCount);
+    memcpy(levels.data(), data + tableOffset, levels.size() * sizeof(CacheLevel));
+
+    std::vector<SDL_Surface*> surfaces;
+    for (const CacheLevel& level : levels)
+    {
+        std::size_t pitch = static_cast<std::size_t>(level.width) * header.bytesPerPixel;
+
+        SDL_Surface* surface = nullptr;
+        if (level.width > 0 && level.height > 0 && level.offset + pitch * level.height <= size)
+        {
+            // The surface refers to the mapped file, the pixels are not copied
+            surface = SDL_CreateRGBSurfaceFrom(file->GetData() + level.offset, level.width, level.height,
+                                               header.bytesPerPixel * 8, pitch,
+                                               header.masks[0], header.masks[1], header.masks[2], header.masks[3]);
+        }
+
+        if (surface == nullptr)
+        {
+            for (SDL_Surface* s : surfaces)
+                SDL_FreeSurface(s);
+            return false;
+        }
+
+        surfaces.push_back(surface);
+    }
+
+    auto imageData = MakeUnique<ImageData>();
+    imageData->surface = surfaces[0];
+    imageData->mipmaps.assign(surfaces.begin() + 1, surfaces.end());
+    image.SetData(std::move(imageData), file);
+
+    decodeTime = header.decodeTime;
+    return true;
+}
+
+bool CTextureCache::Store(const std::string& name, CImage& image, float decodeTime)
+{
+    if (!IsEnabled() || image.IsEmpty())
+        return false;
+
+    std::string key = GetKey(name);
+    if (key.empty())
+        return false;
+
+    SDL_Surface* surface = image.GetData()->surface;
+    if (surface->format->BytesPerPixel != 3 && surface->format->BytesPerPixel != 4)
+    {
+        image.ConvertToRGBA();
+        surface = image.GetData()->surface;
+    }
+
+    int bytesPerPixel = surface->format->BytesPerPixel;
+
+    std::vector<MipmapLevel> levels(1);
+    levels[0].width = surface->w;
+    levels[0].height = surface->h;
+    levels[0].pixels.resize(surface->w * surface->h * bytesPerPixel);
+
+    SDL_LockSurface(surface);
+    for (int y = 0; y < surface->h; ++y)
+    {
+        memcpy(&levels[0].pixels[y * surface->w * bytesPerPixel],
+               static_cast<const unsigned char*>(surface->pixels) + y * surface->pitch,
+               surface->w * bytesPerPixel);
+    }
+    SDL_UnlockSurface(surface);
+
+    while (levels.back().width > 1 || levels.back().height > 1)
+        levels.push_back(Downsample(levels.back(), bytesPerPixel));
+
+    CacheHeader header;
+    header.bytesPerPixel = bytesPerPixel;
+    header.masks[0] = surface->format->Rmask;
+    header.masks[1] = surface->format->Gmask;
+    header.masks[2] = surface->format->Bmask;
+    header.masks[3] = surface->format->Amask;
+    header.levelCount = levels.size();
+    header.decodeTime = decodeTime;
+
+    COutputStream stream;
+    std::size_t position = 0;
+    if (!m_directory.OpenWrite(CCacheDirectory::GetFileName(key), key, stream, &header, sizeof(header), position))
+        return false;
+
+    std::vector<CacheLevel> table(levels.size());
+    std::size_t offset = position + table.size() * sizeof(CacheLevel);
+    for (std::size_t i = 0; i < levels.size(); ++i)
+    {
+        offset = CCacheDirectory::Align(offset);
+        table[i].width = levels[i].width;
+        table[i].height = levels[i].height;
+        table[i].offset = offset;
+        offset += levels[i].pixels.size();
+    }
+
+    stream.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(CacheLevel));
+    position += table.size() * sizeof(CacheLevel);
+
+    for (std::size_t i = 0; i < levels.size(); ++i)
+    {
+        CCacheDirectory::WritePadding(stream, position, table[i].offset);
+        stream.write(reinterpret_cast<const char*>(levels[i].pixels.data()), levels[i].pixels.size());
+        position += levels[i].pixels.size();
+    }
+
+    bool ok = stream.good();
+    stream.close();
+
+    if (!ok)
+        GetLogger()->Warn("Couldn't write texture cache file for '%s'\n", name.c_str());
+
+    return ok;
+}
+
+std::string CTextureCache::GetKey(const std::string& name)
+{
+    long long time = CResourceManager::GetLastModificationTime(name);
+    if (time < 0)
+        return "";
+
+    std::stringstream key;
+    key << CResourceManager::CleanPath(name) << '\n' << time;
+    for (const std::string& location : CResourceManager::GetLocations())
+        key << '\n' << location;
+
+    return key.str();
+}
+
+} // namespace Gfx
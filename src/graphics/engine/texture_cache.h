@@ -0,0 +1,76 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file graphics/engine/texture_cache.h
+ * \brief On-disk cache of decoded textures - CTextureCache class
+ */
+
+#pragma once
+
+#include "common/resources/cache_directory.h"
+
+#include <string>
+
+class CImage;
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+/**
+ * \class CTextureCache
+ * \brief Cache of decoded texture images with precomputed mipmaps
+ *
+ * Images are stored uncompressed in the cache directory of the save location,
+ * one file per image, together with the full mipmap chain. Cached images
+ * are mapped into memory and used in place, without decoding or copying.
+ *
+ * An image is identified by its resource path, the current search path
+ * (which includes the enabled mods) and the modification time of the file,
+ * so editing the file or changing mods makes the old entry unused.
+ * Unused entries are removed when the cache is created: those of changed files
+ * right away, the oldest others once the cache grows over its size limit.
+ *
+ * All functions may be called from multiple threads at once.
+ */
+class CTextureCache
+{
+public:
+    //! Creates the cache directory; the cache is disabled if there is no save location
+    CTextureCache();
+
+    //! Returns true if the cache can be used
+    bool IsEnabled() const;
+
+    //! Loads the image with mipmaps from cache, if it is present and up to date
+    /** \a decodeTime is set to the time it took to decode the original file, in milliseconds. */
+    bool Load(const std::string& name, CImage& image, float& decodeTime);
+    //! Stores the decoded image with its mipmaps in cache
+    /** The image may be converted to 32-bit format in the process. */
+    bool Store(const std::string& name, CImage& image, float decodeTime);
+
+private:
+    //! Returns the string identifying the current version of the file, or empty string if it does not exist
+    std::string GetKey(const std::string& name);
+    CCacheDirectory m_directory;
+};
+
+} // namespace Gfx
@@ -0,0 +1,278 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/texture_loader.h"
+
+#include "common/image.h"
+#include "common/make_unique.h"
+
+#include "common/thread/worker_pool.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <SDL_cpuinfo.h>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+CTextureLoader::CTextureLoader()
+    : m_decodeTime(0)
+    , m_decodeCount(0)
+    , m_cacheHits(0)
+    , m_cacheSavedTime(0)
+{
+    int threadCount = std::max(1, std::min(4, SDL_GetCPUCount() - 1));
+    m_pool = MakeUnique<CWorkerPool>(threadCount, "Texture loader");
+}
+
+CTextureLoader::~CTextureLoader()
+{
+    m_pool.reset();
+}
+
+void CTextureLoader::Request(const std::string& name)
+{
+    m_mutex.Lock();
+
+    bool requested = m_entries.find(name) != m_entries.end();
+    if (!requested)
+        m_entries[name] = Entry();
+
+    m_mutex.Unlock();
+
+    if (!requested)
+        m_pool->Start([this, name]() { Run(name); });
+}
+
+bool CTextureLoader::IsRequested(const std::string& name)
+{
+    m_mutex.Lock();
+    bool requested = m_entries.find(name) != m_entries.end();
+    m_mutex.Unlock();
+
+    return requested;
+}
+
+bool CTextureLoader::TryTake(const std::string& name, std::unique_ptr<CImage>& image, std::string& error)
+{
+    m_mutex.Lock();
+
+    auto it = m_entries.find(name);
+    if (it == m_entries.end() || it->second.state != State::Done)
+    {
+        m_mutex.Unlock();
+        return false;
+    }
+
+    TakeEntry(it, image, error);
+
+    m_mutex.Unlock();
+    return true;
+}
+
+bool CTextureLoader::Take(const std::string& name, std::unique_ptr<CImage>& image, std::string& error)
+{
+    m_mutex.Lock();
+
+    auto it = m_entries.find(name);
+    if (it == m_entries.end())
+    {
+        m_mutex.Unlock();
+        return false;
+    }
+
+    // Not started yet, decoding here is faster than waiting behind the rest of the queue
+    if (it->second.state == State::Queued)
+    {
+        it->second.state = State::Decoding;
+
+        m_mutex.Unlock();
+        Decode(name, image, error);
+        m_mutex.Lock();
+
+        Finish(name, image, error);
+        it = m_entries.find(name);
+    }
+
+    while (it->second.state != State::Done)
+    {
+        m_finishCond.Wait(*m_mutex);
+    }
+
+    TakeEntry(it, image, error);
+
+    m_mutex.Unlock();
+    return true;
+}
+
+void CTextureLoader::Clear()
+{
+    m_mutex.Lock();
+    m_entries.clear();
+    m_mutex.Unlock();
+}
+
+void CTextureLoader::Clear(const std::function<bool(const std::string&)>& keep)
+{
+    m_mutex.Lock();
+
+    // Queued images are skipped by Run(), images being decoded are discarded by Finish()
+    for (auto it = m_entries.begin(); it != m_entries.end(); )
+    {
+        if (keep(it->first))
+            ++it;
+        else
+            it = m_entries.erase(it);
+    }
+
+    m_mutex.Unlock();
+}
+
+int CTextureLoader::GetQueueDepth()
+{
+    m_mutex.Lock();
+
+    int depth = 0;
+    for (const auto& entry : m_entries)
+    {
+        if (entry.second.state != State::Done)
+            depth++;
+    }
+
+    m_mutex.Unlock();
+    return depth;
+}
+
+float CTextureLoader::GetAverageDecodeTime()
+{
+    m_mutex.Lock();
+    float time = m_decodeCount > 0 ? m_decodeTime / (m_decodeCount * 1e6f) : 0.0f;
+    m_mutex.Unlock();
+
+    return time;
+}
+
+int CTextureLoader::GetCacheHits()
+{
+    m_mutex.Lock();
+    int hits = m_cacheHits;
+    m_mutex.Unlock();
+
+    return hits;
+}
+
+float CTextureLoader::GetCacheSavedTime()
+{
+    m_mutex.Lock();
+    float time = m_cacheSavedTime / 1e6f;
+    m_mutex.Unlock();
+
+    return time;
+}
+
+void CTextureLoader::Run(const std::string& name)
+{
+    m_mutex.Lock();
+
+    // Take() may have decoded the image already, or Clear() dropped it; after Clear(),
+    // a new request of the same name may also be served by the job of the old one
+    auto it = m_entries.find(name);
+    if (it == m_entries.end() || it->second.state != State::Queued)
+    {
+        m_mutex.Unlock();
+        return;
+    }
+
+    it->second.state = State::Decoding;
+
+    std::unique_ptr<CImage> image;
+    std::string error;
+
+    m_mutex.Unlock();
+    Decode(name, image, error);
+    m_mutex.Lock();
+
+    Finish(name, image, error);
+
+    m_mutex.Unlock();
+}
+
+void CTextureLoader::Decode(const std::string& name, std::unique_ptr<CImage>& image, std::string& error)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    image = MakeUnique<CImage>();
+
+    float originalTime = 0.0f;
+    if (m_cache.Load(name, *image, originalTime))
+    {
+        auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+        m_mutex.Lock();
+        m_decodeTime += time.count();
+        m_decodeCount++;
+        m_cacheHits++;
+        m_cacheSavedTime += static_cast<long long>(originalTime * 1e6f) - time.count();
+        m_mutex.Unlock();
+        return;
+    }
+
+    if (!image->Load(name))
+    {
+        error = image->GetError();
+        image.reset();
+    }
+
+    auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    m_mutex.Lock();
+    m_decodeTime += time.count();
+    m_decodeCount++;
+    m_mutex.Unlock();
+
+    // Map the stored copy, which also brings the precomputed mipmaps
+    if (image != nullptr && m_cache.Store(name, *image, time.count() / 1e6f))
+        m_cache.Load(name, *image, originalTime);
+}
+
+void CTextureLoader::Finish(const std::string& name, std::unique_ptr<CImage>& image, std::string& error)
+{
+    // The entry is gone if the loader was cleared in the meantime
+    auto it = m_entries.find(name);
+    if (it != m_entries.end() && it->second.state == State::Decoding)
+    {
+        it->second.state = State::Done;
+        it->second.image = std::move(image);
+        it->second.error = error;
+    }
+
+    m_finishCond.Broadcast();
+}
+
+void CTextureLoader::TakeEntry(std::map<std::string, Entry>::iterator it, std::unique_ptr<CImage>& image, std::string& error)
+{
+    image = std::move(it->second.image);
+    error = it->second.error;
+    m_entries.erase(it);
+}
+
+} // namespace Gfx
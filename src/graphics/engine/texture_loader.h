@@ -0,0 +1,140 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file graphics/engine/texture_loader.h
+ * \brief Background decoding of texture images - CTextureLoader class
+ */
+
+#pragma once
+
+#include "common/thread/sdl_cond_wrapper.h"
+#include "common/thread/sdl_mutex_wrapper.h"
+
+#include "graphics/engine/texture_cache.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+class CImage;
+class CWorkerPool;
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+/**
+ * \class CTextureLoader
+ * \brief Decodes texture images on worker threads
+ *
+ * Only decoding happens in the background; the decoded images are taken
+ * by the engine, which uploads them to the device on the main thread.
+ * Apart from the workers, the loader must be used from a single thread.
+ *
+ * Decoded images are kept in CTextureCache, so later runs map them
+ * from the cache instead of decoding the original files.
+ */
+class CTextureLoader
+{
+public:
+    //! Starts the worker threads, one less than there are processors, at most 4
+    CTextureLoader();
+    //! Stops the worker threads, dropping the images not taken
+    ~CTextureLoader();
+
+    CTextureLoader(const CTextureLoader&) = delete;
+    CTextureLoader& operator=(const CTextureLoader&) = delete;
+
+    //! Queues decoding of the given image file, if it is not requested already
+    void Request(const std::string& name);
+    //! Returns true if the image was requested and not taken yet
+    bool IsRequested(const std::string& name);
+
+    //! Takes the image if its decoding has finished, returns false otherwise
+    /** On decoding failure, \a image is null and \a error holds the reason. */
+    bool TryTake(const std::string& name, std::unique_ptr<CImage>& image, std::string& error);
+    //! Takes the image, decoding it right away or waiting for the worker; returns false if it was not requested
+    bool Take(const std::string& name, std::unique_ptr<CImage>& image, std::string& error);
+
+    //! Drops all requests and all images not taken yet
+    void Clear();
+    //! Drops the requests and images not taken yet, except those for which \a keep returns true
+    void Clear(const std::function<bool(const std::string&)>& keep);
+
+    //! Decodes the image on the calling thread, bypassing the queue
+    /** On failure, \a image is null and \a error holds the reason. */
+    void Decode(const std::string& name, std::unique_ptr<CImage>& image, std::string& error);
+
+    //! Returns the number of images waiting for decoding or being decoded
+    int GetQueueDepth();
+    //! Returns the average time of decoding one image in milliseconds
+    float GetAverageDecodeTime();
+    //! Returns the number of images loaded from the texture cache
+    int GetCacheHits();
+    //! Returns the decoding time saved by the texture cache in milliseconds
+    float GetCacheSavedTime();
+
+private:
+    enum class State
+    {
+        Queued,
+        Decoding,
+        Done
+    };
+
+    struct Entry
+    {
+        State state = State::Queued;
+        std::unique_ptr<CImage> image;
+        std::string error;
+    };
+
+    //! Decodes the requested image on a worker thread, unless it was taken or dropped meanwhile
+    void Run(const std::string& name);
+    //! Stores the result of decoding, with the mutex held
+    void Finish(const std::string& name, std::unique_ptr<CImage>& image, std::string& error);
+    //! Moves the result out of a finished entry and removes it, with the mutex held
+    void TakeEntry(std::map<std::string, Entry>::iterator it, std::unique_ptr<CImage>& image, std::string& error);
+
+    CTextureCache m_cache;
+
+    CSDLMutexWrapper m_mutex;
+    //! Signalled when decoding of an image finishes
+    CSDLCondWrapper m_finishCond;
+
+    //! All requested images not taken yet
+    std::map<std::string, Entry> m_entries;
+
+    //! Total decoding time in nanoseconds
+    long long m_decodeTime;
+    //! Number of decoded images
+    int m_decodeCount;
+    //! Number of images loaded from cache
+    int m_cacheHits;
+    //! Difference between original decoding time and loading from cache, in nanoseconds
+    long long m_cacheSavedTime;
+
+    //! Worker threads, destroyed first as they use the other members
+    std::unique_ptr<CWorkerPool> m_pool;
+};
+
+} // namespace Gfx
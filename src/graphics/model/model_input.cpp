@@ -28,6 +28,7 @@
 #include "graphics/model/model_io_structs.h"
 
 #include <fstream>
+#include <cstdint>
 #include <cstdio>
 
 #include <boost/algorithm/string.hpp>
@@ -36,9 +37,64 @@
 namespace Gfx
 {
 
+namespace
+{
+
+//! Stream buffer reading directly from a block of memory
+class CMemoryStreamBuffer : public std::streambuf
+{
+public:
+    CMemoryStreamBuffer(const char* data, std::size_t size)
+    {
+        // the get area is never written to
+        char* begin = const_cast<char*>(data);
+        setg(begin, begin, begin + size);
+    }
+
+private:
+    std::streampos seekpos(std::streampos sp, std::ios_base::openmode which) override
+    {
+        return seekoff(off_type(sp), std::ios_base::beg, which);
+    }
+
+    std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode which) override
+    {
+        std::streamoff position = off;
+        if (way == std::ios_base::cur)
+            position += gptr() - eback();
+        else if (way == std::ios_base::end)
+            position += egptr() - eback();
+
+        if (position < 0 || position > egptr() - eback())
+            return pos_type(off_type(-1));
+
+        setg(eback(), eback() + position, egptr());
+        return pos_type(position);
+    }
+};
+
+bool IsLittleEndian()
+{
+    const std::uint32_t probe = 1;
+    return *reinterpret_cast<const unsigned char*>(&probe) == 1;
+}
+
+} // anonymous namespace
+
 // Private functions
 namespace ModelInput
 {
+    //! Triangles of an old format model sorted by level of detail
+    struct LodTriangles
+    {
+        //! Full detail triangles
+        std::vector<ModelTriangle> full;
+        //! Reduced detail triangles (medium, low)
+        std::vector<ModelTriangle> reduced[MODEL_MESH_LOD_COUNT];
+        //! Whether the model has triangles of its own for the reduced level
+        bool hasReduced[MODEL_MESH_LOD_COUNT] = { false, false };
+    };
+
     void ReadTextModel(CModel &model, std::istream &stream);
     void ReadTextModelV1AndV2(CModel &model, std::istream &stream);
 
@@ -49,15 +105,22 @@ namespace ModelInput
     void ReadBinaryModel(CModel &model, std::istream &stream);
     void ReadBinaryModelV1AndV2(CModel &model, std::istream &stream);
     void ReadBinaryModelV3(CModel &model, std::istream &stream);
+    CModelMesh ReadBinaryMesh(std::istream &stream);
+    std::vector<ModelTriangle> ReadBinaryTriangles(std::istream &stream);
+    ModelTriangleGroupV3 ReadBinaryTriangleGroup(std::istream &stream);
+    void ReadBinaryPadding(std::istream &stream);
+    void ReadBinaryVertices(std::istream &stream, std::vector<VertexTex2>& vertices);
 
     void ReadOldModel(CModel &model, std::istream &stream);
-    std::vector<ModelTriangle> ReadOldModelV1(std::istream &stream, int totalTriangles);
-    std::vector<ModelTriangle> ReadOldModelV2(std::istream &stream, int totalTriangles);
-    std::vector<ModelTriangle> ReadOldModelV3(std::istream &stream, int totalTriangles);
+    LodTriangles ReadOldModelV1(std::istream &stream, int totalTriangles);
+    LodTriangles ReadOldModelV2(std::istream &stream, int totalTriangles);
+    LodTriangles ReadOldModelV3(std::istream &stream, int totalTriangles);
 
     Vertex ReadBinaryVertex(std::istream& stream);
     VertexTex2 ReadBinaryVertexTex2(std::istream& stream);
     Material ReadBinaryMaterial(std::istream& stream);
+    Math::Vector ReadBinaryVector(std::istream& stream);
+    Color ReadBinaryColor(std::istream& stream);
 
     std::string ReadLineString(std::istream& stream, const std::string& expectedPrefix);
     void ReadValuePrefix(std::istream& stream, const std::string& expectedPrefix);
@@ -73,6 +136,8 @@ namespace ModelInput
     void ConvertOldTex1Name(ModelTriangle& triangle, const char* tex1Name);
     void ConvertFromOldRenderState(ModelTriangle& triangle, int state);
     ModelLODLevel MinMaxToLodLevel(float min, float max);
+    void AddLodTriangle(LodTriangles& triangles, ModelLODLevel lodLevel, const ModelTriangle& triangle);
+    void SetMeshTriangles(CModelMesh& mesh, LodTriangles& triangles);
 }
 
 using namespace IOUtils;
@@ -112,6 +177,13 @@ CModel ModelInput::Read(std::istream &stream, ModelFormat format)
     return model;
 }
 
+CModel ModelInput::Read(const char* data, std::size_t size, ModelFormat format)
+{
+    CMemoryStreamBuffer buffer(data, size);
+    std::istream stream(&buffer);
+    return Read(stream, format);
+}
+
 void ModelInput::ReadBinaryModel(CModel &model, std::istream &stream)
 {
     int version = 0;
@@ -146,7 +218,7 @@ void ModelInput::ReadBinaryModelV1AndV2(CModel &model, std::istream &stream)
         throw CModelIOException(std::string("Error reading model file header: ") + e.what());
     }
 
-    CModelMesh mesh;
+    LodTriangles triangles;
 
     try
     {
@@ -167,10 +239,6 @@ void ModelInput::ReadBinaryModelV1AndV2(CModel &model, std::istream &stream)
 
             t.state = ReadBinary<4, int>(stream);
 
-            if (t.lodLevel == ModelLODLevel::Low ||
-                t.lodLevel == ModelLODLevel::Medium)
-                continue;
-
             ModelTriangle triangle;
             triangle.p1 = t.p1;
             triangle.p2 = t.p2;
@@ -183,7 +251,7 @@ void ModelInput::ReadBinaryModelV1AndV2(CModel &model, std::istream &stream)
             triangle.variableTex2 = t.variableTex2;
             ConvertFromOldRenderState(triangle, t.state);
 
-            mesh.AddTriangle(triangle);
+            AddLodTriangle(triangles, t.lodLevel, triangle);
         }
     }
     catch (const std::exception& e)
@@ -191,12 +259,195 @@ void ModelInput::ReadBinaryModelV1AndV2(CModel &model, std::istream &stream)
         throw CModelIOException(std::string("Error reading model data: ") + e.what());
     }
 
+    CModelMesh mesh;
+    SetMeshTriangles(mesh, triangles);
+
     model.AddMesh("main", std::move(mesh));
 }
 
 void ModelInput::ReadBinaryModelV3(CModel &model, std::istream &stream)
 {
-    // TODO...
+    ModelHeaderV3 header;
+
+    try
+    {
+        header.version = ReadBinary<4, int>(stream);
+        header.totalCrashSpheres = ReadBinary<4, int>(stream);
+        header.hasShadowSpot = ReadBinaryBool(stream);
+        header.hasCameraCollisionSphere = ReadBinaryBool(stream);
+        /* padding */ ReadBinary<2, int>(stream);
+        header.totalMeshes = ReadBinary<4, int>(stream);
+    }
+    catch (const std::exception& e)
+    {
+        throw CModelIOException(std::string("Error reading model header: ") + e.what());
+    }
+
+    try
+    {
+        for (int i = 0; i < header.totalCrashSpheres; ++i)
+        {
+            ModelCrashSphere crashSphere;
+            crashSphere.position = ReadBinaryVector(stream);
+            crashSphere.radius = ReadBinaryFloat(stream);
+            crashSphere.hardness = ReadBinaryFloat(stream);
+            crashSphere.sound = ReadBinaryString<1>(stream);
+            model.AddCrashSphere(crashSphere);
+        }
+
+        if (header.hasShadowSpot)
+        {
+            ModelShadowSpot shadowSpot;
+            shadowSpot.radius = ReadBinaryFloat(stream);
+            shadowSpot.intensity = ReadBinaryFloat(stream);
+            model.SetShadowSpot(shadowSpot);
+        }
+
+        if (header.hasCameraCollisionSphere)
+        {
+            Math::Sphere sphere;
+            sphere.pos = ReadBinaryVector(stream);
+            sphere.radius = ReadBinaryFloat(stream);
+            model.SetCameraCollisionSphere(sphere);
+        }
+
+        for (int i = 0; i < header.totalMeshes; ++i)
+        {
+            std::string meshName = ReadBinaryString<1>(stream);
+            CModelMesh mesh = ReadBinaryMesh(stream);
+            model.AddMesh(meshName, std::move(mesh));
+        }
+    }
+    catch (const CModelIOException& e)
+    {
+        throw;
+    }
+    catch (const std::exception& e)
+    {
+        throw CModelIOException(std::string("Error reading model data: ") + e.what());
+    }
+}
+
+CModelMesh ModelInput::ReadBinaryMesh(std::istream &stream)
+{
+    CModelMesh mesh;
+
+    mesh.SetParent(ReadBinaryString<1>(stream));
+    mesh.SetPosition(ReadBinaryVector(stream));
+    mesh.SetRotation(ReadBinaryVector(stream));
+    mesh.SetScale(ReadBinaryVector(stream));
+
+    mesh.SetTriangles(ReadBinaryTriangles(stream));
+    for (int i = 0; i < MODEL_MESH_LOD_COUNT; ++i)
+        mesh.SetLodTriangles(i, ReadBinaryTriangles(stream));
+
+    return mesh;
+}
+
+std::vector<ModelTriangle> ModelInput::ReadBinaryTriangles(std::istream &stream)
+{
+    int totalGroups = ReadBinary<4, int>(stream);
+    int totalTriangles = ReadBinary<4, int>(stream);
+    if (totalGroups < 0 || totalTriangles < 0)
+        throw CModelIOException("Invalid number of triangles");
+
+    std::vector<ModelTriangleGroupV3> groups;
+    groups.reserve(totalGroups);
+    int groupTriangles = 0;
+    for (int i = 0; i < totalGroups; ++i)
+    {
+        groups.push_back(ReadBinaryTriangleGroup(stream));
+        groupTriangles += groups.back().totalTriangles;
+    }
+    if (groupTriangles != totalTriangles)
+        throw CModelIOException("Triangle groups don't match the number of triangles");
+
+    ReadBinaryPadding(stream);
+
+    std::vector<VertexTex2> vertices(3 * static_cast<std::size_t>(totalTriangles));
+    ReadBinaryVertices(stream, vertices);
+
+    std::vector<ModelTriangle> triangles;
+    triangles.reserve(totalTriangles);
+
+    const VertexTex2* vertex = vertices.data();
+    for (const ModelTriangleGroupV3& group : groups)
+    {
+        ModelTriangle triangle;
+        triangle.diffuse = group.diffuse;
+        triangle.ambient = group.ambient;
+        triangle.specular = group.specular;
+        triangle.tex1Name = group.tex1Name;
+        triangle.tex2Name = group.tex2Name;
+        triangle.variableTex2 = group.variableTex2;
+        triangle.doubleSided = group.doubleSided;
+        triangle.transparentMode = group.transparentMode;
+        triangle.specialMark = group.specialMark;
+
+        for (int i = 0; i < group.totalTriangles; ++i)
+        {
+            triangle.p1 = *vertex++;
+            triangle.p2 = *vertex++;
+            triangle.p3 = *vertex++;
+            triangles.push_back(triangle);
+        }
+    }
+
+    return triangles;
+}
+
+ModelTriangleGroupV3 ModelInput::ReadBinaryTriangleGroup(std::istream &stream)
+{
+    ModelTriangleGroupV3 group;
+
+    group.diffuse = ReadBinaryColor(stream);
+    group.ambient = ReadBinaryColor(stream);
+    group.specular = ReadBinaryColor(stream);
+    group.tex1Name = ReadBinaryString<1>(stream);
+    group.tex2Name = ReadBinaryString<1>(stream);
+    group.variableTex2 = ReadBinaryBool(stream);
+    group.doubleSided = ReadBinaryBool(stream);
+
+    int transparentMode = ReadBinary<1, int>(stream);
+    if (transparentMode > static_cast<int>(ModelTransparentMode::MapWhiteToAlpha))
+        throw CModelIOException("Invalid transparent mode");
+    group.transparentMode = static_cast<ModelTransparentMode>(transparentMode);
+
+    int specialMark = ReadBinary<1, int>(stream);
+    if (specialMark > static_cast<int>(ModelSpecialMark::Part3))
+        throw CModelIOException("Invalid special mark");
+    group.specialMark = static_cast<ModelSpecialMark>(specialMark);
+
+    group.totalTriangles = ReadBinary<4, int>(stream);
+    if (group.totalTriangles < 0)
+        throw CModelIOException("Invalid number of triangles in group");
+
+    return group;
+}
+
+void ModelInput::ReadBinaryPadding(std::istream &stream)
+{
+    std::streamoff position = stream.tellg();
+    if (position < 0)
+        throw CModelIOException("Binary models can only be read from seekable streams");
+
+    int padding = (MODEL_BINARY_V3_ALIGNMENT - position % MODEL_BINARY_V3_ALIGNMENT) % MODEL_BINARY_V3_ALIGNMENT;
+    stream.ignore(padding);
+}
+
+void ModelInput::ReadBinaryVertices(std::istream &stream, std::vector<VertexTex2>& vertices)
+{
+    static_assert(sizeof(VertexTex2) == 10 * sizeof(float), "VertexTex2 must be laid out as in binary model files");
+
+    if (IsLittleEndian())
+    {
+        // The array is stored exactly as in memory
+        stream.read(reinterpret_cast<char*>(vertices.data()), vertices.size() * sizeof(VertexTex2));
+        return;
+    }
+
+    for (VertexTex2& vertex : vertices)
+        vertex = ReadBinaryVertexTex2(stream);
 }
 
 void ModelInput::ReadTextModel(CModel &model, std::istream &stream)
@@ -234,7 +485,7 @@ void ModelInput::ReadTextModelV1AndV2(CModel &model, std::istream &stream)
         throw CModelIOException(std::string("Error reading model header: ") + e.what());
     }
 
-    CModelMesh mesh;
+    LodTriangles triangles;
 
     for (int i = 0; i < header.totalTriangles; ++i)
     {
@@ -260,10 +511,6 @@ void ModelInput::ReadTextModelV1AndV2(CModel &model, std::istream &stream)
 
         t.state = boost::lexical_cast<int>(ReadLineString(stream, "state"));
 
-        if (t.lodLevel == ModelLODLevel::Low ||
-            t.lodLevel == ModelLODLevel::Medium)
-            continue;
-
         ModelTriangle triangle;
         triangle.p1 = t.p1;
         triangle.p2 = t.p2;
@@ -276,9 +523,12 @@ void ModelInput::ReadTextModelV1AndV2(CModel &model, std::istream &stream)
         triangle.variableTex2 = t.variableTex2;
         ConvertFromOldRenderState(triangle, t.state);
 
-        mesh.AddTriangle(triangle);
+        AddLodTriangle(triangles, t.lodLevel, triangle);
     }
 
+    CModelMesh mesh;
+    SetMeshTriangles(mesh, triangles);
+
     model.AddMesh("main", std::move(mesh));
 }
 
@@ -391,7 +641,7 @@ void ModelInput::ReadOldModel(CModel &model, std::istream &stream)
         throw CModelIOException(std::string("Error reading model file header: ") + e.what());
     }
 
-    std::vector<ModelTriangle> triangles;
+    LodTriangles triangles;
 
     try
     {
@@ -414,14 +664,14 @@ void ModelInput::ReadOldModel(CModel &model, std::istream &stream)
     }
 
     CModelMesh mesh;
-    mesh.SetTriangles(std::move(triangles));
+    SetMeshTriangles(mesh, triangles);
 
     model.AddMesh("main", std::move(mesh));
 }
 
-std::vector<ModelTriangle> ModelInput::ReadOldModelV1(std::istream &stream, int totalTriangles)
+ModelInput::LodTriangles ModelInput::ReadOldModelV1(std::istream &stream, int totalTriangles)
 {
-    std::vector<ModelTriangle> triangles;
+    LodTriangles triangles;
 
     for (int i = 0; i < totalTriangles; ++i)
     {
@@ -440,11 +690,6 @@ std::vector<ModelTriangle> ModelInput::ReadOldModelV1(std::istream &stream, int
         t.min = ReadBinaryFloat(stream);
         t.max = ReadBinaryFloat(stream);
 
-        ModelLODLevel lodLevel = MinMaxToLodLevel(t.min, t.max);
-        if (lodLevel == ModelLODLevel::Low ||
-            lodLevel == ModelLODLevel::Medium)
-            continue;
-
         ModelTriangle triangle;
         triangle.p1.FromVertex(t.p1);
         triangle.p2.FromVertex(t.p2);
@@ -455,15 +700,15 @@ std::vector<ModelTriangle> ModelInput::ReadOldModelV1(std::istream &stream, int
         triangle.specular = t.material.specular;
         ConvertOldTex1Name(triangle, t.texName);
 
-        triangles.push_back(triangle);
+        AddLodTriangle(triangles, MinMaxToLodLevel(t.min, t.max), triangle);
     }
 
     return triangles;
 }
 
-std::vector<ModelTriangle> ModelInput::ReadOldModelV2(std::istream &stream, int totalTriangles)
+ModelInput::LodTriangles ModelInput::ReadOldModelV2(std::istream &stream, int totalTriangles)
 {
-    std::vector<ModelTriangle> triangles;
+    LodTriangles triangles;
 
     for (int i = 0; i < totalTriangles; ++i)
     {
@@ -488,11 +733,6 @@ std::vector<ModelTriangle> ModelInput::ReadOldModelV2(std::istream &stream, int
         t.reserved3 = ReadBinary<2, short>(stream);
         t.reserved4 = ReadBinary<2, short>(stream);
 
-        ModelLODLevel lodLevel = MinMaxToLodLevel(t.min, t.max);
-        if (lodLevel == ModelLODLevel::Low ||
-            lodLevel == ModelLODLevel::Medium)
-            continue;
-
         ModelTriangle triangle;
         triangle.p1.FromVertex(t.p1);
         triangle.p2.FromVertex(t.p2);
@@ -505,15 +745,15 @@ std::vector<ModelTriangle> ModelInput::ReadOldModelV2(std::istream &stream, int
 
         ConvertFromOldRenderState(triangle, t.state);
 
-        triangles.push_back(triangle);
+        AddLodTriangle(triangles, MinMaxToLodLevel(t.min, t.max), triangle);
     }
 
     return triangles;
 }
 
-std::vector<ModelTriangle> ModelInput::ReadOldModelV3(std::istream &stream, int totalTriangles)
+ModelInput::LodTriangles ModelInput::ReadOldModelV3(std::istream &stream, int totalTriangles)
 {
-    std::vector<ModelTriangle> triangles;
+    LodTriangles triangles;
 
     for (int i = 0; i < totalTriangles; ++i)
     {
@@ -538,11 +778,6 @@ std::vector<ModelTriangle> ModelInput::ReadOldModelV3(std::istream &stream, int
         t.reserved3 = ReadBinary<2, short>(stream);
         t.reserved4 = ReadBinary<2, short>(stream);
 
-        ModelLODLevel lodLevel = MinMaxToLodLevel(t.min, t.max);
-        if (lodLevel == ModelLODLevel::Low ||
-            lodLevel == ModelLODLevel::Medium)
-            continue;
-
         ModelTriangle triangle;
         triangle.p1 = t.p1;
         triangle.p2 = t.p2;
@@ -563,7 +798,7 @@ std::vector<ModelTriangle> ModelInput::ReadOldModelV3(std::istream &stream, int
             triangle.tex2Name = tex2Name;
         }
 
-        triangles.push_back(triangle);
+        AddLodTriangle(triangles, MinMaxToLodLevel(t.min, t.max), triangle);
     }
 
     return triangles;
@@ -583,6 +818,45 @@ ModelLODLevel ModelInput::MinMaxToLodLevel(float min, float max)
     return ModelLODLevel::Constant;
 }
 
+void ModelInput::AddLodTriangle(LodTriangles& triangles, ModelLODLevel lodLevel, const ModelTriangle& triangle)
+{
+    switch (lodLevel)
+    {
+        case ModelLODLevel::High:
+            triangles.full.push_back(triangle);
+            break;
+
+        case ModelLODLevel::Medium:
+            triangles.reduced[0].push_back(triangle);
+            triangles.hasReduced[0] = true;
+            break;
+
+        case ModelLODLevel::Low:
+            triangles.reduced[1].push_back(triangle);
+            triangles.hasReduced[1] = true;
+            break;
+
+        case ModelLODLevel::Constant:
+        default:
+            triangles.full.push_back(triangle);
+            for (int i = 0; i < MODEL_MESH_LOD_COUNT; ++i)
+                triangles.reduced[i].push_back(triangle);
+            break;
+    }
+}
+
+void ModelInput::SetMeshTriangles(CModelMesh& mesh, LodTriangles& triangles)
+{
+    mesh.SetTriangles(std::move(triangles.full));
+
+    // A level made only of the constant triangles would lose the detailed parts entirely
+    for (int i = 0; i < MODEL_MESH_LOD_COUNT; ++i)
+    {
+        if (triangles.hasReduced[i])
+            mesh.SetLodTriangles(i, std::move(triangles.reduced[i]));
+    }
+}
+
 void ModelInput::ConvertOldTex1Name(ModelTriangle& triangle, const char* tex1Name)
 {
     triangle.tex1Name = tex1Name;
@@ -652,6 +926,29 @@ VertexTex2 ModelInput::ReadBinaryVertexTex2(std::istream& stream)
     return vertex;
 }
 
+Math::Vector ModelInput::ReadBinaryVector(std::istream& stream)
+{
+    Math::Vector vector;
+
+    vector.x = ReadBinaryFloat(stream);
+    vector.y = ReadBinaryFloat(stream);
+    vector.z = ReadBinaryFloat(stream);
+
+    return vector;
+}
+
+Color ModelInput::ReadBinaryColor(std::istream& stream)
+{
+    Color color;
+
+    color.r = ReadBinaryFloat(stream);
+    color.g = ReadBinaryFloat(stream);
+    color.b = ReadBinaryFloat(stream);
+    color.a = ReadBinaryFloat(stream);
+
+    return color;
+}
+
 Material ModelInput::ReadBinaryMaterial(std::istream& stream)
 {
     Material material;
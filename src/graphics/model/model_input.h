@@ -22,6 +22,7 @@
 #include "graphics/model/model.h"
 #include "graphics/model/model_format.h"
 
+#include <cstddef>
 #include <istream>
 
 namespace Gfx
@@ -38,6 +39,11 @@ namespace ModelInput
      * @throws CModelIOException on read/write error
      */
     CModel Read(std::istream &stream, ModelFormat format);
+    //! Reads model in given \a format from \a size bytes of \a data in memory, without copying them
+    /**
+     * @throws CModelIOException on read/write error
+     */
+    CModel Read(const char* data, std::size_t size, ModelFormat format);
 }
 
 } // namespace Gfx
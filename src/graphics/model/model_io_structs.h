@@ -149,6 +149,43 @@ struct ModelMeshHeaderV3
  */
 struct ModelTriangleV3 : ModelTriangle {};
 
+//! Alignment of vertex arrays in binary model file version 3
+const int MODEL_BINARY_V3_ALIGNMENT = 16;
+
+/**
+ * \struct ModelTriangleGroupV3
+ * \brief Run of consecutive triangles sharing everything but vertices, in binary model file version 3
+ *
+ * The binary format stores each list of triangles of a mesh (full detail,
+ * then reduced levels of detail) as a count of groups and triangles, the groups,
+ * padding to MODEL_BINARY_V3_ALIGNMENT bytes from the start of the file
+ * and an array of 3 vertices per triangle, each vertex as 10 floats
+ * in the same layout as VertexTex2, so that the array can be read in one go.
+ */
+struct ModelTriangleGroupV3
+{
+    //! Diffuse color
+    Color diffuse;
+    //! Ambient color
+    Color ambient;
+    //! Specular color
+    Color specular;
+    //! Name of 1st texture
+    std::string tex1Name;
+    //! Name of 2nd texture
+    std::string tex2Name;
+    //! If true, 2nd texture will be taken from current engine setting
+    bool variableTex2 = false;
+    //! Whether to render as double-sided surface
+    bool doubleSided = false;
+    //! How to deal with texture transparency
+    ModelTransparentMode transparentMode = ModelTransparentMode::None;
+    //! Special marking
+    ModelSpecialMark specialMark = ModelSpecialMark::None;
+    //! Number of triangles in group
+    int totalTriangles = 0;
+};
+
 
 
 /*******************************************************
@@ -21,7 +21,7 @@
 
 #include "common/logger.h"
 
-#include "common/resources/inputstream.h"
+#include "common/resources/resourcemanager.h"
 
 #include "graphics/model/model_input.h"
 #include "graphics/model/model_io_exception.h"
@@ -35,16 +35,22 @@ CModel& CModelManager::GetModel(const std::string& modelName)
     if (it != m_models.end())
         return it->second;
 
-    std::string modelFile = "models-new/" + modelName + ".txt";
+    // Converted binary models are preferred, as they load much faster
+    std::string modelFile = GetBinaryModelPath("models-new/" + modelName + ".txt");
+    ModelFormat format = ModelFormat::Binary;
+    if (modelFile.empty())
+    {
+        modelFile = "models-new/" + modelName + ".txt";
+        format = ModelFormat::Text;
+    }
 
     GetLogger()->Debug("Loading new model: %s\n", modelFile.c_str());
 
-    CInputStream stream;
-    stream.open(modelFile.c_str());
-    if (!stream.is_open())
+    auto file = CResourceManager::GetFileView(modelFile);
+    if (!file->IsOpen())
         throw CModelIOException(std::string("Could not open file '") + modelName + "'");
 
-    CModel model = ModelInput::Read(stream, ModelFormat::Text);
+    CModel model = ModelInput::Read(file->GetData(), file->GetSize(), format);
     m_models[modelName] = model;
 
     return m_models[modelName];
@@ -55,4 +61,22 @@ void CModelManager::ClearCache()
     m_models.clear();
 }
 
+std::string CModelManager::GetBinaryModelPath(const std::string& path)
+{
+    std::string binaryPath = path.substr(0, path.find_last_of('.')) + ".bin";
+    if (binaryPath == path || !CResourceManager::Exists(binaryPath))
+        return "";
+
+    if (!CResourceManager::Exists(path))
+        return binaryPath;
+
+    if (CResourceManager::GetLocation(binaryPath) != CResourceManager::GetLocation(path))
+        return "";
+
+    if (CResourceManager::GetLastModificationTime(binaryPath) < CResourceManager::GetLastModificationTime(path))
+        return "";
+
+    return binaryPath;
+}
+
 } // namespace Gfx
@@ -41,6 +41,14 @@ public:
     //! Clears cached models
     void ClearCache();
 
+    //! Returns the path of the converted binary model to read instead of the model at \a path, or empty string
+    /**
+     * The binary model is used if it is in the same location as the model and not older,
+     * so that a model changed or replaced by a mod is not shadowed by an old conversion.
+     * If there is no model at \a path, any binary model is used.
+     */
+    static std::string GetBinaryModelPath(const std::string& path);
+
 private:
     std::unordered_map<std::string, CModel> m_models;
 };
@@ -19,6 +19,8 @@
 
 #include "graphics/model/model_mesh.h"
 
+#include <cassert>
+
 namespace Gfx
 {
 
@@ -42,6 +44,18 @@ int CModelMesh::GetTriangleCount() const
     return m_triangles.size();
 }
 
+void CModelMesh::SetLodTriangles(int lodLevel, std::vector<ModelTriangle>&& triangles)
+{
+    assert(lodLevel >= 0 && lodLevel < MODEL_MESH_LOD_COUNT);
+    m_lodTriangles[lodLevel] = triangles;
+}
+
+const std::vector<ModelTriangle>& CModelMesh::GetLodTriangles(int lodLevel) const
+{
+    assert(lodLevel >= 0 && lodLevel < MODEL_MESH_LOD_COUNT);
+    return m_lodTriangles[lodLevel];
+}
+
 const Math::Vector& CModelMesh::GetPosition() const
 {
     return m_position;
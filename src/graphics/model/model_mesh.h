@@ -28,6 +28,9 @@
 namespace Gfx
 {
 
+//! Number of reduced levels of detail a mesh can carry
+const int MODEL_MESH_LOD_COUNT = 2;
+
 /**
  * \class CModelMesh
  * \brief Mesh data saved in model file
@@ -44,6 +47,11 @@ public:
     //! Returns number of triangles
     int GetTriangleCount() const;
 
+    //! Sets the triangles of a reduced level of detail (0 = medium, 1 = low)
+    void SetLodTriangles(int lodLevel, std::vector<ModelTriangle> &&triangles);
+    //! Returns the triangles of a reduced level of detail, empty if the mesh has no such level
+    const std::vector<ModelTriangle>& GetLodTriangles(int lodLevel) const;
+
     //! Returns the mesh position
     const Math::Vector& GetPosition() const;
     //! Sets the mesh rotation
@@ -66,6 +74,7 @@ public:
 
 private:
     std::vector<ModelTriangle> m_triangles;
+    std::vector<ModelTriangle> m_lodTriangles[MODEL_MESH_LOD_COUNT];
     Math::Vector m_position;
     Math::Vector m_rotation;
     Math::Vector m_scale;
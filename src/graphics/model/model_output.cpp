@@ -44,6 +44,11 @@ namespace ModelOutput
     std::string SpecialMarkToString(ModelSpecialMark specialMark);
 
     void WriteBinaryModel(const CModel& model, std::ostream &stream);
+    void WriteBinaryMesh(const CModelMesh* mesh, const std::string& meshName, std::ostream &stream);
+    void WriteBinaryTriangles(const std::vector<ModelTriangle>& triangles, std::ostream &stream);
+    void WriteBinaryTriangleGroup(const ModelTriangleGroupV3& group, std::ostream &stream);
+    bool IsInTriangleGroup(const ModelTriangle& triangle, const ModelTriangleGroupV3& group);
+    void WriteBinaryPadding(std::ostream &stream);
 
     void WriteOldModel(const CModel& model, std::ostream &stream);
 
@@ -51,6 +56,8 @@ namespace ModelOutput
 
     void WriteBinaryVertexTex2(VertexTex2 vertex, std::ostream &stream);
     void WriteBinaryMaterial(const Material& material, std::ostream &stream);
+    void WriteBinaryVector(const Math::Vector& vector, std::ostream &stream);
+    void WriteBinaryColor(const Color& color, std::ostream &stream);
 
     void WriteTextVertexTex2(const VertexTex2& vertex, std::ostream &stream);
     void WriteTextMaterial(const Material& material, std::ostream &stream);
@@ -260,44 +267,140 @@ std::string ModelOutput::SpecialMarkToString(ModelSpecialMark specialMark)
 
 void ModelOutput::WriteBinaryModel(const CModel& model, std::ostream &stream)
 {
-    const CModelMesh* mesh = model.GetMesh("main");
-    if (mesh == nullptr)
-        throw CModelIOException("No main mesh found in model");
+    ModelHeaderV3 header;
+    header.version = 3;
+    header.totalCrashSpheres = model.GetCrashSphereCount();
+    header.hasShadowSpot = model.HasShadowSpot();
+    header.hasCameraCollisionSphere = model.HasCameraCollisionSphere();
+    header.totalMeshes = model.GetMeshCount();
 
-    ModelHeaderV1AndV2 header;
+    WriteBinary<4, int>(header.version, stream);
+    WriteBinary<4, int>(header.totalCrashSpheres, stream);
+    WriteBinaryBool(header.hasShadowSpot, stream);
+    WriteBinaryBool(header.hasCameraCollisionSphere, stream);
+    /* padding */ WriteBinary<2, int>(0, stream);
+    WriteBinary<4, int>(header.totalMeshes, stream);
 
-    header.version = 2;
-    header.totalTriangles = mesh->GetTriangleCount();
+    for (const auto& crashSphere : model.GetCrashSpheres())
+    {
+        WriteBinaryVector(crashSphere.position, stream);
+        WriteBinaryFloat(crashSphere.radius, stream);
+        WriteBinaryFloat(crashSphere.hardness, stream);
+        WriteBinaryString<1>(crashSphere.sound, stream);
+    }
 
-    WriteBinary<4, int>(header.version, stream);
-    WriteBinary<4, int>(header.totalTriangles, stream);
+    if (model.HasShadowSpot())
+    {
+        WriteBinaryFloat(model.GetShadowSpot().radius, stream);
+        WriteBinaryFloat(model.GetShadowSpot().intensity, stream);
+    }
 
-    for (const ModelTriangle& triangle : mesh->GetTriangles())
+    if (model.HasCameraCollisionSphere())
     {
-        ModelTriangleV1AndV2 t;
+        WriteBinaryVector(model.GetCameraCollisionSphere().pos, stream);
+        WriteBinaryFloat(model.GetCameraCollisionSphere().radius, stream);
+    }
 
-        t.p1 = triangle.p1;
-        t.p2 = triangle.p2;
-        t.p3 = triangle.p3;
-        t.material.ambient = triangle.ambient;
-        t.material.diffuse = triangle.diffuse;
-        t.material.specular = triangle.specular;
-        t.tex1Name = triangle.tex1Name;
-        t.tex2Name = triangle.tex2Name;
-        t.variableTex2 = triangle.variableTex2;
-        t.state = ConvertToOldState(triangle);
+    for (const std::string& meshName : model.GetMeshNames())
+    {
+        const CModelMesh* mesh = model.GetMesh(meshName);
+        assert(mesh != nullptr);
+        WriteBinaryMesh(mesh, meshName, stream);
+    }
+}
 
-        WriteBinaryVertexTex2(t.p1, stream);
-        WriteBinaryVertexTex2(t.p2, stream);
-        WriteBinaryVertexTex2(t.p3, stream);
-        WriteBinaryMaterial(t.material, stream);
-        WriteBinaryString<1>(t.tex1Name, stream);
-        WriteBinaryString<1>(t.tex2Name, stream);
-        WriteBinaryBool(t.variableTex2, stream);
-        WriteBinary<4, int>(t.state, stream);
+void ModelOutput::WriteBinaryMesh(const CModelMesh* mesh, const std::string& meshName, std::ostream &stream)
+{
+    WriteBinaryString<1>(meshName, stream);
+    WriteBinaryString<1>(mesh->GetParent(), stream);
+    WriteBinaryVector(mesh->GetPosition(), stream);
+    WriteBinaryVector(mesh->GetRotation(), stream);
+    WriteBinaryVector(mesh->GetScale(), stream);
+
+    WriteBinaryTriangles(mesh->GetTriangles(), stream);
+    for (int i = 0; i < MODEL_MESH_LOD_COUNT; ++i)
+        WriteBinaryTriangles(mesh->GetLodTriangles(i), stream);
+}
+
+void ModelOutput::WriteBinaryTriangles(const std::vector<ModelTriangle>& triangles, std::ostream &stream)
+{
+    std::vector<ModelTriangleGroupV3> groups;
+    for (const ModelTriangle& triangle : triangles)
+    {
+        if (!groups.empty() && IsInTriangleGroup(triangle, groups.back()))
+        {
+            ++groups.back().totalTriangles;
+            continue;
+        }
+
+        ModelTriangleGroupV3 group;
+        group.diffuse = triangle.diffuse;
+        group.ambient = triangle.ambient;
+        group.specular = triangle.specular;
+        group.tex1Name = triangle.tex1Name;
+        group.tex2Name = triangle.tex2Name;
+        group.variableTex2 = triangle.variableTex2;
+        group.doubleSided = triangle.doubleSided;
+        group.transparentMode = triangle.transparentMode;
+        group.specialMark = triangle.specialMark;
+        group.totalTriangles = 1;
+        groups.push_back(group);
+    }
+
+    WriteBinary<4, int>(groups.size(), stream);
+    WriteBinary<4, int>(triangles.size(), stream);
+
+    for (const ModelTriangleGroupV3& group : groups)
+        WriteBinaryTriangleGroup(group, stream);
+
+    WriteBinaryPadding(stream);
+
+    for (const ModelTriangle& triangle : triangles)
+    {
+        WriteBinaryVertexTex2(triangle.p1, stream);
+        WriteBinaryVertexTex2(triangle.p2, stream);
+        WriteBinaryVertexTex2(triangle.p3, stream);
     }
 }
 
+void ModelOutput::WriteBinaryTriangleGroup(const ModelTriangleGroupV3& group, std::ostream &stream)
+{
+    WriteBinaryColor(group.diffuse, stream);
+    WriteBinaryColor(group.ambient, stream);
+    WriteBinaryColor(group.specular, stream);
+    WriteBinaryString<1>(group.tex1Name, stream);
+    WriteBinaryString<1>(group.tex2Name, stream);
+    WriteBinaryBool(group.variableTex2, stream);
+    WriteBinaryBool(group.doubleSided, stream);
+    WriteBinary<1, int>(static_cast<int>(group.transparentMode), stream);
+    WriteBinary<1, int>(static_cast<int>(group.specialMark), stream);
+    WriteBinary<4, int>(group.totalTriangles, stream);
+}
+
+bool ModelOutput::IsInTriangleGroup(const ModelTriangle& triangle, const ModelTriangleGroupV3& group)
+{
+    return triangle.diffuse == group.diffuse &&
+           triangle.ambient == group.ambient &&
+           triangle.specular == group.specular &&
+           triangle.tex1Name == group.tex1Name &&
+           triangle.tex2Name == group.tex2Name &&
+           triangle.variableTex2 == group.variableTex2 &&
+           triangle.doubleSided == group.doubleSided &&
+           triangle.transparentMode == group.transparentMode &&
+           triangle.specialMark == group.specialMark;
+}
+
+void ModelOutput::WriteBinaryPadding(std::ostream &stream)
+{
+    std::streamoff position = stream.tellp();
+    if (position < 0)
+        throw CModelIOException("Binary models can only be written to seekable streams");
+
+    int padding = (MODEL_BINARY_V3_ALIGNMENT - position % MODEL_BINARY_V3_ALIGNMENT) % MODEL_BINARY_V3_ALIGNMENT;
+    for (int i = 0; i < padding; ++i)
+        stream.put(0);
+}
+
 void ModelOutput::WriteOldModel(const CModel& model, std::ostream &stream)
 {
     const CModelMesh* mesh = model.GetMesh("main");
@@ -452,6 +555,21 @@ void ModelOutput::WriteBinaryMaterial(const Material& material, std::ostream &st
     /* power */       WriteBinaryFloat(0.0f, stream);
 }
 
+void ModelOutput::WriteBinaryVector(const Math::Vector& vector, std::ostream &stream)
+{
+    WriteBinaryFloat(vector.x, stream);
+    WriteBinaryFloat(vector.y, stream);
+    WriteBinaryFloat(vector.z, stream);
+}
+
+void ModelOutput::WriteBinaryColor(const Color& color, std::ostream &stream)
+{
+    WriteBinaryFloat(color.r, stream);
+    WriteBinaryFloat(color.g, stream);
+    WriteBinaryFloat(color.b, stream);
+    WriteBinaryFloat(color.a, stream);
+}
+
 void ModelOutput::WriteTextVertexTex2(const VertexTex2& vertex, std::ostream &stream)
 {
     stream << "c " << vertex.coord.x << " " << vertex.coord.y << " " << vertex.coord.z;
@@ -753,7 +753,8 @@ Texture CGL14Device::CreateTexture(ImageData *data, const TextureCreateParams &p
     {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipmapLevel - 1);
-        glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
+        // Precomputed mipmaps are uploaded after the base level
+        glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, data->mipmaps.empty() ? GL_TRUE : GL_FALSE);
     }
     else
     {
@@ -780,6 +781,9 @@ Texture CGL14Device::CreateTexture(ImageData *data, const TextureCreateParams &p
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, texData.actualSurface->w, texData.actualSurface->h,
                  0, texData.sourceFormat, GL_UNSIGNED_BYTE, texData.actualSurface->pixels);
 
+    if (params.mipmap)
+        UploadTextureMipmaps(data, params.format, mipmapLevel - 1);
+
     SDL_FreeSurface(texData.convertedSurface);
 
     m_allTextures.insert(result);
@@ -1505,6 +1509,16 @@ void CGL14Device::DrawStaticBuffer(unsigned int bufferId)
     glDrawArrays(mode, 0, (*it).second.vertexCount);
 }
 
+void CGL14Device::DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* worldMatrices, int instanceCount)
+{
+    // No instancing support, draw each instance with its own world transform
+    for (int i = 0; i < instanceCount; i++)
+    {
+        SetTransform(TRANSFORM_WORLD, worldMatrices[i]);
+        DrawStaticBuffer(bufferId);
+    }
+}
+
 void CGL14Device::DestroyStaticBuffer(unsigned int bufferId)
 {
     auto it = m_vboObjects.find(bufferId);
@@ -140,6 +140,7 @@ public:
         UpdateStaticBufferImpl(bufferId, primitiveType, vertices, vertexCount);
     }
     void DrawStaticBuffer(unsigned int bufferId) override;
+    void DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* worldMatrices, int instanceCount) override;
     void DestroyStaticBuffer(unsigned int bufferId) override;
 
     int ComputeSphereVisibility(const Math::Vector &center, float radius) override;
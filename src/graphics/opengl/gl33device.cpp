@@ -364,6 +364,7 @@ bool CGL33Device::Create()
         uni.normalMatrix = glGetUniformLocation(m_normalProgram, "uni_NormalMatrix");
         uni.shadowMatrix = glGetUniformLocation(m_normalProgram, "uni_ShadowMatrix");
         uni.cameraPosition = glGetUniformLocation(m_normalProgram, "uni_CameraPosition");
+        uni.instanced = glGetUniformLocation(m_normalProgram, "uni_Instanced");
 
         uni.primaryTexture = glGetUniformLocation(m_normalProgram, "uni_PrimaryTexture");
         uni.secondaryTexture = glGetUniformLocation(m_normalProgram, "uni_SecondaryTexture");
@@ -422,6 +423,7 @@ bool CGL33Device::Create()
         glUniformMatrix4fv(uni.normalMatrix, 1, GL_FALSE, matrix.Array());
         glUniformMatrix4fv(uni.shadowMatrix, 1, GL_FALSE, matrix.Array());
         glUniform3f(uni.cameraPosition, 0.0f, 0.0f, 0.0f);
+        glUniform1i(uni.instanced, 0);
 
         glUniform1i(uni.primaryTexture, 0);
         glUniform1i(uni.secondaryTexture, 1);
@@ -485,6 +487,7 @@ bool CGL33Device::Create()
         uni.projectionMatrix = glGetUniformLocation(m_shadowProgram, "uni_ProjectionMatrix");
         uni.viewMatrix = glGetUniformLocation(m_shadowProgram, "uni_ViewMatrix");
         uni.modelMatrix = glGetUniformLocation(m_shadowProgram, "uni_ModelMatrix");
+        uni.instanced = glGetUniformLocation(m_shadowProgram, "uni_Instanced");
 
         uni.primaryTexture = glGetUniformLocation(m_shadowProgram, "uni_Texture");
 
@@ -509,6 +512,8 @@ bool CGL33Device::Create()
 
         glUniform1i(uni.alphaTestEnabled, 0);
         glUniform1f(uni.alphaReference, 1.0f);
+
+        glUniform1i(uni.instanced, 0);
     }
 
     SetRenderMode(RENDER_MODE_NORMAL);
@@ -562,6 +567,12 @@ void CGL33Device::Destroy()
     glDeleteVertexArrays(1, &m_dynamicBuffer.vao);
     glDeleteBuffers(1, &m_dynamicBuffer.vbo);
 
+    if (m_instanceBuffer != 0)
+    {
+        glDeleteBuffers(1, &m_instanceBuffer);
+        m_instanceBuffer = 0;
+    }
+
     m_vboMemory -= m_dynamicBuffer.size;
 
     m_lights.clear();
@@ -820,7 +831,7 @@ Texture CGL33Device::CreateTexture(ImageData *data, const TextureCreateParams &p
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, texData.actualSurface->w, texData.actualSurface->h,
                  0, texData.sourceFormat, GL_UNSIGNED_BYTE, texData.actualSurface->pixels);
 
-    if (params.mipmap)
+    if (params.mipmap && !UploadTextureMipmaps(data, params.format, mipmapLevel - 1))
         glGenerateMipmap(GL_TEXTURE_2D);
 
     SDL_FreeSurface(texData.convertedSurface);
@@ -1487,6 +1498,62 @@ void CGL33Device::DrawStaticBuffer(unsigned int bufferId)
     glDrawArrays(mode, 0, info.vertexCount);
 }
 
+void CGL33Device::DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* worldMatrices, int instanceCount)
+{
+    if (instanceCount <= 0)
+        return;
+
+    // Interface program has no instancing support
+    if (m_uni->instanced < 0)
+    {
+        for (int i = 0; i < instanceCount; i++)
+        {
+            SetTransform(TRANSFORM_WORLD, worldMatrices[i]);
+            DrawStaticBuffer(bufferId);
+        }
+        return;
+    }
+
+    if (m_updateLights) UpdateLights();
+
+    auto it = m_vboObjects.find(bufferId);
+    if (it == m_vboObjects.end())
+        return;
+
+    VertexBufferInfo &info = (*it).second;
+
+    BindVAO(info.vao);
+
+    if (m_instanceBuffer == 0)
+        glGenBuffers(1, &m_instanceBuffer);
+
+    BindVBO(m_instanceBuffer);
+
+    // Orphan the previous contents, the buffer may still be in use by earlier draws
+    GLsizeiptr size = instanceCount * sizeof(Math::Matrix);
+    glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size, worldMatrices);
+
+    // World matrix, one column per attribute
+    for (int i = 0; i < 4; i++)
+    {
+        glEnableVertexAttribArray(5 + i);
+        glVertexAttribPointer(5 + i, 4, GL_FLOAT, GL_FALSE, sizeof(Math::Matrix),
+            reinterpret_cast<void*>(i * 4 * sizeof(float)));
+        glVertexAttribDivisor(5 + i, 1);
+    }
+
+    glUniform1i(m_uni->instanced, 1);
+
+    GLenum mode = TranslateGfxPrimitive(info.primitiveType);
+    glDrawArraysInstanced(mode, 0, info.vertexCount, instanceCount);
+
+    glUniform1i(m_uni->instanced, 0);
+
+    for (int i = 0; i < 4; i++)
+        glDisableVertexAttribArray(5 + i);
+}
+
 void CGL33Device::DestroyStaticBuffer(unsigned int bufferId)
 {
     auto it = m_vboObjects.find(bufferId);
@@ -155,6 +155,7 @@ public:
         UpdateStaticBufferImpl(bufferId, primitiveType, vertices, vertexCount);
     }
     void DrawStaticBuffer(unsigned int bufferId) override;
+    void DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* worldMatrices, int instanceCount) override;
     void DestroyStaticBuffer(unsigned int bufferId) override;
 
     int ComputeSphereVisibility(const Math::Vector &center, float radius) override;
@@ -307,6 +308,8 @@ private:
     GLuint m_shadowProgram = 0;
 
     DynamicBuffer m_dynamicBuffer;
+    //! Buffer of per-instance world matrices for instanced drawing
+    GLuint m_instanceBuffer = 0;
 
     //! Current mode
     unsigned int m_mode = 0;
@@ -668,4 +668,29 @@ PreparedTextureData PrepareTextureData(ImageData* imageData, TexImgFormat format
     return texData;
 }
 
+bool UploadTextureMipmaps(ImageData* imageData, TexImgFormat format, int maxLevel)
+{
+    if (imageData->mipmaps.empty())
+        return false;
+
+    int levelCount = std::min(static_cast<int>(imageData->mipmaps.size()), maxLevel);
+    for (int level = 1; level <= levelCount; ++level)
+    {
+        ImageData levelData;
+        levelData.surface = imageData->mipmaps[level - 1];
+
+        PreparedTextureData texData = PrepareTextureData(&levelData, format);
+
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, texData.actualSurface->pitch / texData.actualSurface->format->BytesPerPixel);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, texData.actualSurface->w, texData.actualSurface->h,
+                     0, texData.sourceFormat, GL_UNSIGNED_BYTE, texData.actualSurface->pixels);
+
+        SDL_FreeSurface(texData.convertedSurface);
+    }
+
+    return true;
+}
+
 } // namespace Gfx
@@ -112,6 +112,10 @@ struct PreparedTextureData
 
 PreparedTextureData PrepareTextureData(ImageData* imageData, TexImgFormat format);
 
+//! Uploads the precomputed mipmaps of image data to the bound texture, up to given level
+/** Returns false if the image data has no precomputed mipmaps. */
+bool UploadTextureMipmaps(ImageData* imageData, TexImgFormat format, int maxLevel);
+
 class CGLFrameBufferPixels : public CFrameBufferPixels
 {
 public:
@@ -169,6 +173,8 @@ struct UniformLocations
     GLint normalMatrix = -1;
     //! Camera position
     GLint cameraPosition = -1;
+    //! true takes model matrix from per-instance attributes
+    GLint instanced = -1;
 
     //! Primary texture sampler
     GLint primaryTexture = -1;
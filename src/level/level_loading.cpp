@@ -0,0 +1,200 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "level/level_loading.h"
+
+#include "common/image.h"
+#include "common/logger.h"
+#include "common/make_unique.h"
+#include "common/stringutils.h"
+
+#include "common/resources/resourcemanager.h"
+
+#include "common/thread/worker_pool.h"
+
+#include "level/parser/parser.h"
+
+#include <algorithm>
+
+#include <SDL.h>
+
+namespace
+{
+
+long long MicrosecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // anonymous namespace
+
+CLevelLoadingJobs::CLevelLoadingJobs()
+{
+}
+
+CLevelLoadingJobs::~CLevelLoadingJobs()
+{
+    // Jobs still running use the members, the pool must be stopped first
+    m_pool.reset();
+}
+
+void CLevelLoadingJobs::Start(CLevelParser& levelParser, bool terrain, bool programs, bool soluce)
+{
+    // The main thread creates the scene in the meantime
+    int threadCount = std::max(1, SDL_GetCPUCount() - 1);
+    m_pool = MakeUnique<CWorkerPool>(threadCount, "Level loading");
+
+    for (auto& line : levelParser.GetLines())
+    {
+        std::string command = line->GetCommand();
+        if (terrain && (command == "TerrainRelief" || command == "TerrainResource"))
+        {
+            AddImage(line->GetParam("image")->AsPath("textures"));
+        }
+        else if (programs && command == "LevelController" && line->GetParam("script")->IsDefined())
+        {
+            AddFile(line->GetParam("script")->AsPath("ai"));
+        }
+        else if (programs && command == "CreateObject")
+        {
+            AddProgramFiles(line.get(), soluce);
+        }
+    }
+}
+
+void CLevelLoadingJobs::AddImage(const std::string& fileName)
+{
+    if (m_images.count(fileName) > 0)
+        return;
+
+    ImageJob& job = m_images[fileName];
+    job.image = MakeUnique<CImage>();
+
+    CImage* image = job.image.get();
+    bool* loaded = &job.loaded;
+    job.id = m_pool->Start([this, image, loaded, fileName]()
+    {
+        auto start = std::chrono::steady_clock::now();
+        *loaded = image->Load(fileName);
+        AddJobTime(m_imageTime, start);
+    });
+}
+
+void CLevelLoadingJobs::AddProgramFiles(CLevelParserLine* line, bool soluce)
+{
+    // Same parameters as CProgramStorageObjectImpl::LoadAllProgramsForLevel()
+    bool allFilled = true;
+    for (int i = 0; i < 10 || allFilled; i++)
+    {
+        std::string op = "script" + StrUtils::ToString<int>(i+1);
+        if (line->GetParam(op)->IsDefined())
+            AddFile(line->GetParam(op)->AsPath("ai"));
+        else
+            allFilled = false;
+    }
+
+    if (soluce && line->GetParam("soluce")->IsDefined())
+        AddFile(line->GetParam("soluce")->AsPath("ai"));
+}
+
+void CLevelLoadingJobs::AddFile(const std::string& fileName)
+{
+    if (!m_files.insert(fileName).second)
+        return;
+
+    // Reading puts the file in the resource cache, where the main thread finds it later
+    m_pool->Start([this, fileName]()
+    {
+        auto start = std::chrono::steady_clock::now();
+        CResourceManager::ReadCachedFile(fileName);
+        AddJobTime(m_fileTime, start);
+    });
+}
+
+void CLevelLoadingJobs::AddJobTime(long long& counter, std::chrono::steady_clock::time_point start)
+{
+    long long time = MicrosecondsSince(start);
+    m_mutex.Lock();
+    counter += time;
+    m_mutex.Unlock();
+}
+
+std::unique_ptr<CImage> CLevelLoadingJobs::TakeImage(const std::string& fileName)
+{
+    auto it = m_images.find(fileName);
+    if (it == m_images.end() || it->second.image == nullptr)
+        return nullptr;
+
+    m_pool->Wait(it->second.id);
+
+    if (!it->second.loaded)
+        return nullptr;
+
+    return std::move(it->second.image);
+}
+
+void CLevelLoadingJobs::Finish()
+{
+    if (m_pool == nullptr)
+        return;
+
+    m_pool->WaitAll();
+    m_pool.reset();
+
+    GetLogger()->Info("Level loading jobs: %d images decoded in %.2f ms, %d files read in %.2f ms\n",
+                      static_cast<int>(m_images.size()), m_imageTime / 1000.0f,
+                      static_cast<int>(m_files.size()), m_fileTime / 1000.0f);
+}
+
+
+void CLevelLoadingTimer::SetStage(const std::string& stage)
+{
+    if (stage == m_stage)
+        return;
+
+    auto now = std::chrono::steady_clock::now();
+
+    if (!m_stage.empty())
+    {
+        auto it = std::find_if(m_times.begin(), m_times.end(),
+                               [this](const std::pair<std::string, long long>& time) { return time.first == m_stage; });
+        if (it == m_times.end())
+        {
+            m_times.emplace_back(m_stage, 0);
+            it = m_times.end() - 1;
+        }
+        it->second += std::chrono::duration_cast<std::chrono::microseconds>(now - m_stageStart).count();
+    }
+
+    m_stage = stage;
+    m_stageStart = now;
+}
+
+void CLevelLoadingTimer::Log()
+{
+    SetStage("");
+
+    long long total = 0;
+    for (const auto& time : m_times)
+        total += time.second;
+
+    GetLogger()->Info("Level loaded in %.2f ms\n", total / 1000.0f);
+    for (const auto& time : m_times)
+        GetLogger()->Info("  %s: %.2f ms\n", time.first.c_str(), time.second / 1000.0f);
+}
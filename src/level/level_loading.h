@@ -0,0 +1,108 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file level/level_loading.h
+ * \brief Background jobs and stage timing of level loading
+ */
+
+#pragma once
+
+#include "common/thread/sdl_mutex_wrapper.h"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+class CImage;
+class CLevelParser;
+class CLevelParserLine;
+class CWorkerPool;
+
+/**
+ * \class CLevelLoadingJobs
+ * \brief Loads the assets of a level on worker threads while the scene is created
+ *
+ * The jobs are started from the parsed level file before its commands are executed.
+ * They only decode images and read files into the resource cache. Everything touching
+ * the engine, the terrain, the objects or CBot is still done on the main thread
+ * by CRobotMain::CreateScene(), which takes the decoded data when it needs it.
+ */
+class CLevelLoadingJobs
+{
+public:
+    CLevelLoadingJobs();
+    ~CLevelLoadingJobs();
+
+    //! Starts the jobs for the terrain images and/or the programs used by the level
+    void Start(CLevelParser& levelParser, bool terrain, bool programs, bool soluce);
+    //! Waits for the image decoded in background and takes it, returns nullptr if it wasn't decoded
+    std::unique_ptr<CImage> TakeImage(const std::string& fileName);
+    //! Waits for all jobs and writes the time they took to the log
+    void Finish();
+
+private:
+    struct ImageJob
+    {
+        int id = -1;
+        std::unique_ptr<CImage> image;
+        bool loaded = false;
+    };
+
+    void AddImage(const std::string& fileName);
+    void AddProgramFiles(CLevelParserLine* line, bool soluce);
+    void AddFile(const std::string& fileName);
+    //! Adds the time since start to the given counter
+    void AddJobTime(long long& counter, std::chrono::steady_clock::time_point start);
+
+    std::unique_ptr<CWorkerPool> m_pool;
+    std::map<std::string, ImageJob> m_images;
+    std::set<std::string> m_files;
+
+    CSDLMutexWrapper m_mutex;
+    //! Time spent decoding images, in microseconds
+    long long m_imageTime = 0;
+    //! Time spent reading files, in microseconds
+    long long m_fileTime = 0;
+};
+
+/**
+ * \class CLevelLoadingTimer
+ * \brief Measures the time spent in each stage of level loading
+ *
+ * The stages may be entered many times, the time is summed for each stage.
+ */
+class CLevelLoadingTimer
+{
+public:
+    //! Ends the current stage and continues timing the given one
+    void SetStage(const std::string& stage);
+    //! Ends the current stage and writes the time spent in each stage to the log
+    void Log();
+
+private:
+    //! Time spent in each stage, in microseconds, in the order the stages were entered
+    std::vector<std::pair<std::string, long long>> m_times;
+    std::string m_stage;
+    std::chrono::steady_clock::time_point m_stageStart;
+};
@@ -27,6 +27,7 @@
 
 #include "common/config_file.h"
 #include "common/event.h"
+#include "common/image.h"
 #include "common/logger.h"
 #include "common/make_unique.h"
 #include "common/restext.h"
@@ -37,6 +38,8 @@
 #include "common/resources/outputstream.h"
 #include "common/resources/resourcemanager.h"
 
+#include "graphics/core/recordingdevice.h"
+
 #include "graphics/engine/camera.h"
 #include "graphics/engine/cloud.h"
 #include "graphics/engine/engine.h"
@@ -52,6 +55,7 @@
 
 #include "graphics/model/model_manager.h"
 
+#include "level/level_loading.h"
 #include "level/mainmovie.h"
 #include "level/player_profile.h"
 #include "level/scene_conditions.h"
@@ -108,6 +112,7 @@
 #include "ui/screen/screen_loading.h"
 
 #include <algorithm>
+#include <fstream>
 #include <iomanip>
 #include <stdexcept>
 #include <ctime>
@@ -2357,6 +2362,9 @@ bool CRobotMain::EventFrame(const Event &event)
 {
     m_time += event.rTime;
 
+    if (m_benchmark)
+        UpdateBenchmark();
+
     m_water->EventProcess(event);
     m_cloud->EventProcess(event);
     m_lightning->EventProcess(event);
@@ -2725,6 +2733,8 @@ void CRobotMain::CreateScene(bool soluce, bool fixScene, bool resetObject)
 
     m_base = nullptr;
 
+    CBot::CBotProgram::ResetCacheStats();
+
     if (!resetObject)
     {
         m_build = 0;
@@ -2814,14 +2824,44 @@ void CRobotMain::CreateScene(bool soluce, bool fixScene, bool resetObject)
         m_ui->GetDialog()->StartInformation("Level loading warning", "This level contains problems. It may stop working in future versions of the game.", message);
     };
 
+    CLevelLoadingTimer loadingTimer;
+    CLevelLoadingJobs loadingJobs;
+
     try
     {
+        loadingTimer.SetStage("parsing");
         m_ui->GetLoadingScreen()->SetProgress(0.05f, RT_LOADING_PROCESSING);
         GetLogger()->Info("Loading level: %s\n", m_levelFile.c_str());
         CLevelParser levelParser(m_levelFile);
         levelParser.SetLevelPaths(m_levelCategory, m_levelChap, m_levelRank);
         levelParser.Load();
         int numObjects = levelParser.CountLines("CreateObject");
+
+        // Decode the terrain images and read the programs on worker threads,
+        // the commands below take their results when they get to them
+        loadingTimer.SetStage("starting jobs");
+        loadingJobs.Start(levelParser, !resetObject, m_sceneReadPath.empty(), soluce);
+
+        // Decode the scenery textures in background while the rest of the level loads
+        if (!resetObject)
+        {
+            for (auto& line : levelParser.GetLines())
+            {
+                std::string command = line->GetCommand();
+                if ((command == "Background" || command == "ForegroundName" || command == "Planet") &&
+                    line->GetParam("image")->IsDefined())
+                {
+                    m_engine->PrefetchTexture(line->GetParam("image")->AsPath("textures"));
+                }
+                else if (command == "TerrainMaterial")
+                {
+                    std::string name = line->GetParam("image")->AsPath("textures");
+                    if (name.find(".") == std::string::npos)
+                        name += ".png";
+                    m_engine->PrefetchTexture("textures/../" + name);
+                }
+            }
+        }
         m_ui->GetLoadingScreen()->SetProgress(0.1f, RT_LOADING_LEVEL_SETTINGS);
 
         int rankObj = 0;
@@ -2829,6 +2869,14 @@ void CRobotMain::CreateScene(bool soluce, bool fixScene, bool resetObject)
 
         for (auto& line : levelParser.GetLines())
         {
+            std::string command = line->GetCommand();
+            if (command.compare(0, 7, "Terrain") == 0)
+                loadingTimer.SetStage("terrain");
+            else if (command == "BeginObject" || command == "LevelController" || command == "CreateObject")
+                loadingTimer.SetStage("objects");
+            else
+                loadingTimer.SetStage("scene settings");
+
             if (line->GetCommand() == "Title" && !resetObject)
             {
                 //strcpy(m_title, line->GetParam("text")->AsString().c_str());
@@ -2859,7 +2907,7 @@ void CRobotMain::CreateScene(bool soluce, bool fixScene, bool resetObject)
 
                 m_immediatSatCom = line->GetParam("immediat")->AsBool(false);
                 m_beginSatCom = m_lockedSatCom = line->GetParam("lock")->AsBool(false);
-                if (m_app->GetSceneTestMode()) m_immediatSatCom = false;
+                if (m_app->GetSceneTestMode() || !m_app->GetBenchmarkFile().empty()) m_immediatSatCom = false;
                 continue;
             }
 
@@ -3178,10 +3226,15 @@ void CRobotMain::CreateScene(bool soluce, bool fixScene, bool resetObject)
             if (line->GetCommand() == "TerrainRelief" && !resetObject)
             {
                 m_ui->GetLoadingScreen()->SetProgress(0.2f+(1.f/5.f)*0.05f, RT_LOADING_TERRAIN, RT_LOADING_TERRAIN_RELIEF);
-                m_terrain->LoadRelief(
-                    line->GetParam("image")->AsPath("textures"),
-                    line->GetParam("factor")->AsFloat(1.0f),
-                    line->GetParam("border")->AsBool(true));
+                std::string fileName = line->GetParam("image")->AsPath("textures");
+                float factor = line->GetParam("factor")->AsFloat(1.0f);
+                bool border = line->GetParam("border")->AsBool(true);
+
+                std::unique_ptr<CImage> image = loadingJobs.TakeImage(fileName);
+                if (image != nullptr)
+                    m_terrain->LoadRelief(*image, factor, border);
+                else
+                    m_terrain->LoadRelief(fileName, factor, border);
                 continue;
             }
 
@@ -3195,7 +3248,13 @@ void CRobotMain::CreateScene(bool soluce, bool fixScene, bool resetObject)
             if (line->GetCommand() == "TerrainResource" && !resetObject)
             {
                 m_ui->GetLoadingScreen()->SetProgress(0.2f+(2.f/5.f)*0.05f, RT_LOADING_TERRAIN, RT_LOADING_TERRAIN_RES);
-                m_terrain->LoadResources(line->GetParam("image")->AsPath("textures"));
+                std::string fileName = line->GetParam("image")->AsPath("textures");
+
+                std::unique_ptr<CImage> image = loadingJobs.TakeImage(fileName);
+                if (image != nullptr)
+                    m_terrain->LoadResources(*image);
+                else
+                    m_terrain->LoadResources(fileName);
                 continue;
             }
 
@@ -3747,9 +3806,22 @@ void CRobotMain::CreateScene(bool soluce, bool fixScene, bool resetObject)
             throw CLevelParserException("Unknown command: '" + line->GetCommand() + "' in " + line->GetLevelFilename() + ":" + boost::lexical_cast<std::string>(line->GetLineNumber()));
         }
 
+        loadingTimer.SetStage("waiting for jobs");
+        loadingJobs.Finish();
+
+        loadingTimer.SetStage("finishing");
+
         // Do this here to prevent the first frame from taking a long time to render
         m_engine->UpdateGroundSpotTextures();
 
+        int cacheHits = 0, cacheMisses = 0;
+        CBot::CBotProgram::GetCacheStats(cacheHits, cacheMisses);
+        if (cacheHits + cacheMisses > 0)
+        {
+            GetLogger()->Info("CBot compile cache: %d hits, %d misses (%d%% hit rate)\n",
+                              cacheHits, cacheMisses, 100 * cacheHits / (cacheHits + cacheMisses));
+        }
+
         m_ui->GetLoadingScreen()->SetProgress(1.0f, RT_LOADING_FINISHED);
         if (m_ui->GetLoadingScreen()->IsVisible())
         {
@@ -3845,9 +3917,14 @@ void CRobotMain::CreateScene(bool soluce, bool fixScene, bool resetObject)
     }
     m_sceneReadPath = "";
 
+    loadingTimer.Log();
+
     if (m_app->GetSceneTestMode())
         m_eventQueue->AddEvent(Event(EVENT_QUIT));
 
+    if (!m_app->GetBenchmarkFile().empty() && !resetObject)
+        StartBenchmark();
+
     m_ui->ShowLoadingScreen(false);
     if (m_missionType == MISSION_CODE_BATTLE)
     {
@@ -3856,6 +3933,59 @@ void CRobotMain::CreateScene(bool soluce, bool fixScene, bool resetObject)
     CreateShortcuts();
 }
 
+//! Number of frames rendered by the benchmark
+const int BENCHMARK_FRAMES = 1000;
+
+void CRobotMain::StartBenchmark()
+{
+    auto device = dynamic_cast<Gfx::CRecordingDevice*>(m_engine->GetDevice());
+    if (device == nullptr)
+    {
+        GetLogger()->Error("Rendering benchmark needs the recording device (-graphics record)\n");
+        return;
+    }
+
+    GetLogger()->Info("Starting rendering benchmark\n");
+    Math::Vector eye, lookat;
+    m_camera->GetCamera(eye, lookat);
+    m_camera->StartVisit(lookat, Math::Max(Math::Distance(eye, lookat), 50.0f));
+    device->ClearFrameHistory();
+    device->SetRecording(true);
+    m_engine->SetTextBenchmark(m_app->GetBenchmarkText());
+    m_benchmark = true;
+}
+
+void CRobotMain::UpdateBenchmark()
+{
+    auto device = static_cast<Gfx::CRecordingDevice*>(m_engine->GetDevice());
+    const auto& frames = device->GetFrameHistory();
+    if (static_cast<int>(frames.size()) < BENCHMARK_FRAMES)
+        return;
+
+    long long drawCalls = 0, instances = 0, cpuTime = 0;
+    for (const auto& frame : frames)
+    {
+        drawCalls += frame.drawCalls;
+        instances += frame.instances;
+        cpuTime += frame.cpuTime;
+    }
+    GetLogger()->Info("Rendering benchmark: %d frames, %.1f draw calls (%.1f instanced objects) and %.3f ms per frame\n",
+                      static_cast<int>(frames.size()), static_cast<float>(drawCalls) / frames.size(),
+                      static_cast<float>(instances) / frames.size(), cpuTime / 1000.0f / frames.size());
+
+    std::ofstream stream(m_app->GetBenchmarkFile());
+    device->WriteFrameHistoryJson(stream);
+    if (!stream)
+        GetLogger()->Error("Unable to write benchmark results to %s\n", m_app->GetBenchmarkFile().c_str());
+    device->SetRecording(false);
+    device->ClearFrameHistory();
+
+    m_benchmark = false;
+    m_engine->SetTextBenchmark(false);
+    m_camera->StopVisit();
+    m_eventQueue->AddEvent(Event(EVENT_QUIT));
+}
+
 void CRobotMain::LevelLoadingError(const std::string& error, const std::runtime_error& exception, Phase exitPhase)
 {
     m_ui->ShowLoadingScreen(false);
@@ -4951,7 +5081,7 @@ CObject* CRobotMain::IOReadScene(std::string filename, std::string filecbot)
         if (version == 1)
         {
             CBot::ReadLong(istr, version);         // version of CBOT
-            if (version == CBot::CBotProgram::GetVersion())
+            if (CBot::CBotProgram::IsVersionSupported(version))
             {
                 unsigned short flag;
                 CBot::ReadWord(istr, flag); // TODO
@@ -5448,7 +5578,7 @@ float CRobotMain::GetPersoAngle()
 
 void CRobotMain::SetLevel(LevelCategory cat, int chap, int rank)
 {
-    GetLogger()->Debug("Change level to %s %d %d\n", GetLevelCategoryDir(cat).c_str(), chap, rank);
+    GetLogger()->Debug(LOG_CATEGORY_LEVEL, "Change level to %s %d %d\n", GetLevelCategoryDir(cat).c_str(), chap, rank);
     m_levelCategory = cat;
     m_levelChap = chap;
     m_levelRank = rank;
@@ -5754,7 +5884,7 @@ void CRobotMain::AutosaveRotate()
     if (m_playerProfile == nullptr)
         return;
 
-    GetLogger()->Debug("Rotate autosaves...\n");
+    GetLogger()->Debug(LOG_CATEGORY_LEVEL, "Rotate autosaves...\n");
     auto saveDirs = CResourceManager::ListDirectories(m_playerProfile->GetSaveDir());
     const std::string autosavePrefix = "autosave";
     std::vector<std::string> autosaves;
@@ -5805,7 +5935,7 @@ void CRobotMain::QuickLoad()
     if(!CResourceManager::Exists(dir))
     {
         m_displayText->DisplayError(ERR_NO_QUICK_SLOT, Math::Vector(0.0f,0.0f,0.0f), 15.0f, 60.0f, 1000.0f);
-        GetLogger()->Debug("Quicksave slot not found\n");
+        GetLogger()->Debug(LOG_CATEGORY_LEVEL, "Quicksave slot not found\n");
         return;
     }
     m_playerProfile->LoadScene(dir);
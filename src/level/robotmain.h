@@ -519,6 +519,10 @@ protected:
     void        StartDisplayVisit(EventType event);
     void        FrameVisit(float rTime);
     void        StopDisplayVisit();
+    //! Starts flying around the scene to measure the rendering, see CApplication::GetBenchmarkFile()
+    void        StartBenchmark();
+    //! Writes the benchmark results and quits once enough frames were rendered
+    void        UpdateBenchmark();
     void        ExecuteCmd(const std::string& cmd);
     void        UpdateSpeedLabel();
 
@@ -634,6 +638,7 @@ protected:
     bool            m_cheatTrainerPilot = false;    // remote trainer?
     bool            m_friendAim = false;
     bool            m_resetCreate = false;
+    bool            m_benchmark = false;       // rendering benchmark in progress?
     bool            m_mapShow = false;
     bool            m_mapImage = false;
     char            m_mapFilename[100] = {};
@@ -872,6 +872,13 @@ CObjectUPtr CObjectFactory::CreatePlant(const ObjectCreateParams& params)
         obj->CreateShadowCircle(50.0f, 0.5f);
     }
 
+    // Plants look about the same from every side and are made of a single part,
+    // so their impostor can face the camera whatever their orientation
+    if ( type != OBJECT_TREE5 )
+    {
+        m_engine->SetObjectImpostor(obj->GetObjectRank(0), true);
+    }
+
     pos = obj->GetPosition();
     obj->SetPosition(pos);  // to display the shadows immediately
 
@@ -37,7 +37,7 @@ extern const char* GetObjectName(ObjectType type);
 extern const char* GetObjectAlias(ObjectType type);
 extern std::string GetHelpFilename(ObjectType type);
 extern std::string GetHelpFilename(const char *token);
-extern bool IsType(const char *token);
-extern bool IsFunction(const char *token);
+extern bool IsType(const std::string& token);
+extern bool IsFunction(const std::string& token);
 extern const char* GetHelpText(const char *token);
 
@@ -44,6 +44,8 @@
 #include "ui/controls/interface.h"
 #include "ui/controls/list.h"
 
+#include <algorithm>
+
 #include <libintl.h>
 
 const int CBOT_IPF = 100;       // CBOT: default number of instructions / frame
@@ -169,10 +171,10 @@ bool CScript::CheckToken()
     std::map<std::string, int> cursor2;
 
     auto tokens = CBot::CBotToken::CompileTokens(m_script.get());
-    CBot::CBotToken* bt = tokens.get();
+    CBot::CBotToken* bt = tokens != nullptr ? tokens->GetFirst() : nullptr;
     while ( bt != nullptr )
     {
-        std::string token = bt->GetString();
+        const std::string& token = bt->GetString();
 
         // Store only the last occurrence of the token
         cursor1[token] = bt->GetStart();
@@ -240,7 +242,9 @@ bool CScript::Compile()
         m_botProg = MakeUnique<CBot::CBotProgram>(m_object->GetBotVar());
     }
 
-    if ( m_botProg->Compile(m_script.get(), functionList, this) )
+    // Compile-time checks of the external functions only depend on the object type
+    long context = static_cast<long>(m_object->GetType());
+    if ( m_botProg->CompileShared(m_script.get(), functionList, this, context) )
     {
         if (functionList.empty())
         {
@@ -589,11 +593,23 @@ void CScript::UpdateList(Ui::CList* list)
     list->SetState(Ui::STATE_ENABLE);
 }
 
+// Adds a highlighted range, merged with the previous one if possible
+
+static void AddRun(std::vector<CScript::ColorizeRun>& runs, int start, int end, int format)
+{
+    if (!runs.empty() && runs.back().end == start && runs.back().format == format)
+    {
+        runs.back().end = end;
+        return;
+    }
+    runs.push_back({start, end, format});
+}
+
 // Colorize a string or character literal with escape sequences also colored
 
-static void HighlightString(Ui::CEdit* edit, const std::string& s, int start)
+static void HighlightString(std::vector<CScript::ColorizeRun>& runs, const std::string& s, int start)
 {
-    edit->SetFormat(start, start + 1, Gfx::FONT_HIGHLIGHT_STRING);
+    AddRun(runs, start, start + 1, Gfx::FONT_HIGHLIGHT_STRING);
 
     auto it = s.cbegin();
     char endQuote = *(it++);
@@ -603,7 +619,7 @@ static void HighlightString(Ui::CEdit* edit, const std::string& s, int start)
     {
         if (*(it++) != '\\') // not escape sequence
         {
-            edit->SetFormat(start, start + 1, Gfx::FONT_HIGHLIGHT_STRING);
+            AddRun(runs, start, start + 1, Gfx::FONT_HIGHLIGHT_STRING);
             ++start;
             continue;
         }
@@ -633,32 +649,25 @@ static void HighlightString(Ui::CEdit* edit, const std::string& s, int start)
         else      // n, r, t, etc.
             ++it;
 
-        edit->SetFormat(start, end, Gfx::FONT_HIGHLIGHT_NONE);
+        AddRun(runs, start, end, Gfx::FONT_HIGHLIGHT_NONE);
         start = end;
     }
 
     if (it != s.cend())
-        edit->SetFormat(start, start + 1, Gfx::FONT_HIGHLIGHT_STRING);
+        AddRun(runs, start, start + 1, Gfx::FONT_HIGHLIGHT_STRING);
 }
 
-// Colorize the text according to syntax.
+// Finds the highlighted ranges of a piece of program.
+// Returns true if the text ends inside an unterminated block comment.
 
-void CScript::ColorizeScript(Ui::CEdit* edit, int rangeStart, int rangeEnd)
+static bool ColorizeTokens(const std::string& text, int offset, std::vector<CScript::ColorizeRun>& runs)
 {
-    if (rangeEnd > edit->GetTextLength())
-        rangeEnd = edit->GetTextLength();
-
-    edit->SetFormat(rangeStart, rangeEnd, Gfx::FONT_HIGHLIGHT_COMMENT); // anything not processed is a comment
-
-    // NOTE: Images are registered as index in some array, and that can be 0 which normally ends the string!
-    std::string text = edit->GetText();
-    text = text.substr(rangeStart, rangeEnd-rangeStart);
-
-    auto tokens = CBot::CBotToken::CompileTokens(text.c_str());
-    CBot::CBotToken* bt = tokens.get();
+    auto tokens = CBot::CBotToken::CompileTokens(text);
+    CBot::CBotToken* bt = tokens != nullptr ? tokens->GetFirst() : nullptr;
+    std::size_t lastEnd = 0;
     while ( bt != nullptr )
     {
-        std::string token = bt->GetString();
+        const std::string& token = bt->GetString();
         int type = bt->GetType();
 
         int cursor1 = bt->GetStart();
@@ -666,15 +675,16 @@ void CScript::ColorizeScript(Ui::CEdit* edit, int rangeStart, int rangeEnd)
 
         if (cursor1 < 0 || cursor2 < 0 || cursor1 == cursor2 || type == 0) { bt = bt->GetNext(); continue; } // seems to be a bug in CBot engine (how does it even still work? D:)
 
-        cursor1 += rangeStart;
-        cursor2 += rangeStart;
+        lastEnd = cursor2;
+        cursor1 += offset;
+        cursor2 += offset;
 
         Gfx::FontHighlight color = Gfx::FONT_HIGHLIGHT_NONE;
-        if ((type == CBot::TokenTypVar || (type >= CBot::TokenKeyWord && type < CBot::TokenKeyWord+100)) && IsType(token.c_str())) // types (basic types are TokenKeyWord, classes are TokenTypVar)
+        if ((type == CBot::TokenTypVar || (type >= CBot::TokenKeyWord && type < CBot::TokenKeyWord+100)) && IsType(token)) // types (basic types are TokenKeyWord, classes are TokenTypVar)
         {
             color = Gfx::FONT_HIGHLIGHT_TYPE;
         }
-        else if (type == CBot::TokenTypVar && IsFunction(token.c_str())) // functions
+        else if (type == CBot::TokenTypVar && IsFunction(token)) // functions
         {
             color = Gfx::FONT_HIGHLIGHT_TOKEN;
         }
@@ -700,16 +710,187 @@ void CScript::ColorizeScript(Ui::CEdit* edit, int rangeStart, int rangeEnd)
         }
         else if (type == CBot::TokenTypString || type == CBot::TokenTypChar) // string literals and character literals
         {
-            HighlightString(edit, token, cursor1);
+            HighlightString(runs, token, cursor1);
             bt = bt->GetNext();
             continue;
         }
 
         assert(cursor1 < cursor2);
-        edit->SetFormat(cursor1, cursor2, color);
+        AddRun(runs, cursor1, cursor2, color);
 
         bt = bt->GetNext();
     }
+
+    // Only the separators after the last token can contain an unterminated comment
+    std::size_t i = lastEnd;
+    while (i < text.length())
+    {
+        if (text[i] == ' ' || text[i] == '\t' || text[i] == '\r' || text[i] == '\n')
+        {
+            i++;
+        }
+        else if (text.compare(i, 2, "/*") == 0)
+        {
+            i = text.find("*/", i + 1);
+            if (i == std::string::npos) return true;
+            i += 2;
+        }
+        else
+        {
+            break;
+        }
+    }
+    return false;
+}
+
+// Colorize the text according to syntax.
+
+void CScript::ColorizeScript(Ui::CEdit* edit, int rangeStart, int rangeEnd)
+{
+    if (rangeEnd > edit->GetTextLength())
+        rangeEnd = edit->GetTextLength();
+
+    edit->SetFormat(rangeStart, rangeEnd, Gfx::FONT_HIGHLIGHT_COMMENT); // anything not processed is a comment
+
+    // NOTE: Images are registered as index in some array, and that can be 0 which normally ends the string!
+    std::string text = edit->GetText();
+    text = text.substr(rangeStart, rangeEnd-rangeStart);
+
+    std::vector<ColorizeRun> runs;
+    ColorizeTokens(text.c_str(), rangeStart, runs);
+    for (const ColorizeRun& run : runs)
+    {
+        edit->SetFormat(run.start, run.end, run.format);
+    }
+}
+
+// Updates the highlighting kept in the cache after a modification of the text.
+// The part of the text between start and oldEnd was replaced by the part
+// between start and newEnd; start < 0 means that the whole text changed.
+// Only the lines containing the modified part are split and lexed again, plus
+// the following lines as long as their starting comment state changes.
+// Returns the position of firstLine, the first line lexed again; the lines
+// lexed again end before endLine.
+
+int CScript::UpdateColorizeCache(ColorizeCache& cache, const std::string& text, int length,
+                                 int start, int oldEnd, int newEnd, int& firstLine, int& endLine)
+{
+    std::vector<ColorizeLine>& lines = cache.lines;
+    const int oldLength = length - newEnd + oldEnd;
+    if (start < 0 || cache.length != oldLength)
+    {
+        lines.clear();
+        lines.emplace_back();
+        lines.back().length = 1; // the empty text
+        start = 0;
+        oldEnd = 0;
+        newEnd = length;
+    }
+    cache.length = length;
+
+    if (start == oldEnd && start == newEnd)
+    {
+        firstLine = endLine = 0;
+        return 0;
+    }
+
+    // The cached lines containing the modified part, each length includes the end of line
+    int first = 0;
+    int firstPos = 0;
+    while (firstPos + lines[first].length <= start)
+    {
+        firstPos += lines[first].length;
+        first++;
+    }
+    int last = first;
+    int lastPos = firstPos;
+    while (lastPos + lines[last].length <= oldEnd)
+    {
+        lastPos += lines[last].length;
+        last++;
+    }
+
+    // Split the new text of these lines, up to the end of the line containing newEnd
+    std::vector<ColorizeLine> modified;
+    int pos = firstPos;
+    while (true)
+    {
+        std::size_t eol = text.find('\n', pos);
+        int end = (eol == std::string::npos || static_cast<int>(eol) >= length) ? length : static_cast<int>(eol);
+        modified.emplace_back();
+        modified.back().length = end + 1 - pos;
+        pos = end + 1;
+        if (pos > newEnd) break;
+    }
+    const int modifiedCount = static_cast<int>(modified.size());
+    lines.erase(lines.begin() + first, lines.begin() + last + 1);
+    lines.insert(lines.begin() + first,
+                 std::make_move_iterator(modified.begin()), std::make_move_iterator(modified.end()));
+
+    // Re-lex the modified lines, and the following ones as long as their starting state changes
+    const int count = static_cast<int>(lines.size());
+    bool comment = first > 0 && lines[first-1].commentAfter;
+    int i = first;
+    pos = firstPos;
+    for (; i < count; i++)
+    {
+        ColorizeLine& line = lines[i];
+        if (i >= first + modifiedCount && line.commentBefore == comment) break;
+
+        const int lineStart = pos;
+        const int end = lineStart + line.length - 1;
+        pos += line.length;
+        line.commentBefore = comment;
+        line.runs.clear();
+
+        int tokensStart = lineStart;
+        if (comment)
+        {
+            std::size_t close = text.find("*/", lineStart);
+            if (close == std::string::npos || static_cast<int>(close) + 2 > end)
+            {
+                line.commentAfter = true;
+                continue;
+            }
+            tokensStart = static_cast<int>(close) + 2;
+        }
+        line.commentAfter = ColorizeTokens(text.substr(tokensStart, end - tokensStart), tokensStart - lineStart, line.runs);
+        comment = line.commentAfter;
+    }
+
+    firstLine = first;
+    endLine = i;
+    return firstPos;
+}
+
+// Colorize the text according to syntax, reusing the result for the lines
+// that did not change since the last call with the same cache.
+// Only the lines lexed again are formatted, the edit keeps the format of the
+// other characters when text is inserted or deleted.
+
+void CScript::ColorizeScript(Ui::CEdit* edit, ColorizeCache& cache)
+{
+    const std::string& text = edit->GetText();
+    const int length = std::min(edit->GetTextLength(), static_cast<int>(text.length()));
+
+    int start, oldEnd, newEnd;
+    if (!edit->TakeChangedRange(start, oldEnd, newEnd))
+    {
+        start = -1;
+    }
+
+    int firstLine, endLine;
+    int pos = UpdateColorizeCache(cache, text, length, start, oldEnd, newEnd, firstLine, endLine);
+    for (int i = firstLine; i < endLine; i++)
+    {
+        const ColorizeLine& line = cache.lines[i];
+        edit->SetFormat(pos, std::min(pos + line.length, length), Gfx::FONT_HIGHLIGHT_COMMENT); // anything not processed is a comment
+        for (const ColorizeRun& run : line.runs)
+        {
+            edit->SetFormat(pos + run.start, pos + run.end, run.format);
+        }
+        pos += line.length;
+    }
 }
 
 
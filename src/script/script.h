@@ -29,6 +29,7 @@
 #include <memory>
 #include <limits>
 #include <string>
+#include <vector>
 #include <boost/optional.hpp>
 
 
@@ -60,6 +61,30 @@ class CScript
 {
 friend class CScriptFunctions;
 public:
+    //! Range of characters highlighted with one format
+    struct ColorizeRun
+    {
+        int start;
+        int end;
+        int format;
+    };
+
+    //! Highlighting of one line of a program
+    struct ColorizeLine
+    {
+        int length = 0;                 //!< length of the line, including the end of line
+        bool commentBefore = false;     //!< the line starts inside a block comment
+        bool commentAfter = false;      //!< the line ends inside a block comment
+        std::vector<ColorizeRun> runs;  //!< highlighted ranges, relative to the beginning of the line
+    };
+
+    //! Highlighting of a program kept between calls to ColorizeScript()
+    struct ColorizeCache
+    {
+        int length = -1;                //!< length of the text, -1 if nothing is cached
+        std::vector<ColorizeLine> lines;
+    };
+
     CScript(COldObject* object);
     ~CScript();
 
@@ -80,6 +105,9 @@ public:
     bool        GetCursor(int &cursor1, int &cursor2);
     void        UpdateList(Ui::CList* list);
     static void ColorizeScript(Ui::CEdit* edit, int rangeStart = 0, int rangeEnd = std::numeric_limits<int>::max());
+    static void ColorizeScript(Ui::CEdit* edit, ColorizeCache& cache);
+    static int  UpdateColorizeCache(ColorizeCache& cache, const std::string& text, int length,
+                                    int start, int oldEnd, int newEnd, int& firstLine, int& endLine);
     bool        IntroduceVirus();
 
     int         GetError();
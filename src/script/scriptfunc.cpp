@@ -3406,6 +3406,253 @@ private:
 };
 
 
+// Updates of the single fields of the class Object.
+// Reading item.position from a program calls only the update of "position",
+// using the object as a whole updates all of them through uObject.
+// Instances without an object of their own get the user pointer of the program,
+// which can be null, so every update has to check the result.
+
+static COldObject* GetUpdatedObject(void* user)
+{
+    if ( user == nullptr )  return nullptr;
+
+    CObject* obj = static_cast<CObject*>(user);
+    assert(obj->Implements(ObjectInterfaceType::Old));
+    return static_cast<COldObject*>(obj);
+}
+
+static void SetPointFields(CBotVar* pVar, const Math::Vector& pos)
+{
+    CBotVar* pSub = pVar->GetItemList();  // "x"
+    pSub->SetValFloat(pos.x/g_unit);
+    pSub = pSub->GetNext();  // "y"
+    pSub->SetValFloat(pos.z/g_unit);
+    pSub = pSub->GetNext();  // "z"
+    pSub->SetValFloat(pos.y/g_unit);
+}
+
+static void SetPointFieldsNan(CBotVar* pVar)
+{
+    CBotVar* pSub = pVar->GetItemList();  // "x"
+    pSub->SetInit(CBotVar::InitType::IS_NAN);
+    pSub = pSub->GetNext();  // "y"
+    pSub->SetInit(CBotVar::InitType::IS_NAN);
+    pSub = pSub->GetNext();  // "z"
+    pSub->SetInit(CBotVar::InitType::IS_NAN);
+}
+
+static Math::Vector GetObjectAngles(COldObject* object)
+{
+    return object->GetRotation() + object->GetTilt();
+}
+
+// Updates the object's type.
+static void uObjectCategory(CBotVar* pVar, void* user)
+{
+    COldObject* object = GetUpdatedObject(user);
+    if ( object == nullptr )  return;
+    pVar->SetValInt(object->GetType(), object->GetName());
+}
+
+// Updates the position of the object.
+static void uObjectPosition(CBotVar* pVar, void* user)
+{
+    COldObject* object = GetUpdatedObject(user);
+    if ( object == nullptr )  return;
+    if (IsObjectBeingTransported(object))
+    {
+        SetPointFieldsNan(pVar);
+    }
+    else
+    {
+        Math::Vector pos = object->GetPosition();
+        float waterLevel = Gfx::CEngine::GetInstancePointer()->GetWater()->GetLevel();
+        pos.y -= waterLevel;  // relative to sea level!
+        SetPointFields(pVar, pos);
+    }
+}
+
+// Updates the angles.
+static void uObjectOrientation(CBotVar* pVar, void* user)
+{
+    COldObject* object = GetUpdatedObject(user);
+    if ( object == nullptr )  return;
+    Math::Vector pos = GetObjectAngles(object);
+    pVar->SetValFloat(Math::NormAngle(2*Math::PI - pos.y)*180.0f/Math::PI);
+}
+
+static void uObjectPitch(CBotVar* pVar, void* user)
+{
+    COldObject* object = GetUpdatedObject(user);
+    if ( object == nullptr )  return;
+    Math::Vector pos = GetObjectAngles(object);
+    pVar->SetValFloat((Math::NormAngle(pos.z + Math::PI) - Math::PI)*180.0f/Math::PI);
+}
+
+static void uObjectRoll(CBotVar* pVar, void* user)
+{
+    COldObject* object = GetUpdatedObject(user);
+    if ( object == nullptr )  return;
+    Math::Vector pos = GetObjectAngles(object);
+    pVar->SetValFloat((Math::NormAngle(pos.x + Math::PI) - Math::PI)*180.0f/Math::PI);
+}
+
+// Updates the energy level of the object.
+static void uObjectEnergyLevel(CBotVar* pVar, void* user)
+{
+    COldObject* object = GetUpdatedObject(user);
+    if ( object == nullptr )  return;
+    pVar->SetValFloat(object->GetEnergyLevel());
+}
+
+// Updates the shield level of the object.
+static void uObjectShieldLevel(CBotVar* pVar, void* user)
+{
+    COldObject* object = GetUpdatedObject(user);
+    if ( object == nullptr )  return;
+    float value;
+    if ( !object->Implements(ObjectInterfaceType::Shielded) ) value = 1.0f;
+    else value = dynamic_cast<CShieldedObject*>(object)->GetShield();
+    pVar->SetValFloat(value);
+}
+
+// Updates the temperature of the reactor.
+static void uObjectTemperature(CBotVar* pVar, void* user)
+{
+    COldObject* object = GetUpdatedObject(user);
+    if ( object == nullptr )  return;
+    float value;
+    if ( !object->Implements(ObjectInterfaceType::JetFlying) )  value = 0.0f;
+    else value = 1.0f-dynamic_cast<CJetFlyingObject*>(object)->GetReactorRange();
+    pVar->SetValFloat(value);
+}
+
+// Updates the height above the ground.
+static void uObjectAltitude(CBotVar* pVar, void* user)
+{
+    COldObject* object = GetUpdatedObject(user);
+    if ( object == nullptr )  return;
+    CPhysics* physics = object->GetPhysics();
+    float value;
+    if ( physics == nullptr )  value = 0.0f;
+    else                 value = physics->GetFloorHeight();
+    pVar->SetValFloat(value/g_unit);
+}
+
+// Updates the lifetime of the object.
+static void uObjectLifeTime(CBotVar* pVar, void* user)
+{
+    COldObject* object = GetUpdatedObject(user);
+    if ( object == nullptr )  return;
+    pVar->SetValFloat(object->GetAbsTime());
+}
+
+// Updates the type of battery.
+static void uObjectEnergyCell(CBotVar* pVar, void* user)
+{
+    COldObject* object = GetUpdatedObject(user);
+    if ( object == nullptr )  return;
+    if (object->Implements(ObjectInterfaceType::Powered))
+    {
+        CObject* power = dynamic_cast<CPoweredObject*>(object)->GetPower();
+        if (power == nullptr)
+        {
+            pVar->SetPointer(nullptr);
+        }
+        else if (power->Implements(ObjectInterfaceType::Old))
+        {
+            pVar->SetPointer(power->GetBotVar());
+        }
+    }
+}
+
+// Updates the transported object's type.
+static void uObjectLoad(CBotVar* pVar, void* user)
+{
+    COldObject* object = GetUpdatedObject(user);
+    if ( object == nullptr )  return;
+    if (object->Implements(ObjectInterfaceType::Carrier))
+    {
+        CObject* cargo = dynamic_cast<CCarrierObject*>(object)->GetCargo();
+        if (cargo == nullptr)
+        {
+            pVar->SetPointer(nullptr);
+        }
+        else if (cargo->Implements(ObjectInterfaceType::Old))
+        {
+            pVar->SetPointer(cargo->GetBotVar());
+        }
+    }
+}
+
+static void uObjectId(CBotVar* pVar, void* user)
+{
+    COldObject* object = GetUpdatedObject(user);
+    if ( object == nullptr )  return;
+    pVar->SetValInt(object->GetID());
+}
+
+static void uObjectTeam(CBotVar* pVar, void* user)
+{
+    COldObject* object = GetUpdatedObject(user);
+    if ( object == nullptr )  return;
+    pVar->SetValInt(object->GetTeam());
+}
+
+static void uObjectDead(CBotVar* pVar, void* user)
+{
+    COldObject* object = GetUpdatedObject(user);
+    if ( object == nullptr )  return;
+    pVar->SetValInt(object->IsDying());
+}
+
+// Updates the velocity of the object.
+static void uObjectVelocity(CBotVar* pVar, void* user)
+{
+    COldObject* object = GetUpdatedObject(user);
+    if ( object == nullptr )  return;
+    CPhysics* physics = object->GetPhysics();
+    if (IsObjectBeingTransported(object) || physics == nullptr)
+    {
+        SetPointFieldsNan(pVar);
+    }
+    else
+    {
+        Math::Matrix matRotate;
+        Math::LoadRotationZXYMatrix(matRotate, object->GetRotation());
+        Math::Vector pos = physics->GetLinMotion(MO_CURSPEED);
+        pos = Transform(matRotate, pos);
+        SetPointFields(pVar, pos);
+    }
+}
+
+struct ObjectFieldUpdate
+{
+    const char* name;
+    void (*update)(CBotVar* pVar, void* user);
+};
+
+// In the same order as the fields of the class Object.
+static const ObjectFieldUpdate OBJECT_FIELD_UPDATES[] =
+{
+    { "category",    uObjectCategory },
+    { "position",    uObjectPosition },
+    { "orientation", uObjectOrientation },
+    { "pitch",       uObjectPitch },
+    { "roll",        uObjectRoll },
+    { "energyLevel", uObjectEnergyLevel },
+    { "shieldLevel", uObjectShieldLevel },
+    { "temperature", uObjectTemperature },
+    { "altitude",    uObjectAltitude },
+    { "lifeTime",    uObjectLifeTime },
+    { "energyCell",  uObjectEnergyCell },
+    { "load",        uObjectLoad },
+    { "id",          uObjectId },
+    { "team",        uObjectTeam },
+    { "dead",        uObjectDead },
+    { "velocity",    uObjectVelocity },
+};
+
 
 // Initializes all functions for module CBOT.
 
@@ -3523,6 +3770,10 @@ void CScriptFunctions::Init()
     bc->AddItem("team",        CBotTypResult(CBotTypInt), CBotVar::ProtectionLevel::ReadOnly);
     bc->AddItem("dead",        CBotTypResult(CBotTypBoolean), CBotVar::ProtectionLevel::ReadOnly);
     bc->AddItem("velocity",    CBotTypResult(CBotTypClass, "point"), CBotVar::ProtectionLevel::ReadOnly);
+    for (const ObjectFieldUpdate& field : OBJECT_FIELD_UPDATES)
+    {
+        bc->SetFieldUpdateFunc(field.name, field.update);
+    }
 
     CBotProgram::AddFunction("endmission",rEndMission,cEndMission);
     CBotProgram::AddFunction("playmusic", rPlayMusic ,cPlayMusic);
@@ -3603,153 +3854,14 @@ void CScriptFunctions::Init()
 
 void CScriptFunctions::uObject(CBotVar* botThis, void* user)
 {
-    CPhysics*   physics;
-    CBotVar     *pVar, *pSub;
-    ObjectType  type;
-    Math::Vector    pos;
-    float       value;
-
     if ( user == nullptr )  return;
 
-    CObject* obj = static_cast<CObject*>(user);
-    assert(obj->Implements(ObjectInterfaceType::Old));
-    COldObject* object = static_cast<COldObject*>(obj);
-
-    physics = object->GetPhysics();
-
-    // Updates the object's type.
-    pVar = botThis->GetItemList();  // "category"
-    type = object->GetType();
-    pVar->SetValInt(type, object->GetName());
-
-    // Updates the position of the object.
-    pVar = pVar->GetNext();  // "position"
-    if (IsObjectBeingTransported(object))
-    {
-        pSub = pVar->GetItemList();  // "x"
-        pSub->SetInit(CBotVar::InitType::IS_NAN);
-        pSub = pSub->GetNext();  // "y"
-        pSub->SetInit(CBotVar::InitType::IS_NAN);
-        pSub = pSub->GetNext();  // "z"
-        pSub->SetInit(CBotVar::InitType::IS_NAN);
-    }
-    else
-    {
-        pos = object->GetPosition();
-        float waterLevel = Gfx::CEngine::GetInstancePointer()->GetWater()->GetLevel();
-        pos.y -= waterLevel;  // relative to sea level!
-        pSub = pVar->GetItemList();  // "x"
-        pSub->SetValFloat(pos.x/g_unit);
-        pSub = pSub->GetNext();  // "y"
-        pSub->SetValFloat(pos.z/g_unit);
-        pSub = pSub->GetNext();  // "z"
-        pSub->SetValFloat(pos.y/g_unit);
-    }
-
-    // Updates the angle.
-    pos = object->GetRotation();
-    pos += object->GetTilt();
-    pVar = pVar->GetNext();  // "orientation"
-    pVar->SetValFloat(Math::NormAngle(2*Math::PI - pos.y)*180.0f/Math::PI);
-    pVar = pVar->GetNext();  // "pitch"
-    pVar->SetValFloat((Math::NormAngle(pos.z + Math::PI) - Math::PI)*180.0f/Math::PI);
-    pVar = pVar->GetNext();  // "roll"
-    pVar->SetValFloat((Math::NormAngle(pos.x + Math::PI) - Math::PI)*180.0f/Math::PI);
-
-    // Updates the energy level of the object.
-    pVar = pVar->GetNext();  // "energyLevel"
-    value = object->GetEnergyLevel();
-    pVar->SetValFloat(value);
-
-    // Updates the shield level of the object.
-    pVar = pVar->GetNext();  // "shieldLevel"
-    if ( !obj->Implements(ObjectInterfaceType::Shielded) ) value = 1.0f;
-    else value = dynamic_cast<CShieldedObject*>(object)->GetShield();
-    pVar->SetValFloat(value);
-
-    // Updates the temperature of the reactor.
-    pVar = pVar->GetNext();  // "temperature"
-    if ( !obj->Implements(ObjectInterfaceType::JetFlying) )  value = 0.0f;
-    else value = 1.0f-dynamic_cast<CJetFlyingObject*>(object)->GetReactorRange();
-    pVar->SetValFloat(value);
-
-    // Updates the height above the ground.
-    pVar = pVar->GetNext();  // "altitude"
-    if ( physics == nullptr )  value = 0.0f;
-    else                 value = physics->GetFloorHeight();
-    pVar->SetValFloat(value/g_unit);
-
-    // Updates the lifetime of the object.
-    pVar = pVar->GetNext();  // "lifeTime"
-    value = object->GetAbsTime();
-    pVar->SetValFloat(value);
-
-    // Updates the type of battery.
-    pVar = pVar->GetNext();  // "energyCell"
-    if (object->Implements(ObjectInterfaceType::Powered))
-    {
-        CObject* power = dynamic_cast<CPoweredObject*>(object)->GetPower();
-        if (power == nullptr)
-        {
-            pVar->SetPointer(nullptr);
-        }
-        else if (power->Implements(ObjectInterfaceType::Old))
-        {
-            pVar->SetPointer(power->GetBotVar());
-        }
-    }
-
-    // Updates the transported object's type.
-    pVar = pVar->GetNext();  // "load"
-    if (object->Implements(ObjectInterfaceType::Carrier))
-    {
-        CObject* cargo = dynamic_cast<CCarrierObject*>(object)->GetCargo();
-        if (cargo == nullptr)
-        {
-            pVar->SetPointer(nullptr);
-        }
-        else if (cargo->Implements(ObjectInterfaceType::Old))
-        {
-            pVar->SetPointer(cargo->GetBotVar());
-        }
-    }
-
-    pVar = pVar->GetNext();  // "id"
-    value = object->GetID();
-    pVar->SetValInt(value);
-
-    pVar = pVar->GetNext();  // "team"
-    value = object->GetTeam();
-    pVar->SetValInt(value);
-
-    pVar = pVar->GetNext();  // "dead"
-    value = object->IsDying();
-    pVar->SetValInt(value);
-
-    // Updates the velocity of the object.
-    pVar = pVar->GetNext();  // "velocity"
-    if (IsObjectBeingTransported(object) || physics == nullptr)
-    {
-        pSub = pVar->GetItemList();  // "x"
-        pSub->SetInit(CBotVar::InitType::IS_NAN);
-        pSub = pSub->GetNext();  // "y"
-        pSub->SetInit(CBotVar::InitType::IS_NAN);
-        pSub = pSub->GetNext();  // "z"
-        pSub->SetInit(CBotVar::InitType::IS_NAN);
-    }
-    else
+    // The table follows the order in which the fields are added in Init()
+    CBotVar* pVar = botThis->GetItemList();
+    for (const ObjectFieldUpdate& field : OBJECT_FIELD_UPDATES)
     {
-        Math::Matrix matRotate;
-        Math::LoadRotationZXYMatrix(matRotate, object->GetRotation());
-        pos = physics->GetLinMotion(MO_CURSPEED);
-        pos = Transform(matRotate, pos);
-
-        pSub = pVar->GetItemList();  // "x"
-        pSub->SetValFloat(pos.x/g_unit);
-        pSub = pSub->GetNext();  // "y"
-        pSub->SetValFloat(pos.z/g_unit);
-        pSub = pSub->GetNext();  // "z"
-        pSub->SetValFloat(pos.y/g_unit);
+        field.update(pVar, user);
+        pVar = pVar->GetNext();
     }
 }
 
@@ -22,8 +22,63 @@
 
 #include "common/make_unique.h"
 
+#include "common/resources/resourcemanager.h"
+
+#include "common/thread/worker_pool.h"
+
+#include "math/func.h"
+
+#include "sound/oalsound/sound_cache.h"
+
 #include <algorithm>
+#include <chrono>
 #include <iomanip>
+#include <sstream>
+
+#include <SDL_cpuinfo.h>
+#include <SDL_timer.h>
+
+
+namespace
+{
+
+//! Interval between refills of the music streams in milliseconds
+const int MUSIC_STREAM_INTERVAL = 20;
+
+//! Initial limit of sounds played on OpenAL sources at once
+const unsigned int MAX_REAL_VOICES = 64;
+//! Sounds quieter than this at the listener are never played on an OpenAL source
+const float AUDIBLE_VOLUME = 0.01f;
+//! Interval between choosing the sounds played on OpenAL sources in seconds
+const float VOICE_UPDATE_INTERVAL = 0.1f;
+
+//! Decodes the files in parallel, filling the samples of each file
+void DecodeSounds(const std::vector<std::string>& fileNames,
+                  std::vector<std::vector<short>>& decoded, std::vector<SoundSamples>& samples)
+{
+    int threadCount = std::max(1, std::min(static_cast<int>(fileNames.size()), SDL_GetCPUCount()));
+    CWorkerPool pool(threadCount, "Sound decoder");
+
+    for (std::size_t i = 0; i < fileNames.size(); ++i)
+    {
+        pool.Start([i, &fileNames, &decoded, &samples]()
+        {
+            int channels = 0;
+            int sampleRate = 0;
+            if (!CBuffer::DecodeFile(fileNames[i], decoded[i], channels, sampleRate))
+                return;
+
+            samples[i].samples = decoded[i].data();
+            samples[i].count = decoded[i].size();
+            samples[i].channels = channels;
+            samples[i].sampleRate = sampleRate;
+        });
+    }
+
+    pool.WaitAll();
+}
+
+} // anonymous namespace
 
 
 CALSound::CALSound()
@@ -33,6 +88,14 @@ CALSound::CALSound()
       m_channelsLimit(2048),
       m_device{},
       m_context{},
+      m_sourceCount(0),
+      m_sourcesLimit(MAX_REAL_VOICES),
+      m_voiceUpdateTime(0.0f),
+      m_realVoices(0),
+      m_virtualVoices(0),
+      m_musicFadeTime(0.0f),
+      m_musicFadeCurrentTime(0.0f),
+      m_streaming(false),
       m_thread("Music loading thread")
 {
 }
@@ -47,8 +110,22 @@ void CALSound::CleanUp()
     if (m_enabled)
     {
         GetLogger()->Info("Unloading files and closing device...\n");
+
+        if (m_streamThread != nullptr)
+        {
+            m_musicMutex.Lock();
+            m_streaming = false;
+            m_musicMutex.Unlock();
+            m_streamThread->Join();
+            m_streamThread.reset();
+        }
+
         Reset();
 
+        alDeleteSources(m_freeSources.size(), m_freeSources.data());
+        m_freeSources.clear();
+        m_sourceCount = 0;
+
         alcDestroyContext(m_context);
         alcCloseDevice(m_device);
     }
@@ -81,25 +158,69 @@ bool CALSound::Create()
 
     GetLogger()->Info("Done.\n");
     m_enabled = true;
+
+    m_streaming = true;
+    m_streamThread = MakeUnique<CThread>([this]() { StreamMusic(); }, "Music streaming thread");
+    m_streamThread->Start();
     return true;
 }
 
+void CALSound::StreamMusic()
+{
+    while (true)
+    {
+        m_musicMutex.Lock();
+        if (!m_streaming)
+        {
+            m_musicMutex.Unlock();
+            break;
+        }
+
+        if (m_currentMusic != nullptr)
+        {
+            m_currentMusic->Update();
+        }
+        for (auto& old : m_oldMusic)
+        {
+            old.music->Update();
+        }
+        if (m_previousMusic.music != nullptr)
+        {
+            m_previousMusic.music->Update();
+        }
+        m_musicMutex.Unlock();
+
+        SDL_Delay(MUSIC_STREAM_INTERVAL);
+    }
+}
+
 void CALSound::Reset()
 {
     StopAll();
-    StopMusic();
 
+    for (auto& it : m_channels)
+    {
+        if (!it.second->IsVirtual())
+            m_freeSources.push_back(it.second->Virtualize());
+    }
     m_channels.clear();
+    m_realVoices = 0;
+    m_virtualVoices = 0;
+
+    m_musicMutex.Lock();
 
     m_currentMusic.reset();
 
     m_oldMusic.clear();
 
     m_previousMusic.music.reset();
-
-    m_sounds.clear();
+    m_previousMusic.fadeTime = 0.0f;
 
     m_music.clear();
+
+    m_musicMutex.Unlock();
+
+    m_sounds.clear();
 }
 
 bool CALSound::GetEnable()
@@ -123,10 +244,12 @@ int CALSound::GetAudioVolume()
 void CALSound::SetMusicVolume(int volume)
 {
     m_musicVolume = static_cast<float>(volume) / MAXVOLUME;
+    m_musicMutex.Lock();
     if (m_currentMusic)
     {
         m_currentMusic->SetVolume(m_musicVolume);
     }
+    m_musicMutex.Unlock();
 }
 
 int CALSound::GetMusicVolume()
@@ -148,17 +271,97 @@ bool CALSound::Cache(SoundType sound, const std::string &filename)
     return false;
 }
 
+void CALSound::CacheSounds(const std::map<SoundType, std::string> &files)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // Each file is decoded only once, even if used by several sounds
+    std::vector<std::string> fileNames;
+    std::map<SoundType, std::size_t> fileIndex;
+    std::map<std::string, std::size_t> nameIndex;
+    for (const auto& file : files)
+    {
+        if (IsCached(file.first))
+            continue;
+
+        std::string name = CResourceManager::CleanPath(file.second);
+        auto it = nameIndex.find(name);
+        if (it == nameIndex.end())
+        {
+            it = nameIndex.emplace(name, fileNames.size()).first;
+            fileNames.push_back(name);
+        }
+        fileIndex[file.first] = it->second;
+    }
+
+    std::stringstream key;
+    for (const std::string& location : CResourceManager::GetLocations())
+        key << location << '\n';
+    for (const std::string& name : fileNames)
+    {
+        key << name << ' ' << CResourceManager::GetFileSize(name)
+            << ' ' << CResourceManager::GetLastModificationTime(name) << '\n';
+    }
+
+    CSoundCache cache;
+    std::vector<SoundSamples> samples;
+    std::vector<std::vector<short>> decoded;
+    bool cached = cache.Load(key.str(), samples) && samples.size() == fileNames.size();
+    if (!cached)
+    {
+        samples.assign(fileNames.size(), SoundSamples());
+        decoded.resize(fileNames.size());
+        DecodeSounds(fileNames, decoded, samples);
+        cache.Store(key.str(), samples);
+    }
+
+    // Create all buffers at once when the samples are ready
+    int loaded = 0;
+    for (const auto& sound : fileIndex)
+    {
+        const SoundSamples& data = samples[sound.second];
+        auto buffer = MakeUnique<CBuffer>();
+        if (data.channels > 0 &&
+            buffer->LoadFromSamples(data.samples, data.count, data.channels, data.sampleRate, sound.first))
+        {
+            m_sounds[sound.first] = std::move(buffer);
+            ++loaded;
+        }
+        else
+        {
+            GetLogger()->Warn("Unable to load audio: %s\n", files.at(sound.first).c_str());
+        }
+    }
+    cache.Close();
+
+    auto time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    GetLogger()->Info("Loaded %d sound effects from %d files %s in %d ms\n", loaded, static_cast<int>(fileNames.size()),
+                      cached ? "from cache" : "decoded", static_cast<int>(time.count()));
+}
+
 void CALSound::CacheMusic(const std::string &filename)
 {
+    if (!m_enabled)
+    {
+        return;
+    }
+
     m_thread.Start([this, filename]()
     {
-        if (m_music.find(filename) == m_music.end())
+        m_musicMutex.Lock();
+        bool cached = m_music.find(filename) != m_music.end();
+        m_musicMutex.Unlock();
+        if (cached)
         {
-            auto buffer = MakeUnique<CBuffer>();
-            if (buffer->LoadFromFile(filename, static_cast<SoundType>(-1)))
-            {
-                m_music[filename] = std::move(buffer);
-            }
+            return;
+        }
+
+        auto stream = MakeUnique<CMusicStream>();
+        if (stream->Open(filename))
+        {
+            m_musicMutex.Lock();
+            m_music[filename] = std::move(stream);
+            m_musicMutex.Unlock();
         }
     });
 }
@@ -170,7 +373,10 @@ bool CALSound::IsCached(SoundType sound)
 
 bool CALSound::IsCachedMusic(const std::string &filename)
 {
-    return m_music.find(filename) != m_music.end();
+    m_musicMutex.Lock();
+    bool cached = m_music.find(filename) != m_music.end();
+    m_musicMutex.Unlock();
+    return cached;
 }
 
 int CALSound::GetPriority(SoundType sound)
@@ -248,21 +454,16 @@ bool CALSound::SearchFreeBuffer(SoundType sound, int &channel, bool &alreadyLoad
     if (m_channels.size() == 0)
     {
         auto chn = MakeUnique<CChannel>();
-        // check if we channel ready to play music, if not report error
-        if (chn->IsReady())
-        {
-            chn->SetPriority(priority);
-            chn->Reset();
-            channel = 1;
-            m_channels[channel] = std::move(chn);
-            alreadyLoaded = false;
-            return true;
-        }
-        GetLogger()->Error("Could not open channel to play sound!\n");
-        return false;
+        chn->SetPriority(priority);
+        chn->Reset();
+        channel = 1;
+        m_channels[channel] = std::move(chn);
+        alreadyLoaded = false;
+        return true;
     }
 
     // Assigns new channel within limit
+    // Channels do not need an OpenAL source, they get one when they are among the loudest
     if (m_channels.size() < m_channelsLimit)
     {
         auto it = m_channels.end();
@@ -273,18 +474,12 @@ bool CALSound::SearchFreeBuffer(SoundType sound, int &channel, bool &alreadyLoad
             if (m_channels.find(i) == m_channels.end())
             {
                 auto chn = MakeUnique<CChannel>();
-                // check if channel is ready to play music, if not destroy it and seek free one
-                if (chn->IsReady())
-                {
-                    chn->SetPriority(priority);
-                    chn->Reset();
-                    m_channels[i] = std::move(chn);
-                    channel = i;
-                    alreadyLoaded = false;
-                    return true;
-                }
-                GetLogger()->Debug("Could not open additional channel to play sound!\n");
-                break;
+                chn->SetPriority(priority);
+                chn->Reset();
+                m_channels[i] = std::move(chn);
+                channel = i;
+                alreadyLoaded = false;
+                return true;
             }
         }
     }
@@ -294,7 +489,7 @@ bool CALSound::SearchFreeBuffer(SoundType sound, int &channel, bool &alreadyLoad
     {
         if (it.second->GetPriority() < priority)
         {
-            GetLogger()->Debug("Sound channel with lower priority will be reused.\n");
+            GetLogger()->Debug(LOG_CATEGORY_SOUND, "Sound channel with lower priority will be reused.\n");
             channel = it.first;
             it.second->Reset();
             return true;
@@ -307,11 +502,11 @@ bool CALSound::SearchFreeBuffer(SoundType sound, int &channel, bool &alreadyLoad
     {
         channel = lowerOrEqual;
         m_channels[channel]->Reset();
-        GetLogger()->Debug("Sound channel with lower or equal priority will be reused.\n");
+        GetLogger()->Debug(LOG_CATEGORY_SOUND, "Sound channel with lower or equal priority will be reused.\n");
         return true;
     }
 
-    GetLogger()->Debug("Could not find free buffer to use.\n");
+    GetLogger()->Debug(LOG_CATEGORY_SOUND, "Could not find free buffer to use.\n");
     return false;
 }
 
@@ -333,7 +528,7 @@ int CALSound::Play(SoundType sound, const Math::Vector &pos, bool relativeToList
     }
     if (m_sounds.find(sound) == m_sounds.end())
     {
-        GetLogger()->Debug("Sound %d was not loaded!\n", sound);
+        GetLogger()->Debug(LOG_CATEGORY_SOUND, "Sound %d was not loaded!\n", sound);
         return -1;
     }
 
@@ -370,16 +565,163 @@ int CALSound::Play(SoundType sound, const Math::Vector &pos, bool relativeToList
 
     if (!chn->Play())
     {
-        m_channelsLimit = m_channels.size() - 1;
-        GetLogger()->Debug("Changing channel limit to %u.\n", m_channelsLimit);
-        m_channels.erase(channel);
-
         return -1;
     }
 
+    if (chn->IsVirtual())
+    {
+        PromoteChannel(chn);
+    }
+
     return channel | ((chn->GetId() & 0xffff) << 16);
 }
 
+float CALSound::GetLoudness(CChannel* channel)
+{
+    if (!channel->IsPlaying() || channel->IsMuted())
+    {
+        return 0.0f;
+    }
+
+    // the same attenuation as AL_LINEAR_DISTANCE_CLAMPED
+    float distance = channel->IsRelativeToListener() ? channel->GetPosition().Length()
+                                                     : Math::Distance(channel->GetPosition(), m_eye);
+    distance = Math::Clamp(distance, SOUND_REFERENCE_DISTANCE, SOUND_MAX_DISTANCE);
+    float attenuation = 1.0f - (distance - SOUND_REFERENCE_DISTANCE) / (SOUND_MAX_DISTANCE - SOUND_REFERENCE_DISTANCE);
+
+    return channel->GetVolume() * attenuation;
+}
+
+bool CALSound::AcquireSource(ALuint &source)
+{
+    if (!m_freeSources.empty())
+    {
+        source = m_freeSources.back();
+        m_freeSources.pop_back();
+        return true;
+    }
+
+    if (m_sourceCount >= m_sourcesLimit)
+    {
+        return false;
+    }
+
+    alGenSources(1, &source);
+    if (CheckOpenALError())
+    {
+        m_sourcesLimit = m_sourceCount;
+        GetLogger()->Debug(LOG_CATEGORY_SOUND, "Changing real voices limit to %u.\n", m_sourcesLimit);
+        return false;
+    }
+
+    ++m_sourceCount;
+    return true;
+}
+
+void CALSound::PromoteChannel(CChannel* channel)
+{
+    float loudness = GetLoudness(channel);
+    if (loudness < AUDIBLE_VOLUME)
+    {
+        return;
+    }
+
+    ALuint source;
+    if (AcquireSource(source))
+    {
+        channel->Realize(source);
+        return;
+    }
+
+    // take the source from the least important channel if it is less important than this one
+    float score = loudness * (1.0f + channel->GetPriority() / 10.0f);
+    CChannel* weakest = nullptr;
+    for (auto& it : m_channels)
+    {
+        CChannel* other = it.second.get();
+        if (other->IsVirtual() || other == channel)
+        {
+            continue;
+        }
+
+        float otherScore = GetLoudness(other) * (1.0f + other->GetPriority() / 10.0f);
+        if (otherScore < score)
+        {
+            score = otherScore;
+            weakest = other;
+        }
+    }
+
+    if (weakest != nullptr)
+    {
+        channel->Realize(weakest->Virtualize());
+    }
+}
+
+void CALSound::UpdateVoices()
+{
+    struct Voice
+    {
+        CChannel* channel;
+        float score;
+    };
+
+    std::vector<Voice> voices;
+    m_realVoices = 0;
+    m_virtualVoices = 0;
+    for (auto& it : m_channels)
+    {
+        CChannel* channel = it.second.get();
+        if (!channel->IsPlaying())
+        {
+            // stopped channels give their sources back
+            if (!channel->IsVirtual())
+                m_freeSources.push_back(channel->Virtualize());
+            continue;
+        }
+
+        float loudness = GetLoudness(channel);
+        if (loudness < AUDIBLE_VOLUME)
+        {
+            if (!channel->IsVirtual())
+                m_freeSources.push_back(channel->Virtualize());
+            ++m_virtualVoices;
+            continue;
+        }
+
+        voices.push_back({ channel, loudness * (1.0f + channel->GetPriority() / 10.0f) });
+    }
+
+    std::sort(voices.begin(), voices.end(), [](const Voice& a, const Voice& b) { return a.score > b.score; });
+
+    // the sources of the less important channels are given to the more important ones
+    for (std::size_t i = m_sourcesLimit; i < voices.size(); ++i)
+    {
+        if (!voices[i].channel->IsVirtual())
+            m_freeSources.push_back(voices[i].channel->Virtualize());
+    }
+
+    for (std::size_t i = 0; i < voices.size(); ++i)
+    {
+        ALuint source;
+        if (voices[i].channel->IsVirtual() && (i >= m_sourcesLimit || !AcquireSource(source)))
+        {
+            ++m_virtualVoices;
+            continue;
+        }
+
+        if (voices[i].channel->IsVirtual())
+            voices[i].channel->Realize(source);
+        ++m_realVoices;
+    }
+}
+
+void CALSound::GetVoiceCount(int &realVoices, int &virtualVoices)
+{
+    realVoices = m_realVoices;
+    virtualVoices = m_virtualVoices;
+}
+
 bool CALSound::FlushEnvelope(int channel)
 {
     if (!CheckChannel(channel))
@@ -490,6 +832,8 @@ void CALSound::FrameMove(float rTime)
     float volume, frequency;
     for (auto& it : m_channels)
     {
+        it.second->UpdateVirtual(rTime);
+
         if (!it.second->IsPlaying())
         {
             continue;
@@ -542,6 +886,29 @@ void CALSound::FrameMove(float rTime)
         }
     }
 
+    m_voiceUpdateTime += rTime;
+    if (m_voiceUpdateTime >= VOICE_UPDATE_INTERVAL)
+    {
+        m_voiceUpdateTime = 0.0f;
+        UpdateVoices();
+    }
+
+    m_musicMutex.Lock();
+
+    if (m_currentMusic != nullptr && m_musicFadeTime > 0.0f)
+    {
+        m_musicFadeCurrentTime += rTime;
+        if (m_musicFadeCurrentTime >= m_musicFadeTime)
+        {
+            m_musicFadeTime = 0.0f;
+            m_currentMusic->SetVolume(m_musicVolume);
+        }
+        else
+        {
+            m_currentMusic->SetVolume((m_musicFadeCurrentTime / m_musicFadeTime) * m_musicVolume);
+        }
+    }
+
     auto it = m_oldMusic.begin();
     while (it != m_oldMusic.end())
     {
@@ -569,6 +936,8 @@ void CALSound::FrameMove(float rTime)
             m_previousMusic.music->SetVolume(((m_previousMusic.fadeTime-m_previousMusic.currentTime) / m_previousMusic.fadeTime) * m_musicVolume);
         }
     }
+
+    m_musicMutex.Unlock();
 }
 
 void CALSound::SetListener(const Math::Vector &eye, const Math::Vector &lookat)
@@ -592,29 +961,45 @@ void CALSound::PlayMusic(const std::string &filename, bool repeat, float fadeTim
 
     m_thread.Start([this, filename, repeat, fadeTime]()
     {
-        CBuffer* buffer = nullptr;
+        std::unique_ptr<CMusicStream> stream;
 
-        // check if we have music in cache
-        if (m_music.find(filename) == m_music.end())
+        // check if we have music stream already opened
+        m_musicMutex.Lock();
+        auto it = m_music.find(filename);
+        if (it != m_music.end())
         {
-            GetLogger()->Debug("Music %s was not cached!\n", filename.c_str());
+            stream = std::move(it->second);
+            m_music.erase(it);
+        }
+        m_musicMutex.Unlock();
 
-            auto newBuffer = MakeUnique<CBuffer>();
-            buffer = newBuffer.get();
-            if (!newBuffer->LoadFromFile(filename, static_cast<SoundType>(-1)))
+        if (stream == nullptr)
+        {
+            GetLogger()->Debug(LOG_CATEGORY_SOUND, "Music %s was not cached!\n", filename.c_str());
+
+            stream = MakeUnique<CMusicStream>();
+            if (!stream->Open(filename))
             {
                 return;
             }
-            m_music[filename] = std::move(newBuffer);
         }
         else
         {
-            GetLogger()->Debug("Music loaded from cache\n");
-            buffer = m_music[filename].get();
+            GetLogger()->Debug(LOG_CATEGORY_SOUND, "Music loaded from cache\n");
         }
 
+        stream->SetLoop(repeat);
+
+        m_musicMutex.Lock();
+
+        // fade in only when replacing music that can still be heard
+        bool crossfade = m_previousMusic.music != nullptr &&
+                         m_previousMusic.currentTime < m_previousMusic.fadeTime;
+
         if (m_currentMusic)
         {
+            crossfade = crossfade || m_currentMusic->IsPlaying();
+
             OldMusic old;
             old.music = std::move(m_currentMusic);
             old.fadeTime = fadeTime;
@@ -622,16 +1007,19 @@ void CALSound::PlayMusic(const std::string &filename, bool repeat, float fadeTim
             m_oldMusic.push_back(std::move(old));
         }
 
-        m_currentMusic = MakeUnique<CChannel>();
-        m_currentMusic->SetBuffer(buffer);
-        m_currentMusic->SetVolume(m_musicVolume);
-        m_currentMusic->SetLoop(repeat);
+        m_currentMusic = std::move(stream);
+        m_musicFadeTime = crossfade ? fadeTime : 0.0f;
+        m_musicFadeCurrentTime = 0.0f;
+        m_currentMusic->SetVolume(m_musicFadeTime > 0.0f ? 0.0f : m_musicVolume);
         m_currentMusic->Play();
+
+        m_musicMutex.Unlock();
     });
 }
 
 void CALSound::PlayPauseMusic(const std::string &filename, bool repeat)
 {
+    m_musicMutex.Lock();
     if (m_previousMusic.fadeTime > 0.0f)
     {
         if (m_currentMusic != nullptr)
@@ -652,6 +1040,7 @@ void CALSound::PlayPauseMusic(const std::string &filename, bool repeat)
             m_previousMusic.currentTime = 0.0f;
         }
     }
+    m_musicMutex.Unlock();
     PlayMusic(filename, repeat);
 }
 
@@ -661,7 +1050,9 @@ void CALSound::StopPauseMusic()
     {
         StopMusic();
 
+        m_musicMutex.Lock();
         m_currentMusic = std::move(m_previousMusic.music);
+        m_musicFadeTime = 0.0f;
         if (m_currentMusic != nullptr)
         {
             m_currentMusic->SetVolume(m_musicVolume);
@@ -671,31 +1062,40 @@ void CALSound::StopPauseMusic()
             }
         }
         m_previousMusic.fadeTime = 0.0f;
+        m_musicMutex.Unlock();
     }
 }
 
 void CALSound::StopMusic(float fadeTime)
 {
-    if (!m_enabled || m_currentMusic == nullptr)
+    if (!m_enabled)
     {
         return;
     }
 
-    OldMusic old;
-    old.music = std::move(m_currentMusic);
-    old.fadeTime = fadeTime;
-    old.currentTime = 0.0f;
-    m_oldMusic.push_back(std::move(old));
+    m_musicMutex.Lock();
+    if (m_currentMusic != nullptr)
+    {
+        OldMusic old;
+        old.music = std::move(m_currentMusic);
+        old.fadeTime = fadeTime;
+        old.currentTime = 0.0f;
+        m_oldMusic.push_back(std::move(old));
+    }
+    m_musicMutex.Unlock();
 }
 
 bool CALSound::IsPlayingMusic()
 {
-    if (!m_enabled || m_currentMusic == nullptr)
+    if (!m_enabled)
     {
         return false;
     }
 
-    return m_currentMusic->IsPlaying();
+    m_musicMutex.Lock();
+    bool playing = m_currentMusic != nullptr && m_currentMusic->IsPlaying();
+    m_musicMutex.Unlock();
+    return playing;
 }
 
 bool CALSound::CheckChannel(int &channel)
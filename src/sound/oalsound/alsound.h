@@ -26,16 +26,20 @@
 
 #include "sound/sound.h"
 
+#include "common/thread/sdl_mutex_wrapper.h"
+#include "common/thread/thread.h"
 #include "common/thread/worker_thread.h"
 
 #include "sound/oalsound/buffer.h"
 #include "sound/oalsound/channel.h"
 #include "sound/oalsound/check.h"
+#include "sound/oalsound/music_stream.h"
 
 #include <map>
 #include <memory>
 #include <string>
 #include <list>
+#include <vector>
 
 #include <al.h>
 
@@ -62,7 +66,7 @@ struct OldMusic
         return *this;
     }
 
-    std::unique_ptr<CChannel> music;
+    std::unique_ptr<CMusicStream> music;
     float fadeTime = 0.0f;
     float currentTime = 0.0f;
 
@@ -86,6 +90,7 @@ public:
     bool Create() override;
     void Reset() override;
     bool Cache(SoundType, const std::string &) override;
+    void CacheSounds(const std::map<SoundType, std::string> &files) override;
     void CacheMusic(const std::string &) override;
     bool IsCached(SoundType) override;
     bool IsCachedMusic(const std::string &) override;
@@ -108,6 +113,7 @@ public:
     bool Stop(int channel) override;
     bool StopAll() override;
     bool MuteAll(bool mute) override;
+    void GetVoiceCount(int &realVoices, int &virtualVoices) override;
 
     void PlayMusic(const std::string &filename, bool repeat, float fadeTime = 2.0f) override;
     void StopMusic(float fadeTime=2.0f) override;
@@ -122,6 +128,17 @@ private:
     bool SearchFreeBuffer(SoundType sound, int &channel, bool &alreadyLoaded);
     bool CheckChannel(int &channel);
 
+    //! Returns the volume at which the channel is heard at the listener position
+    float GetLoudness(CChannel* channel);
+    //! Returns an unused OpenAL source, creating it within the limit of real voices
+    bool AcquireSource(ALuint &source);
+    //! Gives a source to a new audible channel, taking it from a less important channel if needed
+    void PromoteChannel(CChannel* channel);
+    //! Gives sources to the most important audible channels and takes them from the other ones
+    void UpdateVoices();
+    //! Loop of the thread refilling buffers of the music streams
+    void StreamMusic();
+
     bool m_enabled;
     float m_audioVolume;
     float m_musicVolume;
@@ -129,11 +146,28 @@ private:
     ALCdevice* m_device;
     ALCcontext* m_context;
     std::map<SoundType, std::unique_ptr<CBuffer>> m_sounds;
-    std::map<std::string, std::unique_ptr<CBuffer>> m_music;
     std::map<int, std::unique_ptr<CChannel>> m_channels;
-    std::unique_ptr<CChannel> m_currentMusic;
+    //! OpenAL sources not used by any channel
+    std::vector<ALuint> m_freeSources;
+    //! Number of OpenAL sources created for channels
+    unsigned int m_sourceCount;
+    //! Maximum number of channels played on OpenAL sources
+    unsigned int m_sourcesLimit;
+    float m_voiceUpdateTime;
+    int m_realVoices;
+    int m_virtualVoices;
+    //! Music streams opened in advance by CacheMusic, ready to start
+    std::map<std::string, std::unique_ptr<CMusicStream>> m_music;
+    std::unique_ptr<CMusicStream> m_currentMusic;
+    //! Fade in of the current music when crossfading with the previous one
+    float m_musicFadeTime;
+    float m_musicFadeCurrentTime;
     std::list<OldMusic> m_oldMusic;
     OldMusic m_previousMusic;
+    //! Protects the music streams, used by the loading and streaming threads
+    CSDLMutexWrapper m_musicMutex;
+    bool m_streaming;
+    std::unique_ptr<CThread> m_streamThread;
     Math::Vector m_eye;
     Math::Vector m_lookat;
     CWorkerThread m_thread;
@@ -24,6 +24,7 @@
 
 #include "sound/oalsound/check.h"
 
+#include <array>
 #include <cstddef>
 #include <memory>
 
@@ -41,26 +42,66 @@ CBuffer::~CBuffer()
     {
         alDeleteBuffers(1, &m_buffer);
         if (CheckOpenALError())
-            GetLogger()->Debug("Failed to unload buffer. Code %d\n", GetOpenALErrorCode());
+            GetLogger()->Debug(LOG_CATEGORY_SOUND, "Failed to unload buffer. Code %d\n", GetOpenALErrorCode());
     }
 }
 
 bool CBuffer::LoadFromFile(std::string filename, SoundType sound)
 {
-    m_sound = sound;
-    GetLogger()->Debug("Loading audio file: %s\n", filename.c_str());
+    std::vector<short> samples;
+    int channels = 0;
+    int sampleRate = 0;
+    if (!DecodeFile(filename, samples, channels, sampleRate))
+    {
+        m_sound = sound;
+        m_loaded = false;
+        return false;
+    }
+
+    return LoadFromSamples(samples.data(), samples.size(), channels, sampleRate, sound);
+}
+
+bool CBuffer::DecodeFile(const std::string& filename, std::vector<short>& samples, int& channels, int& sampleRate)
+{
+    GetLogger()->Debug(LOG_CATEGORY_SOUND, "Loading audio file: %s\n", filename.c_str());
 
     auto file = CResourceManager::GetSNDFileHandler(filename);
 
-    GetLogger()->Trace("  channels %d\n", file->GetFileInfo().channels);
-    GetLogger()->Trace("  format %d\n", file->GetFileInfo().format);
-    GetLogger()->Trace("  frames %d\n", file->GetFileInfo().frames);
-    GetLogger()->Trace("  samplerate %d\n", file->GetFileInfo().samplerate);
-    GetLogger()->Trace("  sections %d\n", file->GetFileInfo().sections);
+    GetLogger()->Trace(LOG_CATEGORY_SOUND, "  channels %d\n", file->GetFileInfo().channels);
+    GetLogger()->Trace(LOG_CATEGORY_SOUND, "  format %d\n", file->GetFileInfo().format);
+    GetLogger()->Trace(LOG_CATEGORY_SOUND, "  frames %d\n", file->GetFileInfo().frames);
+    GetLogger()->Trace(LOG_CATEGORY_SOUND, "  samplerate %d\n", file->GetFileInfo().samplerate);
+    GetLogger()->Trace(LOG_CATEGORY_SOUND, "  sections %d\n", file->GetFileInfo().sections);
 
     if (!file->IsOpen())
     {
         GetLogger()->Warn("Could not load file %s. Reason: %s\n", filename.c_str(), file->GetLastError().c_str());
+        return false;
+    }
+
+    channels = file->GetFileInfo().channels;
+    sampleRate = file->GetFileInfo().samplerate;
+
+    // read chunks of 4096 samples
+    samples.clear();
+    samples.reserve(file->GetFileInfo().frames * channels);
+    std::array<short, 4096> buffer;
+    std::size_t read = 0;
+    while ((read = file->Read(buffer.data(), buffer.size())) != 0)
+    {
+        samples.insert(samples.end(), buffer.begin(), buffer.begin() + read);
+    }
+
+    return true;
+}
+
+bool CBuffer::LoadFromSamples(const short* samples, std::size_t count, int channels, int sampleRate, SoundType sound)
+{
+    m_sound = sound;
+
+    if (channels != 1 && channels != 2)
+    {
+        GetLogger()->Warn("Unsupported number of audio channels: %d\n", channels);
         m_loaded = false;
         return false;
     }
@@ -73,19 +114,9 @@ bool CBuffer::LoadFromFile(std::string filename, SoundType sound)
         return false;
     }
 
-    // read chunks of 4096 samples
-    std::vector<uint16_t> data;
-    std::array<int16_t, 4096> buffer;
-    data.reserve(file->GetFileInfo().frames);
-    std::size_t read = 0;
-    while ((read = file->Read(buffer.data(), buffer.size())) != 0)
-    {
-        data.insert(data.end(), buffer.begin(), buffer.begin() + read);
-    }
-
-    ALenum format = file->GetFileInfo().channels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
-    alBufferData(m_buffer, format, &data.front(), data.size() * sizeof(uint16_t), file->GetFileInfo().samplerate);
-    m_duration = static_cast<float>(file->GetFileInfo().frames) / file->GetFileInfo().samplerate;
+    ALenum format = channels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+    alBufferData(m_buffer, format, samples, count * sizeof(short), sampleRate);
+    m_duration = static_cast<float>(count / channels) / sampleRate;
     m_loaded = true;
     return true;
 }
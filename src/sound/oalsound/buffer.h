@@ -26,9 +26,9 @@
 
 #include "sound/sound.h"
 
+#include <cstddef>
 #include <string>
 #include <vector>
-#include <array>
 
 #include <al.h>
 
@@ -39,8 +39,13 @@ public:
     ~CBuffer();
 
     bool LoadFromFile(std::string, SoundType);
+    //! Creates the buffer from 16-bit samples decoded earlier, interleaved if there are two channels
+    bool LoadFromSamples(const short* samples, std::size_t count, int channels, int sampleRate, SoundType);
     bool IsLoaded();
 
+    //! Decodes the whole file into 16-bit samples
+    static bool DecodeFile(const std::string& filename, std::vector<short>& samples, int& channels, int& sampleRate);
+
     SoundType GetSoundType();
     ALuint GetBuffer();
     float GetDuration();
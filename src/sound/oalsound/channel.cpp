@@ -17,14 +17,16 @@
  * along with this program. If not, see http://gnu.org/licenses
  */
 
-
 #include "sound/oalsound/channel.h"
 
 #include "sound/oalsound/buffer.h"
 
+#include <cmath>
+
 CChannel::CChannel()
     : m_buffer(nullptr),
       m_source(0),
+      m_hasSource(false),
       m_priority(0),
       m_id(0),
       m_startAmplitude(0.0f),
@@ -32,96 +34,135 @@ CChannel::CChannel()
       m_changeFrequency(0.0f),
       m_initFrequency(0.0f),
       m_volume(0.0f),
-      m_ready(false),
+      m_gain(1.0f),
+      m_frequency(1.0f),
       m_loop(false),
-      m_mute(false)
+      m_mute(false),
+      m_playing(false),
+      m_paused(false),
+      m_time(0.0f),
+      m_relativeToListener(false)
 {
-    alGenSources(1, &m_source);
-
-    if (CheckOpenALError())
-    {
-        GetLogger()->Debug("Failed to create sound source. Code: %d\n", GetOpenALErrorCode());
-        m_ready = false;
-    }
-    else
-    {
-        m_ready = true;
-    }
 }
 
 CChannel::~CChannel()
 {
-    if (m_ready)
+    if (m_hasSource)
     {
         alSourceStop(m_source);
         alSourcei(m_source, AL_BUFFER, 0);
         alDeleteSources(1, &m_source);
         if (CheckOpenALError())
-            GetLogger()->Debug("Failed to delete sound source. Code: %d\n", GetOpenALErrorCode());
+            GetLogger()->Debug(LOG_CATEGORY_SOUND, "Failed to delete sound source. Code: %d\n", GetOpenALErrorCode());
     }
 }
 
 bool CChannel::Play()
 {
-    if (!m_ready || m_buffer == nullptr)
+    if (m_buffer == nullptr)
     {
         return false;
     }
 
+    // like OpenAL, continue if paused and start over otherwise
+    if (!m_paused)
+    {
+        m_time = 0.0f;
+    }
+    m_playing = true;
+    m_paused = false;
+
+    if (!m_hasSource)
+    {
+        return true;
+    }
+
     alSourcei(m_source, AL_LOOPING, static_cast<ALint>(m_loop));
-    alSourcei(m_source, AL_REFERENCE_DISTANCE, 10.0f);
-    alSourcei(m_source, AL_MAX_DISTANCE, 110.0f);
+    alSourcef(m_source, AL_REFERENCE_DISTANCE, SOUND_REFERENCE_DISTANCE);
+    alSourcef(m_source, AL_MAX_DISTANCE, SOUND_MAX_DISTANCE);
     alSourcePlay(m_source);
     if (CheckOpenALError())
     {
-        GetLogger()->Debug("Could not play audio sound source. Code: %d\n", GetOpenALErrorCode());
+        GetLogger()->Debug(LOG_CATEGORY_SOUND, "Could not play audio sound source. Code: %d\n", GetOpenALErrorCode());
     }
     return true;
 }
 
 bool CChannel::Pause()
 {
-    if (!m_ready || !IsPlaying())
+    if (!IsPlaying())
     {
         return false;
     }
 
+    m_paused = true;
+
+    if (!m_hasSource)
+    {
+        return true;
+    }
+
     alSourcePause(m_source);
     if (CheckOpenALError())
     {
-        GetLogger()->Debug("Could not pause audio sound source. Code: %d\n", GetOpenALErrorCode());
+        GetLogger()->Debug(LOG_CATEGORY_SOUND, "Could not pause audio sound source. Code: %d\n", GetOpenALErrorCode());
     }
     return true;
 }
 
 bool CChannel::SetPosition(const Math::Vector &pos, bool relativeToListener)
 {
-    if (!m_ready || m_buffer == nullptr)
+    if (m_buffer == nullptr)
     {
         return false;
     }
 
+    m_position = pos;
+    m_relativeToListener = relativeToListener;
+
+    if (!m_hasSource)
+    {
+        return true;
+    }
+
     alSource3f(m_source, AL_POSITION, pos.x, pos.y, pos.z);
     alSourcei(m_source, AL_SOURCE_RELATIVE, relativeToListener);
     if (CheckOpenALError())
     {
-        GetLogger()->Debug("Could not set sound position. Code: %d\n", GetOpenALErrorCode());
+        GetLogger()->Debug(LOG_CATEGORY_SOUND, "Could not set sound position. Code: %d\n", GetOpenALErrorCode());
         return false;
     }
     return true;
 }
 
+const Math::Vector& CChannel::GetPosition()
+{
+    return m_position;
+}
+
+bool CChannel::IsRelativeToListener()
+{
+    return m_relativeToListener;
+}
+
 bool CChannel::SetFrequency(float freq)
 {
-    if (!m_ready || m_buffer == nullptr)
+    if (m_buffer == nullptr)
     {
         return false;
     }
 
+    m_frequency = freq;
+
+    if (!m_hasSource)
+    {
+        return true;
+    }
+
     alSourcef(m_source, AL_PITCH, freq);
     if (CheckOpenALError())
     {
-        GetLogger()->Debug("Could not set sound pitch to '%f'. Code: %d\n", freq, GetOpenALErrorCode());
+        GetLogger()->Debug(LOG_CATEGORY_SOUND, "Could not set sound pitch to '%f'. Code: %d\n", freq, GetOpenALErrorCode());
         return false;
     }
     return true;
@@ -129,33 +170,32 @@ bool CChannel::SetFrequency(float freq)
 
 float CChannel::GetFrequency()
 {
-    ALfloat freq;
-    if (!m_ready || m_buffer == nullptr)
-    {
-        return 0;
-    }
-
-    alGetSourcef(m_source, AL_PITCH, &freq);
-    if (CheckOpenALError())
+    if (m_buffer == nullptr)
     {
-        GetLogger()->Debug("Could not get sound pitch. Code: %d\n", GetOpenALErrorCode());
         return 0;
     }
 
-    return freq;
+    return m_frequency;
 }
 
 bool CChannel::SetVolume(float vol)
 {
-    if (!m_ready || vol < 0 || m_buffer == nullptr)
+    if (vol < 0 || m_buffer == nullptr)
     {
         return false;
     }
 
+    m_gain = vol;
+
+    if (!m_hasSource)
+    {
+        return true;
+    }
+
     alSourcef(m_source, AL_GAIN, vol);
     if (CheckOpenALError())
     {
-        GetLogger()->Debug("Could not set sound volume to '%f'. Code: %d\n", vol, GetOpenALErrorCode());
+        GetLogger()->Debug(LOG_CATEGORY_SOUND, "Could not set sound volume to '%f'. Code: %d\n", vol, GetOpenALErrorCode());
         return false;
     }
     return true;
@@ -163,20 +203,12 @@ bool CChannel::SetVolume(float vol)
 
 float CChannel::GetVolume()
 {
-    ALfloat vol;
-    if (!m_ready || m_buffer == nullptr)
+    if (m_buffer == nullptr)
     {
         return 0;
     }
 
-    alGetSourcef(m_source, AL_GAIN, &vol);
-    if (CheckOpenALError())
-    {
-        GetLogger()->Debug("Could not get sound volume. Code: %d\n", GetOpenALErrorCode());
-        return 0;
-    }
-
-    return vol;
+    return m_gain;
 }
 
 void CChannel::SetVolumeAtrib(float volume)
@@ -246,7 +278,7 @@ void CChannel::ResetOper()
 
 SoundType CChannel::GetSoundType()
 {
-    if (!m_ready || m_buffer == nullptr)
+    if (m_buffer == nullptr)
     {
         return SOUND_NONE;
     }
@@ -256,35 +288,37 @@ SoundType CChannel::GetSoundType()
 
 bool CChannel::SetBuffer(CBuffer *buffer)
 {
-    if (!m_ready)
-        return false;
-
     Stop();
     m_buffer = buffer;
-    if (buffer == nullptr)
+    m_initFrequency = m_frequency;
+
+    if (!m_hasSource)
     {
-        alSourcei(m_source, AL_BUFFER, 0);
         return true;
     }
 
-    alSourcei(m_source, AL_BUFFER, buffer->GetBuffer());
+    alSourcei(m_source, AL_BUFFER, buffer != nullptr ? buffer->GetBuffer() : 0);
     if (CheckOpenALError())
     {
         GetLogger()->Warn("Could not set sound buffer. Code: %d\n", GetOpenALErrorCode());
         return false;
     }
-    m_initFrequency = GetFrequency();
     return true;
 }
 
 bool CChannel::IsPlaying()
 {
-    ALint status;
-    if (!m_ready || m_buffer == nullptr)
+    if (m_buffer == nullptr || !m_playing)
     {
         return false;
     }
 
+    if (!m_hasSource)
+    {
+        return !m_paused;
+    }
+
+    ALint status;
     alGetSourcei(m_source, AL_SOURCE_STATE, &status);
     if (CheckOpenALError())
     {
@@ -292,12 +326,12 @@ bool CChannel::IsPlaying()
         return false;
     }
 
-    return status == AL_PLAYING;
-}
+    if (status == AL_STOPPED)
+    {
+        m_playing = false;
+    }
 
-bool CChannel::IsReady()
-{
-    return m_ready;
+    return status == AL_PLAYING;
 }
 
 bool CChannel::IsLoaded()
@@ -307,11 +341,20 @@ bool CChannel::IsLoaded()
 
 bool CChannel::Stop()
 {
-    if (!m_ready || m_buffer == nullptr)
+    if (m_buffer == nullptr)
     {
         return false;
     }
 
+    m_playing = false;
+    m_paused = false;
+    m_time = 0.0f;
+
+    if (!m_hasSource)
+    {
+        return true;
+    }
+
     alSourceStop(m_source);
     if (CheckOpenALError())
     {
@@ -323,11 +366,16 @@ bool CChannel::Stop()
 
 float CChannel::GetCurrentTime()
 {
-    if (!m_ready || m_buffer == nullptr)
+    if (m_buffer == nullptr)
     {
         return 0.0f;
     }
 
+    if (!m_hasSource)
+    {
+        return m_time;
+    }
+
     ALfloat current;
     alGetSourcef(m_source, AL_SEC_OFFSET, &current);
     if (CheckOpenALError())
@@ -340,7 +388,14 @@ float CChannel::GetCurrentTime()
 
 void CChannel::SetCurrentTime(float current)
 {
-    if (!m_ready || m_buffer == nullptr)
+    if (m_buffer == nullptr)
+    {
+        return;
+    }
+
+    m_time = current;
+
+    if (!m_hasSource)
     {
         return;
     }
@@ -354,7 +409,7 @@ void CChannel::SetCurrentTime(float current)
 
 float CChannel::GetDuration()
 {
-    if (!m_ready || m_buffer == nullptr)
+    if (m_buffer == nullptr)
     {
         return 0.0f;
     }
@@ -362,6 +417,103 @@ float CChannel::GetDuration()
     return m_buffer->GetDuration();
 }
 
+bool CChannel::IsVirtual()
+{
+    return !m_hasSource;
+}
+
+void CChannel::Realize(ALuint source)
+{
+    if (m_hasSource)
+    {
+        return;
+    }
+
+    m_source = source;
+    m_hasSource = true;
+
+    alSourcei(m_source, AL_BUFFER, m_buffer != nullptr ? m_buffer->GetBuffer() : 0);
+    alSourcei(m_source, AL_LOOPING, static_cast<ALint>(m_loop));
+    alSourcef(m_source, AL_REFERENCE_DISTANCE, SOUND_REFERENCE_DISTANCE);
+    alSourcef(m_source, AL_MAX_DISTANCE, SOUND_MAX_DISTANCE);
+    alSourcef(m_source, AL_GAIN, m_gain);
+    alSourcef(m_source, AL_PITCH, m_frequency);
+    alSource3f(m_source, AL_POSITION, m_position.x, m_position.y, m_position.z);
+    alSourcei(m_source, AL_SOURCE_RELATIVE, m_relativeToListener);
+
+    if (m_playing && m_buffer != nullptr)
+    {
+        alSourcef(m_source, AL_SEC_OFFSET, m_time);
+        alSourcePlay(m_source);
+        if (m_paused)
+            alSourcePause(m_source);
+    }
+
+    if (CheckOpenALError())
+    {
+        GetLogger()->Debug(LOG_CATEGORY_SOUND, "Could not restore sound on audio source. Code: %d\n", GetOpenALErrorCode());
+    }
+}
+
+ALuint CChannel::Virtualize()
+{
+    if (!m_hasSource)
+    {
+        return 0;
+    }
+
+    if (m_playing)
+    {
+        ALint status;
+        alGetSourcei(m_source, AL_SOURCE_STATE, &status);
+        if (status == AL_STOPPED)
+        {
+            m_playing = false;
+            m_time = 0.0f;
+        }
+        else
+        {
+            alGetSourcef(m_source, AL_SEC_OFFSET, &m_time);
+        }
+    }
+
+    alSourceStop(m_source);
+    alSourcei(m_source, AL_BUFFER, 0);
+    if (CheckOpenALError())
+    {
+        GetLogger()->Debug(LOG_CATEGORY_SOUND, "Could not release audio source. Code: %d\n", GetOpenALErrorCode());
+    }
+
+    m_hasSource = false;
+    ALuint source = m_source;
+    m_source = 0;
+    return source;
+}
+
+void CChannel::UpdateVirtual(float rTime)
+{
+    if (m_hasSource || !m_playing || m_paused || m_buffer == nullptr)
+    {
+        return;
+    }
+
+    m_time += rTime * m_frequency;
+
+    float duration = m_buffer->GetDuration();
+    if (m_time >= duration)
+    {
+        if (m_loop && duration > 0.0f)
+        {
+            m_time = fmodf(m_time, duration);
+        }
+        else
+        {
+            m_playing = false;
+            m_time = 0.0f;
+        }
+    }
+}
+
 bool CChannel::HasEnvelope()
 {
     return m_oper.size() > 0;
@@ -401,4 +553,3 @@ int CChannel::GetId()
 {
     return m_id;
 }
-
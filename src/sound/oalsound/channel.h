@@ -39,6 +39,11 @@
 
 class CBuffer;
 
+//! Distance up to which sounds are played at full volume
+const float SOUND_REFERENCE_DISTANCE = 10.0f;
+//! Distance from which sounds can no longer be heard
+const float SOUND_MAX_DISTANCE = 110.0f;
+
 struct SoundOper
 {
     float finalAmplitude = 0.0f;
@@ -49,6 +54,13 @@ struct SoundOper
 };
 
 
+/**
+ * \class CChannel
+ * \brief Sound effect played on an OpenAL source, or tracked virtually without one
+ *
+ * A virtual channel keeps its state and play time, so that it can continue
+ * on a source given later by Realize().
+ */
 class CChannel
 {
 public:
@@ -60,6 +72,8 @@ public:
     bool Stop();
 
     bool SetPosition(const Math::Vector &pos, bool relativeToListener = false);
+    const Math::Vector& GetPosition();
+    bool IsRelativeToListener();
 
     bool SetFrequency(float freq);
     float GetFrequency();
@@ -74,11 +88,19 @@ public:
     float GetVolumeAtrib();
 
     bool IsPlaying();
-    bool IsReady();
     bool IsLoaded();
 
     bool SetBuffer(CBuffer *buffer);
 
+    //! Returns true if the channel has no OpenAL source
+    bool IsVirtual();
+    //! Gives the channel an OpenAL source and continues playing on it
+    void Realize(ALuint source);
+    //! Takes the OpenAL source from the channel, which continues playing virtually
+    ALuint Virtualize();
+    //! Advances the play time of a virtual channel
+    void UpdateVirtual(float rTime);
+
     bool HasEnvelope();
     SoundOper& GetEnvelope();
     void PopEnvelope();
@@ -108,6 +130,7 @@ public:
 private:
     CBuffer *m_buffer;
     ALuint m_source;
+    bool m_hasSource;
 
     int m_priority;
     int m_id;
@@ -116,10 +139,17 @@ private:
     float m_changeFrequency;
     float m_initFrequency;
     float m_volume;
+    //! Gain and pitch of the source
+    float m_gain;
+    float m_frequency;
     std::deque<SoundOper> m_oper;
-    bool m_ready;
     bool m_loop;
     bool m_mute;
+    //! Playing or paused, the state of a source must be checked too
+    bool m_playing;
+    bool m_paused;
+    //! Play time of a virtual channel
+    float m_time;
     Math::Vector m_position;
+    bool m_relativeToListener;
 };
-
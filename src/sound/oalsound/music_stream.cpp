@@ -0,0 +1,259 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "sound/oalsound/music_stream.h"
+
+#include "common/resources/resourcemanager.h"
+#include "common/resources/sndfile_wrapper.h"
+
+namespace
+{
+
+//! Number of frames decoded into one buffer (about 0.2 s at 44.1 kHz)
+const int STREAM_CHUNK_FRAMES = 8192;
+
+} // anonymous namespace
+
+
+CMusicStream::CMusicStream()
+    : m_source(0),
+      m_buffers(),
+      m_format(AL_FORMAT_STEREO16),
+      m_sampleRate(0),
+      m_ready(false),
+      m_loop(false),
+      m_playing(false),
+      m_finished(false)
+{
+    alGenSources(1, &m_source);
+    if (CheckOpenALError())
+    {
+        GetLogger()->Debug(LOG_CATEGORY_SOUND, "Failed to create music source. Code: %d\n", GetOpenALErrorCode());
+        return;
+    }
+
+    alGenBuffers(BUFFER_COUNT, m_buffers.data());
+    if (CheckOpenALError())
+    {
+        GetLogger()->Debug(LOG_CATEGORY_SOUND, "Failed to create music buffers. Code: %d\n", GetOpenALErrorCode());
+        alDeleteSources(1, &m_source);
+        return;
+    }
+
+    // Music is not positioned in the world
+    alSourcei(m_source, AL_SOURCE_RELATIVE, AL_TRUE);
+    alSource3f(m_source, AL_POSITION, 0.0f, 0.0f, 0.0f);
+
+    m_freeBuffers.assign(m_buffers.begin(), m_buffers.end());
+    m_ready = true;
+}
+
+CMusicStream::~CMusicStream()
+{
+    if (m_ready)
+    {
+        alSourceStop(m_source);
+        alSourcei(m_source, AL_BUFFER, 0);
+        alDeleteSources(1, &m_source);
+        alDeleteBuffers(BUFFER_COUNT, m_buffers.data());
+        if (CheckOpenALError())
+            GetLogger()->Debug(LOG_CATEGORY_SOUND, "Failed to delete music source. Code: %d\n", GetOpenALErrorCode());
+    }
+}
+
+bool CMusicStream::Open(const std::string &filename)
+{
+    if (!m_ready)
+    {
+        return false;
+    }
+
+    GetLogger()->Debug(LOG_CATEGORY_SOUND, "Opening music stream: %s\n", filename.c_str());
+
+    m_file = CResourceManager::GetSNDFileHandler(filename);
+    if (!m_file->IsOpen())
+    {
+        GetLogger()->Warn("Could not load file %s. Reason: %s\n", filename.c_str(), m_file->GetLastError().c_str());
+        m_file.reset();
+        return false;
+    }
+
+    int channels = m_file->GetFileInfo().channels;
+    if (channels != 1 && channels != 2)
+    {
+        GetLogger()->Warn("Could not stream file %s. Unsupported number of channels: %d\n", filename.c_str(), channels);
+        m_file.reset();
+        return false;
+    }
+
+    m_format = channels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+    m_sampleRate = m_file->GetFileInfo().samplerate;
+    m_data.resize(STREAM_CHUNK_FRAMES * channels);
+
+    Update();
+    return true;
+}
+
+bool CMusicStream::FillBuffer(ALuint buffer)
+{
+    if (m_finished && !m_loop)
+    {
+        return false;
+    }
+    m_finished = false;
+
+    std::size_t filled = 0;
+    bool rewound = false;
+    while (filled < m_data.size())
+    {
+        sf_count_t read = m_file->Read(m_data.data() + filled, m_data.size() - filled);
+        if (read > 0)
+        {
+            filled += read;
+            rewound = false;
+            continue;
+        }
+
+        // end of file; rewinding twice in a row means there is nothing to play
+        if (!m_loop || rewound)
+        {
+            m_finished = true;
+            break;
+        }
+        m_file->Seek(0, SEEK_SET);
+        rewound = true;
+    }
+
+    if (filled == 0)
+    {
+        return false;
+    }
+
+    alBufferData(buffer, m_format, m_data.data(), filled * sizeof(short), m_sampleRate);
+    alSourceQueueBuffers(m_source, 1, &buffer);
+    if (CheckOpenALError())
+    {
+        GetLogger()->Debug(LOG_CATEGORY_SOUND, "Could not queue music buffer. Code: %d\n", GetOpenALErrorCode());
+        return false;
+    }
+    return true;
+}
+
+void CMusicStream::Update()
+{
+    if (!m_ready || m_file == nullptr)
+    {
+        return;
+    }
+
+    ALint processed = 0;
+    alGetSourcei(m_source, AL_BUFFERS_PROCESSED, &processed);
+    while (processed-- > 0)
+    {
+        ALuint buffer = 0;
+        alSourceUnqueueBuffers(m_source, 1, &buffer);
+        m_freeBuffers.push_back(buffer);
+    }
+
+    while (!m_freeBuffers.empty() && FillBuffer(m_freeBuffers.back()))
+    {
+        m_freeBuffers.pop_back();
+    }
+
+    if (!m_playing)
+    {
+        return;
+    }
+
+    ALint state = AL_STOPPED;
+    ALint queued = 0;
+    alGetSourcei(m_source, AL_SOURCE_STATE, &state);
+    alGetSourcei(m_source, AL_BUFFERS_QUEUED, &queued);
+    if (state != AL_PLAYING)
+    {
+        if (queued > 0)
+        {
+            GetLogger()->Trace(LOG_CATEGORY_SOUND, "Music stream ran out of data, restarting playback\n");
+            alSourcePlay(m_source);
+        }
+        else
+        {
+            m_playing = false;
+        }
+    }
+}
+
+bool CMusicStream::Play()
+{
+    if (!m_ready || m_file == nullptr)
+    {
+        return false;
+    }
+
+    alSourcePlay(m_source);
+    if (CheckOpenALError())
+    {
+        GetLogger()->Debug(LOG_CATEGORY_SOUND, "Could not play music stream. Code: %d\n", GetOpenALErrorCode());
+        return false;
+    }
+    m_playing = true;
+    return true;
+}
+
+bool CMusicStream::Pause()
+{
+    if (!m_ready || !m_playing)
+    {
+        return false;
+    }
+
+    alSourcePause(m_source);
+    if (CheckOpenALError())
+    {
+        GetLogger()->Debug(LOG_CATEGORY_SOUND, "Could not pause music stream. Code: %d\n", GetOpenALErrorCode());
+    }
+    m_playing = false;
+    return true;
+}
+
+bool CMusicStream::SetVolume(float vol)
+{
+    if (!m_ready || vol < 0)
+    {
+        return false;
+    }
+
+    alSourcef(m_source, AL_GAIN, vol);
+    if (CheckOpenALError())
+    {
+        GetLogger()->Debug(LOG_CATEGORY_SOUND, "Could not set music volume to '%f'. Code: %d\n", vol, GetOpenALErrorCode());
+        return false;
+    }
+    return true;
+}
+
+void CMusicStream::SetLoop(bool loop)
+{
+    m_loop = loop;
+}
+
+bool CMusicStream::IsPlaying()
+{
+    return m_playing;
+}
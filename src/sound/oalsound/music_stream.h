@@ -0,0 +1,87 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file music_stream.h
+ * \brief OpenAL streamed music source
+ */
+
+#pragma once
+
+#include "sound/oalsound/check.h"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <al.h>
+
+class CSNDFileWrapper;
+
+/**
+ * \class CMusicStream
+ * \brief Music source decoded in small chunks into a ring of queued buffers
+ *
+ * Only the queued chunks are kept in memory instead of the whole decoded track.
+ * Update() has to be called regularly to refill buffers already played.
+ */
+class CMusicStream
+{
+public:
+    CMusicStream();
+    ~CMusicStream();
+
+    CMusicStream(const CMusicStream&) = delete;
+    CMusicStream& operator=(const CMusicStream&) = delete;
+
+    //! Opens the file and decodes the first chunks so that playback can start immediately
+    bool Open(const std::string &filename);
+
+    bool Play();
+    bool Pause();
+
+    bool SetVolume(float vol);
+    void SetLoop(bool loop);
+
+    //! Returns true until the end of a non-looping track has been played
+    bool IsPlaying();
+
+    //! Refills and requeues buffers that were already played
+    void Update();
+
+private:
+    bool FillBuffer(ALuint buffer);
+
+    static const int BUFFER_COUNT = 4;
+
+    std::unique_ptr<CSNDFileWrapper> m_file;
+    ALuint m_source;
+    std::array<ALuint, BUFFER_COUNT> m_buffers;
+    //! Buffers not queued on the source
+    std::vector<ALuint> m_freeBuffers;
+    //! Decoding chunk
+    std::vector<short> m_data;
+    ALenum m_format;
+    int m_sampleRate;
+    bool m_ready;
+    bool m_loop;
+    bool m_playing;
+    bool m_finished;
+};
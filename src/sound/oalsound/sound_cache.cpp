@@ -0,0 +1,166 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "sound/oalsound/sound_cache.h"
+
+#include "common/logger.h"
+#include "common/make_unique.h"
+
+#include "common/resources/mapped_file.h"
+#include "common/resources/outputstream.h"
+
+#include <cstdint>
+#include <cstring>
+
+
+namespace
+{
+
+//! Directory of the cache, relative to the save location
+const std::string CACHE_DIRECTORY = "cache";
+//! Name of the cache file in the cache directory
+const std::string CACHE_FILE = "sounds.cache";
+//! Identifies sound cache files
+const char CACHE_MAGIC[4] = { 'C', 'S', 'N', 'D' };
+//! Version of the file layout
+const uint32_t CACHE_VERSION = 2;
+
+/*
+ * Layout of the cache file, following the header of CCacheDirectory:
+ *   CacheHeader
+ *   CacheSound[soundCount]
+ *   samples of each sound, aligned to CCacheDirectory::ALIGNMENT
+ */
+
+struct CacheHeader
+{
+    uint32_t soundCount;
+};
+
+struct CacheSound
+{
+    uint32_t channels;
+    uint32_t sampleRate;
+    //! Offset of the samples from the start of the file
+    uint64_t offset;
+    uint64_t count;
+};
+
+} // anonymous namespace
+
+
+CSoundCache::CSoundCache()
+    : m_directory(CACHE_DIRECTORY, CACHE_MAGIC, CACHE_VERSION)
+{
+}
+
+CSoundCache::~CSoundCache()
+{
+}
+
+bool CSoundCache::IsEnabled() const
+{
+    return m_directory.IsEnabled();
+}
+
+bool CSoundCache::Load(const std::string& key, std::vector<SoundSamples>& sounds)
+{
+    Close();
+
+    auto file = MakeUnique<CMappedFile>();
+    CacheHeader header;
+    std::size_t tableOffset = 0;
+    if (!m_directory.OpenRead(CACHE_FILE, key, *file, &header, sizeof(header), tableOffset))
+        return false;
+
+    const char* data = file->GetData();
+    std::size_t size = file->GetSize();
+
+    if (size < tableOffset + header.soundCount * sizeof(CacheSound))
+        return false;
+
+    std::vector<CacheSound> table(header.soundCount);
+    memcpy(table.data(), data + tableOffset, table.size() * sizeof(CacheSound));
+
+    std::vector<SoundSamples> newSounds;
+    for (const CacheSound& entry : table)
+    {
+        if (entry.offset % CCacheDirectory::ALIGNMENT != 0 || entry.offset + entry.count * sizeof(short) > size)
+            return false;
+
+        SoundSamples sound;
+        sound.samples = reinterpret_cast<const short*>(data + entry.offset);
+        sound.count = entry.count;
+        sound.channels = entry.channels;
+        sound.sampleRate = entry.sampleRate;
+        newSounds.push_back(sound);
+    }
+
+    m_file = std::move(file);
+    sounds = std::move(newSounds);
+    return true;
+}
+
+void CSoundCache::Close()
+{
+    m_file.reset();
+}
+
+bool CSoundCache::Store(const std::string& key, const std::vector<SoundSamples>& sounds)
+{
+    CacheHeader header;
+    header.soundCount = sounds.size();
+
+    COutputStream stream;
+    std::size_t position = 0;
+    if (!m_directory.OpenWrite(CACHE_FILE, key, stream, &header, sizeof(header), position))
+        return false;
+
+    std::vector<CacheSound> table;
+    std::size_t offset = CCacheDirectory::Align(position + sounds.size() * sizeof(CacheSound));
+    for (const SoundSamples& sound : sounds)
+    {
+        CacheSound entry;
+        entry.channels = sound.channels;
+        entry.sampleRate = sound.sampleRate;
+        entry.offset = offset;
+        entry.count = sound.count;
+        table.push_back(entry);
+
+        offset = CCacheDirectory::Align(offset + sound.count * sizeof(short));
+    }
+
+    stream.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(CacheSound));
+    position += table.size() * sizeof(CacheSound);
+
+    for (std::size_t i = 0; i < sounds.size(); ++i)
+    {
+        CCacheDirectory::WritePadding(stream, position, table[i].offset);
+        stream.write(reinterpret_cast<const char*>(sounds[i].samples), sounds[i].count * sizeof(short));
+        position += sounds[i].count * sizeof(short);
+    }
+
+    bool ok = stream.good();
+    stream.close();
+
+    if (!ok)
+        GetLogger()->Warn("Couldn't write sound cache file\n");
+
+    return ok;
+}
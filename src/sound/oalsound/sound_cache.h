@@ -0,0 +1,82 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file sound/oalsound/sound_cache.h
+ * \brief On-disk cache of decoded sound effects - CSoundCache class
+ */
+
+#pragma once
+
+#include "common/resources/cache_directory.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+class CMappedFile;
+
+/**
+ * \struct SoundSamples
+ * \brief Decoded 16-bit samples of one sound file
+ *
+ * The samples are not owned; they point to a decoded buffer or to the mapped cache file.
+ */
+struct SoundSamples
+{
+    const short* samples = nullptr;
+    //! Number of samples of all channels
+    std::size_t count = 0;
+    //! Number of channels, 0 if the file could not be decoded
+    int channels = 0;
+    int sampleRate = 0;
+};
+
+/**
+ * \class CSoundCache
+ * \brief Cache of decoded sound effects
+ *
+ * Samples of all sound effects are stored uncompressed in one file in the cache
+ * directory of the save location. The key identifies the sound files, so that
+ * the samples can be used again on the next start without decoding the files.
+ */
+class CSoundCache
+{
+public:
+    //! Creates the cache directory; the cache is disabled if there is no save location
+    CSoundCache();
+    ~CSoundCache();
+
+    //! Returns true if the cache can be used
+    bool IsEnabled() const;
+
+    //! Maps the cache file stored with the given key and returns the samples of each sound in it
+    /** The samples stay valid until Close() is called. */
+    bool Load(const std::string& key, std::vector<SoundSamples>& sounds);
+    //! Unmaps the cache file opened by Load()
+    void Close();
+
+    //! Stores the samples of each sound with the given key
+    bool Store(const std::string& key, const std::vector<SoundSamples>& sounds);
+
+private:
+    CCacheDirectory m_directory;
+    std::unique_ptr<CMappedFile> m_file;
+};
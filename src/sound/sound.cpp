@@ -43,13 +43,14 @@ bool CSoundInterface::Create()
 
 void CSoundInterface::CacheAll()
 {
+    std::map<SoundType, std::string> files;
     for ( int i = 0; i < SOUND_MAX; i++ )
     {
         std::stringstream filename;
         filename << "sounds/sound" << std::setfill('0') << std::setw(3) << i << ".wav";
-        if ( !Cache(static_cast<SoundType>(i), filename.str()) )
-            GetLogger()->Warn("Unable to load audio: %s\n", filename.str().c_str());
+        files[static_cast<SoundType>(i)] = filename.str();
     }
+    CacheSounds(files);
 }
 
 void CSoundInterface::Reset()
@@ -61,6 +62,15 @@ bool CSoundInterface::Cache(SoundType sound, const std::string &file)
     return true;
 }
 
+void CSoundInterface::CacheSounds(const std::map<SoundType, std::string> &files)
+{
+    for (const auto& file : files)
+    {
+        if ( !Cache(file.first, file.second) )
+            GetLogger()->Warn("Unable to load audio: %s\n", file.second.c_str());
+    }
+}
+
 void CSoundInterface::CacheMusic(const std::string &file)
 {
 }
@@ -151,6 +161,12 @@ bool CSoundInterface::MuteAll(bool mute)
     return true;
 }
 
+void CSoundInterface::GetVoiceCount(int &realVoices, int &virtualVoices)
+{
+    realVoices = 0;
+    virtualVoices = 0;
+}
+
 void CSoundInterface::PlayMusic(const std::string &filename, bool repeat, float fadeTime)
 {
 }
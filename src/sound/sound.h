@@ -26,6 +26,7 @@
 
 #include "sound/sound_type.h"
 
+#include <map>
 #include <string>
 
 namespace Math
@@ -68,7 +69,7 @@ public:
     virtual bool Create();
 
     /** Function called to cache all sound effect files.
-     *  Function calls \link CSoundInterface::Cache() \endlink for each file
+     *  Function calls \link CSoundInterface::CacheSounds() \endlink with all files
      */
     void CacheAll();
 
@@ -84,6 +85,13 @@ public:
      */
     virtual bool Cache(SoundType sound, const std::string &file);
 
+    /** Function called to cache many sound effect files at once.
+     *  By default calls \link CSoundInterface::Cache() \endlink for each file.
+     *  Plugins may override it to load the files in parallel.
+     * \param files - files to load for each sound id
+     */
+    virtual void CacheSounds(const std::map<SoundType, std::string> &files);
+
     /** Function called to cache music file.
      *  This function is called by CRobotMain for each file used in the mission.
      *  This function is executed asynchronously
@@ -205,6 +213,12 @@ public:
      */
     virtual bool MuteAll(bool mute);
 
+    /** Returns the number of playing sound effects
+     * \param realVoices - number of sounds played by the audio device
+     * \param virtualVoices - number of sounds only tracked, because they are too quiet or less important
+     */
+    virtual void GetVoiceCount(int &realVoices, int &virtualVoices);
+
     /** Start playing music
      * This function is executed asynchronously
      * \param filename - name of file to play
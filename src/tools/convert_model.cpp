@@ -68,7 +68,7 @@ void PrintUsage(const std::string& program)
 
     std::cerr << "Model formats:" << std::endl;
     std::cerr << " old       => old binary format" << std::endl;
-    std::cerr << " new_bin   => new binary format" << std::endl;
+    std::cerr << " new_bin   => new binary format (written as version 3, fastest to load)" << std::endl;
     std::cerr << " new_txt   => new text format" << std::endl;
 }
 
@@ -124,7 +124,6 @@ bool CColor::EventProcess(const Event &event)
 // Draw the button.
 void CColor::Draw()
 {
-    Gfx::CDevice* device;
     Gfx::VertexCol  vertex[4];  // 2 triangles
     Gfx::Color   color;
     Math::Point     p1, p2;
@@ -155,8 +154,7 @@ void CColor::Draw()
     vertex[2] = Gfx::VertexCol(Math::Vector(p2.x, p1.y, 0.0f), color);
     vertex[3] = Gfx::VertexCol(Math::Vector(p2.x, p2.y, 0.0f), color);
 
-    device = m_engine->GetDevice();
-    device->DrawPrimitive(Gfx::PRIMITIVE_TRIANGLE_STRIP, vertex, 4);
+    m_engine->DrawInterfaceStrip(vertex, 4);
     m_engine->AddStatisticTriangle(2);
 }
 
@@ -606,13 +606,10 @@ void CControl::DrawPart(int icon, float zoom, float ex)
 void CControl::DrawIcon(Math::Point pos, Math::Point dim, Math::Point uv1, Math::Point uv2,
                         float ex)
 {
-    Gfx::CDevice*   device;
     Gfx::Vertex     vertex[8];  // 6 triangles
     Math::Point     p1, p2, p3, p4;
     Math::Vector    n;
 
-    device = m_engine->GetDevice();
-
     p1.x = pos.x;
     p1.y = pos.y;
     p2.x = pos.x + dim.x;
@@ -627,7 +624,7 @@ void CControl::DrawIcon(Math::Point pos, Math::Point dim, Math::Point uv1, Math:
         vertex[2] = Gfx::Vertex(Math::Vector(p2.x, p1.y, 0.0f), n, Math::Point(uv2.x,uv2.y));
         vertex[3] = Gfx::Vertex(Math::Vector(p2.x, p2.y, 0.0f), n, Math::Point(uv2.x,uv1.y));
 
-        device->DrawPrimitive(Gfx::PRIMITIVE_TRIANGLE_STRIP, vertex, 4);
+        m_engine->DrawInterfaceStrip(vertex, 4);
         m_engine->AddStatisticTriangle(2);
     }
     else    // 3 pieces?
@@ -646,7 +643,7 @@ void CControl::DrawIcon(Math::Point pos, Math::Point dim, Math::Point uv1, Math:
             vertex[6] = Gfx::Vertex(Math::Vector(p2.x, p1.y, 0.0f), n, Math::Point(uv2.x,   uv2.y));
             vertex[7] = Gfx::Vertex(Math::Vector(p2.x, p2.y, 0.0f), n, Math::Point(uv2.x,   uv1.y));
 
-            device->DrawPrimitive(Gfx::PRIMITIVE_TRIANGLE_STRIP, vertex, 8);
+            m_engine->DrawInterfaceStrip(vertex, 8);
             m_engine->AddStatisticTriangle(6);
         }
         else
@@ -663,7 +660,7 @@ void CControl::DrawIcon(Math::Point pos, Math::Point dim, Math::Point uv1, Math:
             vertex[6] = Gfx::Vertex(Math::Vector(p2.x, p2.y, 0.0f), n, Math::Point(uv2.x, uv1.y     ));
             vertex[7] = Gfx::Vertex(Math::Vector(p1.x, p2.y, 0.0f), n, Math::Point(uv1.x, uv1.y     ));
 
-            device->DrawPrimitive(Gfx::PRIMITIVE_TRIANGLE_STRIP, vertex, 8);
+            m_engine->DrawInterfaceStrip(vertex, 8);
             m_engine->AddStatisticTriangle(6);
         }
     }
@@ -674,13 +671,10 @@ void CControl::DrawIcon(Math::Point pos, Math::Point dim, Math::Point uv1, Math:
 void CControl::DrawIcon(Math::Point pos, Math::Point dim, Math::Point uv1, Math::Point uv2,
                         Math::Point corner, float ex)
 {
-    Gfx::CDevice* device;
     Gfx::Vertex    vertex[8];  // 6 triangles
     Math::Point     p1, p2, p3, p4;
     Math::Vector    n;
 
-    device = m_engine->GetDevice();
-
     p1.x = pos.x;
     p1.y = pos.y;
     p2.x = pos.x + dim.x;
@@ -709,7 +703,7 @@ void CControl::DrawIcon(Math::Point pos, Math::Point dim, Math::Point uv1, Math:
     vertex[5] = Gfx::Vertex(Math::Vector(p4.x, p3.y, 0.0f), n, Math::Point(uv2.x - ex, uv2.y - ex));
     vertex[6] = Gfx::Vertex(Math::Vector(p2.x, p1.y, 0.0f), n, Math::Point(uv2.x,      uv2.y     ));
     vertex[7] = Gfx::Vertex(Math::Vector(p2.x, p3.y, 0.0f), n, Math::Point(uv2.x,      uv2.y - ex));
-    device->DrawPrimitive(Gfx::PRIMITIVE_TRIANGLE_STRIP, vertex, 8);
+    m_engine->DrawInterfaceStrip(vertex, 8);
     m_engine->AddStatisticTriangle(6);
 
     // Central horizontal band.
@@ -721,7 +715,7 @@ void CControl::DrawIcon(Math::Point pos, Math::Point dim, Math::Point uv1, Math:
     vertex[5] = Gfx::Vertex(Math::Vector(p4.x, p4.y, 0.0f), n, Math::Point(uv2.x - ex, uv1.y + ex));
     vertex[6] = Gfx::Vertex(Math::Vector(p2.x, p3.y, 0.0f), n, Math::Point(uv2.x,      uv2.y - ex));
     vertex[7] = Gfx::Vertex(Math::Vector(p2.x, p4.y, 0.0f), n, Math::Point(uv2.x,      uv1.y + ex));
-    device->DrawPrimitive(Gfx::PRIMITIVE_TRIANGLE_STRIP, vertex, 8);
+    m_engine->DrawInterfaceStrip(vertex, 8);
     m_engine->AddStatisticTriangle(6);
 
     // Top horizontal band.
@@ -733,7 +727,7 @@ void CControl::DrawIcon(Math::Point pos, Math::Point dim, Math::Point uv1, Math:
     vertex[5] = Gfx::Vertex(Math::Vector(p4.x, p2.y, 0.0f), n, Math::Point(uv2.x - ex, uv1.y   ));
     vertex[6] = Gfx::Vertex(Math::Vector(p2.x, p4.y, 0.0f), n, Math::Point(uv2.x,      uv1.y + ex));
     vertex[7] = Gfx::Vertex(Math::Vector(p2.x, p2.y, 0.0f), n, Math::Point(uv2.x,      uv1.y   ));
-    device->DrawPrimitive(Gfx::PRIMITIVE_TRIANGLE_STRIP, vertex, 8);
+    m_engine->DrawInterfaceStrip(vertex, 8);
     m_engine->AddStatisticTriangle(6);
 }
 
@@ -42,6 +42,7 @@
 #include <SDL.h>
 #include <boost/algorithm/string.hpp>
 
+#include <algorithm>
 #include <cstring>
 
 namespace Ui
@@ -141,6 +142,11 @@ CEdit::CEdit()
 
     m_bUndoForce = true;
     m_undoOper = OPERUNDO_SPEC;
+
+    m_changeStart = 0;
+    m_changeTail = 0;
+    m_changeLength = 0;
+    MarkChangedAll();
 }
 
 // Object's destructor.
@@ -1275,7 +1281,7 @@ void CEdit::DrawHorizontalGradient(Math::Point pos, Math::Point dim, Gfx::Color
         Gfx::VertexCol(Math::Vector(p2.x, p2.y, 0.0f), color2)
     };
 
-    m_engine->GetDevice()->DrawPrimitive(Gfx::PRIMITIVE_TRIANGLE_STRIP, quad, 4);
+    m_engine->DrawInterfaceStrip(quad, 4);
     m_engine->AddStatisticTriangle(2);
 }
 
@@ -1294,6 +1300,7 @@ void CEdit::SetText(const std::string& text, bool bNew)
 
     if ( !bNew )  UndoMemorize(OPERUNDO_SPEC);
 
+    MarkChangedAll();
     m_len = text.size();
 
     if( m_len >= GetMaxChar() ) m_len = GetMaxChar();
@@ -1467,6 +1474,7 @@ bool CEdit::ReadText(std::string filename)
     len = stream.size();
     len2 = len + 1;
 
+    MarkChangedAll();
     m_len = len;
     m_cursor1 = 0;
     m_cursor2 = 0;
@@ -1926,6 +1934,7 @@ void CEdit::SetMaxChar(int max)
 
     m_maxChar = max;
 
+    MarkChangedAll();
     m_text.resize( m_maxChar + 1, '\0' );
 
     m_format.clear();
@@ -2117,6 +2126,7 @@ bool CEdit::GetDisplaySpec()
 
 void CEdit::SetMultiFont(bool bMulti)
 {
+    MarkChangedAll();
     m_format.clear();
 
     if (bMulti)
@@ -2722,6 +2732,7 @@ void CEdit::InsertOne(char character)
 
     if ( m_len >= GetMaxChar() )  return;
 
+    MarkChanged(m_cursor1, m_cursor1);
     m_text.resize( m_text.size() + 1, '\0' );
     m_format.resize( m_format.size() + 1, m_fontType );
 
@@ -2784,6 +2795,7 @@ void CEdit::DeleteOne(int dir)
     }
 
     if ( m_cursor1 > m_cursor2 )  Math::Swap(m_cursor1, m_cursor2);
+    MarkChanged(m_cursor1, m_cursor2);
     hole = m_cursor2-m_cursor1;
     end = m_len-hole;
     for ( i=m_cursor1 ; i<end ; i++ )
@@ -2989,6 +3001,7 @@ bool CEdit::MinMaj(bool bMaj)
     c2 = m_cursor2;
     if ( c1 > c2 )  Math::Swap(c1, c2);  // always c1 <= c2
 
+    MarkChanged(c1, c2);
     for ( i=c1 ; i<c2 ; i++ )
     {
         character = static_cast<unsigned char>(m_text[i]);
@@ -3218,6 +3231,7 @@ bool CEdit::UndoRecall()
 
     if ( m_undo[0].text.empty() )  return false;
 
+    MarkChangedAll();
     m_len = m_undo[0].len;
     m_text = m_undo[0].text;
 
@@ -3239,10 +3253,66 @@ bool CEdit::UndoRecall()
 }
 
 
+// Gives the part of the text modified since the last call.
+// The text from oldEnd in the previous text is found at newEnd in
+// the current text. Returns false if the whole text must be considered
+// modified, e.g. after an undo or a change of the characters format.
+
+bool CEdit::TakeChangedRange(int &start, int &oldEnd, int &newEnd)
+{
+    bool    bPartial;
+
+    bPartial = !m_bChangedAll;
+    if ( m_bChanged )
+    {
+        start  = m_changeStart;
+        oldEnd = std::max(start, m_changeLength - m_changeTail);
+        newEnd = std::max(start, m_len - m_changeTail);
+    }
+    else
+    {
+        start  = 0;
+        oldEnd = 0;
+        newEnd = 0;
+    }
+
+    m_bChanged = false;
+    m_bChangedAll = false;
+    m_changeLength = m_len;
+    return bPartial;
+}
+
+// Memorizes that the characters between cursor1 and cursor2 are going to be modified.
+
+void CEdit::MarkChanged(int cursor1, int cursor2)
+{
+    if ( m_bChanged )
+    {
+        m_changeStart = std::min(m_changeStart, cursor1);
+        m_changeTail  = std::min(m_changeTail, m_len-cursor2);
+    }
+    else
+    {
+        m_changeStart = cursor1;
+        m_changeTail  = m_len-cursor2;
+        m_bChanged = true;
+    }
+}
+
+// Memorizes that the whole text is modified.
+
+void CEdit::MarkChangedAll()
+{
+    m_bChanged = false;
+    m_bChangedAll = true;
+}
+
+
 // Clears the format of all characters.
 
 bool CEdit::ClearFormat()
 {
+    MarkChangedAll();
     if ( m_format.empty() )
     {
         SetMultiFont(true);
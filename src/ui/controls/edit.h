@@ -176,6 +176,8 @@ public:
     bool        ClearFormat();
     bool        SetFormat(int cursor1, int cursor2, int format);
 
+    bool        TakeChangedRange(int &start, int &oldEnd, int &newEnd);
+
 protected:
     void        SendModifEvent();
     bool        IsLinkPos(Math::Point pos);
@@ -220,6 +222,9 @@ protected:
     void        UndoMemorize(OperUndo oper);
     bool        UndoRecall();
 
+    void        MarkChanged(int cursor1, int cursor2);
+    void        MarkChangedAll();
+
     void        UpdateScroll();
 
     void        SetFocus(CControl* control) override;
@@ -273,6 +278,12 @@ protected:
     bool        m_bUndoForce;
     OperUndo    m_undoOper;
     std::array<EditUndo, EDITUNDOMAX> m_undo;
+
+    bool        m_bChanged;         // true -> text modified since TakeChangedRange()
+    bool        m_bChangedAll;      // true -> whole text to be considered modified
+    int         m_changeStart;      // first modified character
+    int         m_changeTail;       // number of unmodified characters at the end
+    int         m_changeLength;     // length of the text at the last TakeChangedRange()
 };
 
 
@@ -957,19 +957,16 @@ void CMap::DrawHighlight(Math::Point pos)
 
 void CMap::DrawTriangle(Math::Point p1, Math::Point p2, Math::Point p3, Math::Point uv1, Math::Point uv2)
 {
-    Gfx::CDevice* device;
-    Gfx::VertexTex2  vertex[3];  // 1 triangle
+    Gfx::Vertex  vertex[3];  // 1 triangle
     Math::Vector    n;
 
-    device = m_engine->GetDevice();
-
     n = Math::Vector(0.0f, 0.0f, -1.0f);  // normal
 
-    vertex[0] = Gfx::VertexTex2(Math::Vector(p1.x, p1.y, 0.0f), n, Math::Point(uv1.x,uv1.y));
-    vertex[1] = Gfx::VertexTex2(Math::Vector(p2.x, p2.y, 0.0f), n, Math::Point(uv1.x,uv2.y));
-    vertex[2] = Gfx::VertexTex2(Math::Vector(p3.x, p3.y, 0.0f), n, Math::Point(uv2.x,uv2.y));
+    vertex[0] = Gfx::Vertex(Math::Vector(p1.x, p1.y, 0.0f), n, Math::Point(uv1.x,uv1.y));
+    vertex[1] = Gfx::Vertex(Math::Vector(p2.x, p2.y, 0.0f), n, Math::Point(uv1.x,uv2.y));
+    vertex[2] = Gfx::Vertex(Math::Vector(p3.x, p3.y, 0.0f), n, Math::Point(uv2.x,uv2.y));
 
-    device->DrawPrimitive(Gfx::PRIMITIVE_TRIANGLES, vertex, 3);
+    m_engine->DrawInterfaceStrip(vertex, 3);
     m_engine->AddStatisticTriangle(1);
 }
 
@@ -977,21 +974,18 @@ void CMap::DrawTriangle(Math::Point p1, Math::Point p2, Math::Point p3, Math::Po
 
 void CMap::DrawPenta(Math::Point p1, Math::Point p2, Math::Point p3, Math::Point p4, Math::Point p5, Math::Point uv1, Math::Point uv2)
 {
-    Gfx::CDevice* device;
-    Gfx::VertexTex2  vertex[5];  // 1 pentagon
+    Gfx::Vertex  vertex[5];  // 1 pentagon
     Math::Vector    n;
 
-    device = m_engine->GetDevice();
-
     n = Math::Vector(0.0f, 0.0f, -1.0f);  // normal
 
-    vertex[0] = Gfx::VertexTex2(Math::Vector(p1.x, p1.y, 0.0f), n, Math::Point(uv1.x,uv1.y));
-    vertex[1] = Gfx::VertexTex2(Math::Vector(p2.x, p2.y, 0.0f), n, Math::Point(uv1.x,uv2.y));
-    vertex[2] = Gfx::VertexTex2(Math::Vector(p5.x, p5.y, 0.0f), n, Math::Point(uv2.x,uv2.y));
-    vertex[3] = Gfx::VertexTex2(Math::Vector(p3.x, p3.y, 0.0f), n, Math::Point(uv2.x,uv2.y));
-    vertex[4] = Gfx::VertexTex2(Math::Vector(p4.x, p4.y, 0.0f), n, Math::Point(uv2.x,uv2.y));
+    vertex[0] = Gfx::Vertex(Math::Vector(p1.x, p1.y, 0.0f), n, Math::Point(uv1.x,uv1.y));
+    vertex[1] = Gfx::Vertex(Math::Vector(p2.x, p2.y, 0.0f), n, Math::Point(uv1.x,uv2.y));
+    vertex[2] = Gfx::Vertex(Math::Vector(p5.x, p5.y, 0.0f), n, Math::Point(uv2.x,uv2.y));
+    vertex[3] = Gfx::Vertex(Math::Vector(p3.x, p3.y, 0.0f), n, Math::Point(uv2.x,uv2.y));
+    vertex[4] = Gfx::Vertex(Math::Vector(p4.x, p4.y, 0.0f), n, Math::Point(uv2.x,uv2.y));
 
-    device->DrawPrimitive(Gfx::PRIMITIVE_TRIANGLE_STRIP, vertex, 5);
+    m_engine->DrawInterfaceStrip(vertex, 5);
     m_engine->AddStatisticTriangle(3);
 }
 
@@ -999,13 +993,10 @@ void CMap::DrawPenta(Math::Point p1, Math::Point p2, Math::Point p3, Math::Point
 
 void CMap::DrawVertex(Math::Point uv1, Math::Point uv2, float zoom)
 {
-    Gfx::CDevice* device;
-    Gfx::VertexTex2  vertex[4];  // 2 triangles
+    Gfx::Vertex  vertex[4];  // 2 triangles
     Math::Point     p1, p2, c;
     Math::Vector    n;
 
-    device = m_engine->GetDevice();
-
     p1.x = m_pos.x;
     p1.y = m_pos.y;
     p2.x = m_pos.x + m_dim.x;
@@ -1026,12 +1017,12 @@ void CMap::DrawVertex(Math::Point uv1, Math::Point uv2, float zoom)
 
     n = Math::Vector(0.0f, 0.0f, -1.0f);  // normal
 
-    vertex[0] = Gfx::VertexTex2(Math::Vector(p1.x, p1.y, 0.0f), n, Math::Point(uv1.x,uv2.y));
-    vertex[1] = Gfx::VertexTex2(Math::Vector(p1.x, p2.y, 0.0f), n, Math::Point(uv1.x,uv1.y));
-    vertex[2] = Gfx::VertexTex2(Math::Vector(p2.x, p1.y, 0.0f), n, Math::Point(uv2.x,uv2.y));
-    vertex[3] = Gfx::VertexTex2(Math::Vector(p2.x, p2.y, 0.0f), n, Math::Point(uv2.x,uv1.y));
+    vertex[0] = Gfx::Vertex(Math::Vector(p1.x, p1.y, 0.0f), n, Math::Point(uv1.x,uv2.y));
+    vertex[1] = Gfx::Vertex(Math::Vector(p1.x, p2.y, 0.0f), n, Math::Point(uv1.x,uv1.y));
+    vertex[2] = Gfx::Vertex(Math::Vector(p2.x, p1.y, 0.0f), n, Math::Point(uv2.x,uv2.y));
+    vertex[3] = Gfx::Vertex(Math::Vector(p2.x, p2.y, 0.0f), n, Math::Point(uv2.x,uv1.y));
 
-    device->DrawPrimitive(Gfx::PRIMITIVE_TRIANGLE_STRIP, vertex, 4);
+    m_engine->DrawInterfaceStrip(vertex, 4);
     m_engine->AddStatisticTriangle(2);
 }
 
@@ -222,14 +222,11 @@ void CShortcut::Draw()
 
 void CShortcut::DrawVertex(int icon, float zoom)
 {
-    Gfx::CDevice* device;
     Gfx::Vertex  vertex[4];  // 2 triangles
     Math::Point     p1, p2, c;
     Math::Vector    n;
     float       u1, u2, v1, v2, dp;
 
-    device = m_engine->GetDevice();
-
     p1.x = m_pos.x;
     p1.y = m_pos.y;
     p2.x = m_pos.x + m_dim.x;
@@ -262,7 +259,7 @@ void CShortcut::DrawVertex(int icon, float zoom)
     vertex[2] = Gfx::Vertex(Math::Vector(p2.x, p1.y, 0.0f), n, Math::Point(u2, v2));
     vertex[3] = Gfx::Vertex(Math::Vector(p2.x, p2.y, 0.0f), n, Math::Point(u2, v1));
 
-    device->DrawPrimitive(Gfx::PRIMITIVE_TRIANGLE_STRIP, vertex, 4);
+    m_engine->DrawInterfaceStrip(vertex, 4);
     m_engine->AddStatisticTriangle(2);
 }
 
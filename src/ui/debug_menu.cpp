@@ -25,6 +25,7 @@
 #include "common/stringutils.h"
 
 #include "graphics/engine/lightning.h"
+#include "graphics/engine/oldmodelmanager.h"
 #include "graphics/engine/terrain.h"
 
 #include "level/robotmain.h"
@@ -86,7 +87,7 @@ void CDebugMenu::CreateInterface()
     CButton* pb;
 
     ddim.x = 4*dim.x+4*ox;
-    ddim.y = 222.0f/480.0f;
+    ddim.y = 222.0f/480.0f+dim.y*0.5f;
     pos.x = 1.0f-ddim.x;
     pos.y = oy+sy*3.0f;
     pw->CreateGroup(pos, ddim, 6, EVENT_WINDOW7);
@@ -94,7 +95,7 @@ void CDebugMenu::CreateInterface()
     ddim.x = ddim.x - 4*ox;
     ddim.y = dim.y*0.5f;
     pos.x += 2*ox;
-    pos.y = oy+sy*9.0f;
+    pos.y = oy+sy*9.0f+dim.y*0.5f;
     pb = pw->CreateButton(pos, ddim, -1, EVENT_DBG_SPAWN_OBJ);
     pb->SetName("Spawn object");
     pos.y -= ddim.y;
@@ -122,6 +123,9 @@ void CDebugMenu::CreateInterface()
     pos.y -= 0.048f;
     pb = pw->CreateButton(pos, ddim, -1, EVENT_DBG_LIGHTS_DUMP);
     pb->SetName("Dump lights to log");
+    pos.y -= ddim.y;
+    pb = pw->CreateButton(pos, ddim, -1, EVENT_DBG_MODELS_DUMP);
+    pb->SetName("Dump model memory to log");
 
     UpdateInterface();
 }
@@ -322,6 +326,10 @@ bool CDebugMenu::EventProcess(const Event &event)
             m_engine->DebugDumpLights();
             break;
 
+        case EVENT_DBG_MODELS_DUMP:
+            m_engine->GetModelManager()->DebugDumpModels();
+            break;
+
 
         case EVENT_SPAWN_CANCEL:
             DestroyInterface();
@@ -412,6 +412,7 @@ void CScreenSetupGame::ChangeSetupButtons()
     if ( pli != nullptr )
     {
         m_settings->SetLanguage(static_cast<Language>(pli->GetSelect()-1));
+        m_engine->PrewarmText();
         // TODO: A really ugly way to apply the change immediately
         m_main->ChangePhase(m_main->GetPhase());
     }
@@ -549,7 +549,7 @@ void CStudio::SearchToken(CEdit* edit)
 
 void CStudio::ColorizeScript(CEdit* edit)
 {
-    m_script->ColorizeScript(edit);
+    m_script->ColorizeScript(edit, m_colorizeCache);
 }
 
 
@@ -566,6 +566,7 @@ void CStudio::StartEditScript(CScript *script, std::string name, Program* progra
 
     m_script  = script;
     m_program = program;
+    m_colorizeCache.lines.clear();
 
     m_main->SetEditLock(true, true);
     m_main->SetEditFull(false);
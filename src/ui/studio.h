@@ -21,10 +21,11 @@
 
 #include "graphics/engine/camera.h"
 
+#include "script/script.h"
+
 #include <string>
 
 class CEventQueue;
-class CScript;
 class CSoundInterface;
 class CSettings;
 struct Program;
@@ -79,6 +80,7 @@ protected:
 
     Program*    m_program;
     CScript*    m_script;
+    CScript::ColorizeCache m_colorizeCache;
     Gfx::CameraType m_editCamera;
 
     bool        m_bEditMaximized;
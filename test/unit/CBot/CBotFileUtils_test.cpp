@@ -0,0 +1,362 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "CBot/CBot.h"
+#include "CBot/CBotFileUtils.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+using namespace CBot;
+
+TEST(CBotFileUtilsTest, BufferRoundTrip)
+{
+    CBotBufferWriter writer;
+    ASSERT_TRUE(WriteWord(writer, 12345));
+    ASSERT_TRUE(WriteShort(writer, -300));
+    ASSERT_TRUE(WriteInt(writer, std::numeric_limits<int>::min()));
+    ASSERT_TRUE(WriteLong(writer, 1L << 40));
+    ASSERT_TRUE(WriteFloat(writer, 3.25f));
+    ASSERT_TRUE(WriteDouble(writer, -1.0e100));
+    ASSERT_TRUE(WriteString(writer, "Hello world"));
+    ASSERT_TRUE(WriteString(writer, ""));
+    ASSERT_TRUE(WriteIntArray(writer, {1, -2, 300000, std::numeric_limits<int>::max()}));
+    ASSERT_TRUE(WriteFloatArray(writer, {0.5f, -0.25f}));
+    ASSERT_TRUE(WriteDoubleArray(writer, {}));
+
+    std::stringstream sstr;
+    ASSERT_TRUE(WriteBuffer(sstr, writer));
+
+    CBotBufferReader reader;
+    ASSERT_TRUE(ReadBuffer(sstr, reader));
+
+    unsigned short w;
+    short s;
+    int i;
+    long l;
+    float f;
+    double d;
+    std::string str1, str2;
+    std::vector<int> ints;
+    std::vector<float> floats;
+    std::vector<double> doubles;
+    ASSERT_TRUE(ReadWord(reader, w));
+    ASSERT_TRUE(ReadShort(reader, s));
+    ASSERT_TRUE(ReadInt(reader, i));
+    ASSERT_TRUE(ReadLong(reader, l));
+    ASSERT_TRUE(ReadFloat(reader, f));
+    ASSERT_TRUE(ReadDouble(reader, d));
+    ASSERT_TRUE(ReadString(reader, str1));
+    ASSERT_TRUE(ReadString(reader, str2));
+    ASSERT_TRUE(ReadIntArray(reader, ints));
+    ASSERT_TRUE(ReadFloatArray(reader, floats));
+    ASSERT_TRUE(ReadDoubleArray(reader, doubles));
+
+    EXPECT_EQ(12345, w);
+    EXPECT_EQ(-300, s);
+    EXPECT_EQ(std::numeric_limits<int>::min(), i);
+    EXPECT_EQ(1L << 40, l);
+    EXPECT_EQ(3.25f, f);
+    EXPECT_EQ(-1.0e100, d);
+    EXPECT_EQ("Hello world", str1);
+    EXPECT_EQ("", str2);
+    EXPECT_EQ(std::vector<int>({1, -2, 300000, std::numeric_limits<int>::max()}), ints);
+    EXPECT_EQ(std::vector<float>({0.5f, -0.25f}), floats);
+    EXPECT_TRUE(doubles.empty());
+
+    EXPECT_EQ(0u, reader.GetRemaining());
+    char c;
+    EXPECT_FALSE(ReadByte(reader, c));
+}
+
+TEST(CBotFileUtilsTest, BufferMatchesStreamEncoding)
+{
+    // values encoded into the buffer must stay readable with the stream functions
+    CBotBufferWriter writer;
+    ASSERT_TRUE(WriteInt(writer, -123456));
+    ASSERT_TRUE(WriteString(writer, "abc"));
+
+    std::stringstream sstr(std::string(writer.GetData(), writer.GetSize()));
+    int i;
+    std::string str;
+    ASSERT_TRUE(ReadInt(sstr, i));
+    ASSERT_TRUE(ReadString(sstr, str));
+    EXPECT_EQ(-123456, i);
+    EXPECT_EQ("abc", str);
+}
+
+TEST(CBotFileUtilsTest, ReadStreamCopiesBytes)
+{
+    std::stringstream data(std::string("\x01\x80\xff", 3));
+    std::stringstream sstr;
+    ASSERT_TRUE(WriteStream(sstr, data));
+
+    std::stringstream out;
+    ASSERT_TRUE(ReadStream(sstr, out));
+    EXPECT_EQ(std::string("\x01\x80\xff", 3), out.str());
+}
+
+class CBotStateUT : public testing::Test
+{
+public:
+    CBotStateUT()
+    {
+        CBotProgram::Init();
+        CBotProgram::AddFunction("WAIT", rWait, cWait);
+        CBotProgram::AddFunction("ASSERT", rAssert, cAssert);
+        m_waiting = false;
+        m_wait = true;
+        m_failed = false;
+    }
+
+    ~CBotStateUT()
+    {
+        CBotProgram::Free();
+    }
+
+protected:
+    static CBotTypResult cWait(CBotVar* &var, void* user)
+    {
+        if (var != nullptr) return CBotTypResult(CBotErrOverParam);
+        return CBotTypResult(CBotTypVoid);
+    }
+
+    static bool rWait(CBotVar* var, CBotVar* result, int& exception, void* user)
+    {
+        m_waiting = true;
+        return !m_wait; // false suspends the program in this call
+    }
+
+    static CBotTypResult cAssert(CBotVar* &var, void* user)
+    {
+        if (var == nullptr) return CBotTypResult(CBotErrLowParam);
+        if (var->GetType() != CBotTypBoolean) return CBotTypResult(CBotErrBadString);
+        var = var->GetNext();
+        return CBotTypResult(CBotTypVoid);
+    }
+
+    static bool rAssert(CBotVar* var, CBotVar* result, int& exception, void* user)
+    {
+        if (!var->GetValInt()) m_failed = true;
+        return true;
+    }
+
+    std::unique_ptr<CBotProgram> StartAndWait(const std::string& code)
+    {
+        auto program = std::unique_ptr<CBotProgram>(new CBotProgram());
+        std::vector<std::string> externFunctions;
+        EXPECT_TRUE(program->Compile(code, externFunctions));
+        EXPECT_EQ(1u, externFunctions.size());
+        if (externFunctions.empty()) return program;
+
+        EXPECT_TRUE(program->Start(externFunctions[0]));
+        while (!m_waiting)
+        {
+            if (program->Run()) break;
+        }
+        EXPECT_TRUE(m_waiting);
+        return program;
+    }
+
+    void Finish(CBotProgram* program)
+    {
+        m_wait = false;
+        while (!program->Run());
+
+        CBotError error;
+        int cursor1, cursor2;
+        program->GetError(error, cursor1, cursor2);
+        EXPECT_EQ(CBotNoErr, error);
+        EXPECT_FALSE(m_failed);
+    }
+
+    static bool m_waiting;
+    static bool m_wait;
+    static bool m_failed;
+};
+
+bool CBotStateUT::m_waiting = false;
+bool CBotStateUT::m_wait = true;
+bool CBotStateUT::m_failed = false;
+
+static const char* const LARGE_STATE_PROGRAM =
+    "extern void LargeState()\n"
+    "{\n"
+    "    int a[];\n"
+    "    float b[];\n"
+    "    double c[];\n"
+    "    string s[];\n"
+    "    int mixed[];\n"
+    "    for (int i = 0; i < 5000; ++i)\n"
+    "    {\n"
+    "        a[i] = i * 3 - 7000;\n"
+    "        b[i] = i / 4.0;\n"
+    "        c[i] = i * 1.5;\n"
+    "        if (i % 10 == 0) s[i/10] = \"item\" + i;\n"
+    "    }\n"
+    "    mixed[0] = 1;\n"
+    "    mixed[2] = 3;\n"
+    "    mixed[4] = 5;\n"
+    "    WAIT();\n"
+    "    for (int i = 0; i < 5000; ++i)\n"
+    "    {\n"
+    "        ASSERT(a[i] == i * 3 - 7000);\n"
+    "        ASSERT(b[i] == i / 4.0);\n"
+    "        ASSERT(c[i] == i * 1.5);\n"
+    "    }\n"
+    "    ASSERT(s[499] == \"item4990\");\n"
+    "    ASSERT(sizeof(mixed) == 5);\n"
+    "    ASSERT(mixed[0] == 1 && mixed[2] == 3 && mixed[4] == 5);\n"
+    "}\n";
+
+TEST_F(CBotStateUT, SaveRestoreLargeArrays)
+{
+    auto program = StartAndWait(LARGE_STATE_PROGRAM);
+    ASSERT_TRUE(m_waiting);
+
+    std::stringstream sstr;
+    ASSERT_TRUE(program->SaveState(sstr));
+    ASSERT_TRUE(program->RestoreState(sstr));
+
+    // a second round trip must give exactly the same data
+    std::stringstream first, second;
+    ASSERT_TRUE(program->SaveState(first));
+    ASSERT_TRUE(program->RestoreState(first));
+    ASSERT_TRUE(program->SaveState(second));
+    EXPECT_EQ(first.str(), second.str());
+
+    Finish(program.get());
+}
+
+TEST_F(CBotStateUT, RestoreOldVersion)
+{
+    // states saved before the version 105 had no size prefix
+    auto program = StartAndWait(LARGE_STATE_PROGRAM);
+    ASSERT_TRUE(m_waiting);
+
+    std::stringstream sstr;
+    ASSERT_TRUE(WriteLong(sstr, CBOTVERSION_COMPAT));
+    ASSERT_TRUE(WriteWord(sstr, 0)); // not running
+    ASSERT_TRUE(WriteLong(sstr, 42)); // following data must not be consumed
+    EXPECT_TRUE(program->RestoreState(sstr));
+
+    long next;
+    ASSERT_TRUE(ReadLong(sstr, next));
+    EXPECT_EQ(42, next);
+
+    std::stringstream unsupported;
+    ASSERT_TRUE(WriteLong(unsupported, CBOTVERSION_COMPAT - 1));
+    ASSERT_TRUE(WriteWord(unsupported, 0));
+    EXPECT_FALSE(program->RestoreState(unsupported));
+}
+
+static const char* const OLD_STATE_PROGRAM =
+    "extern void OldState()\n"
+    "{\n"
+    "    int a[];\n"
+    "    for (int i = 0; i < 4; ++i) a[i] = i * 10;\n"
+    "    float f = 2.5;\n"
+    "    string s = \"old\";\n"
+    "    int n = 0;\n"
+    "    while (n < 3)\n"
+    "    {\n"
+    "        n++;\n"
+    "        if (n == 2) WAIT();\n"
+    "    }\n"
+    "    ASSERT(n == 3);\n"
+    "    ASSERT(a[3] == 30 && f == 2.5 && s == \"old\");\n"
+    "}\n";
+
+// OLD_STATE_PROGRAM stopped in WAIT(), as saved by CBot version 104
+static const char OLD_STATE[] =
+    "\xe8\x00\x01\x08\x4f\x6c\x64\x53\x74\x61\x74\x65\x01\x01\x00\x00"
+    "\x00\x00\x00\x01\x02\x01\x00\x00\x00\x00\x01\x01\x05\x00\x00\x64"
+    "\x00\x04\x01\x00\x00\x00\x64\x00\x0a\x01\x01\x61\x0a\xff\xff\x03"
+    "\x04\x64\x00\x0b\x00\x00\x0b\xff\xff\x03\x04\x97\xce\x00\x64\x00"
+    "\x04\x01\x00\x00\x64\x00\x04\x01\x00\x0a\x64\x00\x04\x01\x00\x14"
+    "\x64\x00\x04\x01\x00\x1e\x00\x00\x64\x00\x06\x01\x01\x66\x80\x80"
+    "\x80\x81\x04\x64\x00\x09\x01\x01\x73\x03\x6f\x6c\x64\x64\x00\x04"
+    "\x01\x01\x6e\x02\x00\x01\x00\x01\x00\x00\x64\x00\x08\x01\x00\x01"
+    "\x00\x00\x01\x01\x01\x00\x00\x64\x00\x04\x01\x01\x6e\x01\x00\x00"
+    "\x01\x00\x01\x00\x00\x64\x00\x08\x01\x00\x01\x00\x00\x01\x00\x00"
+    "\x00\x00\x00\x00\x01\x00\x00\x00\x00\x00\x00\x01\x00\x01\x00\x00"
+    "\x00\x00\x01\x00\x00\x00\x00\x00\x00\x00";
+
+TEST_F(CBotStateUT, RestoreOldVersionRunning)
+{
+    CBotProgram program;
+    std::vector<std::string> externFunctions;
+    ASSERT_TRUE(program.Compile(OLD_STATE_PROGRAM, externFunctions));
+
+    std::stringstream sstr;
+    sstr.write(OLD_STATE, sizeof(OLD_STATE) - 1);
+    ASSERT_TRUE(WriteLong(sstr, 42)); // following data must not be consumed
+    ASSERT_TRUE(program.RestoreState(sstr));
+
+    // the program must continue in the suspended call, not start again
+    std::string functionName;
+    int start, end;
+    ASSERT_TRUE(program.GetRunPos(functionName, start, end));
+    EXPECT_EQ("OldState", functionName);
+    EXPECT_EQ("WAIT", std::string(OLD_STATE_PROGRAM).substr(start, end - start));
+
+    long next;
+    ASSERT_TRUE(ReadLong(sstr, next));
+    EXPECT_EQ(42, next);
+
+    Finish(&program);
+}
+
+// run with --gtest_also_run_disabled_tests
+TEST_F(CBotStateUT, DISABLED_SaveRestoreBenchmark)
+{
+    auto program = StartAndWait(LARGE_STATE_PROGRAM);
+    ASSERT_TRUE(m_waiting);
+
+    const int count = 20;
+    std::size_t size = 0;
+    std::chrono::steady_clock::duration saveTime{}, restoreTime{};
+    for (int i = 0; i < count; ++i)
+    {
+        std::stringstream sstr;
+        auto start = std::chrono::steady_clock::now();
+        ASSERT_TRUE(program->SaveState(sstr));
+        auto saved = std::chrono::steady_clock::now();
+        ASSERT_TRUE(program->RestoreState(sstr));
+        auto restored = std::chrono::steady_clock::now();
+
+        saveTime += saved - start;
+        restoreTime += restored - saved;
+        size = sstr.str().size();
+    }
+
+    auto toMs = [count](std::chrono::steady_clock::duration d)
+    {
+        return std::chrono::duration<double, std::milli>(d).count() / count;
+    };
+    RecordProperty("StateSize", static_cast<int>(size));
+    std::cout << "[ BENCH    ] state size " << size << " B, save " << toMs(saveTime)
+              << " ms, restore " << toMs(restoreTime) << " ms" << std::endl;
+
+    Finish(program.get());
+}
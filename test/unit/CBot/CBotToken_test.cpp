@@ -48,7 +48,7 @@ protected:
     {
         auto tokens = CBotToken::CompileTokens(code);
         ASSERT_TRUE(tokens != nullptr);
-        CBotToken* token = tokens.get()->GetNext(); // TODO: why do we always have to skip the first one :/
+        CBotToken* token = tokens->GetFirst()->GetNext(); // TODO: why do we always have to skip the first one :/
         ASSERT_TRUE(token != nullptr);
         unsigned int i = 0;
         do
@@ -122,3 +122,65 @@ TEST_F(CBotTokenUT, BasicProgram)
         {"}",           ID_CLBLK},
     });
 }
+
+TEST_F(CBotTokenUT, Operators)
+{
+    ExecuteTest("a>>>=b>>>c>>=d**e!=!f", {
+        {"a",    TokenTypVar},
+        {">>>=", ID_ASSSR},
+        {"b",    TokenTypVar},
+        {">>>",  ID_SR},
+        {"c",    TokenTypVar},
+        {">>=",  ID_ASSASR},
+        {"d",    TokenTypVar},
+        {"**",   ID_POWER},
+        {"e",    TokenTypVar},
+        {"!=",   ID_NE},
+        {"!",    ID_LOG_NOT},
+        {"f",    TokenTypVar},
+    });
+}
+
+TEST_F(CBotTokenUT, Literals)
+{
+    ExecuteTest("0x1F 0b101 1.5e-3 2.x '\\u0041' 'a' \"a\\\"b\" nan", {
+        {"0x1F",       TokenTypNum},
+        {"0b101",      TokenTypNum},
+        {"1.5e-3",     TokenTypNum},
+        {"2.",         TokenTypNum},
+        {"x",          TokenTypVar},
+        {"'\\u0041'",  TokenTypChar},
+        {"'a'",        TokenTypChar},
+        {"\"a\\\"b\"", TokenTypString},
+        {"nan",        ID_NAN},
+    });
+}
+
+TEST_F(CBotTokenUT, DefinedConstants)
+{
+    CBotToken::DefineNum("TestConstant", 42);
+    ExecuteTest("TestConstant TestConstants", {
+        {"TestConstant",  TokenTypDef},
+        {"TestConstants", TokenTypVar},
+    });
+}
+
+TEST_F(CBotTokenUT, TokenPositions)
+{
+    std::string code = "  /* a */ int x// b\n=10;";
+    auto tokens = CBotToken::CompileTokens(code);
+    ASSERT_TRUE(tokens != nullptr);
+    ASSERT_EQ(tokens->GetCount(), 7u); // separators, int, x, =, 10, ;, terminator
+
+    CBotToken* token = tokens->GetFirst();
+    EXPECT_EQ(token->GetStart(), 0);
+    EXPECT_EQ(token->GetEnd(), 0);
+    for (token = token->GetNext(); token->GetType() != TokenTypNone; token = token->GetNext())
+    {
+        EXPECT_EQ(code.substr(token->GetStart(), token->GetEnd() - token->GetStart()), token->GetString());
+    }
+    EXPECT_EQ(token->GetStart(), static_cast<int>(code.length()));
+    EXPECT_EQ(token->GetNext(), nullptr);
+
+    EXPECT_EQ(CBotToken::CompileTokens(""), nullptr);
+}
@@ -3326,3 +3326,168 @@ TEST_F(CBotUT, ClassTestSaveInheritedMembers)
         "}\n"
     );
 }
+
+TEST_F(CBotUT, CompileSharedReusesCode)
+{
+    const std::string code =
+        "int Twice(int x) { return x * 2; }\n"
+        "extern void TestShared()\n"
+        "{\n"
+        "    int a[];\n"
+        "    for (int i = 0; i < 10; ++i) a[i] = Twice(i);\n"
+        "    ASSERT(a[9] == 18);\n"
+        "}\n";
+
+    CBotProgram::ResetCacheStats();
+    std::vector<std::string> externFunctions;
+    auto first = std::unique_ptr<CBotProgram>(new CBotProgram());
+    auto second = std::unique_ptr<CBotProgram>(new CBotProgram());
+    auto other = std::unique_ptr<CBotProgram>(new CBotProgram());
+    ASSERT_TRUE(first->CompileShared(code, externFunctions, nullptr, 1));
+    ASSERT_TRUE(second->CompileShared(code, externFunctions, nullptr, 1));
+    ASSERT_EQ(1u, externFunctions.size());
+    EXPECT_EQ("TestShared", externFunctions[0]);
+    ASSERT_TRUE(other->CompileShared(code, externFunctions, nullptr, 2)); // different context
+
+    int hits, misses;
+    CBotProgram::GetCacheStats(hits, misses);
+    EXPECT_EQ(1, hits);
+    EXPECT_EQ(2, misses);
+
+    // both programs run independently on the same code
+    ASSERT_TRUE(first->Start("TestShared"));
+    ASSERT_TRUE(second->Start("TestShared"));
+    EXPECT_FALSE(first->Run(nullptr, 0));
+    EXPECT_FALSE(second->Run(nullptr, 0));
+
+    // the code stays alive as long as any program uses it
+    first.reset();
+    while (!second->Run());
+    CBotError error;
+    int cursor1, cursor2;
+    second->GetError(error, cursor1, cursor2);
+    EXPECT_EQ(CBotNoErr, error);
+
+    // programs with public functions are never shared
+    const std::string publicCode = "public void PublicShared() {}\n";
+    auto public1 = std::unique_ptr<CBotProgram>(new CBotProgram());
+    auto public2 = std::unique_ptr<CBotProgram>(new CBotProgram());
+    public1->CompileShared(publicCode, externFunctions, nullptr, 1);
+    public2->CompileShared(publicCode, externFunctions, nullptr, 1);
+    CBotProgram::GetCacheStats(hits, misses);
+    EXPECT_EQ(1, hits);
+    EXPECT_EQ(4, misses);
+}
+
+TEST_F(CBotUT, CompileSharedTracksPublicFunctions)
+{
+    const std::string code =
+        "extern void TestUsesPublic()\n"
+        "{\n"
+        "    ASSERT(PublicValue() == 1);\n"
+        "}\n";
+
+    CBotProgram::ResetCacheStats();
+    std::vector<std::string> externFunctions;
+    auto provider = std::unique_ptr<CBotProgram>(new CBotProgram());
+    ASSERT_TRUE(provider->Compile("public int PublicValue() { return 1; }\n", externFunctions, nullptr));
+
+    auto first = std::unique_ptr<CBotProgram>(new CBotProgram());
+    auto second = std::unique_ptr<CBotProgram>(new CBotProgram());
+    ASSERT_TRUE(first->CompileShared(code, externFunctions, nullptr, 1));
+    ASSERT_TRUE(second->CompileShared(code, externFunctions, nullptr, 1));
+
+    int hits, misses;
+    CBotProgram::GetCacheStats(hits, misses);
+    EXPECT_EQ(1, hits);
+    EXPECT_EQ(1, misses);
+
+    // the code compiled against the old public function must not be reused
+    ASSERT_TRUE(provider->Compile("public string PublicValue() { return \"1\"; }\n", externFunctions, nullptr));
+    auto third = std::unique_ptr<CBotProgram>(new CBotProgram());
+    EXPECT_FALSE(third->CompileShared(code, externFunctions, nullptr, 1));
+    CBotProgram::GetCacheStats(hits, misses);
+    EXPECT_EQ(1, hits);
+    EXPECT_EQ(2, misses);
+}
+
+namespace
+{
+
+int g_fullUpdates = 0;
+int g_fieldUpdates = 0;
+int g_testObjectUser = 0;
+CBotVar* g_testObject = nullptr;
+
+void uTestObject(CBotVar* thisVar, void* user)
+{
+    g_fullUpdates++;
+    CBotVar* pVar = thisVar->GetItemList();  // "lazy"
+    pVar->SetValInt(1);
+    pVar = pVar->GetNext();  // "eager"
+    pVar->SetValInt(2);
+}
+
+void uTestObjectLazy(CBotVar* field, void* user)
+{
+    g_fieldUpdates++;
+    field->SetValInt(1);
+}
+
+CBotTypResult cGetTestObject(CBotVar* &var, void* user)
+{
+    if (var != nullptr) return CBotTypResult(CBotErrOverParam);
+    return CBotTypResult(CBotTypPointer, "testobject");
+}
+
+bool rGetTestObject(CBotVar* var, CBotVar* result, int& exception, void* user)
+{
+    result->SetPointer(g_testObject);
+    return true;
+}
+
+} // anonymous namespace
+
+TEST_F(CBotUT, ClassFieldUpdateFunc)
+{
+    CBotClass* bc = CBotClass::Create("testobject", nullptr);
+    bc->AddItem("lazy", CBotTypResult(CBotTypInt), CBotVar::ProtectionLevel::ReadOnly);
+    bc->AddItem("eager", CBotTypResult(CBotTypInt), CBotVar::ProtectionLevel::ReadOnly);
+    bc->SetUpdateFunc(uTestObject);
+    ASSERT_TRUE(bc->SetFieldUpdateFunc("lazy", uTestObjectLazy));
+    EXPECT_FALSE(bc->SetFieldUpdateFunc("unknown", uTestObjectLazy));
+    CBotProgram::AddFunction("getTestObject", rGetTestObject, cGetTestObject);
+
+    g_testObject = CBotVar::Create("", CBotTypResult(CBotTypClass, "testobject"));
+    g_testObject->SetUserPtr(&g_testObjectUser);
+
+    // Reading a field with its own update function doesn't update the whole instance
+    g_fullUpdates = g_fieldUpdates = 0;
+    ExecuteTest(
+        "extern void TestLazyField()\n"
+        "{\n"
+        "    testobject o = getTestObject();\n"
+        "    ASSERT(o.lazy == 1);\n"
+        "    ASSERT(getTestObject().lazy == 1);\n"
+        "    testobject list[] = { getTestObject() };\n"
+        "    ASSERT(list[0].lazy == 1);\n"
+        "}\n"
+    );
+    EXPECT_EQ(3, g_fieldUpdates);
+    EXPECT_EQ(0, g_fullUpdates);
+
+    // Other fields still update the whole instance
+    g_fullUpdates = g_fieldUpdates = 0;
+    ExecuteTest(
+        "extern void TestEagerField()\n"
+        "{\n"
+        "    testobject o = getTestObject();\n"
+        "    ASSERT(o.eager == 2);\n"
+        "}\n"
+    );
+    EXPECT_EQ(0, g_fieldUpdates);
+    EXPECT_EQ(1, g_fullUpdates);
+
+    CBotVar::Destroy(g_testObject);
+    g_testObject = nullptr;
+}
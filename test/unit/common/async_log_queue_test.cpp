@@ -0,0 +1,256 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "common/async_log_queue.h"
+
+#include "common/make_unique.h"
+
+#include "common/thread/worker_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct LoggedMessage
+{
+    LogLevel level;
+    std::string text;
+};
+
+CAsyncLogQueue::WriteFunction CollectInto(std::vector<LoggedMessage>& messages)
+{
+    return [&messages](LogLevel level, const char* message, std::size_t length)
+    {
+        messages.push_back(LoggedMessage{level, std::string(message, length)});
+    };
+}
+
+void PushString(CAsyncLogQueue& queue, LogLevel level, const std::string& text)
+{
+    queue.Push(level, text.data(), text.size());
+}
+
+} // anonymous namespace
+
+TEST(CAsyncLogQueueTest, WritesMessagesInOrder)
+{
+    std::vector<LoggedMessage> messages;
+    {
+        CAsyncLogQueue queue(CollectInto(messages));
+        for (int i = 0; i < 100; i++)
+            PushString(queue, LOG_INFO, "message " + std::to_string(i));
+    }
+
+    ASSERT_EQ(100u, messages.size());
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_EQ(LOG_INFO, messages[i].level);
+        EXPECT_EQ("message " + std::to_string(i), messages[i].text);
+    }
+}
+
+TEST(CAsyncLogQueueTest, FlushWritesPendingMessages)
+{
+    std::vector<LoggedMessage> messages;
+    CAsyncLogQueue queue(CollectInto(messages));
+
+    PushString(queue, LOG_ERROR, "error");
+    queue.Flush();
+
+    ASSERT_EQ(1u, messages.size());
+    EXPECT_EQ(LOG_ERROR, messages[0].level);
+    EXPECT_EQ("error", messages[0].text);
+}
+
+TEST(CAsyncLogQueueTest, MessagesFromManyThreads)
+{
+    const int threadCount = 4;
+    const int messageCount = 500;
+
+    std::vector<LoggedMessage> messages;
+    {
+        CAsyncLogQueue queue(CollectInto(messages));
+        CWorkerPool pool(threadCount);
+        for (int t = 0; t < threadCount; t++)
+        {
+            pool.Start([&queue, t, messageCount]()
+            {
+                for (int i = 0; i < messageCount; i++)
+                    PushString(queue, LOG_DEBUG, std::to_string(t) + " " + std::to_string(i));
+            });
+        }
+        pool.WaitAll();
+    }
+
+    ASSERT_EQ(static_cast<std::size_t>(threadCount * messageCount), messages.size());
+
+    // Messages of a single thread keep their order
+    std::vector<int> next(threadCount, 0);
+    for (const auto& message : messages)
+    {
+        std::size_t space = message.text.find(' ');
+        int t = std::stoi(message.text.substr(0, space));
+        int i = std::stoi(message.text.substr(space + 1));
+        ASSERT_EQ(next[t], i);
+        next[t]++;
+    }
+}
+
+TEST(CAsyncLogQueueTest, KeepsOrderAcrossThreads)
+{
+    const int threadCount = 2;
+    const int messageCount = 200;
+
+    std::atomic<bool> writing{false};
+    std::atomic<bool> release{false};
+    std::vector<LoggedMessage> messages;
+    {
+        CAsyncLogQueue queue([&](LogLevel level, const char* message, std::size_t length)
+        {
+            // Hold the flush thread so that all messages are merged in a single drain
+            if (!writing)
+            {
+                writing = true;
+                while (!release) {}
+            }
+            messages.push_back(LoggedMessage{level, std::string(message, length)});
+        });
+
+        PushString(queue, LOG_ERROR, "first");
+        while (!writing) {}
+
+        // Threads take turns, so the order of the messages is known
+        std::atomic<int> turn{0};
+        CWorkerPool pool(threadCount);
+        for (int t = 0; t < threadCount; t++)
+        {
+            pool.Start([&queue, &turn, t, threadCount, messageCount]()
+            {
+                for (int i = t; i < messageCount; i += threadCount)
+                {
+                    while (turn != i) {}
+                    PushString(queue, LOG_DEBUG, std::to_string(i));
+                    turn++;
+                }
+            });
+        }
+        pool.WaitAll();
+        release = true;
+    }
+
+    ASSERT_EQ(static_cast<std::size_t>(messageCount + 1), messages.size());
+    for (int i = 0; i < messageCount; i++)
+        EXPECT_EQ(std::to_string(i), messages[i + 1].text);
+}
+
+TEST(CAsyncLogQueueTest, TryFlushDoesNotWaitForRunningFlush)
+{
+    std::atomic<bool> writing{false};
+    std::atomic<bool> release{false};
+    std::vector<LoggedMessage> messages;
+    {
+        CAsyncLogQueue queue([&](LogLevel level, const char* message, std::size_t length)
+        {
+            if (!writing)
+            {
+                writing = true;
+                while (!release) {}
+            }
+            messages.push_back(LoggedMessage{level, std::string(message, length)});
+        });
+
+        PushString(queue, LOG_ERROR, "first");
+        while (!writing) {}
+
+        PushString(queue, LOG_INFO, "second");
+        EXPECT_FALSE(queue.TryFlush());
+        release = true;
+    }
+
+    ASSERT_EQ(2u, messages.size());
+    EXPECT_EQ("second", messages[1].text);
+}
+
+TEST(CAsyncLogQueueTest, CountsAndReportsDroppedMessages)
+{
+    std::atomic<bool> writing{false};
+    std::atomic<bool> release{false};
+    std::vector<LoggedMessage> messages;
+
+    std::unique_ptr<CAsyncLogQueue> queue = MakeUnique<CAsyncLogQueue>(
+        [&](LogLevel level, const char* message, std::size_t length)
+        {
+            // Block the flush thread on the first message so that the ring fills up
+            if (!writing)
+            {
+                writing = true;
+                while (!release) {}
+            }
+            messages.push_back(LoggedMessage{level, std::string(message, length)});
+        });
+
+    PushString(*queue, LOG_ERROR, "first");
+    while (!writing) {}
+
+    std::string text(100, 'x');
+    int pushed = 2 * CAsyncLogQueue::RING_SIZE / text.size();
+    for (int i = 0; i < pushed; i++)
+        PushString(*queue, LOG_TRACE, text);
+
+    release = true;
+    unsigned long dropped = queue->GetDroppedCount();
+    queue.reset();
+
+    EXPECT_GT(dropped, 0u);
+    EXPECT_EQ(pushed + 1 - static_cast<int>(dropped) + 1, static_cast<int>(messages.size()));
+
+    int reports = 0;
+    for (const auto& message : messages)
+    {
+        if (message.level == LOG_WARN && message.text.find("dropped") != std::string::npos)
+            reports++;
+    }
+    EXPECT_EQ(1, reports);
+}
+
+TEST(CLoggerTest, SetLogLevels)
+{
+    CLogger* logger = GetLogger();
+
+    ASSERT_TRUE(logger->SetLogLevels("debug,sound=trace,graphics=none"));
+    EXPECT_TRUE(logger->IsEnabled(LOG_CATEGORY_GENERAL, LOG_DEBUG));
+    EXPECT_FALSE(logger->IsEnabled(LOG_CATEGORY_GENERAL, LOG_TRACE));
+    EXPECT_TRUE(logger->IsEnabled(LOG_CATEGORY_SOUND, LOG_TRACE));
+    EXPECT_FALSE(logger->IsEnabled(LOG_CATEGORY_GRAPHICS, LOG_ERROR));
+
+    // Invalid entries leave the levels unchanged
+    EXPECT_FALSE(logger->SetLogLevels("info,unknown=trace"));
+    EXPECT_FALSE(logger->SetLogLevels("sound=loud"));
+    EXPECT_TRUE(logger->IsEnabled(LOG_CATEGORY_GENERAL, LOG_DEBUG));
+    EXPECT_TRUE(logger->IsEnabled(LOG_CATEGORY_SOUND, LOG_TRACE));
+
+    logger->SetLogLevel(LOG_INFO);
+    EXPECT_FALSE(logger->IsEnabled(LOG_CATEGORY_SOUND, LOG_DEBUG));
+    EXPECT_TRUE(logger->IsEnabled(LOG_CATEGORY_GRAPHICS, LOG_INFO));
+}
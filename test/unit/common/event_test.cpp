@@ -0,0 +1,159 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "common/event.h"
+
+#include "common/make_unique.h"
+
+#include "common/thread/thread.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+TEST(CEventQueueTest, ReturnsEventsInOrder)
+{
+    CEventQueue queue;
+    EXPECT_TRUE(queue.IsEmpty());
+    EXPECT_EQ(EVENT_NULL, queue.GetEvent().type);
+
+    queue.AddEvent(Event(EVENT_KEY_DOWN));
+    queue.AddEvent(Event(EVENT_KEY_UP));
+    EXPECT_FALSE(queue.IsEmpty());
+    EXPECT_EQ(2, queue.GetSize());
+
+    EXPECT_EQ(EVENT_KEY_DOWN, queue.GetEvent().type);
+    EXPECT_EQ(EVENT_KEY_UP, queue.GetEvent().type);
+    EXPECT_TRUE(queue.IsEmpty());
+    EXPECT_EQ(EVENT_NULL, queue.GetEvent().type);
+}
+
+TEST(CEventQueueTest, MovesEventData)
+{
+    CEventQueue queue;
+
+    Event event(EVENT_KEY_DOWN);
+    auto data = MakeUnique<KeyEventData>();
+    data->key = KEY(a);
+    event.data = std::move(data);
+    queue.AddEvent(std::move(event));
+
+    Event result = queue.GetEvent();
+    ASSERT_NE(nullptr, result.data);
+    EXPECT_EQ(static_cast<unsigned int>(KEY(a)), result.GetData<KeyEventData>()->key);
+}
+
+TEST(CEventQueueTest, KeepsAllEventsWhenFlooded)
+{
+    CEventQueue queue;
+
+    const int count = CEventQueue::MAX_EVENT_QUEUE * 3;
+    for (int i = 0; i < count; i++)
+    {
+        Event event(EVENT_KEY_DOWN);
+        event.customParam = i;
+        queue.AddEvent(std::move(event));
+    }
+    EXPECT_EQ(count, queue.GetHighWaterMark());
+
+    for (int i = 0; i < count; i++)
+    {
+        Event event = queue.GetEvent();
+        EXPECT_EQ(EVENT_KEY_DOWN, event.type);
+        EXPECT_EQ(i, event.customParam);
+    }
+    EXPECT_TRUE(queue.IsEmpty());
+    EXPECT_EQ(count, queue.GetHighWaterMark());
+}
+
+TEST(CEventQueueTest, CoalescesMouseMovesWhenFlooded)
+{
+    CEventQueue queue;
+
+    for (int i = 0; i < CEventQueue::MAX_EVENT_QUEUE * 2; i++)
+    {
+        Event event(EVENT_MOUSE_MOVE);
+        event.mousePos = Math::Point(i, 0.0f);
+        queue.AddEvent(std::move(event));
+    }
+    queue.AddEvent(Event(EVENT_KEY_DOWN));
+    queue.AddEvent(Event(EVENT_MOUSE_MOVE));
+
+    Event event = queue.GetEvent();
+    EXPECT_EQ(EVENT_MOUSE_MOVE, event.type);
+    EXPECT_FLOAT_EQ(CEventQueue::MAX_EVENT_QUEUE * 2 - 1, event.mousePos.x);
+    EXPECT_EQ(EVENT_KEY_DOWN, queue.GetEvent().type);
+    EXPECT_EQ(EVENT_MOUSE_MOVE, queue.GetEvent().type);
+    EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(CEventQueueTest, KeepsMouseMovesWhenNotFlooded)
+{
+    CEventQueue queue;
+
+    queue.AddEvent(Event(EVENT_MOUSE_MOVE));
+    queue.AddEvent(Event(EVENT_MOUSE_MOVE));
+
+    EXPECT_EQ(EVENT_MOUSE_MOVE, queue.GetEvent().type);
+    EXPECT_EQ(EVENT_MOUSE_MOVE, queue.GetEvent().type);
+    EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(CEventQueueTest, AddsEventsFromManyThreads)
+{
+    CEventQueue queue;
+
+    const int threadCount = 4;
+    const int eventCount = 1000;
+    std::vector<std::unique_ptr<CThread>> threads;
+    for (int t = 0; t < threadCount; t++)
+    {
+        threads.push_back(MakeUnique<CThread>([&queue, t]()
+        {
+            for (int i = 0; i < eventCount; i++)
+            {
+                Event event(EVENT_KEY_DOWN);
+                event.customParam = t * eventCount + i;
+                queue.AddEvent(std::move(event));
+            }
+        }));
+        threads.back()->Start();
+    }
+
+    // Events of each thread must come out in the order they were added
+    std::vector<int> next(threadCount, 0);
+    int received = 0;
+    while (received < threadCount * eventCount)
+    {
+        Event event = queue.GetEvent();
+        if (event.type == EVENT_NULL)
+            continue;
+
+        int t = event.customParam / eventCount;
+        EXPECT_EQ(t * eventCount + next[t], event.customParam);
+        next[t]++;
+        received++;
+    }
+
+    for (auto& thread : threads)
+        thread->Join();
+
+    EXPECT_TRUE(queue.IsEmpty());
+}
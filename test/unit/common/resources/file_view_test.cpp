@@ -0,0 +1,101 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "common/resources/file_view.h"
+
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <string>
+
+#include <physfs.h>
+
+class CFileViewTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_directory = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+        boost::filesystem::create_directories(m_directory + "/models");
+        WriteFile("models/box.mod", "box model");
+        WriteFile("models/empty.mod", "");
+
+        ASSERT_TRUE(PHYSFS_init(nullptr));
+    }
+
+    void TearDown() override
+    {
+        PHYSFS_deinit();
+        boost::filesystem::remove_all(m_directory);
+    }
+
+    void WriteFile(const std::string& path, const std::string& contents)
+    {
+        std::ofstream file(m_directory + "/" + path, std::ios::binary);
+        file << contents;
+    }
+
+    std::string m_directory;
+};
+
+TEST_F(CFileViewTest, MapsFilesInDirectories)
+{
+    ASSERT_TRUE(PHYSFS_mount(m_directory.c_str(), "", 1));
+
+    CFileView view;
+    ASSERT_TRUE(view.Open("models/box.mod"));
+    EXPECT_TRUE(view.IsMapped());
+    EXPECT_EQ("box model", std::string(view.GetData(), view.GetSize()));
+
+    view.Close();
+    EXPECT_FALSE(view.IsOpen());
+    EXPECT_EQ(0u, view.GetSize());
+}
+
+TEST_F(CFileViewTest, MapsFilesBelowMountPoint)
+{
+    ASSERT_TRUE(PHYSFS_mount(m_directory.c_str(), "data", 1));
+
+    CFileView view;
+    ASSERT_TRUE(view.Open("data/models/box.mod"));
+    EXPECT_TRUE(view.IsMapped());
+    EXPECT_EQ("box model", std::string(view.GetData(), view.GetSize()));
+}
+
+TEST_F(CFileViewTest, ReadsEmptyFiles)
+{
+    ASSERT_TRUE(PHYSFS_mount(m_directory.c_str(), "", 1));
+
+    CFileView view;
+    ASSERT_TRUE(view.Open("models/empty.mod"));
+    EXPECT_FALSE(view.IsMapped());
+    EXPECT_EQ(0u, view.GetSize());
+}
+
+TEST_F(CFileViewTest, FailsForMissingFiles)
+{
+    ASSERT_TRUE(PHYSFS_mount(m_directory.c_str(), "", 1));
+
+    CFileView view;
+    EXPECT_FALSE(view.Open("models/sphere.mod"));
+    EXPECT_FALSE(view.IsOpen());
+    EXPECT_EQ(nullptr, view.GetData());
+}
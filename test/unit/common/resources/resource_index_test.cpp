@@ -0,0 +1,170 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "common/resources/resource_index.h"
+
+#include "common/config.h"
+
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <physfs.h>
+
+/* Same as in resource_index.cpp: on file systems that ignore case,
+ * the index leaves paths missing from it to PhysFS */
+#if PLATFORM_WINDOWS || PLATFORM_MACOSX
+const bool INDEX_MISSES_ARE_FINAL = false;
+#else
+const bool INDEX_MISSES_ARE_FINAL = true;
+#endif
+
+class CResourceIndexTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_directory = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+        boost::filesystem::create_directories(m_directory + "/levels/level1");
+        boost::filesystem::create_directories(m_directory + "/models");
+        WriteFile("levels/level1/scene.txt", "Title text=\"Level\"\n");
+        WriteFile("models/box.mod", "box");
+
+        ASSERT_TRUE(PHYSFS_init(nullptr));
+        ASSERT_TRUE(PHYSFS_mount(m_directory.c_str(), "", 1));
+        ASSERT_TRUE(PHYSFS_setWriteDir(m_directory.c_str()));
+    }
+
+    void TearDown() override
+    {
+        PHYSFS_deinit();
+        boost::filesystem::remove_all(m_directory);
+    }
+
+    void WriteFile(const std::string& path, const std::string& contents)
+    {
+        std::ofstream file(m_directory + "/" + path, std::ios::binary);
+        file << contents;
+    }
+
+    //! Checks that the index knows the path is missing, where it answers for missing paths
+    void ExpectMissing(const std::string& path)
+    {
+        bool exists = true;
+        EXPECT_EQ(INDEX_MISSES_ARE_FINAL, m_index.Exists(path, exists));
+        long long size = 0;
+        EXPECT_EQ(INDEX_MISSES_ARE_FINAL, m_index.GetFileSize(path, size));
+
+        if (INDEX_MISSES_ARE_FINAL)
+        {
+            EXPECT_FALSE(exists);
+            EXPECT_EQ(-1, size);
+        }
+    }
+
+    std::string m_directory;
+    CResourceIndex m_index;
+};
+
+TEST_F(CResourceIndexTest, AnswersQueriesFromIndex)
+{
+    bool exists = false;
+    ASSERT_TRUE(m_index.Exists("levels/level1/scene.txt", exists));
+    EXPECT_TRUE(exists);
+    ASSERT_TRUE(m_index.Exists("/levels//level1/", exists));
+    EXPECT_TRUE(exists);
+    ExpectMissing("levels/level2");
+
+    bool directory = false;
+    ASSERT_TRUE(m_index.IsDirectory("levels/level1", directory));
+    EXPECT_TRUE(directory);
+    ASSERT_TRUE(m_index.IsDirectory("models/box.mod", directory));
+    EXPECT_FALSE(directory);
+
+    std::vector<std::string> names;
+    ASSERT_TRUE(m_index.List("", true, true, names));
+    EXPECT_EQ((std::vector<std::string>{ "levels", "models" }), names);
+    ASSERT_TRUE(m_index.List("models", true, false, names));
+    EXPECT_EQ(std::vector<std::string>{ "box.mod" }, names);
+    ASSERT_TRUE(m_index.List("models", false, true, names));
+    EXPECT_TRUE(names.empty());
+
+    long long size = 0;
+    ASSERT_TRUE(m_index.GetFileSize("models/box.mod", size));
+    EXPECT_EQ(3, size);
+    ExpectMissing("models/sphere.mod");
+}
+
+TEST_F(CResourceIndexTest, LeavesRelativePathsToPhysFS)
+{
+    bool exists = false;
+    EXPECT_FALSE(m_index.Exists("levels/../models/box.mod", exists));
+    EXPECT_FALSE(m_index.Exists("./models", exists));
+}
+
+TEST_F(CResourceIndexTest, UpdatesWrittenAndRemovedPaths)
+{
+    ExpectMissing("savegame/player/data.sav");
+
+    ASSERT_TRUE(PHYSFS_mkdir("savegame/player"));
+    PHYSFS_File* file = PHYSFS_openWrite("savegame/player/data.sav");
+    ASSERT_NE(nullptr, file);
+    PHYSFS_write(file, "12345", 1, 5);
+    PHYSFS_close(file);
+    m_index.Update("savegame/player/data.sav");
+
+    bool exists = false;
+    ASSERT_TRUE(m_index.Exists("savegame/player/data.sav", exists));
+    EXPECT_TRUE(exists);
+    std::vector<std::string> names;
+    ASSERT_TRUE(m_index.List("", false, true, names));
+    EXPECT_EQ((std::vector<std::string>{ "levels", "models", "savegame" }), names);
+    long long size = 0;
+    ASSERT_TRUE(m_index.GetFileSize("savegame/player/data.sav", size));
+    EXPECT_EQ(5, size);
+
+    ASSERT_TRUE(PHYSFS_delete("models/box.mod"));
+    m_index.Update("models/box.mod");
+
+    ExpectMissing("models/box.mod");
+    ASSERT_TRUE(m_index.List("models", true, true, names));
+    EXPECT_TRUE(names.empty());
+}
+
+TEST_F(CResourceIndexTest, CachesSmallFiles)
+{
+    auto data = m_index.ReadFile("levels/level1/scene.txt");
+    ASSERT_NE(nullptr, data);
+    EXPECT_EQ("Title text=\"Level\"\n", std::string(data->begin(), data->end()));
+    EXPECT_EQ(data, m_index.ReadFile("levels/level1/scene.txt"));
+
+    WriteFile("levels/level1/scene.txt", "Title text=\"Changed\"\n");
+    m_index.Update("levels/level1/scene.txt");
+
+    data = m_index.ReadFile("levels/level1/scene.txt");
+    ASSERT_NE(nullptr, data);
+    EXPECT_EQ("Title text=\"Changed\"\n", std::string(data->begin(), data->end()));
+
+    m_index.SetCacheSize(0);
+    EXPECT_EQ(nullptr, m_index.ReadFile("levels/level1/scene.txt"));
+}
@@ -0,0 +1,82 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "common/thread/worker_pool.h"
+
+#include "common/thread/sdl_mutex_wrapper.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+TEST(CWorkerPoolTest, RunsAllJobs)
+{
+    CSDLMutexWrapper mutex;
+    int counter = 0;
+
+    CWorkerPool pool(4);
+    for (int i = 0; i < 100; i++)
+    {
+        pool.Start([&]()
+        {
+            mutex.Lock();
+            counter++;
+            mutex.Unlock();
+        });
+    }
+    pool.WaitAll();
+
+    EXPECT_EQ(100, counter);
+}
+
+TEST(CWorkerPoolTest, WaitsForSingleJob)
+{
+    CWorkerPool pool(2);
+
+    std::vector<int> results(10, 0);
+    std::vector<int> ids;
+    for (int i = 0; i < 10; i++)
+        ids.push_back(pool.Start([&results, i]() { results[i] = i * i; }));
+
+    for (int i = 0; i < 10; i++)
+    {
+        pool.Wait(ids[i]);
+        EXPECT_EQ(i * i, results[i]);
+    }
+}
+
+TEST(CWorkerPoolTest, StartsJobsInOrder)
+{
+    CWorkerPool pool(1);
+
+    std::vector<int> order;
+    for (int i = 0; i < 10; i++)
+        pool.Start([&order, i]() { order.push_back(i); });
+    pool.WaitAll();
+
+    ASSERT_EQ(10u, order.size());
+    for (int i = 0; i < 10; i++)
+        EXPECT_EQ(i, order[i]);
+}
+
+TEST(CWorkerPoolTest, WaitAllWithoutJobs)
+{
+    CWorkerPool pool(2);
+    pool.WaitAll();
+}
@@ -0,0 +1,171 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/object_bvh.h"
+
+#include "math/geometry.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Gfx;
+
+struct TestSphere
+{
+    bool used = false;
+    Math::Vector center;
+    float radius = 0.0f;
+};
+
+class CObjectBVHUT : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Math::Matrix proj, view;
+        Math::LoadProjectionMatrix(proj, 0.75f, 4.0f / 3.0f, 0.5f, 500.0f);
+        Math::LoadViewMatrix(view, Math::Vector(0.0f, 50.0f, 0.0f),
+                             Math::Vector(100.0f, 0.0f, 100.0f), Math::Vector(0.0f, 1.0f, 0.0f));
+        m_frustum.LoadFromMatrices(proj, view);
+    }
+
+    Math::Vector RandomPosition()
+    {
+        std::uniform_real_distribution<float> coord(-800.0f, 800.0f);
+        return Math::Vector(coord(m_random), coord(m_random) * 0.1f, coord(m_random));
+    }
+
+    float RandomRadius()
+    {
+        std::uniform_real_distribution<float> radius(0.5f, 40.0f);
+        return radius(m_random);
+    }
+
+    void CheckCulling()
+    {
+        std::vector<int> expected;
+        for (int i = 0; i < static_cast<int>(m_spheres.size()); i++)
+        {
+            if (m_spheres[i].used && m_frustum.IsSphereVisible(m_spheres[i].center, m_spheres[i].radius))
+                expected.push_back(i);
+        }
+
+        std::vector<int> result;
+        m_bvh.Cull(m_frustum, result);
+        std::sort(result.begin(), result.end());
+
+        EXPECT_EQ(expected, result);
+    }
+
+    std::mt19937 m_random{42};
+    EngineFrustum m_frustum;
+    CObjectBVH m_bvh;
+    std::vector<TestSphere> m_spheres;
+};
+
+TEST_F(CObjectBVHUT, FrustumPlanes)
+{
+    EXPECT_TRUE(m_frustum.IsSphereVisible(Math::Vector(100.0f, 0.0f, 100.0f), 1.0f));
+    EXPECT_FALSE(m_frustum.IsSphereVisible(Math::Vector(-100.0f, 0.0f, -100.0f), 1.0f));
+    EXPECT_TRUE(m_frustum.IsSphereVisible(Math::Vector(-100.0f, 0.0f, -100.0f), 200.0f));
+    EXPECT_FALSE(m_frustum.IsSphereVisible(Math::Vector(1000.0f, 0.0f, 1000.0f), 1.0f));
+}
+
+TEST_F(CObjectBVHUT, EmptyTree)
+{
+    std::vector<int> result;
+    m_bvh.Cull(m_frustum, result);
+    EXPECT_TRUE(result.empty());
+    EXPECT_EQ(0, m_bvh.GetHeight());
+    EXPECT_FALSE(m_bvh.Contains(0));
+
+    m_bvh.Remove(3);
+    EXPECT_EQ(0, m_bvh.GetObjectCount());
+}
+
+TEST_F(CObjectBVHUT, CullMatchesBruteForce)
+{
+    m_spheres.resize(2000);
+    for (int i = 0; i < static_cast<int>(m_spheres.size()); i++)
+    {
+        m_spheres[i].used = true;
+        m_spheres[i].center = RandomPosition();
+        m_spheres[i].radius = RandomRadius();
+        m_bvh.Update(i, m_spheres[i].center, m_spheres[i].radius);
+    }
+
+    EXPECT_EQ(2000, m_bvh.GetObjectCount());
+    // Balanced tree over 2000 leaves
+    EXPECT_LE(m_bvh.GetHeight(), 25);
+
+    CheckCulling();
+}
+
+TEST_F(CObjectBVHUT, IncrementalUpdates)
+{
+    m_spheres.resize(500);
+    std::uniform_int_distribution<int> rank(0, static_cast<int>(m_spheres.size()) - 1);
+    std::uniform_real_distribution<float> step(-3.0f, 3.0f);
+
+    for (int iteration = 0; iteration < 20000; iteration++)
+    {
+        int i = rank(m_random);
+        TestSphere& sphere = m_spheres[i];
+
+        int action = iteration % 4;
+        if (!sphere.used || action == 0)
+        {
+            // Insert or jump far away
+            sphere.used = true;
+            sphere.center = RandomPosition();
+            sphere.radius = RandomRadius();
+            m_bvh.Update(i, sphere.center, sphere.radius);
+        }
+        else if (action == 1)
+        {
+            sphere.used = false;
+            m_bvh.Remove(i);
+        }
+        else
+        {
+            // Small movement, usually within the enlarged box
+            sphere.center += Math::Vector(step(m_random), 0.0f, step(m_random));
+            m_bvh.Update(i, sphere.center, sphere.radius);
+        }
+
+        EXPECT_EQ(sphere.used, m_bvh.Contains(i));
+
+        if (iteration % 1000 == 0)
+            CheckCulling();
+    }
+
+    int count = static_cast<int>(std::count_if(m_spheres.begin(), m_spheres.end(),
+                                               [](const TestSphere& s) { return s.used; }));
+    EXPECT_EQ(count, m_bvh.GetObjectCount());
+    CheckCulling();
+
+    m_bvh.Clear();
+    EXPECT_EQ(0, m_bvh.GetObjectCount());
+    std::vector<int> result;
+    m_bvh.Cull(m_frustum, result);
+    EXPECT_TRUE(result.empty());
+}
@@ -0,0 +1,112 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/rect_packer.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace Gfx;
+
+namespace
+{
+
+struct Placed
+{
+    Math::IntPoint pos;
+    Math::IntPoint size;
+};
+
+bool Overlap(const Placed& a, const Placed& b)
+{
+    return a.pos.x < b.pos.x + b.size.x && b.pos.x < a.pos.x + a.size.x &&
+           a.pos.y < b.pos.y + b.size.y && b.pos.y < a.pos.y + a.size.y;
+}
+
+} // anonymous namespace
+
+TEST(CRectPackerTest, FillsPageWithEqualTiles)
+{
+    CRectPacker packer(Math::IntPoint(256, 256));
+
+    Math::IntPoint pos;
+    for (int i = 0; i < 16; ++i)
+    {
+        ASSERT_TRUE(packer.Insert(Math::IntPoint(64, 64), pos));
+        EXPECT_EQ(64 * (i % 4), pos.x);
+        EXPECT_EQ(64 * (i / 4), pos.y);
+    }
+
+    EXPECT_FALSE(packer.Insert(Math::IntPoint(1, 1), pos));
+    EXPECT_FLOAT_EQ(1.0f, packer.GetOccupancy());
+}
+
+TEST(CRectPackerTest, RejectsTooLargeRectangles)
+{
+    CRectPacker packer(Math::IntPoint(128, 64));
+
+    Math::IntPoint pos;
+    EXPECT_FALSE(packer.Insert(Math::IntPoint(129, 10), pos));
+    EXPECT_FALSE(packer.Insert(Math::IntPoint(10, 65), pos));
+    EXPECT_FALSE(packer.Insert(Math::IntPoint(0, 10), pos));
+    EXPECT_TRUE(packer.Insert(Math::IntPoint(128, 64), pos));
+}
+
+TEST(CRectPackerTest, PlacesWithoutOverlap)
+{
+    CRectPacker packer(Math::IntPoint(512, 512));
+
+    std::vector<Placed> placed;
+    for (int i = 0; i < 200; ++i)
+    {
+        Placed p;
+        p.size = Math::IntPoint(8 + (i * 37) % 41, 40 - (i * 13) % 29);
+        if (!packer.Insert(p.size, p.pos))
+            continue;
+
+        EXPECT_GE(p.pos.x, 0);
+        EXPECT_GE(p.pos.y, 0);
+        EXPECT_LE(p.pos.x + p.size.x, 512);
+        EXPECT_LE(p.pos.y + p.size.y, 512);
+        placed.push_back(p);
+    }
+
+    ASSERT_GT(placed.size(), 100u);
+    for (std::size_t i = 0; i < placed.size(); ++i)
+    {
+        for (std::size_t j = i + 1; j < placed.size(); ++j)
+            EXPECT_FALSE(Overlap(placed[i], placed[j]));
+    }
+}
+
+TEST(CRectPackerTest, ReusesShelvesAfterClear)
+{
+    CRectPacker packer(Math::IntPoint(100, 100));
+
+    Math::IntPoint pos;
+    ASSERT_TRUE(packer.Insert(Math::IntPoint(100, 100), pos));
+    EXPECT_FALSE(packer.Insert(Math::IntPoint(10, 10), pos));
+
+    packer.Clear();
+    EXPECT_FLOAT_EQ(0.0f, packer.GetOccupancy());
+    ASSERT_TRUE(packer.Insert(Math::IntPoint(10, 10), pos));
+    EXPECT_EQ(0, pos.x);
+    EXPECT_EQ(0, pos.y);
+}
@@ -0,0 +1,166 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/model/model_input.h"
+#include "graphics/model/model_io_exception.h"
+#include "graphics/model/model_output.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+using namespace Gfx;
+
+namespace
+{
+
+ModelTriangle MakeTriangle(float offset, const std::string& tex1Name)
+{
+    ModelTriangle triangle;
+    triangle.p1 = VertexTex2(Math::Vector(offset, 0.0f, 0.0f), Math::Vector(0.0f, 1.0f, 0.0f), Math::Point(0.0f, 0.0f), Math::Point(0.5f, 0.5f));
+    triangle.p2 = VertexTex2(Math::Vector(offset, 1.0f, 0.0f), Math::Vector(0.0f, 1.0f, 0.0f), Math::Point(1.0f, 0.0f), Math::Point(0.5f, 0.5f));
+    triangle.p3 = VertexTex2(Math::Vector(offset, 0.0f, 1.0f), Math::Vector(0.0f, 1.0f, 0.0f), Math::Point(0.0f, 1.0f), Math::Point(0.5f, 0.5f));
+    triangle.diffuse = Color(1.0f, 0.5f, 0.25f, 1.0f);
+    triangle.tex1Name = tex1Name;
+    return triangle;
+}
+
+void ExpectSameVertex(const VertexTex2& expected, const VertexTex2& actual)
+{
+    EXPECT_TRUE(Math::VectorsEqual(expected.coord, actual.coord));
+    EXPECT_TRUE(Math::VectorsEqual(expected.normal, actual.normal));
+    EXPECT_TRUE(Math::PointsEqual(expected.texCoord, actual.texCoord));
+    EXPECT_TRUE(Math::PointsEqual(expected.texCoord2, actual.texCoord2));
+}
+
+void ExpectSameTriangles(const std::vector<ModelTriangle>& expected, const std::vector<ModelTriangle>& actual)
+{
+    ASSERT_EQ(expected.size(), actual.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        ExpectSameVertex(expected[i].p1, actual[i].p1);
+        ExpectSameVertex(expected[i].p2, actual[i].p2);
+        ExpectSameVertex(expected[i].p3, actual[i].p3);
+        EXPECT_EQ(expected[i].diffuse, actual[i].diffuse);
+        EXPECT_EQ(expected[i].tex1Name, actual[i].tex1Name);
+        EXPECT_EQ(expected[i].tex2Name, actual[i].tex2Name);
+        EXPECT_EQ(expected[i].variableTex2, actual[i].variableTex2);
+        EXPECT_EQ(expected[i].doubleSided, actual[i].doubleSided);
+        EXPECT_EQ(expected[i].transparentMode, actual[i].transparentMode);
+        EXPECT_EQ(expected[i].specialMark, actual[i].specialMark);
+    }
+}
+
+CModel MakeModel()
+{
+    CModel model;
+
+    ModelCrashSphere crashSphere;
+    crashSphere.position = Math::Vector(1.0f, 2.0f, 3.0f);
+    crashSphere.radius = 4.0f;
+    crashSphere.sound = "metal";
+    crashSphere.hardness = 0.5f;
+    model.AddCrashSphere(crashSphere);
+
+    ModelShadowSpot shadowSpot;
+    shadowSpot.radius = 2.0f;
+    shadowSpot.intensity = 0.75f;
+    model.SetShadowSpot(shadowSpot);
+
+    CModelMesh mesh;
+    mesh.AddTriangle(MakeTriangle(0.0f, "base.png"));
+    mesh.AddTriangle(MakeTriangle(1.0f, "base.png"));
+    ModelTriangle special = MakeTriangle(2.0f, "lights.png");
+    special.variableTex2 = true;
+    special.doubleSided = true;
+    special.transparentMode = ModelTransparentMode::MapBlackToAlpha;
+    special.specialMark = ModelSpecialMark::Part2;
+    mesh.AddTriangle(special);
+    mesh.AddTriangle(MakeTriangle(3.0f, "base.png"));
+    mesh.SetLodTriangles(1, { MakeTriangle(4.0f, "base.png") });
+    model.AddMesh("main", std::move(mesh));
+
+    CModelMesh wheel;
+    wheel.SetParent("main");
+    wheel.SetPosition(Math::Vector(1.0f, 0.0f, -1.0f));
+    wheel.SetScale(Math::Vector(2.0f, 2.0f, 2.0f));
+    wheel.AddTriangle(MakeTriangle(5.0f, "wheel.png"));
+    model.AddMesh("wheel", std::move(wheel));
+
+    return model;
+}
+
+} // anonymous namespace
+
+TEST(ModelIOTest, BinaryModelV3RoundTrip)
+{
+    CModel model = MakeModel();
+
+    std::stringstream stream;
+    ModelOutput::Write(model, stream, ModelFormat::Binary);
+    std::string data = stream.str();
+
+    CModel result = ModelInput::Read(data.data(), data.size(), ModelFormat::Binary);
+
+    ASSERT_EQ(1, result.GetCrashSphereCount());
+    EXPECT_TRUE(Math::VectorsEqual(Math::Vector(1.0f, 2.0f, 3.0f), result.GetCrashSpheres()[0].position));
+    EXPECT_EQ(4.0f, result.GetCrashSpheres()[0].radius);
+    EXPECT_EQ("metal", result.GetCrashSpheres()[0].sound);
+    EXPECT_EQ(0.5f, result.GetCrashSpheres()[0].hardness);
+    ASSERT_TRUE(result.HasShadowSpot());
+    EXPECT_EQ(0.75f, result.GetShadowSpot().intensity);
+    EXPECT_FALSE(result.HasCameraCollisionSphere());
+
+    ASSERT_EQ(2, result.GetMeshCount());
+    const CModelMesh* main = result.GetMesh("main");
+    ASSERT_NE(nullptr, main);
+    ExpectSameTriangles(model.GetMesh("main")->GetTriangles(), main->GetTriangles());
+    EXPECT_TRUE(main->GetLodTriangles(0).empty());
+    ExpectSameTriangles(model.GetMesh("main")->GetLodTriangles(1), main->GetLodTriangles(1));
+
+    const CModelMesh* wheel = result.GetMesh("wheel");
+    ASSERT_NE(nullptr, wheel);
+    EXPECT_EQ("main", wheel->GetParent());
+    EXPECT_TRUE(Math::VectorsEqual(Math::Vector(1.0f, 0.0f, -1.0f), wheel->GetPosition()));
+    EXPECT_TRUE(Math::VectorsEqual(Math::Vector(2.0f, 2.0f, 2.0f), wheel->GetScale()));
+    ExpectSameTriangles(model.GetMesh("wheel")->GetTriangles(), wheel->GetTriangles());
+}
+
+TEST(ModelIOTest, BinaryModelV3FromStream)
+{
+    CModel model = MakeModel();
+
+    std::stringstream stream;
+    ModelOutput::Write(model, stream, ModelFormat::Binary);
+    stream.seekg(0);
+
+    CModel result = ModelInput::Read(stream, ModelFormat::Binary);
+    ASSERT_NE(nullptr, result.GetMesh("main"));
+    ExpectSameTriangles(model.GetMesh("main")->GetTriangles(), result.GetMesh("main")->GetTriangles());
+}
+
+TEST(ModelIOTest, TruncatedBinaryModelV3)
+{
+    std::stringstream stream;
+    ModelOutput::Write(MakeModel(), stream, ModelFormat::Binary);
+    std::string data = stream.str();
+
+    EXPECT_THROW(ModelInput::Read(data.data(), data.size() - 10, ModelFormat::Binary), CModelIOException);
+}
@@ -0,0 +1,147 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2020, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "script/script.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+namespace
+{
+
+// Replaces text[start, oldEnd) with replacement and updates the cache like an edit would
+void Edit(CScript::ColorizeCache& cache, std::string& text, int start, int oldEnd, const std::string& replacement,
+          int& firstLine, int& endLine)
+{
+    text.replace(start, oldEnd - start, replacement);
+    int newEnd = start + static_cast<int>(replacement.length());
+    CScript::UpdateColorizeCache(cache, text, static_cast<int>(text.length()), start, oldEnd, newEnd, firstLine, endLine);
+}
+
+CScript::ColorizeCache Colorize(const std::string& text)
+{
+    CScript::ColorizeCache cache;
+    int firstLine, endLine;
+    CScript::UpdateColorizeCache(cache, text, static_cast<int>(text.length()), -1, 0, 0, firstLine, endLine);
+    return cache;
+}
+
+void ExpectSameHighlight(const CScript::ColorizeCache& expected, const CScript::ColorizeCache& actual)
+{
+    EXPECT_EQ(expected.length, actual.length);
+    ASSERT_EQ(expected.lines.size(), actual.lines.size());
+    for (std::size_t i = 0; i < expected.lines.size(); ++i)
+    {
+        const CScript::ColorizeLine& a = expected.lines[i];
+        const CScript::ColorizeLine& b = actual.lines[i];
+        EXPECT_EQ(a.length, b.length) << "line " << i;
+        EXPECT_EQ(a.commentBefore, b.commentBefore) << "line " << i;
+        EXPECT_EQ(a.commentAfter, b.commentAfter) << "line " << i;
+        ASSERT_EQ(a.runs.size(), b.runs.size()) << "line " << i;
+        for (std::size_t j = 0; j < a.runs.size(); ++j)
+        {
+            EXPECT_EQ(a.runs[j].start, b.runs[j].start) << "line " << i;
+            EXPECT_EQ(a.runs[j].end, b.runs[j].end) << "line " << i;
+            EXPECT_EQ(a.runs[j].format, b.runs[j].format) << "line " << i;
+        }
+    }
+}
+
+const std::string PROGRAM =
+    "extern void object::Test()\n"
+    "{\n"
+    "    int a = 1;\n"
+    "    string s = \"text\";\n"
+    "    float f = 2.5;\n"
+    "    message(s);\n"
+    "}\n";
+
+} // anonymous namespace
+
+TEST(ScriptColorizeTest, EditRelexesOnlyModifiedLine)
+{
+    std::string text = PROGRAM;
+    CScript::ColorizeCache cache = Colorize(text);
+    ASSERT_EQ(8u, cache.lines.size());
+
+    int firstLine, endLine;
+    int pos = text.find("1;");
+    Edit(cache, text, pos, pos + 1, "123", firstLine, endLine);
+    EXPECT_EQ(2, firstLine);
+    EXPECT_EQ(3, endLine);
+    ExpectSameHighlight(Colorize(text), cache);
+
+    // a new line splits the modified line in two
+    pos = text.find("float");
+    Edit(cache, text, pos, pos, "int b;\n    ", firstLine, endLine);
+    EXPECT_EQ(4, firstLine);
+    EXPECT_EQ(6, endLine);
+    ASSERT_EQ(9u, cache.lines.size());
+    ExpectSameHighlight(Colorize(text), cache);
+
+    // nothing changed
+    CScript::UpdateColorizeCache(cache, text, static_cast<int>(text.length()), 0, 0, 0, firstLine, endLine);
+    EXPECT_EQ(firstLine, endLine);
+}
+
+TEST(ScriptColorizeTest, BlockCommentRelexesFollowingLines)
+{
+    std::string text = PROGRAM;
+    CScript::ColorizeCache cache = Colorize(text);
+
+    int firstLine, endLine;
+    int pos = text.find("int a");
+    Edit(cache, text, pos, pos, "/*", firstLine, endLine);
+    EXPECT_EQ(2, firstLine);
+    EXPECT_EQ(8, endLine);
+    EXPECT_TRUE(cache.lines[5].commentBefore);
+    ExpectSameHighlight(Colorize(text), cache);
+
+    pos = text.find("float");
+    Edit(cache, text, pos, pos, "*/", firstLine, endLine);
+    EXPECT_EQ(4, firstLine);
+    EXPECT_EQ(8, endLine);
+    EXPECT_FALSE(cache.lines[5].commentBefore);
+    ExpectSameHighlight(Colorize(text), cache);
+}
+
+TEST(ScriptColorizeTest, RandomEditsMatchFullHighlight)
+{
+    const char* const snippets[] = { "\n", "/*", "*/", "int ", "\"", "x", "{", "// ", " ", "2.5", "\nfloat" };
+    std::mt19937 random(1234);
+
+    std::string text = PROGRAM;
+    CScript::ColorizeCache cache = Colorize(text);
+    for (int i = 0; i < 2000; ++i)
+    {
+        int length = static_cast<int>(text.length());
+        int start = std::uniform_int_distribution<int>(0, length)(random);
+        int oldEnd = std::min(length, start + std::uniform_int_distribution<int>(0, 3)(random));
+        std::string replacement;
+        if (random() % 3 != 0 || length < 20)
+            replacement = snippets[random() % (sizeof(snippets) / sizeof(snippets[0]))];
+
+        int firstLine, endLine;
+        Edit(cache, text, start, oldEnd, replacement, firstLine, endLine);
+        ExpectSameHighlight(Colorize(text), cache);
+        if (HasFailure()) break;
+    }
+}
@@ -0,0 +1,20 @@
+#!/bin/bash
+# Runs the rendering benchmark on the given levels (default: a few stock ones)
+# and stores per-frame statistics in benchmark/<level>.json
+# With --text, text resembling the program editor is drawn over the scene
+# and the statistics are stored in benchmark/<level>-text.json
+
+args=
+suffix=
+if [ "$1" = "--text" ]; then
+	args=-benchmarktext
+	suffix=-text
+	shift
+fi
+
+levels=${@:-"missions101 missions203 missions304 missions501 free101"}
+mkdir -p benchmark
+for level in $levels; do
+	echo $level
+	colobot -runscene $level -headless -graphics record -benchmark benchmark/$level$suffix.json $args -loglevel warn 2>&1 | grep -vE --line-buffered "Colobot.*starting" | grep -v --line-buffered "Log level changed"
+done